@@ -271,6 +271,68 @@ class ClipConstants {
   /// 缩略图边长（像素）
   static const int thumbnailSize = 200;
 
+  /// 文本类格式达到该大小（字节）时改为分块流式读取，不经一次性消息传输
+  static const int clipboardStreamThreshold = 8 * 1024 * 1024;
+
+  /// 流式读取的负载上限（字节），超过时中止读取并放弃该格式
+  static const int clipboardStreamMaxBytes = 256 * 1024 * 1024;
+
+  /// 归为同一版本组的最大感知哈希距离（64 位中的不同位数）
+  static const int imageNearDuplicateDistance = 6;
+
+  /// 视为同一文本不同版本的最低相似度（MinHash 估计的 Jaccard 相似度）
+  static const double textNearDuplicateSimilarity = 0.8;
+
+  /// 参与文本近似重复检测的最短长度（字符）
+  static const int textNearDuplicateMinLength = 64;
+
+  /// 近似重复文本以增量形式保存的最短长度（字符）
+  static const int textDeltaMinLength = 4096;
+
+  /// 增量不小于全文的该比例时改存全文
+  static const double textDeltaMaxRatio = 0.5;
+
+  /// 增量链深度超过该值时由后台任务改为直接相对链根编码
+  static const int textDeltaRebaseDepth = 4;
+
+  /// 增量链的最大深度，基准已达到该深度时直接保存全文
+  static const int textDeltaMaxChainDepth = 8;
+
+  /// 内存中缓存的增量行还原全文的总字符数上限（搜索时免于重复还原）
+  static const int textDeltaCacheChars = 8 * 1024 * 1024;
+
+  /// 每种 OCR 语言保留的已初始化引擎数（不小于 [ocrParallelism]，
+  /// 分块识别时无需临时初始化引擎）
+  static const int ocrEnginePoolSize = 4;
+
+  /// OCR 引擎空闲超过该时长后释放（秒）
+  static const int ocrEngineIdleTimeoutSeconds = 300;
+
+  /// 单次 OCR 识别的截止时间（毫秒），超时即中止
+  static const int ocrDeadlineMs = 30000;
+
+  /// 是否在原生侧预处理 OCR 图像（灰度、缩放、二值化）
+  static const bool ocrPreprocess = true;
+
+  /// OCR 预处理缩放的目标分辨率（DPI）
+  static const int ocrTargetDpi = 200;
+
+  /// OCR 预处理的二值化方式：none / otsu / sauvola
+  static const String ocrBinarization = 'sauvola';
+
+  /// OCR 预处理是否校正倾斜（截图很少倾斜，默认关闭）
+  static const bool ocrDeskew = false;
+
+  /// 大截图分块并行识别时最多同时使用的引擎数
+  static const int ocrParallelism = 4;
+
+  /// OCR 结果缓存的条目上限（按图片内容哈希，跨重启保留）
+  static const int ocrCacheEntries = 512;
+
+  /// OCR 前文字预判的阈值（0~1）：含文字可能性低于该值的图片跳过识别，
+  /// 0 为总是识别
+  static const double ocrTextThreshold = 0.2;
+
   /// 文件大小单位换算（1 KB = 1024 B）
   static const int bytesInKB = 1024;
 }
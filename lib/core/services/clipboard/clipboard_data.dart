@@ -1,3 +1,5 @@
+import 'dart:typed_data';
+
 /// 跨平台剪贴板数据模型
 ///
 /// 统一表示从各平台获取的原始剪贴板数据
@@ -11,6 +13,12 @@ class ClipboardData {
     required this.formats,
     required this.sequence,
     required this.timestamp,
+    this.imageThumbnail,
+    this.imageWidth,
+    this.imageHeight,
+    this.hashes = const {},
+    this.imagePerceptualHash,
+    this.imageNearDuplicate,
   });
 
   /// 剪贴板中可用的所有格式
@@ -22,6 +30,25 @@ class ClipboardData {
   /// 检测时间
   final DateTime timestamp;
 
+  /// 原生侧生成的图片缩略图（Linux），无需在 Dart 侧解码原图
+  final Uint8List? imageThumbnail;
+
+  /// 原图尺寸（由原生侧提供时有值）
+  final int? imageWidth;
+  final int? imageHeight;
+
+  /// 原生侧为各格式计算的内容指纹（Linux）
+  final Map<ClipboardFormat, ClipboardFormatHash> hashes;
+
+  /// 图片的感知哈希（64 位，十六进制），用于近似重复检测（Linux）
+  final String? imagePerceptualHash;
+
+  /// 已收录图片中与当前图片最接近的一张（Linux）
+  final ImageNearDuplicate? imageNearDuplicate;
+
+  /// 获取指定格式的 SHA-256（十六进制），未提供时返回 null
+  String? sha256Of(ClipboardFormat format) => hashes[format]?.sha256;
+
   /// 获取指定格式的内容
   T? getFormat<T>(ClipboardFormat format) {
     final content = formats[format];
@@ -58,11 +85,23 @@ class ClipboardData {
     Map<ClipboardFormat, dynamic>? formats,
     int? sequence,
     DateTime? timestamp,
+    Uint8List? imageThumbnail,
+    int? imageWidth,
+    int? imageHeight,
+    Map<ClipboardFormat, ClipboardFormatHash>? hashes,
+    String? imagePerceptualHash,
+    ImageNearDuplicate? imageNearDuplicate,
   }) {
     return ClipboardData(
       formats: formats ?? this.formats,
       sequence: sequence ?? this.sequence,
       timestamp: timestamp ?? this.timestamp,
+      imageThumbnail: imageThumbnail ?? this.imageThumbnail,
+      imageWidth: imageWidth ?? this.imageWidth,
+      imageHeight: imageHeight ?? this.imageHeight,
+      hashes: hashes ?? this.hashes,
+      imagePerceptualHash: imagePerceptualHash ?? this.imagePerceptualHash,
+      imageNearDuplicate: imageNearDuplicate ?? this.imageNearDuplicate,
     );
   }
 
@@ -76,6 +115,30 @@ class ClipboardData {
   }
 }
 
+/// 单个格式的内容指纹
+class ClipboardFormatHash {
+  /// 创建格式指纹
+  const ClipboardFormatHash({required this.xxh64, this.sha256});
+
+  /// 非加密快速指纹（XXH64，十六进制）
+  final String xxh64;
+
+  /// SHA-256（十六进制），仅在请求时计算
+  final String? sha256;
+}
+
+/// 近似重复的已有图片
+class ImageNearDuplicate {
+  /// 创建近似重复结果
+  const ImageNearDuplicate({required this.id, required this.distance});
+
+  /// 已有剪贴项的 ID
+  final String id;
+
+  /// 感知哈希的汉明距离（0..64），越小越相似
+  final int distance;
+}
+
 /// 剪贴板格式枚举
 enum ClipboardFormat {
   /// 纯文本
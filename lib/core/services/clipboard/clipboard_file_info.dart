@@ -0,0 +1,195 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:clip_flow/core/services/observability/index.dart';
+import 'package:flutter/services.dart';
+
+/// 文件内容哈希算法
+enum ClipboardFileHash {
+  /// 不计算
+  none,
+
+  /// XXH64（快速，非加密）
+  xxh64,
+
+  /// SHA-256
+  sha256,
+}
+
+/// 单个文件的元数据
+class ClipboardFileInfo {
+  /// 创建文件元数据
+  const ClipboardFileInfo({
+    required this.path,
+    required this.exists,
+    required this.type,
+    this.isDirectory = false,
+    this.size = 0,
+    this.modified,
+    this.mime,
+    this.hash,
+  });
+
+  /// 从原生结果解析
+  factory ClipboardFileInfo.fromMap(Map<Object?, Object?> map) {
+    final modified = map['modified'] as int?;
+    return ClipboardFileInfo(
+      path: map['path']! as String,
+      exists: map['exists'] as bool? ?? false,
+      type: map['type'] as String? ?? 'file',
+      isDirectory: map['isDirectory'] as bool? ?? false,
+      size: map['size'] as int? ?? 0,
+      modified: modified != null
+          ? DateTime.fromMillisecondsSinceEpoch(modified)
+          : null,
+      mime: map['mime'] as String?,
+      hash: map['hash'] as String?,
+    );
+  }
+
+  /// 本地路径（已百分号解码）
+  final String path;
+
+  /// 文件是否存在
+  final bool exists;
+
+  /// 粗分类：image / audio / video / document / archive / code / file
+  final String type;
+
+  /// 是否为目录
+  final bool isDirectory;
+
+  /// 文件大小（字节）
+  final int size;
+
+  /// 修改时间
+  final DateTime? modified;
+
+  /// MIME 类型（扩展名结合文件头魔数）
+  final String? mime;
+
+  /// 十六进制内容哈希；未请求时为 null
+  final String? hash;
+}
+
+/// 批量读取文件元数据（Linux 原生实现）
+///
+/// 原生侧直接解析剪贴板中的 text/uri-list（含百分号解码），
+/// 由线程池并行完成 stat、MIME 嗅探与可选的内容哈希，结果保持列表顺序。
+/// 复制上千个文件时无需在 Dart 侧逐个 stat。
+class ClipboardFileInfoReader {
+  ClipboardFileInfoReader._();
+
+  static const MethodChannel _platformChannel = MethodChannel(
+    'clipboard_service',
+  );
+
+  static const EventChannel _eventChannel = EventChannel(
+    'file_metadata_events',
+  );
+
+  static Stream<Map<Object?, Object?>>? _events;
+  static int _nextRequestId = 1;
+
+  /// 当前平台是否支持原生采集
+  static bool get isAvailable => Platform.isLinux;
+
+  /// 一次性读取全部元数据
+  ///
+  /// 给出 [paths] 时采集这些路径，否则采集剪贴板中的文件。
+  /// 没有文件、其他平台或调用失败时返回 null。
+  static Future<List<ClipboardFileInfo>?> read({
+    List<String>? paths,
+    ClipboardFileHash hash = ClipboardFileHash.none,
+    int? timeoutMs,
+  }) async {
+    if (!isAvailable) return null;
+    try {
+      final result = await _platformChannel.invokeListMethod<Object?>(
+        'getClipboardFileInfo',
+        {
+          if (paths != null) 'paths': paths,
+          if (hash != ClipboardFileHash.none) 'hash': hash.name,
+          if (timeoutMs != null) 'timeoutMs': timeoutMs,
+        },
+      );
+      return result
+          ?.map((entry) => ClipboardFileInfo.fromMap(entry! as Map))
+          .toList();
+    } on Exception catch (e) {
+      await Log.w(
+        'Native file info failed',
+        tag: 'ClipboardFileInfo',
+        error: e,
+      );
+      return null;
+    }
+  }
+
+  /// 以有序分块的形式读取元数据，先完成的前缀先送达
+  ///
+  /// 参数含义同 [read]；每块最多 [chunkSize] 项。
+  static Stream<List<ClipboardFileInfo>> watch({
+    List<String>? paths,
+    ClipboardFileHash hash = ClipboardFileHash.none,
+    int? chunkSize,
+    int? timeoutMs,
+  }) {
+    if (!isAvailable) {
+      return Stream.error(
+        UnsupportedError('Native file info is only available on Linux'),
+      );
+    }
+    final requestId = _nextRequestId++;
+    final controller = StreamController<List<ClipboardFileInfo>>();
+    StreamSubscription<Map<Object?, Object?>>? subscription;
+    var received = 0;
+    int? expected;
+
+    Future<void> finish() async {
+      await subscription?.cancel();
+      await controller.close();
+    }
+
+    controller.onListen = () {
+      subscription = (_events ??= _eventChannel
+              .receiveBroadcastStream()
+              .where((event) => event is Map)
+              .map((event) => event as Map<Object?, Object?>)
+              .asBroadcastStream())
+          .where((event) => event['requestId'] == requestId)
+          .listen((event) {
+            final entries = (event['entries']! as List)
+                .map((entry) => ClipboardFileInfo.fromMap(entry! as Map))
+                .toList();
+            received += entries.length;
+            controller.add(entries);
+            if (expected != null && received >= expected!) {
+              unawaited(finish());
+            }
+          });
+
+      _platformChannel
+          .invokeMapMethod<String, dynamic>('getClipboardFileInfo', {
+            'requestId': requestId,
+            if (paths != null) 'paths': paths,
+            if (hash != ClipboardFileHash.none) 'hash': hash.name,
+            if (chunkSize != null) 'chunkSize': chunkSize,
+            if (timeoutMs != null) 'timeoutMs': timeoutMs,
+          })
+          .then((result) {
+            // 最后几块事件可能晚于方法响应到达
+            expected = result?['count'] as int? ?? 0;
+            if (received >= expected!) {
+              unawaited(finish());
+            }
+          })
+          .catchError((Object error) {
+            controller.addError(error);
+            unawaited(finish());
+          });
+    };
+    controller.onCancel = () => subscription?.cancel();
+    return controller.stream;
+  }
+}
@@ -16,6 +16,9 @@ class ClipboardPoller {
     'clipboard_service',
   );
 
+  /// Linux 原生剪贴板变化事件（owner-change 推送）
+  static const EventChannel _eventChannel = EventChannel('clipboard_events');
+
   // 轮询间隔配置 - 优化快速复制检测
   static const Duration _minInterval = Duration(
     milliseconds: 100,
@@ -37,6 +40,8 @@ class ClipboardPoller {
   static const int _rapidCopyThreshold = 3; // 快速复制检测阈值
 
   Timer? _pollingTimer;
+  StreamSubscription<dynamic>? _eventSubscription;
+  bool _isEventDriven = false;
   Duration _currentInterval = _defaultInterval;
   bool _isPolling = false;
   bool _isPaused = false;
@@ -81,13 +86,65 @@ class ClipboardPoller {
     _isPaused = false;
     _pollingStartTime = DateTime.now();
 
+    if (Platform.isLinux) {
+      _subscribeToNativeEvents();
+    }
     _scheduleNextPoll();
   }
 
+  /// 订阅原生剪贴板变化事件；订阅失败时保持定时轮询
+  void _subscribeToNativeEvents() {
+    if (_eventSubscription != null) return;
+
+    _eventSubscription = _eventChannel.receiveBroadcastStream().listen(
+      _handleNativeEvent,
+      onError: (Object error) {
+        // 原生端不支持选区通知，回退到定时轮询
+        _cancelNativeEvents();
+        _scheduleNextPoll();
+      },
+      onDone: () {
+        _cancelNativeEvents();
+        _scheduleNextPoll();
+      },
+    );
+  }
+
+  void _cancelNativeEvents() {
+    _eventSubscription?.cancel();
+    _eventSubscription = null;
+    _isEventDriven = false;
+  }
+
+  /// 处理原生推送的剪贴板变化事件
+  void _handleNativeEvent(dynamic event) {
+    if (!_isPolling || _isPaused) return;
+
+    // 首个事件到达说明推送可用，停止定时轮询
+    if (!_isEventDriven) {
+      _isEventDriven = true;
+      _pollingTimer?.cancel();
+      _pollingTimer = null;
+    }
+
+    _totalChecks++;
+    final sequence = event is Map ? event['sequence'] as int? : null;
+    if (sequence != null && sequence == _lastClipboardSequence) return;
+
+    _lastClipboardSequence = sequence ?? _lastClipboardSequence + 1;
+    _successfulChecks++;
+    _recordChange();
+    _onClipboardChanged?.call();
+  }
+
+  /// 是否由原生事件驱动（无需定时轮询）
+  bool get isEventDriven => _isEventDriven;
+
   /// 停止轮询
   void stopPolling() {
     _pollingTimer?.cancel();
     _pollingTimer = null;
+    _cancelNativeEvents();
     _isPolling = false;
     _isPaused = false;
 
@@ -125,7 +182,17 @@ class ClipboardPoller {
 
     _isPaused = false;
     _pollingStartTime = DateTime.now();
-    _scheduleNextPoll();
+    if (!_isEventDriven) {
+      _scheduleNextPoll();
+      return;
+    }
+
+    // 暂停期间的推送被忽略，恢复时补一次序列号比对
+    unawaited(
+      _checkClipboardChange().then((hasChanged) {
+        if (hasChanged) _onClipboardChanged?.call();
+      }).catchError((Object _) {}),
+    );
   }
 
   /// 手动触发一次检查
@@ -158,7 +225,7 @@ class ClipboardPoller {
 
   /// 调度下一次轮询（优化版本）
   void _scheduleNextPoll() {
-    if (!_isPolling || _isPaused) return;
+    if (!_isPolling || _isPaused || _isEventDriven) return;
 
     // 先取消现有的 Timer，防止竞态条件
     _pollingTimer?.cancel();
@@ -451,6 +518,7 @@ class ClipboardPoller {
       'isPolling': isPolling,
       'isPaused': _isPaused,
       'isIdleMode': _isIdleMode,
+      'isEventDriven': _isEventDriven,
       'isRapidCopyMode': _isRapidCopyMode,
       'currentInterval': _currentInterval.inMilliseconds,
       'consecutiveNoChangeCount': _consecutiveNoChangeCount,
@@ -1,4 +1,5 @@
 import 'dart:async';
+import 'dart:convert';
 import 'dart:io';
 import 'dart:typed_data';
 
@@ -46,6 +47,10 @@ class ClipboardProcessor {
   int _cacheMisses = 0;
   DateTime? _lastCleanup;
 
+  // OCR 文字预判统计：请求识别的图片数与因不含文字而跳过的次数
+  int _ocrRequests = 0;
+  int _ocrSkippedNoText = 0;
+
   /// 处理剪贴板内容并创建 ClipItem
   Future<ClipItem?> processClipboardContent() async {
     try {
@@ -62,19 +67,29 @@ class ClipboardProcessor {
       // 获取原始二进制数据用于生成内容哈希
       // 这对于图片等二进制类型至关重要，确保基于内容而非文件名去重
       Uint8List? binaryData;
+      String? nativeContentHash;
       if (tempItem.type == ClipType.image ||
           tempItem.type == ClipType.file ||
           tempItem.type == ClipType.audio ||
           tempItem.type == ClipType.video) {
         // 尝试从原始数据中获取二进制内容
         if (detectionResult.originalData != null) {
-          // 优先使用图片数据
-          binaryData = detectionResult.originalData!.getFormat<Uint8List>(
+          // 原生侧已计算图片负载的 SHA-256 时直接使用，无需再次遍历字节
+          nativeContentHash = detectionResult.originalData!.sha256Of(
             ClipboardFormat.image,
           );
 
+          // 优先使用图片数据
+          binaryData = nativeContentHash != null
+              ? null
+              : detectionResult.originalData!.getFormat<Uint8List>(
+                  ClipboardFormat.image,
+                );
+
           // 如果没有图片数据但是文件类型，尝试读取文件
-          if (binaryData == null && tempItem.filePath != null) {
+          if (binaryData == null &&
+              nativeContentHash == null &&
+              tempItem.filePath != null) {
             try {
               final file = File(tempItem.filePath!);
               if (file.existsSync()) {
@@ -98,6 +113,7 @@ class ClipboardProcessor {
         tempItem.filePath,
         tempItem.metadata,
         binaryBytes: binaryData, // 使用原始二进制数据而非thumbnail
+        fileContentHash: nativeContentHash,
       );
 
       // 检查缓存（使用统一的哈希）
@@ -191,9 +207,15 @@ class ClipboardProcessor {
 
       // 使用统一的去重服务进行检查
       if (processedItem != null) {
-        final deduplicatedItem = await DeduplicationService.instance
+        var deduplicatedItem = await DeduplicationService.instance
             .checkAndPrepare(contentHash, processedItem);
         if (deduplicatedItem != null) {
+          // 全新的内容才需要归入已有版本组
+          if (identical(deduplicatedItem, processedItem)) {
+            deduplicatedItem = deduplicatedItem.type == ClipType.image
+                ? await _groupImageVariant(deduplicatedItem, detectionResult)
+                : await _groupTextVariant(deduplicatedItem);
+          }
           _updateCache(contentHash, deduplicatedItem);
           return deduplicatedItem;
         }
@@ -209,6 +231,108 @@ class ClipboardProcessor {
     }
   }
 
+  /// Linux 上可以分块流式读取的格式（体积可能极大的文本类负载）
+  static const Set<String> _streamableFormats = {'text', 'html', 'rtf'};
+
+  /// Linux：先取格式清单，再按清单只读取需要的格式
+  ///
+  /// 有文件列表时只读取文件与文本（文件管理器同时提供的图标、富文本用不到）；
+  /// 图片超过 [_maxContentLength] 时不会被保存，原生侧查询大小后不再读取，
+  /// 此时直接放弃本次捕获。原生侧在工作线程生成缩略图，随图片一并返回。
+  /// 达到 [ClipConstants.clipboardStreamThreshold] 的文本类格式经
+  /// [ClipboardStreamReader] 分块读取，避免一次性消息造成的内存峰值。
+  Future<Map<Object?, Object?>?> _getLinuxClipboardFormats() async {
+    const options = <String, Object>{
+      'thumbnailSize': ClipConstants.thumbnailSize,
+      'sha256': true,
+      'perceptualHash': true,
+      'nearDuplicateDistance': ClipConstants.imageNearDuplicateDistance,
+    };
+    final manifestResult = await _platformChannel
+        .invokeMethod<Map<Object?, Object?>>('getClipboardFormats', {
+          'manifestOnly': true,
+        });
+    final manifest = manifestResult?['manifest'];
+    final available = manifest is Map && manifest['formats'] is Map
+        ? (manifest['formats'] as Map).keys.cast<String>().toList()
+        : null;
+    // 不支持清单时整体读取
+    if (available == null) {
+      return _platformChannel.invokeMethod<Map<Object?, Object?>>(
+        'getClipboardFormats',
+        options,
+      );
+    }
+    if (available.isEmpty) return null;
+
+    final requested = available.contains('files')
+        ? available.where((f) => f == 'files' || f == 'text').toList()
+        : available;
+    final entries = (manifest as Map)['formats'] as Map;
+    final streamed = requested.where((format) {
+      final size = (entries[format] as Map?)?['size'] as int? ?? 0;
+      return _streamableFormats.contains(format) &&
+          size >= ClipConstants.clipboardStreamThreshold;
+    }).toList();
+    final result = await _platformChannel.invokeMethod<Map<Object?, Object?>>(
+      'getClipboardFormats',
+      {
+        ...options,
+        'formats': requested.where((f) => !streamed.contains(f)).toList(),
+        if (requested.contains('image'))
+          'maxBytes': {'image': _maxContentLength},
+      },
+    );
+
+    final fetched = result?['manifest'];
+    final image = fetched is Map && fetched['formats'] is Map
+        ? (fetched['formats'] as Map)['image']
+        : null;
+    if (image is Map && image['skipped'] == 'tooLarge') {
+      await Log.d(
+        'Clipboard image exceeds size limit, skipped without reading',
+        tag: 'ClipboardProcessor',
+        fields: {'size': image['size'], 'limit': _maxContentLength},
+      );
+      return null;
+    }
+    if (result == null || streamed.isEmpty) return result;
+
+    final merged = {...result};
+    for (final format in streamed) {
+      final content = await _readStreamedFormat(format);
+      if (content != null) merged[format] = content;
+    }
+    return merged;
+  }
+
+  /// 分块读取一个文本类格式并按 UTF-8 解码；读取失败或超过上限时返回 null
+  Future<String?> _readStreamedFormat(String format) async {
+    final builder = BytesBuilder(copy: false);
+    try {
+      await for (final chunk in ClipboardStreamReader.open(
+        format: format,
+        maxBytes: ClipConstants.clipboardStreamMaxBytes,
+      )) {
+        builder.add(chunk);
+      }
+    } on Object catch (e) {
+      await Log.w(
+        'Failed to stream clipboard format',
+        tag: 'ClipboardProcessor',
+        error: e,
+        fields: {'format': format, 'received': builder.length},
+      );
+      return null;
+    }
+    await Log.d(
+      'Clipboard format streamed',
+      tag: 'ClipboardProcessor',
+      fields: {'format': format, 'bytes': builder.length},
+    );
+    return utf8.decode(builder.takeBytes(), allowMalformed: true);
+  }
+
   /// 获取原生剪贴板数据
   Future<ClipboardData?> _getNativeClipboardData() async {
     try {
@@ -216,8 +340,12 @@ class ClipboardProcessor {
       _detector.initialize();
 
       // 使用新的平台方法获取所有格式的剪贴板数据
-      final formatsResult = await _platformChannel
-          .invokeMethod<Map<Object?, Object?>>('getClipboardFormats');
+      // Linux 先取格式清单，再只读取需要的格式
+      final formatsResult = Platform.isLinux
+          ? await _getLinuxClipboardFormats()
+          : await _platformChannel.invokeMethod<Map<Object?, Object?>>(
+              'getClipboardFormats',
+            );
       if (formatsResult == null) return null;
 
       final formatsData = formatsResult.cast<String, dynamic>();
@@ -399,10 +527,25 @@ class ClipboardProcessor {
 
       if (formats.isEmpty) return null;
 
+      final imageThumbnail = formatsData['imageThumbnail'];
+      final hashes = _parseFormatHashes(formatsData['hashes']);
+      final nearDuplicate = formatsData['imageNearDuplicate'];
+
       return ClipboardData(
         sequence: sequence,
         timestamp: DateTime.fromMillisecondsSinceEpoch(timestamp),
         formats: formats,
+        imageThumbnail: imageThumbnail is Uint8List ? imageThumbnail : null,
+        imageWidth: formatsData['imageWidth'] as int?,
+        imageHeight: formatsData['imageHeight'] as int?,
+        hashes: hashes,
+        imagePerceptualHash: formatsData['imagePerceptualHash'] as String?,
+        imageNearDuplicate: nearDuplicate is Map
+            ? ImageNearDuplicate(
+                id: nearDuplicate['id'] as String,
+                distance: nearDuplicate['distance'] as int,
+              )
+            : null,
       );
     } on Exception catch (e) {
       await Log.e(
@@ -414,6 +557,108 @@ class ClipboardProcessor {
     }
   }
 
+  /// 图片与已收录图片近似重复时，在元数据中记录所属版本组
+  ///
+  /// 感知哈希相近不代表内容相同（同一窗口的两张截图常常只差几位），
+  /// 新图片照常保存，只与已有条目归为一组；与文本版本组共用
+  /// metadata['variantOf']。只有内容哈希完全一致才合并到已有条目。
+  Future<ClipItem> _groupImageVariant(
+    ClipItem item,
+    ClipboardDetectionResult detectionResult,
+  ) async {
+    final nearDuplicate = detectionResult.originalData?.imageNearDuplicate;
+    if (nearDuplicate == null ||
+        nearDuplicate.id == item.id ||
+        nearDuplicate.distance > ClipConstants.imageNearDuplicateDistance) {
+      return item;
+    }
+
+    // 索引可能滞后于数据库，以数据库中的条目为准
+    final variant = await DatabaseService.instance.getClipItemById(
+      nearDuplicate.id,
+    );
+    if (variant == null || variant.type != ClipType.image) return item;
+
+    final rootId = variant.metadata['variantOf'] as String? ?? variant.id;
+    await Log.d(
+      'Near-duplicate image found, grouping as variant',
+      tag: 'ClipboardProcessor',
+      fields: {
+        'itemId': item.id,
+        'variantOf': rootId,
+        'distance': nearDuplicate.distance,
+      },
+    );
+    return item.copyWith(
+      metadata: {
+        ...item.metadata,
+        'variantOf': rootId,
+        'variantDistance': nearDuplicate.distance,
+      },
+    );
+  }
+
+  /// 文本与已收录文本近似重复时，在元数据中记录所属版本组
+  ///
+  /// 组以最早的版本为根：metadata['variantOf'] 指向根条目的 ID。
+  Future<ClipItem> _groupTextVariant(ClipItem item) async {
+    if (!TextSimilarityIndex.supports(item)) return item;
+
+    final nearDuplicate = await TextSimilarityIndex.instance.findNearest(
+      item.content!,
+      excludeId: item.id,
+    );
+    if (nearDuplicate == null) return item;
+
+    // 索引可能滞后于数据库，以数据库中的条目为准
+    final variant = await DatabaseService.instance.getClipItemById(
+      nearDuplicate.id,
+    );
+    if (variant == null) return item;
+
+    final rootId = variant.metadata['variantOf'] as String? ?? variant.id;
+    await Log.d(
+      'Near-duplicate text found, grouping as variant',
+      tag: 'ClipboardProcessor',
+      fields: {
+        'itemId': item.id,
+        'variantOf': rootId,
+        'similarity': nearDuplicate.similarity,
+      },
+    );
+    return item.copyWith(
+      metadata: {
+        ...item.metadata,
+        'variantOf': rootId,
+        'variantSimilarity': nearDuplicate.similarity,
+        // 最相近的已有版本，长文本据此以增量形式保存
+        TextDeltaCodec.baseMetadataKey: variant.id,
+      },
+    );
+  }
+
+  /// 解析原生侧返回的各格式指纹
+  Map<ClipboardFormat, ClipboardFormatHash> _parseFormatHashes(
+    Object? hashesData,
+  ) {
+    if (hashesData is! Map) return const {};
+    final hashes = <ClipboardFormat, ClipboardFormatHash>{};
+    for (final entry in hashesData.entries) {
+      final format = ClipboardFormat.values
+          .where((f) => f.name == entry.key)
+          .firstOrNull;
+      final value = entry.value;
+      if (format == null || value is! Map) continue;
+      final xxh64 = value['xxh64'];
+      if (xxh64 is! String) continue;
+      hashes[format] = ClipboardFormatHash(
+        xxh64: xxh64,
+        sha256: value['sha256'] as String?,
+      );
+    }
+    return hashes;
+  }
+
   /// 处理图片数据（新版本）
   Future<ClipItem?> _processImageData(
     ClipboardDetectionResult detectionResult,
@@ -436,12 +681,19 @@ class ClipboardProcessor {
         bytes: imageData,
         type: 'image',
         suggestedExt: extension,
+        contentHash: detectionResult.originalData?.sha256Of(
+          ClipboardFormat.image,
+        ),
       );
 
       if (relativePath.isEmpty) return null;
 
       // 提取元数据
       final metadata = await _extractImageMetadata(imageData);
+      final perceptualHash = detectionResult.originalData?.imagePerceptualHash;
+      if (perceptualHash != null) {
+        metadata[ImageHashIndex.metadataKey] = perceptualHash;
+      }
 
       // OCR文字识别
       String? ocrText;
@@ -466,13 +718,27 @@ class ClipboardProcessor {
           );
         } else {
           final ocrService = OcrServiceFactory.getInstance();
+          _ocrRequests++;
           final ocrResult = await ocrService.recognizeText(
             imageData,
             language: prefs.ocrLanguage,
             minConfidence: prefs.ocrMinConfidence,
+            textThreshold: ClipConstants.ocrTextThreshold,
+            captureSequence: detectionResult.originalData?.sequence,
           );
 
-          if (ocrResult != null && ocrResult.text.isNotEmpty) {
+          if (ocrResult != null && ocrResult.skipped) {
+            _ocrSkippedNoText++;
+            await Log.d(
+              'OCR skipped, image unlikely to contain text',
+              tag: 'ClipboardProcessor',
+              fields: {
+                'contentHash': contentHash,
+                'textScore': ?ocrResult.textScore,
+                'skippedTotal': _ocrSkippedNoText,
+              },
+            );
+          } else if (ocrResult != null && ocrResult.text.isNotEmpty) {
             ocrText = ocrResult.text;
             // 将OCR置信度添加到元数据中
             metadata['ocrConfidence'] = ocrResult.confidence;
@@ -513,10 +779,10 @@ class ClipboardProcessor {
         );
       }
 
-      // 生成缩略图
-      List<int>? thumbnail;
+      // 生成缩略图：优先使用原生侧生成的缩略图
+      List<int>? thumbnail = detectionResult.originalData?.imageThumbnail;
       try {
-        thumbnail = await _generateFileThumbnail(
+        thumbnail ??= await _generateFileThumbnail(
           File(
             await PathService.instance.resolveAbsolutePath(relativePath),
           ),
@@ -591,7 +857,6 @@ class ClipboardProcessor {
       // 保存到应用沙盒（统一管理文件），并保留原始扩展名与原始文件名
       String? relativePath;
       try {
-        final bytes = await file.readAsBytes();
         final ext = file.path.split('.').length > 1
             ? file.path.split('.').last.toLowerCase()
             : null;
@@ -599,8 +864,19 @@ class ClipboardProcessor {
         // 获取原始文件名（不包含路径）
         final originalFileName = file.path.split('/').last;
 
-        relativePath = await _saveMediaToDisk(
-          bytes: bytes,
+        // Linux 由原生侧导入：优先写时复制，不把整个文件读入内存
+        final ingest = MediaStore.instance.startIngest(
+          source: filePath,
+          root: (await PathService.instance.getApplicationSupportDirectory())
+              .path,
+          relativeDir: ClipConstants.mediaFilesDir,
+          prefix: _sanitizedFileBase(originalFileName),
+          extension: ext != null && ext.isNotEmpty ? ext : 'bin',
+        );
+        relativePath = (await ingest?.result)?.relativePath;
+
+        relativePath ??= await _saveMediaToDisk(
+          bytes: await file.readAsBytes(),
           type: 'file',
           suggestedExt: ext,
           // 传入原始文件名，保留原始名称
@@ -627,7 +903,7 @@ class ClipboardProcessor {
       }
 
       // 提取元数据（补充文件名与原始路径）
-      final metadata = await _extractFileMetadata(file, fileType);
+      final metadata = await _extractFileMetadata(file, fileType, files);
       final fileName = file.path.split('/').last;
       metadata['fileName'] = fileName;
       metadata['originalPath'] = file.path;
@@ -882,6 +1158,36 @@ class ClipboardProcessor {
     }
   }
 
+  /// 原始名称清理：去除非法字符，限制长度，支持中文文件名
+  String _sanitizedFileBase(String name) {
+    // 去除路径分隔符，仅保留文件名部分
+    final base = name.split('/').last.split(r'\').last;
+    // 去掉扩展名
+    final dotIndex = base.lastIndexOf('.');
+    final withoutExt = dotIndex > 0 ? base.substring(0, dotIndex) : base;
+
+    // 保留中文字符、字母数字、空格、横杠和下划线，其它替换为下划线
+    // 支持中文字符范围：\u4e00-\u9fff
+    final replaced = withoutExt.replaceAll(
+      RegExp('[^A-Za-z0-9\u4e00-\u9fff _.-]'),
+      '_',
+    );
+
+    // 将连续空格和下划线压缩
+    final compact = replaced
+        .replaceAll(RegExp(r'\s+'), '_') // 空格转下划线
+        .replaceAll(RegExp('_+'), '_') // 连续下划线压缩
+        .replaceAll(RegExp(r'^_+|_+$'), ''); // 去除首尾下划线
+
+    // 如果清理后为空，使用默认名称
+    if (compact.isEmpty) {
+      return 'file';
+    }
+
+    // 限制长度，避免超长文件名，优先保留前面的字符
+    return compact.length > 60 ? compact.substring(0, 60) : compact;
+  }
+
   /// 保存媒体文件到磁盘
   Future<String> _saveMediaToDisk({
     required Uint8List bytes,
@@ -889,6 +1195,7 @@ class ClipboardProcessor {
     String? suggestedExt,
     String? originalName,
     bool keepOriginalName = false,
+    String? contentHash,
   }) async {
     try {
       final dir = await PathService.instance.getApplicationSupportDirectory();
@@ -903,56 +1210,35 @@ class ClipboardProcessor {
         ext = 'bin';
       }
 
-      // 计算文件名哈希（用于去重/避免冲突）
-      // 使用完整哈希或较长前缀以确保唯一性
-      final hash = sha256.convert(bytes).toString();
-      final shortHash = hash.substring(0, 16); // 使用16位哈希
-
-      // 原始名称清理：去除非法字符，限制长度，支持中文文件名
-      String sanitizedBase(String name) {
-        // 去除路径分隔符，仅保留文件名部分
-        final base = name.split('/').last.split(r'\').last;
-        // 去掉扩展名
-        final dotIndex = base.lastIndexOf('.');
-        final withoutExt = dotIndex > 0 ? base.substring(0, dotIndex) : base;
-
-        // 保留中文字符、字母数字、空格、横杠和下划线，其它替换为下划线
-        // 支持中文字符范围：\u4e00-\u9fff
-        final replaced = withoutExt.replaceAll(
-          RegExp('[^A-Za-z0-9\u4e00-\u9fff _.-]'),
-          '_',
-        );
-
-        // 将连续空格和下划线压缩
-        final compact = replaced
-            .replaceAll(RegExp(r'\s+'), '_') // 空格转下划线
-            .replaceAll(RegExp('_+'), '_') // 连续下划线压缩
-            .replaceAll(RegExp(r'^_+|_+$'), ''); // 去除首尾下划线
-
-        // 如果清理后为空，使用默认名称
-        if (compact.isEmpty) {
-          return 'file';
-        }
-
-        // 限制长度，避免超长文件名，优先保留前面的字符
-        return compact.length > 60 ? compact.substring(0, 60) : compact;
-      }
-
-      String fileName;
-      if (keepOriginalName && originalName != null && originalName.isNotEmpty) {
-        final base = sanitizedBase(originalName);
-        // 使用更简洁的格式：原始名_哈希.扩展名
-        // 移除时间戳，确保相同内容生成相同文件名
-        fileName = '${base}_$shortHash.$ext';
-      } else {
-        // 移除时间戳，仅使用类型和哈希
-        // 确保相同内容生成相同文件名，支持基于文件的去重
-        fileName = '${type}_$shortHash.$ext';
-      }
+      // 文件名格式：前缀_哈希.扩展名，前缀为原始名（保留原始名称时）或类型
+      // 移除时间戳，确保相同内容生成相同文件名，支持基于文件的去重
+      final prefix =
+          keepOriginalName && originalName != null && originalName.isNotEmpty
+          ? _sanitizedFileBase(originalName)
+          : type;
 
       final relativeDir = type == 'image'
           ? ClipConstants.mediaImagesDir
           : ClipConstants.mediaFilesDir;
+
+      // Linux 由原生侧在工作线程计算哈希并写入（已存在即跳过、原子写入、合并 fsync）
+      final stored = await MediaStore.instance.write(
+        root: dir.path,
+        relativeDir: relativeDir,
+        prefix: prefix,
+        extension: ext,
+        bytes: bytes,
+        hash: contentHash,
+      );
+      if (stored != null) return stored.relativePath;
+
+      // 计算文件名哈希（用于去重/避免冲突）
+      // 使用完整哈希或较长前缀以确保唯一性
+      // 原生侧已提供 SHA-256 时直接复用
+      final hash = contentHash ?? sha256.convert(bytes).toString();
+      final shortHash = hash.substring(0, 16); // 使用16位哈希
+      final fileName = '${prefix}_$shortHash.$ext';
+
       final absoluteDir = '${dir.path}/$relativeDir';
       final absolutePath = '$absoluteDir/$fileName';
       final relativePath = '$relativeDir/$fileName';
@@ -993,10 +1279,30 @@ class ClipboardProcessor {
   }
 
   /// 提取文件元数据
+  ///
+  /// Linux 上由原生侧并行采集整个选区，多文件时一并记录文件数与总大小。
   Future<Map<String, dynamic>> _extractFileMetadata(
     File file,
     ClipType type,
+    List<String> selection,
   ) async {
+    final infos = await ClipboardFileInfoReader.read(paths: selection);
+    if (infos != null && infos.isNotEmpty && infos.first.exists) {
+      final primary = infos.first;
+      return {
+        'contentLength': primary.size,
+        'sourceApp': await _getSourceApp(),
+        'fileSize': primary.size,
+        'lastModified': primary.modified?.toIso8601String(),
+        'fileType': type.toString(),
+        'mimeType': primary.mime,
+        if (infos.length > 1) ...{
+          'fileCount': infos.length,
+          'totalSize': infos.fold<int>(0, (sum, info) => sum + info.size),
+        },
+      };
+    }
+
     final stat = file.statSync();
 
     return {
@@ -1048,10 +1354,23 @@ class ClipboardProcessor {
     };
   }
 
+  /// 获取 OCR 文字预判统计
+  Map<String, dynamic> getOcrPrefilterStats() {
+    return {
+      'threshold': ClipConstants.ocrTextThreshold,
+      'requests': _ocrRequests,
+      'skipped': _ocrSkippedNoText,
+      'skipRate': _ocrRequests > 0
+          ? (_ocrSkippedNoText / _ocrRequests * 100).toStringAsFixed(1)
+          : '0.0',
+    };
+  }
+
   /// 获取性能指标
   Map<String, dynamic> getPerformanceMetrics() {
     return {
       'cacheEfficiency': getCacheStats(),
+      'ocrPrefilter': getOcrPrefilterStats(),
       'memoryOptimization': {
         'smartCleanupEnabled': true,
         'adaptiveCaching': true,
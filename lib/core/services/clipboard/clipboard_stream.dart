@@ -0,0 +1,178 @@
+import 'dart:async';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+
+/// 大体积剪贴板负载的分块读取（Linux）
+///
+/// 原生侧按块经由 `clipboard_stream` 二进制通道推送数据，
+/// 每块被消费（监听者未暂停）后才应答，从而把处理速度反压到剪贴板所有者。
+/// 消息格式：16 字节小端头部（int32 streamId | int32 flags | int64 offset）+ 负载。
+class ClipboardStreamReader {
+  ClipboardStreamReader._();
+
+  static const MethodChannel _platformChannel = MethodChannel(
+    'clipboard_service',
+  );
+  static const String _streamChannel = 'clipboard_stream';
+
+  static const int _flagEnd = 1;
+  static const int _flagAborted = 2;
+  static const int _headerSize = 16;
+
+  static final Map<int, _ClipboardStreamSink> _sinks = {};
+  static bool _handlerInstalled = false;
+
+  /// 以流的形式读取剪贴板中的某个格式
+  ///
+  /// [format] 为 getClipboardFormats 使用的格式名（text/rtf/html/files/image），
+  /// 也可以通过 [target] 直接指定 MIME 类型。超过 [maxBytes] 时流以错误结束。
+  static Stream<Uint8List> open({
+    String? format,
+    String? target,
+    int? chunkBytes,
+    int? maxBytes,
+    int? timeoutMs,
+  }) {
+    if (!Platform.isLinux) {
+      return Stream.error(
+        UnsupportedError('Clipboard streaming is only available on Linux'),
+      );
+    }
+    _installHandler();
+
+    late final _ClipboardStreamSink sink;
+    sink = _ClipboardStreamSink(
+      onCancel: () {
+        final id = sink.streamId;
+        if (id != null && _sinks.remove(id) != null) {
+          _platformChannel.invokeMethod<bool>('cancelClipboardStream', {
+            'streamId': id,
+          });
+        }
+      },
+    );
+
+    _platformChannel
+        .invokeMapMethod<String, dynamic>('openClipboardStream', {
+          if (format != null) 'format': format,
+          if (target != null) 'target': target,
+          if (chunkBytes != null) 'chunkBytes': chunkBytes,
+          if (maxBytes != null) 'maxBytes': maxBytes,
+          if (timeoutMs != null) 'timeoutMs': timeoutMs,
+        })
+        .then((result) {
+          final id = result?['streamId'] as int?;
+          if (id == null) {
+            sink.closeWithError(StateError('Failed to open clipboard stream'));
+            return;
+          }
+          sink.streamId = id;
+          if (sink.isCancelled) {
+            _platformChannel.invokeMethod<bool>('cancelClipboardStream', {
+              'streamId': id,
+            });
+            return;
+          }
+          _sinks[id] = sink;
+        })
+        .catchError((Object error) {
+          sink.closeWithError(error);
+        });
+
+    return sink.stream;
+  }
+
+  static void _installHandler() {
+    if (_handlerInstalled) return;
+    _handlerInstalled = true;
+    ServicesBinding.instance.defaultBinaryMessenger.setMessageHandler(
+      _streamChannel,
+      _handleMessage,
+    );
+  }
+
+  static Future<ByteData?> _handleMessage(ByteData? message) async {
+    if (message == null || message.lengthInBytes < _headerSize) {
+      return _reply(false);
+    }
+    final id = message.getInt32(0, Endian.little);
+    final flags = message.getInt32(4, Endian.little);
+    final payload = message.buffer.asUint8List(
+      message.offsetInBytes + _headerSize,
+      message.lengthInBytes - _headerSize,
+    );
+
+    final sink = _sinks[id];
+    if (sink == null) {
+      return _reply(false);
+    }
+    if (flags & _flagAborted != 0) {
+      _sinks.remove(id);
+      sink.closeWithError(
+        StateError(
+          payload.isEmpty
+              ? 'Clipboard stream aborted'
+              : String.fromCharCodes(payload),
+        ),
+      );
+      return _reply(false);
+    }
+    if (flags & _flagEnd != 0) {
+      _sinks.remove(id);
+      sink.close();
+      return _reply(true);
+    }
+
+    final accepted = await sink.add(Uint8List.fromList(payload));
+    return _reply(accepted);
+  }
+
+  static ByteData _reply(bool proceed) {
+    return ByteData(1)..setUint8(0, proceed ? 1 : 0);
+  }
+}
+
+class _ClipboardStreamSink {
+  _ClipboardStreamSink({required void Function() onCancel}) {
+    _controller = StreamController<Uint8List>(
+      onPause: () => _resumed = Completer<void>(),
+      onResume: () => _resumed?.complete(),
+      onCancel: () {
+        _cancelled = true;
+        _resumed?.complete();
+        onCancel();
+      },
+    );
+  }
+
+  late final StreamController<Uint8List> _controller;
+  Completer<void>? _resumed;
+  bool _cancelled = false;
+  int? streamId;
+
+  Stream<Uint8List> get stream => _controller.stream;
+  bool get isCancelled => _cancelled;
+
+  /// 监听者暂停期间延迟应答，返回 false 表示监听已取消
+  Future<bool> add(Uint8List chunk) async {
+    if (_cancelled) return false;
+    _controller.add(chunk);
+    final resumed = _resumed;
+    if (_controller.isPaused && resumed != null && !resumed.isCompleted) {
+      await resumed.future;
+    }
+    return !_cancelled;
+  }
+
+  void close() {
+    if (!_controller.isClosed) _controller.close();
+  }
+
+  void closeWithError(Object error) {
+    if (_controller.isClosed) return;
+    _controller.addError(error);
+    _controller.close();
+  }
+}
@@ -1,7 +1,9 @@
 // 剪贴板模块统一导出
 export 'clipboard_data.dart';
 export 'clipboard_detector.dart';
+export 'clipboard_file_info.dart';
 export 'clipboard_manager.dart';
 export 'clipboard_poller.dart';
 export 'clipboard_processor.dart';
 export 'clipboard_service.dart';
+export 'clipboard_stream.dart';
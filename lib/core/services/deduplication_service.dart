@@ -76,8 +76,8 @@ class DeduplicationService {
         },
       );
 
-      // 单一数据库检查
-      final existing = await _checkDatabaseExists(contentHash);
+      // 内容哈希索引确认未收录时直接视为新内容，省去数据库查询
+      final existing = await _findExisting(contentHash);
       if (existing != null) {
         await Log.i(
           'Found existing item, updating timestamp',
@@ -137,6 +137,13 @@ class DeduplicationService {
     }
   }
 
+  /// 查找已存在的相同内容项目：先查内容哈希索引，可能命中时再查数据库
+  Future<ClipItem?> _findExisting(String contentHash) async {
+    final indexed = await ContentHashIndex.instance.contains(contentHash);
+    if (indexed == false) return null;
+    return _checkDatabaseExists(contentHash);
+  }
+
   /// 检查数据库中是否已存在相同内容的项目
   Future<ClipItem?> _checkDatabaseExists(String contentHash) async {
     try {
@@ -250,7 +257,7 @@ class DeduplicationService {
       final ocrTextId = IdGenerator.generateOcrTextId(ocrText, parentImageItem.id);
 
       // 检查数据库中是否已存在相同的OCR文本
-      final existing = await _checkDatabaseExists(ocrTextId);
+      final existing = await _findExisting(ocrTextId);
       if (existing != null) {
         await Log.i(
           'Found existing OCR text, updating timestamp',
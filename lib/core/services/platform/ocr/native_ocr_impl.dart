@@ -1,8 +1,11 @@
 import 'dart:io';
 
+import 'package:clip_flow/core/constants/clip_constants.dart';
 import 'package:clip_flow/core/services/observability/logger/logger.dart';
 import 'package:clip_flow/core/services/platform/ocr/ocr_service.dart';
+import 'package:clip_flow/core/services/storage/index.dart';
 import 'package:flutter/services.dart';
+import 'package:path/path.dart' as p;
 
 /// 原生OCR实现类
 /// 使用各平台的原生OCR能力：
@@ -21,6 +24,10 @@ class NativeOcrImpl implements OcrService {
 
   static const MethodChannel _channel = MethodChannel('clipboard_service');
 
+  // 进行中的识别任务 ID（Linux 原生侧可按 ID 取消）
+  final Set<int> _pendingJobs = {};
+  int _nextJobId = 1;
+
   // 语言列表缓存（优先原生查询，回退基本集合）
   List<String> _supportedLanguagesCache = const [
     'en-US',
@@ -46,6 +53,8 @@ class NativeOcrImpl implements OcrService {
     Uint8List imageBytes, {
     String language = 'auto',
     double? minConfidence,
+    double? textThreshold,
+    int? captureSequence,
   }) async {
     // 检查平台支持
     if (!_isPlatformSupported) {
@@ -70,15 +79,32 @@ class NativeOcrImpl implements OcrService {
       },
     );
 
+    final jobId = _nextJobId++;
+    _pendingJobs.add(jobId);
     try {
       // 调用原生OCR方法
-      final args = {
+      final args = <String, Object>{
         'imageData': imageBytes,
         'language': language,
+        'jobId': jobId,
+        'deadlineMs': ClipConstants.ocrDeadlineMs,
+        'preprocess': ClipConstants.ocrPreprocess,
+        'targetDpi': ClipConstants.ocrTargetDpi,
+        'binarize': ClipConstants.ocrBinarization,
+        'deskew': ClipConstants.ocrDeskew,
+        'parallelism': ClipConstants.ocrParallelism,
       };
       if (minConfidence != null) {
         args['minConfidence'] = minConfidence;
       }
+      if (textThreshold != null) {
+        args['textThreshold'] = textThreshold;
+      }
+      if (captureSequence != null) {
+        // 识别对象是该次捕获的剪贴板内容，剪贴板变化后结果已无意义
+        args['captureSequence'] = captureSequence;
+        args['supersede'] = true;
+      }
 
       final result = await _channel.invokeMethod('performOCR', args);
 
@@ -98,6 +124,33 @@ class NativeOcrImpl implements OcrService {
       final resultMap = Map<String, dynamic>.from(result as Map);
       final text = (resultMap['text'] ?? '').toString();
       final confidence = ((resultMap['confidence'] ?? 0.0) as num).toDouble();
+      final timings = (resultMap['timings'] as Map?)?.map(
+        (key, value) => MapEntry(key.toString(), (value as num).toDouble()),
+      );
+      final regions = (resultMap['regions'] as List?)
+          ?.map((entry) => _parseRegion(entry! as Map))
+          .toList();
+      final skipped = resultMap['skipped'] as bool? ?? false;
+      final textScore = (resultMap['textScore'] as num?)?.toDouble();
+
+      if (skipped) {
+        await Log.d(
+          'OCR skipped: no text detected',
+          tag: 'OCR',
+          fields: {
+            'textScore': ?textScore,
+            'textThreshold': ?textThreshold,
+            'prefilterMs': ?timings?['prefilter'],
+          },
+        );
+        return OcrResult(
+          text: '',
+          confidence: 0,
+          stageTimings: timings,
+          skipped: true,
+          textScore: textScore,
+        );
+      }
 
       await Log.i(
         'OCR recognition completed successfully',
@@ -107,14 +160,27 @@ class NativeOcrImpl implements OcrService {
           'confidence': confidence,
           'hasText': text.isNotEmpty,
           'platform': _platformInfo,
+          'timings': ?timings,
+          'regions': ?regions?.length,
+          'scale': ?resultMap['scale'],
+          'skewAngle': ?resultMap['skewAngle'],
+          'cached': ?resultMap['cached'],
+          'textScore': ?textScore,
         },
       );
 
       return OcrResult(
         text: text,
         confidence: confidence,
+        boundingBoxes: regions,
+        stageTimings: timings,
+        textScore: textScore,
       );
     } on PlatformException catch (e) {
+      if (e.code == 'CANCELLED') {
+        await Log.d('OCR job cancelled', tag: 'OCR', fields: {'jobId': jobId});
+        return null;
+      }
       await Log.e(
         'OCR platform exception occurred',
         tag: 'OCR',
@@ -142,9 +208,23 @@ class NativeOcrImpl implements OcrService {
         },
       );
       return null;
+    } finally {
+      _pendingJobs.remove(jobId);
     }
   }
 
+  /// 解析原生分块识别的区域
+  static OcrBoundingBox _parseRegion(Map<Object?, Object?> map) {
+    return OcrBoundingBox(
+      x: (map['x']! as num).toDouble(),
+      y: (map['y']! as num).toDouble(),
+      width: (map['width']! as num).toDouble(),
+      height: (map['height']! as num).toDouble(),
+      text: map['text'] as String? ?? '',
+      confidence: (map['confidence'] as num? ?? 0).toDouble(),
+    );
+  }
+
   @override
   Future<bool> isAvailable() async {
     await Log.d(
@@ -247,9 +327,42 @@ class NativeOcrImpl implements OcrService {
     }
   }
 
+  @override
+  Future<void> warmUp({String language = 'auto'}) async {
+    // 仅 Linux（Tesseract）需要预热：引擎初始化要加载语言包
+    if (!Platform.isLinux) return;
+    try {
+      // 同时启用原生结果缓存，重复识别同一图片直接返回上次的结果
+      final supportDir = await PathService.instance
+          .getApplicationSupportDirectory();
+      final warmed = await _channel.invokeMethod<bool>('configureOcrEngines', {
+        'poolSize': ClipConstants.ocrEnginePoolSize,
+        'idleTimeoutSeconds': ClipConstants.ocrEngineIdleTimeoutSeconds,
+        'warmLanguage': language,
+        'cacheDirectory': p.join(supportDir.path, 'ocr_cache'),
+        'cacheEntries': ClipConstants.ocrCacheEntries,
+      });
+      await Log.d(
+        'OCR engines warmed up',
+        tag: 'OCR',
+        fields: {'language': language, 'warmed': warmed},
+      );
+    } on PlatformException catch (e) {
+      await Log.w('Failed to warm up OCR engines', tag: 'OCR', error: e);
+    }
+  }
+
   @override
   Future<void> dispose() async {
     await Log.d('Disposing OCR service', tag: 'OCR');
-    // 原生OCR不需要特殊的资源清理
+    // 取消仍在进行的识别（仅 Linux 支持按任务取消）
+    if (!Platform.isLinux) return;
+    for (final jobId in _pendingJobs.toList()) {
+      try {
+        await _channel.invokeMethod<bool>('cancelOcr', {'jobId': jobId});
+      } on PlatformException catch (_) {
+        // 任务可能已结束
+      }
+    }
   }
 }
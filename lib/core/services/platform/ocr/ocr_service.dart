@@ -9,6 +9,9 @@ class OcrResult {
     required this.text,
     required this.confidence,
     this.boundingBoxes,
+    this.stageTimings,
+    this.skipped = false,
+    this.textScore,
   });
 
   /// 识别的文本内容
@@ -20,6 +23,15 @@ class OcrResult {
   /// 文本在图片中的边界框 (可选)
   final List<OcrBoundingBox>? boundingBoxes;
 
+  /// 各处理阶段的耗时（毫秒），如 grayscale、scale、binarize、recognize (可选)
+  final Map<String, double>? stageTimings;
+
+  /// 文字预判认为图片不含文字而未识别（此时 [text] 为空）
+  final bool skipped;
+
+  /// 文字预判给出的含文字可能性 0.0 - 1.0（未预判时为 null）
+  final double? textScore;
+
   @override
   String toString() => 'OcrResult(text: "$text", confidence: $confidence)';
 }
@@ -62,11 +74,17 @@ abstract class OcrService {
   /// [imageBytes] 图片的字节数据
   /// [language] 识别语言代码，如 'en', 'zh', 'auto' 等
   /// [minConfidence] 最小置信度阈值，低于该值的结果可能被原生层过滤
+  /// [textThreshold] 文字预判阈值，含文字可能性低于该值时跳过识别并返回
+  /// [OcrResult.skipped] 的结果；不支持预判的平台忽略该参数
+  /// [captureSequence] 图片捕获时的剪贴板序号；给出时剪贴板再次变化即取消
+  /// 识别并返回 null（Linux），其他平台忽略该参数
   /// 返回识别结果，如果识别失败返回null
   Future<OcrResult?> recognizeText(
     Uint8List imageBytes, {
     String language = 'auto',
     double? minConfidence,
+    double? textThreshold,
+    int? captureSequence,
   });
 
   /// 检查OCR服务是否可用
@@ -78,6 +96,9 @@ abstract class OcrService {
   /// 获取可用的语言列表 (异步等待加载完成)
   Future<List<String>> getAvailableLanguages();
 
+  /// 预先加载 [language] 的识别引擎，降低首次识别延迟
+  Future<void> warmUp({String language = 'auto'});
+
   /// 释放资源
   Future<void> dispose();
 }
@@ -0,0 +1,122 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:clip_flow/core/services/observability/index.dart';
+import 'package:flutter/services.dart';
+
+/// 内容哈希的内存索引（Linux 原生实现）
+///
+/// 原生侧以布谷鸟过滤器 + 开放寻址哈希表保存数据库中全部剪贴项的 ID，
+/// 去重时先查索引：确认未收录即可跳过数据库查询。
+///
+/// 索引只允许“多报”不允许“漏报”：
+/// - 每次写入数据库后必须同步 [add]，写入失败时索引整体失效，回退到数据库查询；
+/// - 删除为尽力同步，遗漏的删除只会让后续查询多走一次数据库。
+class ContentHashIndex {
+  ContentHashIndex._();
+
+  /// 单例实例
+  static final ContentHashIndex instance = ContentHashIndex._();
+
+  static const MethodChannel _platformChannel = MethodChannel(
+    'clipboard_service',
+  );
+
+  /// 启动加载时单次调用携带的 ID 数量
+  static const int _loadChunkSize = 5000;
+
+  bool _ready = false;
+
+  /// 索引是否已加载且与数据库同步
+  bool get isReady => _ready;
+
+  /// 用数据库中的全部 ID 重建索引
+  ///
+  /// 清空请求在调用时立即发出，此后的 [add] 都排在它之后，
+  /// 因此加载期间新写入的 ID 不会丢失。
+  Future<void> load(Future<List<String>> Function() loadIds) async {
+    if (!Platform.isLinux) return;
+    _ready = false;
+
+    try {
+      await _platformChannel.invokeMethod<void>('dedupIndexClear');
+      final ids = await loadIds();
+      for (var i = 0; i < ids.length; i += _loadChunkSize) {
+        final end = i + _loadChunkSize < ids.length
+            ? i + _loadChunkSize
+            : ids.length;
+        await _platformChannel.invokeMethod<int>('dedupIndexAdd', {
+          'hashes': ids.sublist(i, end),
+        });
+      }
+      _ready = true;
+
+      await Log.d(
+        'Content hash index loaded',
+        tag: 'ContentHashIndex',
+        fields: {'count': ids.length},
+      );
+    } on Exception catch (e) {
+      _ready = false;
+      await Log.w(
+        'Failed to load content hash index, falling back to database',
+        tag: 'ContentHashIndex',
+        error: e,
+      );
+    }
+  }
+
+  /// 查询内容哈希是否可能已收录
+  ///
+  /// 返回 false 表示确定未收录；返回 null 表示索引不可用，需要查询数据库。
+  Future<bool?> contains(String hash) async {
+    if (!_ready) return null;
+    try {
+      final id = await _platformChannel.invokeMethod<String>(
+        'dedupIndexLookup',
+        {'hash': hash},
+      );
+      return id != null;
+    } on Exception {
+      return null;
+    }
+  }
+
+  /// 记录新写入的 ID
+  void add(Iterable<String> ids) {
+    if (!Platform.isLinux) return;
+    final list = ids.toList();
+    if (list.isEmpty) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<int>('dedupIndexAdd', {'hashes': list})
+          .catchError((Object _) {
+            // 漏记会导致误判为新内容，只能整体停用索引
+            _ready = false;
+            return 0;
+          }),
+    );
+  }
+
+  /// 移除已删除的 ID
+  void remove(Iterable<String> ids) {
+    if (!_ready) return;
+    final list = ids.toList();
+    if (list.isEmpty) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<int>('dedupIndexRemove', {'hashes': list})
+          .catchError((Object _) => 0),
+    );
+  }
+
+  /// 清空索引（数据库被整体清空时调用）
+  void clear() {
+    if (!_ready) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<void>('dedupIndexClear')
+          .catchError((Object _) {}),
+    );
+  }
+}
@@ -50,10 +50,11 @@ class SqlInputValidator {
       );
     }
 
-    // 检查危险模式
+    // 检查危险模式：除 `.*` 外按字面匹配（`/*` 之类按正则解释会匹配任意输入）
     final lowerQuery = query.toLowerCase();
     for (final pattern in dangerousPatterns) {
-      if (lowerQuery.contains(RegExp(pattern, caseSensitive: false))) {
+      final regex = RegExp.escape(pattern).replaceAll(r'\.\*', '.*');
+      if (lowerQuery.contains(RegExp(regex, caseSensitive: false))) {
         throw ArgumentError(
           '搜索查询包含不安全字符: $pattern',
         );
@@ -96,6 +97,17 @@ class DatabaseService {
   /// 初始化进行中的 Future（用于防止并发初始化）
   Completer<void>? _initializationCompleter;
 
+  /// 增量链重新选基准的后台任务是否在运行
+  bool _rebasingDeltaChains = false;
+
+  /// 增量行还原后的全文，供搜索与分页读取复用
+  final _DeltaTextCache _deltaTexts = _DeltaTextCache(
+    ClipConstants.textDeltaCacheChars,
+  );
+
+  /// 单条 SQL 中 IN 列表的最大参数数量
+  static const int _sqlChunkSize = 500;
+
   /// 初始化数据库
   ///
   /// - 计算数据库路径并打开/创建数据库
@@ -136,6 +148,12 @@ class DatabaseService {
 
       _isInitialized = true;
 
+      // 后台加载内存索引，加载完成前去重仍查询数据库
+      _loadIndexes();
+
+      // 后台缩短上次运行遗留的过长增量链
+      unawaited(_rebaseDeltaChains());
+
       await Log.d(
         'Database initialized successfully',
         tag: 'DatabaseService',
@@ -172,7 +190,10 @@ class DatabaseService {
         is_favorite INTEGER NOT NULL DEFAULT 0,
         created_at TEXT NOT NULL,
         updated_at TEXT NOT NULL,
-        schema_version INTEGER NOT NULL DEFAULT 1
+        schema_version INTEGER NOT NULL DEFAULT 1,
+        content_delta TEXT,
+        delta_base_id TEXT,
+        delta_depth INTEGER NOT NULL DEFAULT 0
       )
     ''');
 
@@ -206,6 +227,11 @@ class DatabaseService {
     await db.execute('''
       CREATE INDEX idx_clip_items_type_created ON ${ClipConstants.clipItemsTable}(type, created_at DESC)
     ''');
+
+    // 增量存储：删除基准前查找依赖它的增量行
+    await db.execute('''
+      CREATE INDEX idx_clip_items_delta_base_id ON ${ClipConstants.clipItemsTable}(delta_base_id)
+    ''');
   }
 
   Future<void> _onUpgrade(Database db, int oldVersion, int newVersion) async {
@@ -285,27 +311,34 @@ class DatabaseService {
       },
     );
 
-    await _database!.insert(
-      ClipConstants.clipItemsTable,
-      {
-        'id': item.id,
-        'type': item.type.name,
-        'content': item.content is String
-            ? item.content
-            : (item.content?.toString() ?? ''),
-        'file_path': item.filePath,
-        'thumbnail': item.thumbnail, // 使用 item.thumbnail 保持一致性
-        'metadata': jsonEncode(item.metadata),
-        'ocr_text': item.ocrText,
-        'ocr_text_id': item.ocrTextId,
-        'is_ocr_extracted': item.isOcrExtracted ? 1 : 0,
-        'is_favorite': item.isFavorite ? 1 : 0,
-        'created_at': item.createdAt.toIso8601String(),
-        'updated_at': item.updatedAt.toIso8601String(),
-        'schema_version': 1,
-      },
-      conflictAlgorithm: ConflictAlgorithm.replace,
-    );
+    // 在同一事务内确认增量基准仍存在，避免与删除交错导致断链
+    final deltaDepth = await _database!.transaction((txn) async {
+      final contentColumns = await _contentColumns(txn, item);
+      await txn.insert(
+        ClipConstants.clipItemsTable,
+        {
+          'id': item.id,
+          'type': item.type.name,
+          ...contentColumns,
+          'file_path': item.filePath,
+          'thumbnail': item.thumbnail, // 使用 item.thumbnail 保持一致性
+          'metadata': jsonEncode(item.metadata),
+          'ocr_text': item.ocrText,
+          'ocr_text_id': item.ocrTextId,
+          'is_ocr_extracted': item.isOcrExtracted ? 1 : 0,
+          'is_favorite': item.isFavorite ? 1 : 0,
+          'created_at': item.createdAt.toIso8601String(),
+          'updated_at': item.updatedAt.toIso8601String(),
+          'schema_version': 1,
+        },
+        conflictAlgorithm: ConflictAlgorithm.replace,
+      );
+      return contentColumns['delta_depth']! as int;
+    });
+    _indexInserted([item]);
+    if (deltaDepth > ClipConstants.textDeltaRebaseDepth) {
+      unawaited(_rebaseDeltaChains());
+    }
 
     await Log.d(
       'Clip item inserted/replaced successfully',
@@ -396,6 +429,7 @@ class DatabaseService {
       }
 
       stopwatch.stop();
+      _indexInserted(items);
 
       await Log.i(
         'Batch insert completed successfully',
@@ -432,13 +466,10 @@ class DatabaseService {
     if (!_isInitialized) await initialize();
     if (_database == null) throw Exception('Database not initialized');
 
-    await _database!.update(
-      ClipConstants.clipItemsTable,
-      {
+    final content = _contentOf(item);
+    await _database!.transaction((txn) async {
+      final values = <String, Object?>{
         'type': item.type.name,
-        'content': item.content is String
-            ? item.content
-            : (item.content?.toString() ?? ''),
         'file_path': item.filePath,
         'thumbnail': item.thumbnail,
         'metadata': jsonEncode(item.metadata),
@@ -446,10 +477,22 @@ class DatabaseService {
         'is_favorite': item.isFavorite ? 1 : 0,
         'updated_at': item.updatedAt.toIso8601String(),
         'schema_version': 1,
-      },
-      where: 'id = ?',
-      whereArgs: [item.id],
-    );
+      };
+      // 内容未变时保留原有存储形式（增量或全文）；
+      // 内容改变时依赖它的增量行先物化为全文
+      if (await _reconstructContent(txn, item.id) != content) {
+        await _detachDeltaDependents(txn, [item.id]);
+        values.addAll(_fullContentColumns(content));
+      }
+      await txn.update(
+        ClipConstants.clipItemsTable,
+        values,
+        where: 'id = ?',
+        whereArgs: [item.id],
+      );
+    });
+    // 提交后再失效，避免并发的搜索把旧内容重新放回缓存
+    _deltaTexts.remove([item.id]);
   }
 
   /// 更新剪贴板项目的收藏状态
@@ -484,17 +527,14 @@ class DatabaseService {
     if (!_isInitialized) await initialize();
     if (_database == null) throw Exception('Database not initialized');
 
-    // 先查询 file_path 用于删除磁盘文件
-    final item = await getClipItemById(id);
-    await _database!.delete(
-      ClipConstants.clipItemsTable,
-      where: 'id = ?',
-      whereArgs: [id],
-    );
+    // 删除的同时取回 file_path 用于删除磁盘文件
+    final rows = await _deleteRows('id = ?', [id]);
+    _indexRemoved([id]);
 
     // 尝试删除媒体文件
-    if (item?.filePath != null && item!.filePath!.isNotEmpty) {
-      await _deleteMediaFileSafe(item.filePath!);
+    final filePath = rows.isEmpty ? null : rows.first['file_path'] as String?;
+    if (filePath != null && filePath.isNotEmpty) {
+      await _deleteMediaFileSafe(filePath);
     }
   }
 
@@ -504,11 +544,9 @@ class DatabaseService {
     if (_database == null) throw Exception('Database not initialized');
 
     // 只删除非收藏的项目
-    await _database!.delete(
-      ClipConstants.clipItemsTable,
-      where: 'is_favorite = ?',
-      whereArgs: [0],
-    );
+    await _deleteRows('is_favorite = ?', [0]);
+    // 保留的收藏项无法逐条推算，直接重建索引
+    _loadIndexes();
 
     // 清理媒体文件（只删除非收藏项目的文件）
     await _cleanupMediaFilesExceptFavorites();
@@ -521,6 +559,7 @@ class DatabaseService {
 
     // 清空数据库
     await _database!.delete(ClipConstants.clipItemsTable);
+    _clearIndexes();
 
     // 直接删除整个媒体目录（更高效）
     await _deleteMediaDirectorySafe();
@@ -602,11 +641,11 @@ class DatabaseService {
           .whereType<String>()
           .toList();
 
-      await _database!.delete(
-        ClipConstants.clipItemsTable,
-        where: 'id IN (${List.filled(idsToDelete.length, '?').join(',')})',
-        whereArgs: idsToDelete,
+      await _deleteRows(
+        'id IN (${List.filled(idsToDelete.length, '?').join(',')})',
+        idsToDelete,
       );
+      _indexRemoved(idsToDelete);
 
       // 6. 删除关联的媒体文件
       for (final row in itemsToDelete) {
@@ -652,7 +691,7 @@ class DatabaseService {
       offset: offset,
     );
 
-    return maps.map(_mapToClipItem).toList();
+    return _mapRows(maps);
   }
 
   /// 按类型获取剪贴项（倒序）
@@ -679,7 +718,7 @@ class DatabaseService {
       offset: offset,
     );
 
-    return maps.map(_mapToClipItem).toList();
+    return _mapRows(maps);
   }
 
   /// 获取收藏的剪贴项（倒序）
@@ -701,7 +740,7 @@ class DatabaseService {
       offset: offset,
     );
 
-    return maps.map(_mapToClipItem).toList();
+    return _mapRows(maps);
   }
 
   /// 搜索剪贴项（在 content、metadata 和 OCR 文本中模糊匹配）
@@ -733,20 +772,13 @@ class DatabaseService {
     );
 
     // 搜索内容、元数据和OCR文本
-    final List<Map<String, dynamic>> maps = await _database!.query(
-      ClipConstants.clipItemsTable,
-      where: '''
-        content LIKE ? OR
-        metadata LIKE ? OR
-        ocr_text LIKE ?
-      ''',
-      whereArgs: ['%$sanitizedQuery%', '%$sanitizedQuery%', '%$sanitizedQuery%'],
-      orderBy: 'created_at DESC',
+    final maps = await _searchRows(
+      sanitizedQuery,
       limit: limit,
       offset: offset,
     );
 
-    final results = maps.map(_mapToClipItem).toList();
+    final results = await _mapRows(maps);
 
     await Log.i(
       'Search completed with OCR text support',
@@ -796,29 +828,14 @@ class DatabaseService {
       },
     );
 
-    var whereClause = '''
-      content LIKE ? OR
-      metadata LIKE ? OR
-      ocr_text LIKE ?
-    ''';
-    final whereArgs = ['%$sanitizedQuery%', '%$sanitizedQuery%', '%$sanitizedQuery%'];
-
-    // 如果指定了类型，添加类型过滤
-    if (type != null) {
-      whereClause = '($whereClause) AND type = ?';
-      whereArgs.add(type.name);
-    }
-
-    final List<Map<String, dynamic>> maps = await _database!.query(
-      ClipConstants.clipItemsTable,
-      where: whereClause,
-      whereArgs: whereArgs,
-      orderBy: 'created_at DESC',
+    final maps = await _searchRows(
+      sanitizedQuery,
+      type: type,
       limit: limit,
       offset: offset,
     );
 
-    final results = maps.map(_mapToClipItem).toList();
+    final results = await _mapRows(maps);
 
     await Log.i(
       'Type-specific search completed with OCR text support',
@@ -838,6 +855,546 @@ class DatabaseService {
     return results;
   }
 
+  /// 查询全部剪贴项的 id（用于加载内容哈希索引）
+  Future<List<String>> _queryClipItemIds() async {
+    final rows = await _database!.query(
+      ClipConstants.clipItemsTable,
+      columns: ['id'],
+    );
+    return rows.map((row) => row['id'] as String?).whereType<String>().toList();
+  }
+
+  /// 查询全部图片的感知哈希（用于加载图片哈希索引）
+  Future<Map<String, String>> _queryImagePerceptualHashes() async {
+    final rows = await _database!.query(
+      ClipConstants.clipItemsTable,
+      columns: ['id', 'metadata'],
+      where: 'type = ?',
+      whereArgs: [ClipType.image.name],
+    );
+    final hashes = <String, String>{};
+    for (final row in rows) {
+      final id = row['id'] as String?;
+      final metadata = row['metadata'];
+      if (id == null || metadata is! String) continue;
+      try {
+        final decoded = jsonDecode(metadata);
+        final hash = decoded is Map ? decoded[ImageHashIndex.metadataKey] : null;
+        if (hash is String) hashes[id] = hash;
+      } on FormatException {
+        // 元数据损坏的条目不参与近似重复检测
+      }
+    }
+    return hashes;
+  }
+
+  /// 查询参与近似重复检测的文本（用于加载文本相似度索引）
+  ///
+  /// 增量存储的文本 content 为 NULL，不参与加载：其基准已在索引中。
+  Future<Map<String, String>> _queryNearDuplicateTexts() async {
+    final types = TextSimilarityIndex.supportedTypes.map((t) => t.name);
+    final rows = await _database!.query(
+      ClipConstants.clipItemsTable,
+      columns: ['id', 'content'],
+      where:
+          'type IN (${List.filled(types.length, '?').join(',')}) '
+          'AND LENGTH(content) >= ?',
+      whereArgs: [...types, ClipConstants.textNearDuplicateMinLength],
+    );
+    final texts = <String, String>{};
+    for (final row in rows) {
+      final id = row['id'] as String?;
+      final content = row['content'] as String?;
+      if (id != null && content != null) texts[id] = content;
+    }
+    return texts;
+  }
+
+  /// 重建内存索引（内容哈希、图片感知哈希与文本相似度）
+  void _loadIndexes() {
+    _deltaTexts.clear();
+    unawaited(ContentHashIndex.instance.load(_queryClipItemIds));
+    unawaited(ImageHashIndex.instance.load(_queryImagePerceptualHashes));
+    unawaited(TextSimilarityIndex.instance.load(_queryNearDuplicateTexts));
+  }
+
+  /// 将新写入的剪贴项同步到内存索引
+  void _indexInserted(Iterable<ClipItem> items) {
+    ContentHashIndex.instance.add(items.map((item) => item.id));
+    final imageHashes = <String, String>{};
+    final texts = <String, String>{};
+    for (final item in items) {
+      final hash = item.metadata[ImageHashIndex.metadataKey];
+      if (item.type == ClipType.image && hash is String) {
+        imageHashes[item.id] = hash;
+      } else if (TextSimilarityIndex.supports(item)) {
+        texts[item.id] = item.content!;
+      }
+    }
+    ImageHashIndex.instance.add(imageHashes);
+    TextSimilarityIndex.instance.add(texts);
+    // 以相同 ID 替换写入时内容可能已变
+    _deltaTexts.remove(items.map((item) => item.id));
+  }
+
+  /// 将已删除的剪贴项从内存索引移除
+  void _indexRemoved(Iterable<String> ids) {
+    final list = ids.toList();
+    ContentHashIndex.instance.remove(list);
+    ImageHashIndex.instance.remove(list);
+    TextSimilarityIndex.instance.remove(list);
+    _deltaTexts.remove(list);
+  }
+
+  void _clearIndexes() {
+    ContentHashIndex.instance.clear();
+    ImageHashIndex.instance.clear();
+    TextSimilarityIndex.instance.clear();
+    _deltaTexts.clear();
+  }
+
+  // === 文本增量存储 ===
+  //
+  // 近似重复的长文本保存为相对最相近已有版本的增量：content 为 NULL，
+  // content_delta 为增量，delta_base_id 指向基准，delta_depth 为到全文链根的距离。
+  // 写入、删除与重新选基准都在事务内完成，增量链不会指向已删除的行。
+
+  /// 剪贴项内容的字符串形式
+  String _contentOf(ClipItem item) => item.content is String
+      ? item.content!
+      : (item.content?.toString() ?? '');
+
+  /// 以全文保存时的内容列
+  Map<String, Object?> _fullContentColumns(String content) => {
+    'content': content,
+    'content_delta': null,
+    'delta_base_id': null,
+    'delta_depth': 0,
+  };
+
+  /// 计算写入剪贴项时的内容列：满足条件且增量足够小时保存增量，否则保存全文
+  Future<Map<String, Object?>> _contentColumns(
+    DatabaseExecutor db,
+    ClipItem item,
+  ) async {
+    final content = _contentOf(item);
+    final full = _fullContentColumns(content);
+    final baseId = item.metadata[TextDeltaCodec.baseMetadataKey];
+    if (!TextDeltaCodec.instance.isAvailable ||
+        !TextSimilarityIndex.supports(item) ||
+        content.length < ClipConstants.textDeltaMinLength ||
+        baseId is! String ||
+        baseId == item.id) {
+      return full;
+    }
+
+    // 基准的链上包含自身时保存增量会成环
+    final chain = await _loadDeltaChain(db, baseId);
+    if (chain == null ||
+        chain.ids.contains(item.id) ||
+        chain.depth >= ClipConstants.textDeltaMaxChainDepth) {
+      return full;
+    }
+    final baseContent = await _applyDeltaChain(baseId, chain);
+    if (baseContent == null) return full;
+
+    final delta = await TextDeltaCodec.instance.encode(baseContent, content);
+    if (delta == null) return full;
+    return {
+      'content': null,
+      'content_delta': delta,
+      'delta_base_id': baseId,
+      'delta_depth': chain.depth + 1,
+    };
+  }
+
+  /// 按创建时间倒序分页返回 content、metadata 或 ocr_text 匹配 [query] 的行
+  ///
+  /// 增量存储的行没有 content 全文，先批量还原（已还原过的直接取缓存）再按
+  /// LIKE 的规则在内存中匹配，命中的行与 SQL 结果合并后再分页。
+  Future<List<Map<String, dynamic>>> _searchRows(
+    String query, {
+    ClipType? type,
+    int? limit,
+    int? offset,
+  }) async {
+    final db = _database!;
+    final typeClause = type == null ? '' : ' AND type = ?';
+    final typeArgs = [if (type != null) type.name];
+    final matchClause =
+        '(content LIKE ? OR metadata LIKE ? OR ocr_text LIKE ?)$typeClause';
+    final matchArgs = [...List.filled(3, '%$query%'), ...typeArgs];
+
+    // 元数据或 OCR 文本已经命中的增量行无需还原（这些列可能为 NULL）
+    final deltaRows = await db.query(
+      ClipConstants.clipItemsTable,
+      columns: ['id', 'created_at'],
+      where:
+          'content_delta IS NOT NULL$typeClause AND '
+          'NOT COALESCE(metadata LIKE ? OR ocr_text LIKE ?, 0)',
+      whereArgs: [...typeArgs, ...List.filled(2, '%$query%')],
+    );
+    final deltaHits = <Map<String, dynamic>>[];
+    if (deltaRows.isNotEmpty) {
+      final contents = await _reconstructContents(db, [
+        for (final row in deltaRows) row['id']! as String,
+      ]);
+      final matcher = _likeMatcher(query);
+      for (final row in deltaRows) {
+        final content = contents[row['id']];
+        if (content != null && matcher.hasMatch(content)) deltaHits.add(row);
+      }
+    }
+
+    if (deltaHits.isEmpty) {
+      return db.query(
+        ClipConstants.clipItemsTable,
+        where: matchClause,
+        whereArgs: matchArgs,
+        orderBy: 'created_at DESC',
+        limit: limit,
+        offset: offset,
+      );
+    }
+
+    // 有增量行命中时先按 ID 合并排序分页，再读取该页的完整行
+    final hits = [
+      ...await db.query(
+        ClipConstants.clipItemsTable,
+        columns: ['id', 'created_at'],
+        where: matchClause,
+        whereArgs: matchArgs,
+      ),
+      ...deltaHits,
+    ]..sort(
+        (a, b) => (b['created_at']! as String).compareTo(
+          a['created_at']! as String,
+        ),
+      );
+    final pageIds = hits
+        .skip(offset ?? 0)
+        .take(limit ?? hits.length)
+        .map((row) => row['id']! as String)
+        .toList();
+    final rowsById = <String, Map<String, dynamic>>{};
+    for (var i = 0; i < pageIds.length; i += _sqlChunkSize) {
+      final chunk = pageIds.skip(i).take(_sqlChunkSize).toList();
+      final rows = await db.query(
+        ClipConstants.clipItemsTable,
+        where: 'id IN (${List.filled(chunk.length, '?').join(',')})',
+        whereArgs: chunk,
+      );
+      for (final row in rows) {
+        rowsById[row['id']! as String] = row;
+      }
+    }
+    return [
+      for (final id in pageIds)
+        if (rowsById[id] case final row?) row,
+    ];
+  }
+
+  /// 与 SQLite 的 `LIKE '%query%'` 相同的匹配：`%` 匹配任意串，`_` 匹配单个字符，
+  /// 不区分大小写
+  static RegExp _likeMatcher(String query) {
+    final pattern = StringBuffer();
+    for (final char in query.split('')) {
+      pattern.write(switch (char) {
+        '%' => '.*',
+        '_' => '.',
+        _ => RegExp.escape(char),
+      });
+    }
+    return RegExp(pattern.toString(), caseSensitive: false, dotAll: true);
+  }
+
+  /// 沿 delta_base_id 读取增量链，断链或成环时返回 null
+  Future<_DeltaChain?> _loadDeltaChain(DatabaseExecutor db, String id) async {
+    return (await _loadDeltaChains(db, [id]))[id];
+  }
+
+  /// 批量读取 [ids] 的增量链，每 [_sqlChunkSize] 个 ID 一次递归查询；
+  /// 断链或成环的 ID 不在结果中
+  Future<Map<String, _DeltaChain>> _loadDeltaChains(
+    DatabaseExecutor db,
+    List<String> ids,
+  ) async {
+    final chains = <String, _DeltaChain>{};
+    for (var i = 0; i < ids.length; i += _sqlChunkSize) {
+      final chunk = ids.skip(i).take(_sqlChunkSize).toList();
+      final rows = await db.rawQuery(
+        '''
+        WITH RECURSIVE
+          chain(start_id, id, content, content_delta, delta_base_id, step) AS (
+            SELECT id, id, content, content_delta, delta_base_id, 0
+            FROM ${ClipConstants.clipItemsTable}
+            WHERE id IN (${List.filled(chunk.length, '?').join(',')})
+            UNION ALL
+            SELECT chain.start_id, c.id, c.content, c.content_delta,
+                   c.delta_base_id, chain.step + 1
+            FROM ${ClipConstants.clipItemsTable} c
+            JOIN chain ON c.id = chain.delta_base_id
+            WHERE chain.content_delta IS NOT NULL AND chain.step < ?
+          )
+        SELECT start_id, id, content, content_delta FROM chain
+        ORDER BY start_id, step
+        ''',
+        [...chunk, ClipConstants.textDeltaMaxChainDepth * 2],
+      );
+
+      final rowsByStart = <String, List<Map<String, Object?>>>{};
+      for (final row in rows) {
+        rowsByStart.putIfAbsent(row['start_id']! as String, () => []).add(row);
+      }
+      rowsByStart.forEach((id, chainRows) {
+        final chain = _chainFromRows(chainRows);
+        if (chain != null) chains[id] = chain;
+      });
+    }
+    return chains;
+  }
+
+  /// 由从目标到链根依次排列的行组装增量链
+  _DeltaChain? _chainFromRows(List<Map<String, Object?>> rows) {
+    final ids = <String>{};
+    final deltas = <String>[];
+    for (final row in rows) {
+      final rowId = row['id'] as String?;
+      if (rowId == null || !ids.add(rowId)) return null;
+      final delta = row['content_delta'] as String?;
+      if (delta == null) {
+        return _DeltaChain(
+          rootId: rowId,
+          rootContent: row['content'] as String? ?? '',
+          deltas: deltas.reversed.toList(),
+          ids: ids,
+        );
+      }
+      deltas.add(delta);
+    }
+    return null;
+  }
+
+  /// 由增量链还原 [id] 的全文（优先使用原生侧缓存）
+  Future<String?> _applyDeltaChain(String id, _DeltaChain chain) async {
+    if (chain.deltas.isEmpty) return chain.rootContent;
+    return await TextDeltaCodec.instance.lookup(id) ??
+        await TextDeltaCodec.instance.apply(
+          chain.rootContent,
+          chain.deltas,
+          id: id,
+        );
+  }
+
+  /// 读取剪贴项的全文；记录不存在或增量链损坏时返回 null
+  Future<String?> _reconstructContent(DatabaseExecutor db, String id) async {
+    final chain = await _loadDeltaChain(db, id);
+    return chain == null ? null : _applyDeltaChain(id, chain);
+  }
+
+  /// 批量读取 [ids] 的全文：先查还原缓存，其余一次查询取链、一次原生调用还原；
+  /// 记录不存在或增量链损坏的 ID 不在结果中
+  Future<Map<String, String>> _reconstructContents(
+    DatabaseExecutor db,
+    List<String> ids,
+  ) async {
+    final contents = <String, String>{};
+    final uncached = <String>[];
+    for (final id in ids) {
+      final cached = _deltaTexts[id];
+      if (cached != null) {
+        contents[id] = cached;
+      } else {
+        uncached.add(id);
+      }
+    }
+    if (uncached.isEmpty) return contents;
+
+    final generation = _deltaTexts.generation;
+    final restored = await _reconstructUncached(db, uncached);
+    _deltaTexts.addAll(restored, generation: generation);
+    return contents..addAll(restored);
+  }
+
+  /// 由增量链还原缓存中没有的 [ids]
+  Future<Map<String, String>> _reconstructUncached(
+    DatabaseExecutor db,
+    List<String> ids,
+  ) async {
+    final chains = await _loadDeltaChains(db, ids);
+    final contents = <String, String>{};
+    final pending = <TextDeltaChain>[];
+    chains.forEach((id, chain) {
+      if (chain.deltas.isEmpty) {
+        contents[id] = chain.rootContent;
+      } else {
+        pending.add(
+          TextDeltaChain(id: id, base: chain.rootContent, deltas: chain.deltas),
+        );
+      }
+    });
+    contents.addAll(await TextDeltaCodec.instance.applyBatch(pending));
+    return contents;
+  }
+
+  /// 增量存储的行先批量还原 content 再交给 [_mapToClipItem]
+  Future<List<ClipItem>> _mapRows(List<Map<String, dynamic>> maps) async {
+    final deltaIds = [
+      for (final map in maps)
+        if (map['content_delta'] != null) map['id']! as String,
+    ];
+    if (deltaIds.isEmpty) return maps.map(_mapToClipItem).toList();
+
+    final contents = await _reconstructContents(_database!, deltaIds);
+    final missing = deltaIds.where((id) => !contents.containsKey(id)).toList();
+    if (missing.isNotEmpty) {
+      await Log.w(
+        'Failed to reconstruct delta-encoded clip items',
+        tag: 'DatabaseService',
+        fields: {'ids': missing},
+      );
+    }
+    return maps.map((map) {
+      if (map['content_delta'] == null) return _mapToClipItem(map);
+      return _mapToClipItem({...map, 'content': contents[map['id']] ?? ''});
+    }).toList();
+  }
+
+  /// 把以 [ids] 为基准的增量行物化为全文（[ids] 自身除外），
+  /// 须在删除或改写 [ids] 的同一事务内调用
+  Future<void> _detachDeltaDependents(
+    DatabaseExecutor db,
+    List<String> ids,
+  ) async {
+    final removed = ids.toSet();
+    for (var i = 0; i < ids.length; i += _sqlChunkSize) {
+      final chunk = ids.skip(i).take(_sqlChunkSize).toList();
+      final rows = await db.query(
+        ClipConstants.clipItemsTable,
+        columns: ['id'],
+        where: 'delta_base_id IN (${List.filled(chunk.length, '?').join(',')})',
+        whereArgs: chunk,
+      );
+      for (final row in rows) {
+        final id = row['id'] as String?;
+        if (id == null || removed.contains(id)) continue;
+
+        final content = await _reconstructContent(db, id);
+        if (content == null) {
+          await Log.w(
+            'Failed to reconstruct delta dependent before detaching',
+            tag: 'DatabaseService',
+            fields: {'id': id},
+          );
+          continue;
+        }
+        await db.update(
+          ClipConstants.clipItemsTable,
+          _fullContentColumns(content),
+          where: 'id = ?',
+          whereArgs: [id],
+        );
+      }
+    }
+  }
+
+  /// 删除满足条件的剪贴项，返回被删除行的 id 与 file_path
+  Future<List<Map<String, Object?>>> _deleteRows(
+    String where,
+    List<Object?> whereArgs,
+  ) {
+    return _database!.transaction((txn) async {
+      final rows = await txn.query(
+        ClipConstants.clipItemsTable,
+        columns: ['id', 'file_path'],
+        where: where,
+        whereArgs: whereArgs,
+      );
+      await _detachDeltaDependents(
+        txn,
+        rows.map((row) => row['id'] as String?).whereType<String>().toList(),
+      );
+      await txn.delete(
+        ClipConstants.clipItemsTable,
+        where: where,
+        whereArgs: whereArgs,
+      );
+      return rows;
+    });
+  }
+
+  /// 后台任务：把深度超过 [ClipConstants.textDeltaRebaseDepth] 的增量行
+  /// 改为直接相对链根编码（差异过大时改存全文），限制还原时的回放次数
+  Future<void> _rebaseDeltaChains() async {
+    if (_rebasingDeltaChains || _database == null) return;
+    _rebasingDeltaChains = true;
+
+    var rebased = 0;
+    try {
+      // 由浅到深处理：上游重新编码后，下游的实际深度随之变小
+      final rows = await _database!.query(
+        ClipConstants.clipItemsTable,
+        columns: ['id'],
+        where: 'delta_depth > ?',
+        whereArgs: [ClipConstants.textDeltaRebaseDepth],
+        orderBy: 'delta_depth ASC',
+      );
+      for (final row in rows) {
+        final id = row['id'] as String?;
+        if (id == null) continue;
+
+        await _database!.transaction((txn) async {
+          final chain = await _loadDeltaChain(txn, id);
+          if (chain == null || chain.deltas.isEmpty) return;
+
+          Map<String, Object?> values;
+          if (chain.depth <= ClipConstants.textDeltaRebaseDepth) {
+            // 记录的深度已过时，只需更正
+            values = {'delta_depth': chain.depth};
+          } else {
+            final content = await _applyDeltaChain(id, chain);
+            if (content == null) return;
+            final delta = await TextDeltaCodec.instance.encode(
+              chain.rootContent,
+              content,
+            );
+            values = delta == null
+                ? _fullContentColumns(content)
+                : {
+                    'content': null,
+                    'content_delta': delta,
+                    'delta_base_id': chain.rootId,
+                    'delta_depth': 1,
+                  };
+            rebased++;
+          }
+          await txn.update(
+            ClipConstants.clipItemsTable,
+            values,
+            where: 'id = ?',
+            whereArgs: [id],
+          );
+        });
+      }
+
+      if (rebased > 0) {
+        await Log.i(
+          'Rebased long delta chains',
+          tag: 'DatabaseService',
+          fields: {'count': rebased},
+        );
+      }
+    } on Exception catch (e) {
+      await Log.w(
+        'Failed to rebase delta chains',
+        tag: 'DatabaseService',
+        error: e,
+      );
+    } finally {
+      _rebasingDeltaChains = false;
+    }
+  }
+
   /// 通过 id 获取剪贴项
   ///
   /// 参数：
@@ -855,7 +1412,7 @@ class DatabaseService {
     );
 
     if (maps.isEmpty) return null;
-    return _mapToClipItem(maps.first);
+    return (await _mapRows(maps)).first;
   }
 
   /// 切换指定剪贴项的收藏状态
@@ -927,18 +1484,13 @@ class DatabaseService {
 
     final cutoffDate = DateTime.now().subtract(Duration(days: maxAgeInDays));
 
-    // 先找出要删的 id 与 file_path
-    final stale = await _database!.query(
-      ClipConstants.clipItemsTable,
-      columns: ['id', 'file_path'],
-      where: 'created_at < ?',
-      whereArgs: [cutoffDate.toIso8601String()],
+    // 删除的同时取回 id 与 file_path
+    final stale = await _deleteRows(
+      'created_at < ?',
+      [cutoffDate.toIso8601String()],
     );
-
-    await _database!.delete(
-      ClipConstants.clipItemsTable,
-      where: 'created_at < ?',
-      whereArgs: [cutoffDate.toIso8601String()],
+    _indexRemoved(
+      stale.map((row) => row['id'] as String?).whereType<String>(),
     );
 
     for (final row in stale) {
@@ -957,18 +1509,10 @@ class DatabaseService {
     if (!_isInitialized) await initialize();
     if (_database == null) throw Exception('Database not initialized');
 
-    // 取出将被删除的 file_path
-    final rows = await _database!.query(
-      ClipConstants.clipItemsTable,
-      columns: ['file_path'],
-      where: 'type = ?',
-      whereArgs: [type.name],
-    );
-
-    await _database!.delete(
-      ClipConstants.clipItemsTable,
-      where: 'type = ?',
-      whereArgs: [type.name],
+    // 删除的同时取回 id 与 file_path
+    final rows = await _deleteRows('type = ?', [type.name]);
+    _indexRemoved(
+      rows.map((r) => r['id'] as String?).whereType<String>(),
     );
 
     for (final r in rows) {
@@ -1269,6 +1813,31 @@ class DatabaseService {
       );
     }
 
+    // clip_items: content_delta / delta_base_id / delta_depth（文本增量存储）
+    final hasContentDelta = await _columnExists(
+      db,
+      ClipConstants.clipItemsTable,
+      'content_delta',
+    );
+    if (!hasContentDelta) {
+      await db.execute(
+        'ALTER TABLE ${ClipConstants.clipItemsTable} ADD COLUMN content_delta TEXT',
+      );
+      await db.execute(
+        'ALTER TABLE ${ClipConstants.clipItemsTable} ADD COLUMN delta_base_id TEXT',
+      );
+      await db.execute(
+        'ALTER TABLE ${ClipConstants.clipItemsTable} '
+        'ADD COLUMN delta_depth INTEGER NOT NULL DEFAULT 0',
+      );
+    }
+    await _ensureIndexExists(
+      db,
+      'idx_clip_items_delta_base_id',
+      ClipConstants.clipItemsTable,
+      'delta_base_id',
+    );
+
     // 预留：如未来新增列，可在此继续检测并 ALTER
   }
 
@@ -1310,9 +1879,15 @@ class DatabaseService {
     if (!_isInitialized) await initialize();
     if (_database == null) throw Exception('Database not initialized');
 
-    final deletedCount = await _database!.delete(
-      ClipConstants.clipItemsTable,
-      where: "type = 'text' AND (content IS NULL OR TRIM(content) = '')",
+    // 增量存储的文本 content 为 NULL，不属于空内容
+    final deleted = await _deleteRows(
+      "type = 'text' AND content_delta IS NULL "
+      "AND (content IS NULL OR TRIM(content) = '')",
+      const [],
+    );
+    final deletedCount = deleted.length;
+    _indexRemoved(
+      deleted.map((row) => row['id'] as String?).whereType<String>(),
     );
 
     await Log.i('Cleaned $deletedCount empty text items from database');
@@ -1328,7 +1903,8 @@ class DatabaseService {
 
     final result = await _database!.rawQuery(
       'SELECT COUNT(*) as count FROM ${ClipConstants.clipItemsTable} '
-      "WHERE type = 'text' AND (content IS NULL OR TRIM(content) = '')",
+      "WHERE type = 'text' AND content_delta IS NULL "
+      "AND (content IS NULL OR TRIM(content) = '')",
     );
 
     return (result.first['count'] as int?) ?? 0;
@@ -1727,3 +2303,71 @@ class DatabaseService {
     }
   }
 }
+
+/// 增量链：根为全文行，[deltas] 按从根到目标的顺序排列
+class _DeltaChain {
+  const _DeltaChain({
+    required this.rootId,
+    required this.rootContent,
+    required this.deltas,
+    required this.ids,
+  });
+
+  /// 链根（全文行）的 ID
+  final String rootId;
+
+  /// 链根的全文
+  final String rootContent;
+
+  /// 依次应用即可得到目标全文的增量
+  final List<String> deltas;
+
+  /// 链上全部行的 ID（含目标与链根）
+  final Set<String> ids;
+
+  /// 目标到链根的实际深度
+  int get depth => deltas.length;
+}
+
+/// 增量行还原结果的缓存，总字符数不超过 [capacity]
+///
+/// 同一 ID 的全文只在替换写入或修改内容时改变，由调用方使之失效。
+/// 缓存满后不再加入新条目（不做淘汰）：搜索每次都按顺序扫描全部增量行，
+/// 淘汰最久未用的条目只会让每个条目都在被读到之前被挤出。
+class _DeltaTextCache {
+  _DeltaTextCache(this.capacity);
+
+  /// 缓存的总字符数上限
+  final int capacity;
+
+  final Map<String, String> _texts = {};
+  int _chars = 0;
+
+  /// 每次失效递增；还原开始前记下，结束时不一致则丢弃结果
+  int generation = 0;
+
+  String? operator [](String id) => _texts[id];
+
+  void addAll(Map<String, String> texts, {required int generation}) {
+    if (generation != this.generation) return;
+    texts.forEach((id, text) {
+      if (_texts.containsKey(id) || _chars + text.length > capacity) return;
+      _texts[id] = text;
+      _chars += text.length;
+    });
+  }
+
+  void remove(Iterable<String> ids) {
+    generation++;
+    for (final id in ids) {
+      final text = _texts.remove(id);
+      if (text != null) _chars -= text.length;
+    }
+  }
+
+  void clear() {
+    generation++;
+    _texts.clear();
+    _chars = 0;
+  }
+}
@@ -0,0 +1,92 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:clip_flow/core/services/observability/index.dart';
+import 'package:flutter/services.dart';
+
+/// 图片感知哈希的近邻索引（Linux 原生实现）
+///
+/// 原生侧以 BK 树按汉明距离组织已收录图片的感知哈希，
+/// 采集时即可找出与新图片最接近的已有图片。
+/// 感知哈希保存在剪贴项元数据的 [metadataKey] 字段中，启动时据此重建索引。
+/// 近似重复检测是尽力而为的：索引缺失或过期只会错过一次合并。
+class ImageHashIndex {
+  ImageHashIndex._();
+
+  /// 单例实例
+  static final ImageHashIndex instance = ImageHashIndex._();
+
+  /// 剪贴项元数据中保存感知哈希的字段
+  static const String metadataKey = 'perceptualHash';
+
+  static const MethodChannel _platformChannel = MethodChannel(
+    'clipboard_service',
+  );
+
+  /// 启动加载时单次调用携带的条目数量
+  static const int _loadChunkSize = 5000;
+
+  /// 用数据库中的图片哈希（ID → 十六进制哈希）重建索引
+  Future<void> load(Future<Map<String, String>> Function() loadHashes) async {
+    if (!Platform.isLinux) return;
+
+    try {
+      await _platformChannel.invokeMethod<void>('imageHashIndexClear');
+      final entries = (await loadHashes()).entries.toList();
+      for (var i = 0; i < entries.length; i += _loadChunkSize) {
+        final chunk = entries.skip(i).take(_loadChunkSize).toList();
+        await _platformChannel.invokeMethod<int>('imageHashIndexAdd', {
+          'ids': chunk.map((e) => e.key).toList(),
+          'hashes': chunk.map((e) => e.value).toList(),
+        });
+      }
+
+      await Log.d(
+        'Image hash index loaded',
+        tag: 'ImageHashIndex',
+        fields: {'count': entries.length},
+      );
+    } on Exception catch (e) {
+      await Log.w(
+        'Failed to load image hash index',
+        tag: 'ImageHashIndex',
+        error: e,
+      );
+    }
+  }
+
+  /// 记录新写入图片的感知哈希（ID → 十六进制哈希）
+  void add(Map<String, String> hashes) {
+    if (!Platform.isLinux || hashes.isEmpty) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<int>('imageHashIndexAdd', {
+            'ids': hashes.keys.toList(),
+            'hashes': hashes.values.toList(),
+          })
+          .catchError((Object _) => 0),
+    );
+  }
+
+  /// 移除已删除的剪贴项（非图片 ID 会被忽略）
+  void remove(Iterable<String> ids) {
+    if (!Platform.isLinux) return;
+    final list = ids.toList();
+    if (list.isEmpty) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<int>('imageHashIndexRemove', {'ids': list})
+          .catchError((Object _) => 0),
+    );
+  }
+
+  /// 清空索引（数据库被整体清空时调用）
+  void clear() {
+    if (!Platform.isLinux) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<void>('imageHashIndexClear')
+          .catchError((Object _) {}),
+    );
+  }
+}
@@ -1,5 +1,10 @@
 // 存储模块统一导出
+export 'content_hash_index.dart';
 export 'database_service.dart';
 export 'encryption_service.dart';
+export 'image_hash_index.dart';
+export 'media_store.dart';
 export 'path_service.dart';
 export 'preferences_service.dart';
+export 'text_delta_codec.dart';
+export 'text_similarity_index.dart';
@@ -0,0 +1,229 @@
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:clip_flow/core/services/observability/index.dart';
+import 'package:flutter/services.dart';
+
+/// 原生媒体存储的写入结果
+class MediaStoreEntry {
+  /// 创建写入结果
+  const MediaStoreEntry({
+    required this.relativePath,
+    required this.hash,
+    required this.existed,
+  });
+
+  /// 相对应用支持目录的路径
+  final String relativePath;
+
+  /// 内容的 SHA-256
+  final String hash;
+
+  /// 相同内容已存在，本次未写入
+  final bool existed;
+}
+
+/// 文件导入进度
+class FileIngestProgress {
+  /// 创建导入进度
+  const FileIngestProgress({
+    required this.jobId,
+    required this.phase,
+    required this.done,
+    required this.total,
+  });
+
+  /// 导入任务 ID
+  final int jobId;
+
+  /// 当前阶段：hash（计算内容哈希）或 copy（复制）
+  final String phase;
+
+  /// 当前阶段已处理的字节数
+  final int done;
+
+  /// 文件总字节数
+  final int total;
+}
+
+/// 进行中的文件导入
+class FileIngestTask {
+  FileIngestTask._(this.id, this.result);
+
+  /// 导入任务 ID
+  final int id;
+
+  /// 导入结果；失败或被取消时为 null
+  final Future<MediaStoreEntry?> result;
+
+  /// 本任务的进度
+  Stream<FileIngestProgress> get progress => MediaStore.instance
+      .ingestProgress
+      .where((event) => event.jobId == id);
+
+  /// 取消导入
+  Future<bool> cancel() => MediaStore.instance._cancelIngest(id);
+}
+
+/// 内容寻址的媒体文件存储（Linux 原生实现）
+///
+/// 原生侧在工作线程写入：文件名由内容哈希生成，已存在即跳过；
+/// 新文件经 O_TMPFILE + linkat 原子出现，连续写入合并 fsync。
+/// 文件导入优先使用写时复制（reflink），其次为内核内复制，不经过 Dart 内存。
+/// 其他平台或原生写入失败时返回 null，由调用方回退到 Dart 写入。
+class MediaStore {
+  MediaStore._();
+
+  /// 单例实例
+  static final MediaStore instance = MediaStore._();
+
+  static const MethodChannel _platformChannel = MethodChannel(
+    'clipboard_service',
+  );
+
+  static const EventChannel _ingestEventChannel = EventChannel(
+    'file_ingest_events',
+  );
+
+  int _nextIngestJobId = 1;
+
+  Stream<FileIngestProgress>? _ingestProgress;
+
+  /// 当前平台是否支持原生写入
+  bool get isAvailable => Platform.isLinux;
+
+  /// 全部文件导入任务的进度
+  Stream<FileIngestProgress> get ingestProgress =>
+      _ingestProgress ??= _ingestEventChannel
+          .receiveBroadcastStream()
+          .where((event) => event is Map)
+          .map((event) {
+            final map = event as Map;
+            return FileIngestProgress(
+              jobId: map['jobId'] as int,
+              phase: map['phase'] as String,
+              done: map['done'] as int,
+              total: map['total'] as int,
+            );
+          })
+          .asBroadcastStream();
+
+  /// 把 [bytes] 写入 `root/relativeDir/<prefix>_<哈希前 16 位>.<extension>`
+  ///
+  /// 文件名中的哈希由原生侧对 [bytes] 计算 SHA-256 得出；给出的 [hash]
+  /// 须为小写十六进制 SHA-256 且与之一致，[extension] 只能含字母与数字，
+  /// 否则原生写入失败并返回 null。
+  Future<MediaStoreEntry?> write({
+    required String root,
+    required String relativeDir,
+    required String prefix,
+    required String extension,
+    required Uint8List bytes,
+    String? hash,
+  }) async {
+    if (!isAvailable) return null;
+    try {
+      final result = await _platformChannel
+          .invokeMapMethod<String, dynamic>('mediaStoreWrite', {
+            'root': root,
+            'relativeDir': relativeDir,
+            'prefix': prefix,
+            'extension': extension,
+            'bytes': bytes,
+            if (hash != null) 'hash': hash,
+          });
+      if (result == null) return null;
+      return MediaStoreEntry(
+        relativePath: result['relativePath'] as String,
+        hash: result['hash'] as String,
+        existed: result['existed'] as bool? ?? false,
+      );
+    } on Exception catch (e) {
+      await Log.w(
+        'Native media store write failed',
+        tag: 'MediaStore',
+        error: e,
+        fields: {'relativeDir': relativeDir, 'size': bytes.length},
+      );
+      return null;
+    }
+  }
+
+  /// 把 [source] 文件导入 `root/relativeDir/<prefix>_<哈希前 16 位>.<extension>`
+  ///
+  /// 其他平台返回 null。
+  FileIngestTask? startIngest({
+    required String source,
+    required String root,
+    required String relativeDir,
+    required String prefix,
+    required String extension,
+  }) {
+    if (!isAvailable) return null;
+    final id = _nextIngestJobId++;
+    return FileIngestTask._(
+      id,
+      _ingest(id, source, root, relativeDir, prefix, extension),
+    );
+  }
+
+  Future<MediaStoreEntry?> _ingest(
+    int jobId,
+    String source,
+    String root,
+    String relativeDir,
+    String prefix,
+    String extension,
+  ) async {
+    try {
+      final result = await _platformChannel
+          .invokeMapMethod<String, dynamic>('ingestFile', {
+            'jobId': jobId,
+            'source': source,
+            'root': root,
+            'relativeDir': relativeDir,
+            'prefix': prefix,
+            'extension': extension,
+          });
+      if (result == null) return null;
+
+      await Log.d(
+        'File ingested',
+        tag: 'MediaStore',
+        fields: {
+          'bytes': result['bytes'],
+          'existed': result['existed'],
+          'method': result['method'],
+        },
+      );
+      return MediaStoreEntry(
+        relativePath: result['relativePath'] as String,
+        hash: result['hash'] as String,
+        existed: result['existed'] as bool? ?? false,
+      );
+    } on PlatformException catch (e) {
+      if (e.code != 'CANCELLED') {
+        await Log.w(
+          'Native file ingest failed',
+          tag: 'MediaStore',
+          error: e,
+          fields: {'source': source},
+        );
+      }
+      return null;
+    } on Exception {
+      return null;
+    }
+  }
+
+  Future<bool> _cancelIngest(int jobId) async {
+    try {
+      return await _platformChannel.invokeMethod<bool>('cancelFileIngest', {
+            'jobId': jobId,
+          }) ??
+          false;
+    } on Exception {
+      return false;
+    }
+  }
+}
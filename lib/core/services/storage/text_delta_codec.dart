@@ -0,0 +1,127 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:clip_flow/core/constants/clip_constants.dart';
+import 'package:flutter/services.dart';
+
+/// 文本增量编解码（Linux 原生实现）
+///
+/// 原生侧以行为单位做 Myers 差分，把近似重复的长文本表示为相对基准文本的
+/// 增量；还原在工作线程执行，并按剪贴项 ID 缓存最近的还原结果。
+/// 其他平台不可用：[encode] 始终返回 null，数据库保存全文。
+class TextDeltaCodec {
+  TextDeltaCodec._();
+
+  /// 单例实例
+  static final TextDeltaCodec instance = TextDeltaCodec._();
+
+  static const MethodChannel _platformChannel = MethodChannel(
+    'clipboard_service',
+  );
+
+  /// 元数据中记录增量基准（最相近的已有文本）ID 的键
+  static const String baseMetadataKey = 'variantBase';
+
+  /// 当前平台是否支持增量存储
+  bool get isAvailable => Platform.isLinux;
+
+  /// 计算 [target] 相对 [base] 的增量；差异过大或增量不够小时返回 null
+  Future<String?> encode(
+    String base,
+    String target, {
+    double maxRatio = ClipConstants.textDeltaMaxRatio,
+  }) async {
+    if (!isAvailable) return null;
+    try {
+      return await _platformChannel.invokeMethod<String>('textDeltaEncode', {
+        'base': base,
+        'target': target,
+        'maxRatio': maxRatio,
+      });
+    } on Exception {
+      return null;
+    }
+  }
+
+  /// 从链根全文 [base] 依次应用 [deltas] 还原文本；给出 [id] 时缓存结果
+  Future<String?> apply(
+    String base,
+    List<String> deltas, {
+    String? id,
+  }) async {
+    if (!isAvailable) return null;
+    try {
+      return await _platformChannel.invokeMethod<String>('textDeltaApply', {
+        'base': base,
+        'deltas': deltas,
+        if (id != null) 'id': id,
+      });
+    } on Exception {
+      return null;
+    }
+  }
+
+  /// 批量还原 [chains]，返回 ID 到还原文本的映射（失败的条目缺省）
+  ///
+  /// 一次通道调用完成整页还原；共享链根的条目只传一份基准全文。
+  Future<Map<String, String>> applyBatch(List<TextDeltaChain> chains) async {
+    if (!isAvailable || chains.isEmpty) return const {};
+    final baseIndex = <String, int>{};
+    final bases = <String>[];
+    final entries = [
+      for (final chain in chains)
+        {
+          'id': chain.id,
+          'base': baseIndex.putIfAbsent(chain.base, () {
+            bases.add(chain.base);
+            return bases.length - 1;
+          }),
+          'deltas': chain.deltas,
+        },
+    ];
+    try {
+      final results = await _platformChannel.invokeListMethod<String?>(
+        'textDeltaApplyBatch',
+        {'bases': bases, 'entries': entries},
+      );
+      if (results == null) return const {};
+      return {
+        for (var i = 0; i < chains.length && i < results.length; i++)
+          if (results[i] case final String text) chains[i].id: text,
+      };
+    } on Exception {
+      return const {};
+    }
+  }
+
+  /// 查询缓存的还原结果，未命中时返回 null
+  Future<String?> lookup(String id) async {
+    if (!isAvailable) return null;
+    try {
+      return await _platformChannel.invokeMethod<String>('textDeltaLookup', {
+        'id': id,
+      });
+    } on Exception {
+      return null;
+    }
+  }
+}
+
+/// 待还原的增量链：链根全文 [base] 依次应用 [deltas] 得到 [id] 的文本
+class TextDeltaChain {
+  /// 创建增量链
+  const TextDeltaChain({
+    required this.id,
+    required this.base,
+    required this.deltas,
+  });
+
+  /// 被还原剪贴项的 ID
+  final String id;
+
+  /// 链根全文
+  final String base;
+
+  /// 从链根到该项依次应用的增量
+  final List<String> deltas;
+}
@@ -0,0 +1,137 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:clip_flow/core/constants/clip_constants.dart';
+import 'package:clip_flow/core/models/clip_item.dart';
+import 'package:clip_flow/core/services/observability/index.dart';
+import 'package:flutter/services.dart';
+
+/// 近似重复的已有文本
+class TextNearDuplicate {
+  /// 创建近似重复结果
+  const TextNearDuplicate({required this.id, required this.similarity});
+
+  /// 已有剪贴项的 ID
+  final String id;
+
+  /// 估计的 Jaccard 相似度（0..1）
+  final double similarity;
+}
+
+/// 文本近似重复索引（Linux 原生实现）
+///
+/// 原生侧对文本做字符 shingle 并计算 MinHash 签名，以 LSH 分带索引，
+/// 用于把同一段落或日志片段的多个编辑版本归为一组。
+/// 签名不落库，启动时由数据库中的文本重新计算；同步是尽力而为的。
+class TextSimilarityIndex {
+  TextSimilarityIndex._();
+
+  /// 单例实例
+  static final TextSimilarityIndex instance = TextSimilarityIndex._();
+
+  static const MethodChannel _platformChannel = MethodChannel(
+    'clipboard_service',
+  );
+
+  /// 参与近似重复检测的类型
+  static const Set<ClipType> supportedTypes = {ClipType.text, ClipType.code};
+
+  /// 启动加载时单次调用携带的条目数量
+  static const int _loadChunkSize = 500;
+
+  /// 剪贴项是否参与近似重复检测（过短的文本 shingle 太少，估计不可靠）
+  static bool supports(ClipItem item) {
+    final content = item.content;
+    return supportedTypes.contains(item.type) &&
+        content != null &&
+        content.length >= ClipConstants.textNearDuplicateMinLength;
+  }
+
+  /// 用数据库中的文本（ID → 内容）重建索引
+  Future<void> load(Future<Map<String, String>> Function() loadTexts) async {
+    if (!Platform.isLinux) return;
+
+    try {
+      await _platformChannel.invokeMethod<void>('textIndexClear');
+      final entries = (await loadTexts()).entries.toList();
+      for (var i = 0; i < entries.length; i += _loadChunkSize) {
+        final chunk = entries.skip(i).take(_loadChunkSize).toList();
+        await _platformChannel.invokeMethod<int>('textIndexAdd', {
+          'ids': chunk.map((e) => e.key).toList(),
+          'texts': chunk.map((e) => e.value).toList(),
+        });
+      }
+
+      await Log.d(
+        'Text similarity index loaded',
+        tag: 'TextSimilarityIndex',
+        fields: {'count': entries.length},
+      );
+    } on Exception catch (e) {
+      await Log.w(
+        'Failed to load text similarity index',
+        tag: 'TextSimilarityIndex',
+        error: e,
+      );
+    }
+  }
+
+  /// 查找与 [text] 最相似的已有文本，相似度低于 [threshold] 时返回 null
+  Future<TextNearDuplicate?> findNearest(
+    String text, {
+    double threshold = ClipConstants.textNearDuplicateSimilarity,
+    String? excludeId,
+  }) async {
+    if (!Platform.isLinux) return null;
+    try {
+      final result = await _platformChannel
+          .invokeMapMethod<String, dynamic>('textIndexQuery', {
+            'text': text,
+            'threshold': threshold,
+            if (excludeId != null) 'excludeId': excludeId,
+          });
+      if (result == null) return null;
+      return TextNearDuplicate(
+        id: result['id'] as String,
+        similarity: (result['similarity'] as num).toDouble(),
+      );
+    } on Exception {
+      return null;
+    }
+  }
+
+  /// 记录新写入的文本（ID → 内容）
+  void add(Map<String, String> texts) {
+    if (!Platform.isLinux || texts.isEmpty) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<int>('textIndexAdd', {
+            'ids': texts.keys.toList(),
+            'texts': texts.values.toList(),
+          })
+          .catchError((Object _) => 0),
+    );
+  }
+
+  /// 移除已删除的剪贴项（未收录的 ID 会被忽略）
+  void remove(Iterable<String> ids) {
+    if (!Platform.isLinux) return;
+    final list = ids.toList();
+    if (list.isEmpty) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<int>('textIndexRemove', {'ids': list})
+          .catchError((Object _) => 0),
+    );
+  }
+
+  /// 清空索引（数据库被整体清空时调用）
+  void clear() {
+    if (!Platform.isLinux) return;
+    unawaited(
+      _platformChannel
+          .invokeMethod<void>('textIndexClear')
+          .catchError((Object _) {}),
+    );
+  }
+}
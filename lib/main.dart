@@ -1,3 +1,4 @@
+import 'dart:async';
 import 'dart:io';
 
 import 'package:clip_flow/app.dart';
@@ -152,6 +153,15 @@ Future<void> _runApp() async {
   // 为了兼容性，仍然初始化基础服务（但不再启动监控）
   await ClipboardService.instance.initialize();
 
+  // 后台预热 OCR 引擎，首次识别无需等待语言包加载
+  if (loadedPreferences.enableOCR) {
+    unawaited(
+      OcrServiceFactory.getInstance().warmUp(
+        language: loadedPreferences.ocrLanguage,
+      ),
+    );
+  }
+
   // 初始化自动更新服务
   try {
     await UpdateService().initialize();
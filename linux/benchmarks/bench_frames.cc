@@ -0,0 +1,308 @@
+#include "bench_frames.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+struct Color {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+};
+
+constexpr Color kDesktop = {0x3a, 0x4a, 0x5c};
+constexpr Color kTitleBar = {0x2b, 0x2b, 0x2b};
+constexpr Color kSidebar = {0xec, 0xec, 0xec};
+constexpr Color kContent = {0xff, 0xff, 0xff};
+constexpr Color kText = {0x22, 0x22, 0x22};
+constexpr Color kSidebarText = {0x55, 0x55, 0x55};
+constexpr Color kTitleText = {0xe8, 0xe8, 0xe8};
+constexpr Color kButton = {0x35, 0x84, 0xe4};
+
+// xorshift32，保证同一种子生成相同的内容
+class Random {
+ public:
+  explicit Random(uint32_t seed) : state_(seed != 0 ? seed : 1) {}
+
+  uint32_t next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  int range(int lo, int hi) {
+    return lo + static_cast<int>(next() % static_cast<uint32_t>(hi - lo + 1));
+  }
+
+ private:
+  uint32_t state_;
+};
+
+class Canvas {
+ public:
+  explicit Canvas(BenchFrame* frame) : frame_(frame) {}
+
+  void fill(int x0, int y0, int x1, int y1, Color color, uint8_t alpha = 255) {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, static_cast<int>(frame_->width));
+    y1 = std::min(y1, static_cast<int>(frame_->height));
+    for (int y = y0; y < y1; ++y) {
+      for (int x = x0; x < x1; ++x) {
+        set(x, y, color, alpha);
+      }
+    }
+  }
+
+  // 以 coverage / 255 的覆盖率把 color 混合到 (x, y)
+  void blend(int x, int y, Color color, int coverage) {
+    if (x < 0 || y < 0 || x >= static_cast<int>(frame_->width) ||
+        y >= static_cast<int>(frame_->height)) {
+      return;
+    }
+    uint8_t* p = pixel(x, y);
+    p[0] = static_cast<uint8_t>((color.r * coverage + p[0] * (255 - coverage)) /
+                                255);
+    p[1] = static_cast<uint8_t>((color.g * coverage + p[1] * (255 - coverage)) /
+                                255);
+    p[2] = static_cast<uint8_t>((color.b * coverage + p[2] * (255 - coverage)) /
+                                255);
+  }
+
+  void set(int x, int y, Color color, uint8_t alpha) {
+    uint8_t* p = pixel(x, y);
+    p[0] = color.r;
+    p[1] = color.g;
+    p[2] = color.b;
+    if (frame_->channels == 4) {
+      p[3] = alpha;
+    }
+  }
+
+  void set_alpha(int x, int y, uint8_t alpha) {
+    if (frame_->channels == 4) {
+      pixel(x, y)[3] = alpha;
+    }
+  }
+
+ private:
+  uint8_t* pixel(int x, int y) {
+    return frame_->pixels.data() + static_cast<size_t>(y) * frame_->stride +
+           static_cast<size_t>(x) * frame_->channels;
+  }
+
+  BenchFrame* frame_;
+};
+
+// 一个字形：格子内 2~4 笔横竖笔画，笔画两侧一像素半覆盖，模拟抗锯齿
+void draw_glyph(Canvas* canvas, Random* random, int x, int y, int cell_width,
+                int cell_height, int stroke, Color color) {
+  int strokes = random->range(2, 4);
+  for (int i = 0; i < strokes; ++i) {
+    bool vertical = random->next() & 1;
+    int x0, y0, x1, y1;
+    if (vertical) {
+      x0 = x + random->range(0, cell_width - stroke);
+      x1 = x0 + stroke;
+      y0 = y + random->range(0, cell_height / 3);
+      y1 = y + random->range(cell_height * 2 / 3, cell_height);
+    } else {
+      y0 = y + random->range(0, cell_height - stroke);
+      y1 = y0 + stroke;
+      x0 = x + random->range(0, cell_width / 3);
+      x1 = x + random->range(cell_width * 2 / 3, cell_width);
+    }
+    for (int py = y0 - 1; py <= y1; ++py) {
+      for (int px = x0 - 1; px <= x1; ++px) {
+        bool inside = px >= x0 && px < x1 && py >= y0 && py < y1;
+        canvas->blend(px, py, color, inside ? 255 : 96);
+      }
+    }
+  }
+}
+
+// 从 (x, y) 起画一行文字，直到 max_x
+void draw_text_line(Canvas* canvas, Random* random, int x, int y, int max_x,
+                    int glyph_height, Color color) {
+  int cell_width = std::max(4, glyph_height * 9 / 14);
+  int stroke = std::max(1, glyph_height / 10);
+  int end = x + random->range((max_x - x) / 2, max_x - x);
+  while (x + cell_width < end) {
+    int word = random->range(2, 9);
+    for (int i = 0; i < word && x + cell_width < end; ++i) {
+      draw_glyph(canvas, random, x, y, cell_width - 1, glyph_height, stroke,
+                 color);
+      x += cell_width;
+    }
+    x += cell_width;
+  }
+}
+
+void draw_text_block(Canvas* canvas, Random* random, int x0, int y0, int x1,
+                     int y1, int glyph_height, Color color) {
+  int line_height = glyph_height * 16 / 10;
+  for (int y = y0; y + glyph_height < y1; y += line_height) {
+    // 偶尔空一行当作段落间隔
+    if (random->range(0, 7) == 0) {
+      continue;
+    }
+    draw_text_line(canvas, random, x0, y, x1, glyph_height, color);
+  }
+}
+
+// 平滑渐变叠加噪声，压缩率接近照片
+void draw_photo(Canvas* canvas, Random* random, int x0, int y0, int x1,
+                int y1) {
+  int width = std::max(1, x1 - x0);
+  int height = std::max(1, y1 - y0);
+  for (int y = y0; y < y1; ++y) {
+    for (int x = x0; x < x1; ++x) {
+      int u = (x - x0) * 255 / width;
+      int v = (y - y0) * 255 / height;
+      int noise = static_cast<int>(random->next() % 25) - 12;
+      Color color = {
+          static_cast<uint8_t>(std::min(255, std::max(0, u + noise))),
+          static_cast<uint8_t>(std::min(255, std::max(0, v + noise))),
+          static_cast<uint8_t>(
+              std::min(255, std::max(0, 255 - (u + v) / 2 + noise))),
+      };
+      canvas->set(x, y, color, 255);
+    }
+  }
+}
+
+}  // namespace
+
+BenchFrame bench_make_screenshot(const std::string& name, uint32_t width,
+                                 uint32_t height, int channels,
+                                 bool translucent, uint32_t seed) {
+  BenchFrame frame;
+  frame.name = name;
+  frame.width = width;
+  frame.height = height;
+  frame.channels = channels;
+  frame.stride = static_cast<size_t>(width) * channels;
+  frame.pixels.assign(frame.stride * height, 0);
+
+  Canvas canvas(&frame);
+  Random random(seed);
+  // 以 1080p 为基准按宽度缩放各部件
+  auto scaled = [width](int value) {
+    return std::max(1, static_cast<int>(value * static_cast<int64_t>(width) /
+                                        1920));
+  };
+  int w = static_cast<int>(width);
+  int h = static_cast<int>(height);
+
+  int margin = translucent ? scaled(24) : 0;
+  canvas.fill(0, 0, w, h, kDesktop, translucent ? 0 : 255);
+  int left = margin;
+  int top = margin;
+  int right = w - margin;
+  int bottom = h - margin;
+
+  int title_height = scaled(40);
+  int sidebar_width = scaled(280);
+  int glyph = scaled(14);
+  canvas.fill(left, top, right, top + title_height, kTitleBar);
+  draw_text_line(&canvas, &random, left + scaled(16), top + scaled(13),
+                 left + scaled(400), scaled(12), kTitleText);
+  canvas.fill(left, top + title_height, left + sidebar_width, bottom,
+              kSidebar);
+  draw_text_block(&canvas, &random, left + scaled(20),
+                  top + title_height + scaled(20),
+                  left + sidebar_width - scaled(20), bottom - scaled(20),
+                  glyph, kSidebarText);
+  canvas.fill(left + sidebar_width, top + title_height, right, bottom,
+              kContent);
+
+  int content_left = left + sidebar_width + scaled(32);
+  int photo_left = left + (right - left) * 62 / 100;
+  int photo_bottom = top + title_height + (bottom - top) * 45 / 100;
+  draw_photo(&canvas, &random, photo_left, top + title_height + scaled(32),
+             right - scaled(32), photo_bottom);
+  draw_text_block(&canvas, &random, content_left,
+                  top + title_height + scaled(32), photo_left - scaled(32),
+                  photo_bottom, glyph, kText);
+  draw_text_block(&canvas, &random, content_left, photo_bottom + scaled(32),
+                  right - scaled(32), bottom - scaled(96), glyph, kText);
+  for (int i = 0; i < 3; ++i) {
+    int x = right - scaled(32) - (i + 1) * scaled(140);
+    canvas.fill(x, bottom - scaled(72), x + scaled(120), bottom - scaled(36),
+                kButton);
+    draw_text_line(&canvas, &random, x + scaled(20), bottom - scaled(62),
+                   x + scaled(100), scaled(12), kContent);
+  }
+
+  if (translucent && channels == 4) {
+    // 窗口阴影：向外逐渐透明；四角圆角外完全透明
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        int dx = std::max({left - x, x - (right - 1), 0});
+        int dy = std::max({top - y, y - (bottom - 1), 0});
+        int distance = std::max(dx, dy);
+        if (distance > 0) {
+          canvas.set(x, y, Color{0, 0, 0},
+                     static_cast<uint8_t>(96 * (margin - distance) / margin));
+        }
+      }
+    }
+    int radius = scaled(12);
+    for (int y = 0; y < radius; ++y) {
+      for (int x = 0; x < radius; ++x) {
+        int ox = radius - x;
+        int oy = radius - y;
+        if (ox * ox + oy * oy > radius * radius) {
+          canvas.set_alpha(left + x, top + y, 0);
+          canvas.set_alpha(right - 1 - x, top + y, 0);
+          canvas.set_alpha(left + x, bottom - 1 - y, 0);
+          canvas.set_alpha(right - 1 - x, bottom - 1 - y, 0);
+        }
+      }
+    }
+  }
+  return frame;
+}
+
+bool bench_load_rgba(const std::string& spec, BenchFrame* frame) {
+  size_t colon = spec.rfind(':');
+  unsigned width = 0;
+  unsigned height = 0;
+  if (colon == std::string::npos ||
+      sscanf(spec.c_str() + colon + 1, "%ux%u", &width, &height) != 2 ||
+      width == 0 || height == 0) {
+    return false;
+  }
+  std::string path = spec.substr(0, colon);
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  frame->name = path.substr(path.rfind('/') + 1);
+  frame->width = width;
+  frame->height = height;
+  frame->channels = 4;
+  frame->stride = static_cast<size_t>(width) * 4;
+  frame->pixels.resize(frame->stride * height);
+  size_t read = fread(frame->pixels.data(), 1, frame->pixels.size(), file);
+  fclose(file);
+  return read == frame->pixels.size();
+}
+
+double bench_median_ms(int iterations, const std::function<void()>& fn) {
+  fn();
+  std::vector<double> samples;
+  for (int i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    samples.push_back(std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count());
+  }
+  std::sort(samples.begin(), samples.end());
+  return samples.empty() ? 0 : samples[samples.size() / 2];
+}
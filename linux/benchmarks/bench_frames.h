@@ -0,0 +1,37 @@
+#ifndef CLIP_FLOW_BENCH_FRAMES_H_
+#define CLIP_FLOW_BENCH_FRAMES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 基准测试共用的图像夹具与计时工具。
+//
+// 合成截图由纯色窗口、侧栏、按钮、抗锯齿的文字行和一块带噪声的照片区域
+// 组成，内容由种子决定，多次运行结果可比。也可以读取原始 RGBA 文件
+// （如由真实截图转换得到），按“路径:宽x高”给出。
+
+struct BenchFrame {
+  std::string name;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  int channels = 4;
+  size_t stride = 0;
+  std::vector<uint8_t> pixels;
+};
+
+// 生成 width x height 的合成截图；translucent 为 true 时
+// 外圈阴影与圆角处的像素带透明度（仅 channels = 4）
+BenchFrame bench_make_screenshot(const std::string& name, uint32_t width,
+                                 uint32_t height, int channels,
+                                 bool translucent, uint32_t seed = 1);
+
+// 读取 “路径:宽x高” 形式的原始 RGBA 文件，失败时返回 false
+bool bench_load_rgba(const std::string& spec, BenchFrame* frame);
+
+// 先预热一次，再执行 iterations 次，返回耗时中位数（毫秒）
+double bench_median_ms(int iterations, const std::function<void()>& fn);
+
+#endif  // CLIP_FLOW_BENCH_FRAMES_H_
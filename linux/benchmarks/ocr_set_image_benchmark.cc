@@ -0,0 +1,121 @@
+// 把 RGBA 截图交给 Tesseract 的两种方式的耗时对比：
+//   pix copy — 逐像素复制为 32 bpp Leptonica PIX 后 SetImage(PIX*)（旧做法）
+//   direct   — 透明度检查（需要时合成白底）后按原行跨度 SetImage(data, ...)
+// 计时只包含准备像素与 SetImage，不含识别。
+//
+// 用法：ocr_set_image_benchmark [--iterations N] [--lang eng]
+//                               [--tessdata 目录] [路径:宽x高 ...]
+// 不给出文件时使用 1080p / 4K / 8K 的合成截图，各含不透明与带透明度两种。
+
+#include <leptonica/allheaders.h>
+#include <tesseract/baseapi.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "bench_frames.h"
+#include "ocr_image.h"
+
+namespace {
+
+void set_image_pix_copy(tesseract::TessBaseAPI* api, const BenchFrame& frame) {
+  PIX* pix = pixCreate(frame.width, frame.height, 32);
+  l_uint32* data = pixGetData(pix);
+  int wpl = pixGetWpl(pix);
+  for (uint32_t y = 0; y < frame.height; ++y) {
+    const uint8_t* row = frame.pixels.data() + y * frame.stride;
+    l_uint32* line = data + static_cast<size_t>(y) * wpl;
+    for (uint32_t x = 0; x < frame.width; ++x) {
+      const uint8_t* p = row + x * frame.channels;
+      composeRGBPixel(p[0], p[1], p[2], line + x);
+    }
+  }
+  api->SetImage(pix);
+  pixDestroy(&pix);
+}
+
+void set_image_direct(tesseract::TessBaseAPI* api, const BenchFrame& frame,
+                      std::vector<uint8_t>* flattened) {
+  const uint8_t* data = frame.pixels.data();
+  size_t stride = frame.stride;
+  if (frame.channels == 4 &&
+      ocr_image_has_transparency(data, frame.width, frame.height, stride)) {
+    stride = static_cast<size_t>(frame.width) * 4;
+    flattened->resize(stride * frame.height);
+    ocr_image_flatten_alpha(data, frame.width, frame.height, frame.stride,
+                            flattened->data(), stride);
+    data = flattened->data();
+  }
+  api->SetImage(data, frame.width, frame.height, frame.channels,
+                static_cast<int>(stride));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = 5;
+  const char* lang = "eng";
+  const char* tessdata = nullptr;
+  std::vector<BenchFrame> frames;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = std::max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--lang") == 0 && i + 1 < argc) {
+      lang = argv[++i];
+    } else if (strcmp(argv[i], "--tessdata") == 0 && i + 1 < argc) {
+      tessdata = argv[++i];
+    } else {
+      BenchFrame frame;
+      if (!bench_load_rgba(argv[i], &frame)) {
+        fprintf(stderr, "cannot load %s (expected path:WIDTHxHEIGHT)\n",
+                argv[i]);
+        return 1;
+      }
+      frames.push_back(std::move(frame));
+    }
+  }
+  if (frames.empty()) {
+    const struct {
+      const char* name;
+      uint32_t width;
+      uint32_t height;
+    } sizes[] = {
+        {"1080p", 1920, 1080},
+        {"4k", 3840, 2160},
+        {"8k", 7680, 4320},
+    };
+    for (const auto& size : sizes) {
+      frames.push_back(bench_make_screenshot(
+          std::string(size.name) + " opaque", size.width, size.height, 4,
+          false));
+      frames.push_back(bench_make_screenshot(
+          std::string(size.name) + " translucent", size.width, size.height, 4,
+          true));
+    }
+  }
+
+  tesseract::TessBaseAPI api;
+  if (api.Init(tessdata, lang) != 0) {
+    fprintf(stderr, "cannot initialize tesseract for language %s\n", lang);
+    return 1;
+  }
+
+  printf("%-20s %11s %14s %14s\n", "frame", "size", "pix copy ms",
+         "direct ms");
+  std::vector<uint8_t> flattened;
+  for (const BenchFrame& frame : frames) {
+    double copy_ms = bench_median_ms(
+        iterations, [&api, &frame]() { set_image_pix_copy(&api, frame); });
+    double direct_ms =
+        bench_median_ms(iterations, [&api, &frame, &flattened]() {
+          set_image_direct(&api, frame, &flattened);
+        });
+    printf("%-20s %5ux%-5u %14.1f %14.1f\n", frame.name.c_str(), frame.width,
+           frame.height, copy_ms, direct_ms);
+  }
+  api.End();
+  return 0;
+}
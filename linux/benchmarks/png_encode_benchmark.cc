@@ -0,0 +1,97 @@
+// gdk-pixbuf 自带的 PNG 编码与 png_encoder 各档位的耗时和体积对比。
+//
+// 用法：png_encode_benchmark [--iterations N] [路径:宽x高 ...]
+// 不给出文件时使用 1080p / 1440p / 4K 的合成截图。
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "bench_frames.h"
+#include "png_encoder.h"
+
+namespace {
+
+void print_row(const BenchFrame& frame, const char* encoder, double ms,
+               size_t bytes) {
+  printf("%-24s %5ux%-5u %-22s %9.1f %10.1f\n", frame.name.c_str(),
+         frame.width, frame.height, encoder, ms, bytes / 1024.0);
+}
+
+void run_frame(const BenchFrame& frame, int iterations) {
+  GdkPixbuf* pixbuf = gdk_pixbuf_new_from_data(
+      frame.pixels.data(), GDK_COLORSPACE_RGB, frame.channels == 4, 8,
+      frame.width, frame.height, static_cast<int>(frame.stride), nullptr,
+      nullptr);
+  size_t bytes = 0;
+  double ms = bench_median_ms(iterations, [pixbuf, &bytes]() {
+    gchar* buffer = nullptr;
+    gsize size = 0;
+    if (gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &size, "png", nullptr,
+                                  nullptr)) {
+      bytes = size;
+      g_free(buffer);
+    }
+  });
+  print_row(frame, "gdk-pixbuf", ms, bytes);
+  g_object_unref(pixbuf);
+
+  struct Variant {
+    const char* name;
+    PngEncodeProfile profile;
+    unsigned threads;
+  };
+  const Variant variants[] = {
+      {"png_encode fast x1", PNG_ENCODE_FAST, 1},
+      {"png_encode fast", PNG_ENCODE_FAST, 0},
+      {"png_encode balanced", PNG_ENCODE_BALANCED, 0},
+      {"png_encode small", PNG_ENCODE_SMALL, 0},
+  };
+  for (const Variant& variant : variants) {
+    std::vector<uint8_t> png;
+    ms = bench_median_ms(iterations, [&frame, &variant, &png]() {
+      png_encode(frame.pixels.data(), frame.width, frame.height, frame.stride,
+                 frame.channels, variant.profile, &png, variant.threads);
+    });
+    print_row(frame, variant.name, ms, png.size());
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = 5;
+  std::vector<BenchFrame> frames;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = std::max(1, atoi(argv[++i]));
+      continue;
+    }
+    BenchFrame frame;
+    if (!bench_load_rgba(argv[i], &frame)) {
+      fprintf(stderr, "cannot load %s (expected path:WIDTHxHEIGHT)\n",
+              argv[i]);
+      return 1;
+    }
+    frames.push_back(std::move(frame));
+  }
+  if (frames.empty()) {
+    frames.push_back(bench_make_screenshot("screenshot-1080p", 1920, 1080, 4,
+                                           false));
+    frames.push_back(bench_make_screenshot("screenshot-1440p", 2560, 1440, 4,
+                                           false));
+    frames.push_back(bench_make_screenshot("screenshot-4k", 3840, 2160, 4,
+                                           false));
+  }
+
+  printf("%-24s %11s %-22s %9s %10s\n", "frame", "size", "encoder",
+         "median ms", "KiB");
+  for (const BenchFrame& frame : frames) {
+    run_frame(frame, iterations);
+  }
+  return 0;
+}
@@ -6,12 +6,118 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <fstream>
-#include <sstream>
+#include <functional>
+#include <iterator>
+#include <map>
 #include <tesseract/baseapi.h>
-#include <leptonica/allheaders.h>
 #include <gdk-pixbuf/gdk-pixbuf.h>
+#ifdef GDK_WINDOWING_X11
+#include <gdk/gdkx.h>
+#endif
+
+#include "clipboard_reader.h"
+#include "clipboard_snapshot.h"
+#include "clipboard_stream.h"
+#include "clipboard_worker.h"
+#include "content_hash.h"
+#include "dedup_index.h"
+#include "file_ingest.h"
+#include "file_metadata.h"
+#include "image_hash_index.h"
+#include "image_scale.h"
+#include "media_store.h"
+#include "ocr_cache.h"
+#include "ocr_engine_pool.h"
+#include "ocr_jobs.h"
+#include "ocr_recognizer.h"
+#include "perceptual_hash.h"
+#include "png_encoder.h"
+#include "text_delta.h"
+#include "text_similarity.h"
+#include "uri_list.h"
+
+// 当前剪贴板所有者提供的 TARGETS 集合
+struct ClipboardTargets {
+  std::vector<GdkAtom> atoms;
+
+  bool contains(GdkAtom atom) const {
+    return std::find(atoms.begin(), atoms.end(), atom) != atoms.end();
+  }
+  bool contains(const gchar* name) const {
+    return contains(gdk_atom_intern_static_string(name));
+  }
+  bool has_image() const {
+    return gtk_targets_include_image(const_cast<GdkAtom*>(atoms.data()),
+                                     atoms.size(), FALSE);
+  }
+  bool has_text() const {
+    return gtk_targets_include_text(const_cast<GdkAtom*>(atoms.data()),
+                                    atoms.size());
+  }
+};
+
+using ClipboardTargetsReadyCallback =
+    std::function<void(ClipboardReadStatus status,
+                       const ClipboardTargets& targets)>;
+
+// 快照缓存的内存上限
+static const gsize kSnapshotMaxBytes = 64 * 1024 * 1024;
+
+// 增量还原缓存的容量
+static const size_t kDeltaCacheMaxBytes = 16 * 1024 * 1024;
+
+// 需要 C++ 构造/析构的插件状态
+struct ClipboardPluginState {
+  // 当前剪贴板状态下已读取的格式数据，供各方法共享
+  ClipboardSnapshotCache snapshot{kSnapshotMaxBytes};
+
+  // 每个所有者只请求一次 TARGETS；owner-change 时失效
+  ClipboardTargets targets;
+  bool targets_valid = false;
+  gint64 targets_fetched_at = 0;
+  bool targets_fetching = false;
+  guint targets_generation = 0;
+  std::vector<ClipboardTargetsReadyCallback> targets_waiters;
+
+  // 等待当前（或排队中）刷新完成的调用方
+  std::vector<std::function<void()>> refresh_waiters;
+  std::vector<std::function<void()>> queued_waiters;
+
+  // 进行中的大负载流式传输，按 streamId 索引
+  std::map<gint, std::unique_ptr<ClipboardStream>> streams;
+  gint next_stream_id = 1;
+
+  // 内容哈希 → 剪贴项 ID，由 Dart 侧在启动时加载并随增删同步
+  DedupIndex dedup_index;
+  // 剪贴项 ID → 图像感知哈希，用于近似重复检测
+  ImageHashIndex image_hash_index;
+  // 剪贴项 ID → 文本 MinHash 签名；清空时递增代数，丢弃清空前发起的写入
+  TextSimilarityIndex text_index;
+  guint text_index_generation = 0;
+
+  // 增量存储文本的还原结果（ID 即内容哈希，缓存不会过期）
+  TextReconstructionCache delta_cache{kDeltaCacheMaxBytes};
+
+  // 进行中的文件导入，按 Dart 分配的 jobId 索引取消标志
+  std::map<gint64, std::shared_ptr<std::atomic<bool>>> ingest_jobs;
+
+  // 插件销毁时置位，进行中的文件元数据采集随之停止
+  std::shared_ptr<std::atomic<bool>> disposed =
+      std::make_shared<std::atomic<bool>>(false);
+
+  // 已初始化的 OCR 引擎，工作线程借出时持有引用
+  std::shared_ptr<OcrEnginePool> ocr_engines =
+      std::make_shared<OcrEnginePool>();
+
+  // 进行中的 OCR 任务
+  OcrJobTable ocr_jobs;
+
+  // OCR 结果缓存；Dart 侧经 configureOcrEngines 给出目录后启用
+  std::shared_ptr<OcrCache> ocr_cache;
+};
 
 #define CLIPBOARD_PLUGIN(obj) \
   (G_TYPE_CHECK_INSTANCE_CAST((obj), clipboard_plugin_get_type(), \
@@ -19,25 +125,638 @@
 
 struct _ClipboardPlugin {
   GObject parent_instance;
+
+  // 流式传输使用的二进制消息通道
+  FlBinaryMessenger* messenger;
+
+  // 剪贴板变化事件通道（owner-change → Dart）
+  FlEventChannel* event_channel;
+  gboolean event_listening;
+
+  // 文件导入进度事件通道
+  FlEventChannel* ingest_event_channel;
+  gboolean ingest_listening;
+
+  // 文件元数据分块事件通道
+  FlEventChannel* file_info_event_channel;
+  gboolean file_info_listening;
+
+  // 空闲 OCR 引擎的定期回收
+  guint ocr_evict_source_id;
+
+  // OCR 缓存的延迟写盘
+  guint ocr_cache_flush_source_id;
+
+  // 监听 CLIPBOARD 选区的 owner-change 信号（底层为 XFixes 选区事件）。
+  // 仅在 Dart 订阅变化事件期间连接，其余时间按轮询路径重新计算指纹
+  GtkClipboard* clipboard;
+  gulong owner_change_handler_id;
+  gboolean owner_change_supported;
+
+  // 插件级剪贴板序列号及最近一次变化时间（毫秒）
+  // 仅在选区所有者或内容指纹变化时推进
+  gint64 sequence;
+  gint64 last_change_time;
+
+  // 上一次观察到的剪贴板状态
+  guint64 owner_id;
+  guint32 acquisition_time;
+  guint64 fingerprint;
+  gboolean fingerprint_strong;
+  gboolean has_state;
+
+  // 异步刷新状态：刷新进行中再次触发时排队合并
+  gboolean refreshing;
+  gboolean refresh_queued;
+  guint64 queued_owner_id;
+  guint32 queued_acquisition_time;
+  const gchar* change_reason;
+  ClipboardPluginState* state;
 };
 
 G_DEFINE_TYPE(ClipboardPlugin, clipboard_plugin, g_object_get_type())
 
 // Forward declarations
-static void get_clipboard_formats(FlMethodCall* method_call);
+static void get_clipboard_formats(ClipboardPlugin* self,
+                                  FlMethodCall* method_call);
 static void clipboard_plugin_handle_method_call(
     ClipboardPlugin* self,
     FlMethodCall* method_call);
 
+// 事件通道的回调以裸指针引用插件（插件持有通道，反向持有会形成循环引用），
+// 释放通道前先撤下回调
+static void clear_event_channel(FlEventChannel** channel) {
+  if (*channel != nullptr) {
+    fl_event_channel_set_stream_handlers(*channel, nullptr, nullptr, nullptr,
+                                         nullptr);
+  }
+  g_clear_object(channel);
+}
+
 static void clipboard_plugin_dispose(GObject* object) {
+  ClipboardPlugin* self = CLIPBOARD_PLUGIN(object);
+
+  if (self->clipboard != nullptr && self->owner_change_handler_id != 0) {
+    g_signal_handler_disconnect(self->clipboard, self->owner_change_handler_id);
+    self->owner_change_handler_id = 0;
+  }
+  self->clipboard = nullptr;
+  clear_event_channel(&self->event_channel);
+  clear_event_channel(&self->ingest_event_channel);
+  clear_event_channel(&self->file_info_event_channel);
+  if (self->ocr_evict_source_id != 0) {
+    g_source_remove(self->ocr_evict_source_id);
+    self->ocr_evict_source_id = 0;
+  }
+  if (self->ocr_cache_flush_source_id != 0) {
+    g_source_remove(self->ocr_cache_flush_source_id);
+    self->ocr_cache_flush_source_id = 0;
+  }
+  if (self->state != nullptr && self->state->ocr_cache != nullptr) {
+    // 退出前写入尚未落盘的缓存，文件很小，直接在主线程完成
+    self->state->ocr_cache->save();
+  }
+  if (self->state != nullptr) {
+    self->state->streams.clear();
+    for (auto& job : self->state->ingest_jobs) {
+      job.second->store(true);
+    }
+    self->state->disposed->store(true);
+    self->state->ocr_jobs.cancel_all();
+  }
+  g_clear_object(&self->messenger);
+
   G_OBJECT_CLASS(clipboard_plugin_parent_class)->dispose(object);
 }
 
+static void clipboard_plugin_finalize(GObject* object) {
+  ClipboardPlugin* self = CLIPBOARD_PLUGIN(object);
+  delete self->state;
+  self->state = nullptr;
+
+  G_OBJECT_CLASS(clipboard_plugin_parent_class)->finalize(object);
+}
+
 static void clipboard_plugin_class_init(ClipboardPluginClass* klass) {
   G_OBJECT_CLASS(klass)->dispose = clipboard_plugin_dispose;
+  G_OBJECT_CLASS(klass)->finalize = clipboard_plugin_finalize;
+}
+
+static void clipboard_plugin_init(ClipboardPlugin* self) {
+  self->messenger = nullptr;
+  self->event_channel = nullptr;
+  self->event_listening = FALSE;
+  self->ingest_event_channel = nullptr;
+  self->ingest_listening = FALSE;
+  self->file_info_event_channel = nullptr;
+  self->file_info_listening = FALSE;
+  self->ocr_evict_source_id = 0;
+  self->ocr_cache_flush_source_id = 0;
+  self->clipboard = nullptr;
+  self->owner_change_handler_id = 0;
+  self->owner_change_supported = FALSE;
+  self->sequence = 0;
+  self->last_change_time = g_get_real_time() / 1000;
+  self->owner_id = 0;
+  self->acquisition_time = 0;
+  self->fingerprint = 0;
+  self->fingerprint_strong = FALSE;
+  self->has_state = FALSE;
+  self->refreshing = FALSE;
+  self->refresh_queued = FALSE;
+  self->queued_owner_id = 0;
+  self->queued_acquisition_time = 0;
+  self->change_reason = "new_owner";
+  self->state = new ClipboardPluginState();
+}
+
+// 异步处理期间持有 GObject 引用，回调链释放时自动 unref
+template <typename T>
+static std::shared_ptr<T> hold_object(T* object) {
+  return std::shared_ptr<T>(static_cast<T*>(g_object_ref(object)),
+                            g_object_unref);
+}
+
+// 从方法参数中读取整数；参数缺失或类型不符时返回默认值
+static gint64 get_int_arg(FlMethodCall* method_call, const gchar* key,
+                          gint64 default_value) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return default_value;
+  }
+  FlValue* value = fl_value_lookup_string(args, key);
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_INT) {
+    return default_value;
+  }
+  return fl_value_get_int(value);
+}
+
+// 从方法参数中读取布尔值；参数缺失或类型不符时返回默认值
+static bool get_bool_arg(FlMethodCall* method_call, const gchar* key,
+                         bool default_value) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return default_value;
+  }
+  FlValue* value = fl_value_lookup_string(args, key);
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_BOOL) {
+    return default_value;
+  }
+  return fl_value_get_bool(value);
+}
+
+// 从方法参数中读取字符串；参数缺失或类型不符时返回 nullptr
+static const gchar* get_string_arg(FlMethodCall* method_call,
+                                   const gchar* key) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+  FlValue* value = fl_value_lookup_string(args, key);
+  return value != nullptr && fl_value_get_type(value) == FL_VALUE_TYPE_STRING
+             ? fl_value_get_string(value)
+             : nullptr;
+}
+
+// 单次读取超时，可由 Dart 通过 timeoutMs 参数覆盖
+static guint get_read_timeout(FlMethodCall* method_call) {
+  gint64 timeout_ms =
+      get_int_arg(method_call, "timeoutMs", kClipboardReadTimeoutMs);
+  return static_cast<guint>(CLAMP(timeout_ms, 50, 30000));
+}
+
+// 需要重新编码时使用的 PNG 档位，可由 Dart 通过 pngProfile 参数选择。
+// 默认速度优先：截图之后可在后台以 small 档位重新压缩
+static PngEncodeProfile get_png_profile(FlMethodCall* method_call) {
+  PngEncodeProfile profile = PNG_ENCODE_FAST;
+  png_encode_profile_from_name(get_string_arg(method_call, "pngProfile"),
+                               &profile);
+  return profile;
+}
+
+static void respond_read_timeout(FlMethodCall* method_call) {
+  fl_method_call_respond_error(method_call, "TIMEOUT",
+                               "Clipboard owner did not respond in time",
+                               nullptr, nullptr);
+}
+
+// 没有选区获取时间可用时探测内容的文本格式，只读取第一个存在的格式
+static const gchar* const kFingerprintProbeTargets[] = {
+  "UTF8_STRING", "text/plain;charset=utf-8", "text/uri-list",
+};
+
+// 探测内容只有前这么多字节参与哈希（另计总长度）
+static const gsize kFingerprintMaxBytes = 256 * 1024;
+
+// 当前是否由 owner-change 信号驱动序列号；未订阅时走轮询路径
+static bool tracking_owner_change(ClipboardPlugin* self) {
+  return self->owner_change_handler_id != 0;
+}
+
+// 无选区通知时（轮询路径）缓存的 TARGETS 最长有效期（微秒）
+static const gint64 kTargetsCacheMaxAgeUs = 1000 * 1000;
+
+static void invalidate_clipboard_targets(ClipboardPlugin* self) {
+  self->state->targets_valid = false;
+  self->state->targets_generation++;
+}
+
+// 获取当前所有者的 TARGETS：命中缓存时直接回调，否则发起一次请求，
+// 并发的调用方共享同一次往返。
+static void with_clipboard_targets(ClipboardPlugin* self, guint timeout_ms,
+                                   ClipboardTargetsReadyCallback callback) {
+  ClipboardPluginState* state = self->state;
+  bool expired = !tracking_owner_change(self) &&
+                 g_get_monotonic_time() - state->targets_fetched_at >
+                     kTargetsCacheMaxAgeUs;
+  if (state->targets_valid && !expired) {
+    callback(CLIPBOARD_READ_OK, state->targets);
+    return;
+  }
+
+  state->targets_waiters.push_back(std::move(callback));
+  if (state->targets_fetching) {
+    return;
+  }
+  state->targets_fetching = true;
+
+  auto plugin = hold_object(self);
+  guint generation = state->targets_generation;
+  clipboard_read_targets(self->clipboard, timeout_ms, [plugin, generation](
+      ClipboardReadStatus status, GdkAtom* atoms, gint n_atoms) {
+    ClipboardPluginState* state = plugin->state;
+    state->targets_fetching = false;
+    state->targets.atoms.assign(atoms, atoms + n_atoms);
+    // 超时或请求期间所有者已变化时不缓存，下次调用重新请求
+    state->targets_valid = status != CLIPBOARD_READ_TIMEOUT &&
+                           generation == state->targets_generation;
+    state->targets_fetched_at = g_get_monotonic_time();
+
+    std::vector<ClipboardTargetsReadyCallback> waiters;
+    waiters.swap(state->targets_waiters);
+    for (auto& waiter : waiters) {
+      waiter(status, state->targets);
+    }
+  });
+}
+
+// 内容指纹计算结果
+struct ClipboardFingerprint {
+  guint64 value = 0;
+  gboolean strong = FALSE;
+  guint32 acquisition_time = 0;
+};
+
+// 读取 TIMESTAMP 目标，即所有者获取选区的时间；不可用时回调 0
+static void read_acquisition_time(GtkClipboard* clipboard,
+                                  const ClipboardTargets& targets,
+                                  std::function<void(guint32)> done) {
+  GdkAtom timestamp_target = gdk_atom_intern_static_string("TIMESTAMP");
+  if (!targets.contains(timestamp_target)) {
+    done(0);
+    return;
+  }
+  clipboard_read_contents(clipboard, timestamp_target, kClipboardReadTimeoutMs,
+      [done](ClipboardReadStatus status, GBytes* bytes) {
+        gsize length = 0;
+        const guchar* data = bytes != nullptr
+            ? static_cast<const guchar*>(g_bytes_get_data(bytes, &length))
+            : nullptr;
+        guint32 time = 0;
+        // X 协议 32 位格式的数据在客户端以 long 存放
+        if (data != nullptr && length >= sizeof(long)) {
+          time = static_cast<guint32>(*reinterpret_cast<const long*>(data));
+        } else if (data != nullptr && length >= sizeof(guint32)) {
+          time = *reinterpret_cast<const guint32*>(data);
+        }
+        done(time);
+      });
+}
+
+// 计算剪贴板指纹，只在无法得到所有者身份时才读取内容：
+// 1. TARGETS 列表总是参与指纹；
+// 2. 选区获取时间（owner-change 事件给出的 acquisition_time，或 TIMESTAMP
+//    目标）可用时，它与所有者一起标识这一次复制，不读取任何格式的内容，
+//    指纹为“弱指纹”，由获取时间判断是否变化；
+// 3. 否则（如轮询路径且所有者不提供 TIMESTAMP）只探测一个文本格式，
+//    其前 kFingerprintMaxBytes 字节与总长度参与哈希，得到“强指纹”。
+static void compute_clipboard_fingerprint(
+    ClipboardPlugin* self,
+    guint32 acquisition_time,
+    std::function<void(const ClipboardFingerprint&)> done) {
+  GtkClipboard* clipboard = self->clipboard;
+  auto plugin = hold_object(self);
+  with_clipboard_targets(self, kClipboardReadTimeoutMs,
+      [clipboard, plugin, acquisition_time, done](
+          ClipboardReadStatus status, const ClipboardTargets& targets) {
+    auto result = std::make_shared<ClipboardFingerprint>();
+    if (status != CLIPBOARD_READ_OK) {
+      done(*result);
+      return;
+    }
+
+    std::vector<std::string> names;
+    names.reserve(targets.atoms.size());
+    for (GdkAtom atom : targets.atoms) {
+      gchar* name = gdk_atom_name(atom);
+      if (name != nullptr) {
+        names.emplace_back(name);
+        g_free(name);
+      }
+    }
+    std::sort(names.begin(), names.end());
+
+    for (const auto& name : names) {
+      result->value = content_hash_combine(
+          result->value, content_hash_xxh64(name.data(), name.size()));
+    }
+
+    if (acquisition_time != 0) {
+      result->acquisition_time = acquisition_time;
+      done(*result);
+      return;
+    }
+
+    const gchar* probe_target = nullptr;
+    for (const gchar* target : kFingerprintProbeTargets) {
+      if (targets.contains(target)) {
+        probe_target = target;
+        break;
+      }
+    }
+
+    read_acquisition_time(clipboard, targets,
+        [clipboard, plugin, probe_target, result, done](guint32 time) {
+      result->acquisition_time = time;
+      if (time != 0 || probe_target == nullptr) {
+        done(*result);
+        return;
+      }
+
+      // 读到的内容同时写入快照缓存，随后的 getClipboardFormats 可直接复用
+      guint epoch = plugin->state->snapshot.epoch();
+      clipboard_read_contents(clipboard,
+          gdk_atom_intern_static_string(probe_target), kClipboardReadTimeoutMs,
+          [plugin, epoch, probe_target, result, done](
+              ClipboardReadStatus status, GBytes* bytes) {
+            if (status != CLIPBOARD_READ_TIMEOUT) {
+              plugin->state->snapshot.store(epoch, probe_target, bytes);
+            }
+            gsize length = 0;
+            const void* data =
+                bytes != nullptr ? g_bytes_get_data(bytes, &length) : nullptr;
+            if (data != nullptr) {
+              guint64 content = content_hash_combine(
+                  length,
+                  content_hash_xxh64(data, MIN(length, kFingerprintMaxBytes)));
+              result->value = content_hash_combine(result->value, content);
+              result->strong = TRUE;
+            }
+            done(*result);
+          });
+    });
+  });
+}
+
+static void send_clipboard_change_event(ClipboardPlugin* self,
+                                        const gchar* reason);
+
+// 根据新指纹更新状态，仅在所有者或内容指纹变化时推进序列号。
+// owner_id / acquisition_time 为 0 时表示调用方无法提供（轮询路径）。
+static gboolean apply_clipboard_fingerprint(
+    ClipboardPlugin* self,
+    guint64 owner_id,
+    guint32 acquisition_time,
+    const ClipboardFingerprint& fingerprint) {
+  if (acquisition_time == 0) {
+    acquisition_time = fingerprint.acquisition_time;
+  }
+
+  gboolean changed;
+  if (!self->has_state) {
+    changed = TRUE;
+  } else if (owner_id != 0 && owner_id != self->owner_id) {
+    changed = TRUE;
+  } else if (fingerprint.value != self->fingerprint) {
+    changed = TRUE;
+  } else {
+    // 弱指纹无法证明内容未变，退回到选区获取时间判断
+    changed = !fingerprint.strong && acquisition_time != self->acquisition_time;
+  }
+
+  if (owner_id != 0) {
+    self->owner_id = owner_id;
+  }
+  self->acquisition_time = acquisition_time;
+  self->fingerprint = fingerprint.value;
+  self->fingerprint_strong = fingerprint.strong;
+
+  if (changed) {
+    self->sequence++;
+    self->state->ocr_jobs.supersede(self->sequence);
+    self->last_change_time = g_get_real_time() / 1000;
+    self->has_state = TRUE;
+    // 有选区通知时快照已在 owner-change 时清空，期间读到的即为新内容
+    if (!tracking_owner_change(self)) {
+      self->state->snapshot.reset(self->sequence);
+    }
+  }
+  return changed;
+}
+
+// 异步重新观察剪贴板状态，完成后调用 done（可为空）。
+// 刷新进行中再次触发时，合并为一次排队刷新。
+static void refresh_clipboard_state(ClipboardPlugin* self,
+                                    guint64 owner_id,
+                                    guint32 acquisition_time,
+                                    std::function<void()> done) {
+  if (self->refreshing) {
+    self->refresh_queued = TRUE;
+    if (owner_id != 0) {
+      self->queued_owner_id = owner_id;
+    }
+    if (acquisition_time != 0) {
+      self->queued_acquisition_time = acquisition_time;
+    }
+    if (done) {
+      self->state->queued_waiters.push_back(std::move(done));
+    }
+    return;
+  }
+
+  self->refreshing = TRUE;
+  if (done) {
+    self->state->refresh_waiters.push_back(std::move(done));
+  }
+
+  // 刷新由所有者变化或轮询触发，TARGETS 需要重新获取
+  invalidate_clipboard_targets(self);
+
+  auto plugin = hold_object(self);
+  compute_clipboard_fingerprint(self, acquisition_time,
+      [plugin, owner_id, acquisition_time](
+          const ClipboardFingerprint& fingerprint) {
+        ClipboardPlugin* self = plugin.get();
+        if (apply_clipboard_fingerprint(self, owner_id, acquisition_time,
+                                        fingerprint)) {
+          send_clipboard_change_event(self, self->change_reason);
+        }
+        self->refreshing = FALSE;
+
+        std::vector<std::function<void()>> waiters;
+        waiters.swap(self->state->refresh_waiters);
+
+        if (self->refresh_queued) {
+          self->refresh_queued = FALSE;
+          guint64 queued_owner_id = self->queued_owner_id;
+          guint32 queued_acquisition_time = self->queued_acquisition_time;
+          self->queued_owner_id = 0;
+          self->queued_acquisition_time = 0;
+
+          std::vector<std::function<void()>> queued;
+          queued.swap(self->state->queued_waiters);
+          auto shared_queued =
+              std::make_shared<std::vector<std::function<void()>>>(
+                  std::move(queued));
+          refresh_clipboard_state(self, queued_owner_id,
+                                  queued_acquisition_time,
+                                  [shared_queued]() {
+                                    for (auto& waiter : *shared_queued) {
+                                      waiter();
+                                    }
+                                  });
+        }
+
+        for (auto& waiter : waiters) {
+          waiter();
+        }
+      });
+}
+
+static guint64 owner_change_owner_id(GdkEvent* event) {
+  if (event == nullptr || event->owner_change.owner == nullptr) {
+    return 0;
+  }
+#ifdef GDK_WINDOWING_X11
+  if (GDK_IS_X11_WINDOW(event->owner_change.owner)) {
+    return gdk_x11_window_get_xid(event->owner_change.owner);
+  }
+#endif
+  return GPOINTER_TO_SIZE(event->owner_change.owner);
+}
+
+// 向 Dart 推送一次剪贴板变化事件
+static void send_clipboard_change_event(ClipboardPlugin* self,
+                                        const gchar* reason) {
+  if (!self->event_listening || self->event_channel == nullptr) {
+    return;
+  }
+
+  g_autoptr(FlValue) event = fl_value_new_map();
+  fl_value_set_string_take(event, "sequence", fl_value_new_int(self->sequence));
+  fl_value_set_string_take(event, "timestamp",
+                           fl_value_new_int(self->last_change_time));
+  fl_value_set_string_take(event, "reason", fl_value_new_string(reason));
+
+  g_autoptr(GError) error = nullptr;
+  if (!fl_event_channel_send(self->event_channel, event, nullptr, &error)) {
+    g_warning("Failed to send clipboard change event: %s",
+              error ? error->message : "unknown");
+  }
+}
+
+static void clipboard_owner_change_cb(GtkClipboard* clipboard,
+                                      GdkEvent* event,
+                                      gpointer user_data) {
+  ClipboardPlugin* self = CLIPBOARD_PLUGIN(user_data);
+
+  const gchar* reason = "new_owner";
+  if (event != nullptr) {
+    switch (event->owner_change.reason) {
+      case GDK_OWNER_CHANGE_DESTROY:
+        reason = "destroy";
+        break;
+      case GDK_OWNER_CHANGE_CLOSE:
+        reason = "close";
+        break;
+      default:
+        break;
+    }
+  }
+
+  guint64 owner_id = owner_change_owner_id(event);
+  guint32 acquisition_time =
+      event != nullptr ? event->owner_change.selection_time : 0;
+  // 变化事件在异步刷新完成、确认序列号推进后发送
+  invalidate_clipboard_targets(self);
+  self->state->snapshot.reset(self->sequence);
+  self->change_reason = reason;
+  refresh_clipboard_state(self, owner_id, acquisition_time, nullptr);
+}
+
+static FlMethodErrorResponse* clipboard_events_listen_cb(FlEventChannel* channel,
+                                                         FlValue* args,
+                                                         gpointer user_data) {
+  ClipboardPlugin* self = CLIPBOARD_PLUGIN(user_data);
+
+  // 显示服务器不支持选区通知时（如部分 Wayland 会话），让 Dart 回退到轮询
+  if (!self->owner_change_supported) {
+    return fl_method_error_response_new(
+        "UNSUPPORTED", "Clipboard owner-change notifications are unavailable",
+        nullptr);
+  }
+
+  if (self->owner_change_handler_id == 0) {
+    self->owner_change_handler_id =
+        g_signal_connect(self->clipboard, "owner-change",
+                         G_CALLBACK(clipboard_owner_change_cb), self);
+    // 未订阅期间的快照可能已过期：清空后重新观察一次，内容变了则推进序列号
+    self->state->snapshot.reset(self->sequence);
+    refresh_clipboard_state(self, 0, 0, nullptr);
+  }
+  self->event_listening = TRUE;
+  return nullptr;
+}
+
+static FlMethodErrorResponse* clipboard_events_cancel_cb(FlEventChannel* channel,
+                                                         FlValue* args,
+                                                         gpointer user_data) {
+  ClipboardPlugin* self = CLIPBOARD_PLUGIN(user_data);
+  if (self->owner_change_handler_id != 0) {
+    g_signal_handler_disconnect(self->clipboard, self->owner_change_handler_id);
+    self->owner_change_handler_id = 0;
+  }
+  self->event_listening = FALSE;
+  return nullptr;
+}
+
+static FlMethodErrorResponse* ingest_events_listen_cb(FlEventChannel* channel,
+                                                      FlValue* args,
+                                                      gpointer user_data) {
+  CLIPBOARD_PLUGIN(user_data)->ingest_listening = TRUE;
+  return nullptr;
+}
+
+static FlMethodErrorResponse* ingest_events_cancel_cb(FlEventChannel* channel,
+                                                      FlValue* args,
+                                                      gpointer user_data) {
+  CLIPBOARD_PLUGIN(user_data)->ingest_listening = FALSE;
+  return nullptr;
+}
+
+static FlMethodErrorResponse* file_info_events_listen_cb(FlEventChannel* channel,
+                                                         FlValue* args,
+                                                         gpointer user_data) {
+  CLIPBOARD_PLUGIN(user_data)->file_info_listening = TRUE;
+  return nullptr;
 }
 
-static void clipboard_plugin_init(ClipboardPlugin* self) {}
+static FlMethodErrorResponse* file_info_events_cancel_cb(FlEventChannel* channel,
+                                                         FlValue* args,
+                                                         gpointer user_data) {
+  CLIPBOARD_PLUGIN(user_data)->file_info_listening = FALSE;
+  return nullptr;
+}
 
 static void method_call_cb(FlMethodChannel* channel, FlMethodCall* method_call,
                           gpointer user_data) {
@@ -57,71 +776,43 @@ void clipboard_plugin_register_with_registrar(FlPluginRegistrar* registrar) {
   fl_method_channel_set_method_call_handler(channel, method_call_cb,
                                             g_object_ref(plugin),
                                             g_object_unref);
+  plugin->messenger = FL_BINARY_MESSENGER(
+      g_object_ref(fl_plugin_registrar_get_messenger(registrar)));
+
+  // 剪贴板变化事件：Dart 订阅后连接 owner-change，替代定时轮询
+  plugin->clipboard = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
+  GdkDisplay* display = gdk_display_get_default();
+  plugin->owner_change_supported =
+      display != nullptr && gdk_display_supports_selection_notification(display);
+
+  plugin->event_channel =
+      fl_event_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                           "clipboard_events", FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(plugin->event_channel,
+                                       clipboard_events_listen_cb,
+                                       clipboard_events_cancel_cb,
+                                       plugin, nullptr);
+
+  plugin->ingest_event_channel =
+      fl_event_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                           "file_ingest_events", FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(plugin->ingest_event_channel,
+                                       ingest_events_listen_cb,
+                                       ingest_events_cancel_cb,
+                                       plugin, nullptr);
+
+  plugin->file_info_event_channel =
+      fl_event_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                           "file_metadata_events", FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(plugin->file_info_event_channel,
+                                       file_info_events_listen_cb,
+                                       file_info_events_cancel_cb,
+                                       plugin, nullptr);
 
   g_object_unref(plugin);
 }
 
 // Helper functions
-static std::string detect_file_type(const std::string& path) {
-  size_t dot_pos = path.find_last_of('.');
-  if (dot_pos == std::string::npos) {
-    return "file";
-  }
-  
-  std::string extension = path.substr(dot_pos + 1);
-  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-  
-  // 图片文件
-  std::vector<std::string> image_extensions = {
-    "png", "jpg", "jpeg", "gif", "webp", "bmp", "tiff", "tif", "svg", "ico", "heic", "heif"
-  };
-  if (std::find(image_extensions.begin(), image_extensions.end(), extension) != image_extensions.end()) {
-    return "image";
-  }
-  
-  // 音频文件
-  std::vector<std::string> audio_extensions = {
-    "mp3", "wav", "aac", "flac", "ogg", "m4a", "wma", "aiff", "au"
-  };
-  if (std::find(audio_extensions.begin(), audio_extensions.end(), extension) != audio_extensions.end()) {
-    return "audio";
-  }
-  
-  // 视频文件
-  std::vector<std::string> video_extensions = {
-    "mp4", "avi", "mov", "wmv", "flv", "webm", "mkv", "m4v", "3gp", "ts"
-  };
-  if (std::find(video_extensions.begin(), video_extensions.end(), extension) != video_extensions.end()) {
-    return "video";
-  }
-  
-  // 文档文件
-  std::vector<std::string> document_extensions = {
-    "pdf", "doc", "docx", "xls", "xlsx", "ppt", "pptx", "txt", "rtf"
-  };
-  if (std::find(document_extensions.begin(), document_extensions.end(), extension) != document_extensions.end()) {
-    return "document";
-  }
-  
-  // 压缩文件
-  std::vector<std::string> archive_extensions = {
-    "zip", "rar", "7z", "tar", "gz", "bz2", "xz"
-  };
-  if (std::find(archive_extensions.begin(), archive_extensions.end(), extension) != archive_extensions.end()) {
-    return "archive";
-  }
-  
-  // 代码文件
-  std::vector<std::string> code_extensions = {
-    "cpp", "c", "h", "cs", "js", "ts", "py", "java", "go", "rs", "php", "rb", "kt", "dart"
-  };
-  if (std::find(code_extensions.begin(), code_extensions.end(), extension) != code_extensions.end()) {
-    return "code";
-  }
-  
-  return "file";
-}
-
 static std::string trim(const std::string& str) {
   size_t first = str.find_first_not_of(' ');
   if (std::string::npos == first) {
@@ -210,389 +901,2725 @@ static std::string detect_text_type(const std::string& text) {
   return "plain";
 }
 
-static void get_clipboard_type(FlMethodCall* method_call) {
-  GtkClipboard* clipboard = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
-  
-  g_autoptr(FlValue) result_map = fl_value_new_map();
-  
-  // 优先检查 RTF 格式 (最高优先级)
-  if (gtk_clipboard_wait_is_target_available(clipboard, gdk_atom_intern("text/rtf", FALSE))) {
-    fl_value_set_string_take(result_map, "type", fl_value_new_string("text"));
-    fl_value_set_string_take(result_map, "hasData", fl_value_new_bool(TRUE));
-    fl_value_set_string_take(result_map, "priority", fl_value_new_int(1));
-  }
-  // 检查 HTML 格式 (第二优先级)
-  else if (gtk_clipboard_wait_is_target_available(clipboard, gdk_atom_intern("text/html", FALSE))) {
-    fl_value_set_string_take(result_map, "type", fl_value_new_string("text"));
-    fl_value_set_string_take(result_map, "hasData", fl_value_new_bool(TRUE));
-    fl_value_set_string_take(result_map, "priority", fl_value_new_int(2));
-  }
-  // 检查文件类型 (第三优先级) (text/uri-list)
-  else if (gtk_clipboard_wait_is_target_available(clipboard, gdk_atom_intern("text/uri-list", FALSE))) {
-    gchar* uris_text = gtk_clipboard_wait_for_text(clipboard);
-    if (uris_text != nullptr) {
-      std::string uris_str(uris_text);
-      std::istringstream iss(uris_str);
-      std::string line;
-      std::vector<std::string> file_paths;
-      
-      while (std::getline(iss, line)) {
-        if (!line.empty() && line.find("file://") == 0) {
-          std::string path = line.substr(7); // Remove "file://"
-          file_paths.push_back(path);
-        }
-      }
-      
-      if (!file_paths.empty()) {
-        std::string first_path = file_paths[0];
-        std::string file_type = detect_file_type(first_path);
-        
-        g_autoptr(FlValue) paths_list = fl_value_new_list();
-        for (const auto& path : file_paths) {
-          fl_value_append_take(paths_list, fl_value_new_string(path.c_str()));
-        }
-        
-        fl_value_set_string_take(result_map, "type", fl_value_new_string("file"));
-        fl_value_set_string_take(result_map, "content", paths_list);
-        fl_value_set_string_take(result_map, "primaryPath", fl_value_new_string(first_path.c_str()));
-        fl_value_set_string_take(result_map, "priority", fl_value_new_int(3));
-      }
-      
-      g_free(uris_text);
+// 解析 text/uri-list，返回 file:// URI 对应的本地路径（已百分号解码）
+static std::vector<std::string> parse_file_uri_list(GBytes* bytes) {
+  gsize length = 0;
+  const gchar* data =
+      static_cast<const gchar*>(g_bytes_get_data(bytes, &length));
+  return uri_list_file_paths(data, length);
+}
+
+// 将 GdkPixbuf 编码为 PNG 字节。8 位 RGB/RGBA 使用多线程编码器，
+// 其他像素布局回退到 gdk-pixbuf 自带的编码。仅做纯计算，可在工作线程调用
+static GBytes* encode_pixbuf_png(GdkPixbuf* pixbuf, PngEncodeProfile profile,
+                                 GError** error) {
+  if (gdk_pixbuf_get_colorspace(pixbuf) == GDK_COLORSPACE_RGB &&
+      gdk_pixbuf_get_bits_per_sample(pixbuf) == 8) {
+    std::vector<uint8_t> png;
+    if (png_encode(gdk_pixbuf_read_pixels(pixbuf),
+                   gdk_pixbuf_get_width(pixbuf), gdk_pixbuf_get_height(pixbuf),
+                   gdk_pixbuf_get_rowstride(pixbuf),
+                   gdk_pixbuf_get_n_channels(pixbuf), profile, &png)) {
+      return g_bytes_new(png.data(), png.size());
     }
   }
-  // 检查图片类型 (第四优先级)
-  else if (gtk_clipboard_wait_is_image_available(clipboard)) {
-    GdkPixbuf* pixbuf = gtk_clipboard_wait_for_image(clipboard);
-    if (pixbuf != nullptr) {
-      fl_value_set_string_take(result_map, "type", fl_value_new_string("image"));
-      fl_value_set_string_take(result_map, "hasData", fl_value_new_bool(TRUE));
-      fl_value_set_string_take(result_map, "priority", fl_value_new_int(4));
-      
-      g_object_unref(pixbuf);
-    }
+
+  gchar* buffer = nullptr;
+  gsize buffer_size = 0;
+  if (!gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &buffer_size, "png", error,
+                                 nullptr)) {
+    return nullptr;
   }
-  // 检查文本类型 (最低优先级)
-  else if (gtk_clipboard_wait_is_text_available(clipboard)) {
-    gchar* text = gtk_clipboard_wait_for_text(clipboard);
-    if (text != nullptr) {
-      std::string text_str(text);
-      
-      fl_value_set_string_take(result_map, "type", fl_value_new_string("text"));
-      fl_value_set_string_take(result_map, "length", fl_value_new_int(text_str.length()));
-      fl_value_set_string_take(result_map, "hasData", fl_value_new_bool(TRUE));
-      fl_value_set_string_take(result_map, "priority", fl_value_new_int(5));
-      
-      g_free(text);
+  return g_bytes_new_take(buffer, buffer_size);
+}
+
+// 可原样透传的编码图像格式，按优先级排列。
+// 所有者只提供位图（image/bmp、image/tiff 等）时才解码后重新编码为 PNG。
+static const gchar* const kPassThroughImageTargets[] = {
+  "image/png", "image/jpeg", "image/jpg", "image/webp", "image/gif",
+};
+
+// 从 TARGETS 中选出可直接透传的图像格式，没有时返回 nullptr
+static const gchar* negotiate_image_target(const ClipboardTargets& targets) {
+  for (const gchar* target : kPassThroughImageTargets) {
+    if (targets.contains(target)) {
+      return target;
     }
   }
-  else {
-    // 未知类型
-    fl_value_set_string_take(result_map, "type", fl_value_new_string("unknown"));
-    fl_value_set_string_take(result_map, "priority", fl_value_new_int(99));
-  }
-  
-  fl_method_call_respond_success(method_call, result_map, nullptr);
+  return nullptr;
 }
 
-static void get_clipboard_sequence(FlMethodCall* method_call) {
-  // Linux 没有直接的序列号概念，使用时间戳作为替代
-  static gint64 last_sequence = 0;
-  last_sequence++;
-  
-  g_autoptr(FlValue) result = fl_value_new_int(last_sequence);
-  fl_method_call_respond_success(method_call, result, nullptr);
-}
+// 快照缓存中派生格式的键
+static const char kSnapshotTextKey[] = "x-clip-flow/utf8-text";
+static const char kSnapshotPngKey[] = "x-clip-flow/png";
 
-static void get_clipboard_file_paths(FlMethodCall* method_call) {
-  GtkClipboard* clipboard = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
-  
-  if (gtk_clipboard_wait_is_target_available(clipboard, gdk_atom_intern("text/uri-list", FALSE))) {
-    gchar* uris_text = gtk_clipboard_wait_for_text(clipboard);
-    if (uris_text != nullptr) {
-      std::string uris_str(uris_text);
-      std::istringstream iss(uris_str);
-      std::string line;
-      
-      g_autoptr(FlValue) paths_list = fl_value_new_list();
-      
-      while (std::getline(iss, line)) {
-        if (!line.empty() && line.find("file://") == 0) {
-          std::string path = line.substr(7); // Remove "file://"
-          fl_value_append_take(paths_list, fl_value_new_string(path.c_str()));
-        }
-      }
-      
-      fl_method_call_respond_success(method_call, paths_list, nullptr);
-      g_free(uris_text);
-      return;
+// 读取目标格式的原始字节，优先命中快照缓存
+static void read_snapshot_contents(ClipboardPlugin* self, const gchar* target,
+                                   guint timeout_ms,
+                                   ClipboardContentsCallback callback) {
+  ClipboardSnapshotCache& snapshot = self->state->snapshot;
+  GBytes* cached = nullptr;
+  if (snapshot.lookup(target, &cached)) {
+    callback(cached != nullptr ? CLIPBOARD_READ_OK : CLIPBOARD_READ_EMPTY,
+             cached);
+    if (cached != nullptr) {
+      g_bytes_unref(cached);
     }
+    return;
   }
-  
-  fl_method_call_respond_success(method_call, nullptr, nullptr);
+
+  auto plugin = hold_object(self);
+  guint epoch = snapshot.epoch();
+  std::string key(target);
+  clipboard_read_contents(self->clipboard, gdk_atom_intern(target, FALSE),
+      timeout_ms, [plugin, epoch, key, callback](
+          ClipboardReadStatus status, GBytes* bytes) {
+        if (status != CLIPBOARD_READ_TIMEOUT) {
+          plugin->state->snapshot.store(epoch, key, bytes);
+        }
+        callback(status, bytes);
+      });
 }
 
-static void get_clipboard_image_data(FlMethodCall* method_call) {
-  GtkClipboard* clipboard = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
-  
-  if (gtk_clipboard_wait_is_image_available(clipboard)) {
-    GdkPixbuf* pixbuf = gtk_clipboard_wait_for_image(clipboard);
-    if (pixbuf != nullptr) {
-      gchar* buffer;
-      gsize buffer_size;
-      GError* error = nullptr;
-      
-      if (gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &buffer_size, "png", &error, nullptr)) {
-        g_autoptr(FlValue) result = fl_value_new_uint8_list(
-            reinterpret_cast<const uint8_t*>(buffer), buffer_size);
-        fl_method_call_respond_success(method_call, result, nullptr);
-        g_free(buffer);
-      } else {
-        fl_method_call_respond_error(method_call, "IMAGE_ERROR", 
-                                   error ? error->message : "Failed to save image", 
-                                   nullptr, nullptr);
-        if (error) g_error_free(error);
+// 读取 UTF-8 文本，优先命中快照缓存
+static void read_snapshot_text(ClipboardPlugin* self, guint timeout_ms,
+                               ClipboardTextCallback callback) {
+  ClipboardSnapshotCache& snapshot = self->state->snapshot;
+  GBytes* cached = nullptr;
+  if (snapshot.lookup(kSnapshotTextKey, &cached)) {
+    if (cached != nullptr) {
+      // 缓存中的文本包含结尾的 NUL
+      callback(CLIPBOARD_READ_OK,
+               static_cast<const gchar*>(g_bytes_get_data(cached, nullptr)));
+      g_bytes_unref(cached);
+    } else {
+      callback(CLIPBOARD_READ_EMPTY, nullptr);
+    }
+    return;
+  }
+
+  auto plugin = hold_object(self);
+  guint epoch = snapshot.epoch();
+  clipboard_read_text(self->clipboard, timeout_ms, [plugin, epoch, callback](
+      ClipboardReadStatus status, const gchar* text) {
+    if (status != CLIPBOARD_READ_TIMEOUT) {
+      GBytes* bytes =
+          text != nullptr ? g_bytes_new(text, strlen(text) + 1) : nullptr;
+      plugin->state->snapshot.store(epoch, kSnapshotTextKey, bytes);
+      if (bytes != nullptr) {
+        g_bytes_unref(bytes);
       }
-      
-      g_object_unref(pixbuf);
-      return;
     }
+    callback(status, text);
+  });
+}
+
+// 读取解码后的图像，优先命中快照缓存
+static void read_snapshot_image(ClipboardPlugin* self, guint timeout_ms,
+                                ClipboardImageCallback callback) {
+  ClipboardSnapshotCache& snapshot = self->state->snapshot;
+  GdkPixbuf* cached = nullptr;
+  if (snapshot.lookup_pixbuf(&cached)) {
+    callback(cached != nullptr ? CLIPBOARD_READ_OK : CLIPBOARD_READ_EMPTY,
+             cached);
+    g_clear_object(&cached);
+    return;
   }
-  
-  fl_method_call_respond_success(method_call, nullptr, nullptr);
+
+  auto plugin = hold_object(self);
+  guint epoch = snapshot.epoch();
+  clipboard_read_image(self->clipboard, timeout_ms, [plugin, epoch, callback](
+      ClipboardReadStatus status, GdkPixbuf* pixbuf) {
+    if (status != CLIPBOARD_READ_TIMEOUT) {
+      plugin->state->snapshot.store_pixbuf(epoch, pixbuf);
+    }
+    callback(status, pixbuf);
+  });
 }
 
-static void perform_ocr(FlMethodCall* method_call) {
-  GtkClipboard* clipboard = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
-  
-  // 检查剪贴板是否包含图像
-  if (!gtk_clipboard_wait_is_image_available(clipboard)) {
-    fl_method_call_respond_error(method_call, "NO_IMAGE", 
-                               "No image found in clipboard", 
-                               nullptr, nullptr);
+// 读取编码后的图像：优先原样透传所有者提供的 PNG/JPEG 等字节，
+// 仅在只有位图时解码并编码为 PNG（同一状态下只编码一次）
+static void read_snapshot_image_encoded(ClipboardPlugin* self,
+                                        const ClipboardTargets& targets,
+                                        guint timeout_ms,
+                                        PngEncodeProfile profile,
+                                        ClipboardContentsCallback callback) {
+  const gchar* encoded_target = negotiate_image_target(targets);
+  if (encoded_target != nullptr) {
+    read_snapshot_contents(self, encoded_target, timeout_ms, callback);
     return;
   }
-  
-  // 获取剪贴板图像
-  GdkPixbuf* pixbuf = gtk_clipboard_wait_for_image(clipboard);
-  if (pixbuf == nullptr) {
-    fl_method_call_respond_error(method_call, "IMAGE_ERROR", 
-                               "Failed to get image from clipboard", 
-                               nullptr, nullptr);
+
+  ClipboardSnapshotCache& snapshot = self->state->snapshot;
+  GBytes* cached = nullptr;
+  if (snapshot.lookup(kSnapshotPngKey, &cached)) {
+    callback(cached != nullptr ? CLIPBOARD_READ_OK : CLIPBOARD_READ_EMPTY,
+             cached);
+    if (cached != nullptr) {
+      g_bytes_unref(cached);
+    }
+    return;
+  }
+
+  auto plugin = hold_object(self);
+  guint epoch = snapshot.epoch();
+  read_snapshot_image(self, timeout_ms, [plugin, epoch, profile, callback](
+      ClipboardReadStatus status, GdkPixbuf* pixbuf) {
+    if (pixbuf == nullptr) {
+      callback(status, nullptr);
+      return;
+    }
+    // 大图编码耗时数十到数百毫秒，放到工作线程，完成后回主线程写缓存并回调
+    struct EncodeJob {
+      GdkPixbuf* pixbuf = nullptr;
+      GBytes* png = nullptr;
+    };
+    auto job = std::make_shared<EncodeJob>();
+    job->pixbuf = GDK_PIXBUF(g_object_ref(pixbuf));
+    clipboard_worker_run(
+        [job, profile]() {
+          job->png = encode_pixbuf_png(job->pixbuf, profile, nullptr);
+        },
+        [plugin, epoch, callback, job]() {
+          g_clear_object(&job->pixbuf);
+          plugin->state->snapshot.store(epoch, kSnapshotPngKey, job->png);
+          callback(job->png != nullptr ? CLIPBOARD_READ_OK
+                                       : CLIPBOARD_READ_EMPTY,
+                   job->png);
+          g_clear_pointer(&job->png, g_bytes_unref);
+        });
+  });
+}
+
+// 缩略图最大边长的上限
+static const guint kThumbnailMaxSide = 1024;
+
+// 将 pixbuf 缩小到 max_side 以内并编码：不透明图像为 JPEG，带透明通道时为 PNG。
+// 仅做纯计算，可在工作线程调用
+static GBytes* build_thumbnail(GdkPixbuf* pixbuf, guint max_side) {
+  guint32 width = gdk_pixbuf_get_width(pixbuf);
+  guint32 height = gdk_pixbuf_get_height(pixbuf);
+  guint32 thumb_width = 0;
+  guint32 thumb_height = 0;
+  image_fit_size(width, height, max_side, &thumb_width, &thumb_height);
+
+  GdkPixbuf* thumb = nullptr;
+  if (thumb_width == width && thumb_height == height) {
+    thumb = GDK_PIXBUF(g_object_ref(pixbuf));
+  } else if (gdk_pixbuf_get_colorspace(pixbuf) == GDK_COLORSPACE_RGB &&
+             gdk_pixbuf_get_bits_per_sample(pixbuf) == 8) {
+    gboolean has_alpha = gdk_pixbuf_get_has_alpha(pixbuf);
+    thumb = gdk_pixbuf_new(GDK_COLORSPACE_RGB, has_alpha, 8, thumb_width,
+                           thumb_height);
+    if (thumb != nullptr &&
+        !image_downscale_area(gdk_pixbuf_read_pixels(pixbuf), width, height,
+                              gdk_pixbuf_get_rowstride(pixbuf),
+                              gdk_pixbuf_get_n_channels(pixbuf),
+                              gdk_pixbuf_get_pixels(thumb), thumb_width,
+                              thumb_height, gdk_pixbuf_get_rowstride(thumb))) {
+      g_clear_object(&thumb);
+    }
+  } else {
+    thumb = gdk_pixbuf_scale_simple(pixbuf, thumb_width, thumb_height,
+                                    GDK_INTERP_TILES);
+  }
+  if (thumb == nullptr) {
+    return nullptr;
+  }
+
+  GBytes* bytes = nullptr;
+  if (gdk_pixbuf_get_has_alpha(thumb)) {
+    bytes = encode_pixbuf_png(thumb, PNG_ENCODE_FAST, nullptr);
+  } else {
+    gchar* buffer = nullptr;
+    gsize buffer_size = 0;
+    if (gdk_pixbuf_save_to_buffer(thumb, &buffer, &buffer_size, "jpeg",
+                                  nullptr, "quality", "80", nullptr)) {
+      bytes = g_bytes_new_take(buffer, buffer_size);
+    }
+  }
+  g_object_unref(thumb);
+  return bytes;
+}
+
+// 从编码后的字节解码图像（工作线程）
+static GdkPixbuf* decode_image_bytes(GBytes* encoded) {
+  GdkPixbufLoader* loader = gdk_pixbuf_loader_new();
+  GdkPixbuf* pixbuf = nullptr;
+  gboolean written = gdk_pixbuf_loader_write_bytes(loader, encoded, nullptr);
+  if (gdk_pixbuf_loader_close(loader, nullptr) && written) {
+    pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+    if (pixbuf != nullptr) {
+      g_object_ref(pixbuf);
+    }
+  }
+  g_object_unref(loader);
+  return pixbuf;
+}
+
+// 原图尺寸与感知哈希，随缩略图一并计算并缓存于快照
+struct ClipboardImageInfo {
+  gint32 width = 0;
+  gint32 height = 0;
+  gint32 has_perceptual_hash = 0;
+  gint32 reserved = 0;
+  guint64 perceptual_hash = 0;
+};
+
+using ClipboardThumbnailCallback =
+    std::function<void(GBytes* thumbnail, const ClipboardImageInfo& info)>;
+
+static std::string thumbnail_snapshot_key(guint max_side) {
+  return "x-clip-flow/thumbnail@" + std::to_string(max_side);
+}
+static const char kSnapshotImageInfoKey[] = "x-clip-flow/image-info";
+
+static bool pixbuf_perceptual_hash(GdkPixbuf* pixbuf, guint64* hash) {
+  if (gdk_pixbuf_get_colorspace(pixbuf) != GDK_COLORSPACE_RGB ||
+      gdk_pixbuf_get_bits_per_sample(pixbuf) != 8) {
+    return false;
+  }
+  uint64_t value = 0;
+  if (!perceptual_hash(gdk_pixbuf_read_pixels(pixbuf),
+                       gdk_pixbuf_get_width(pixbuf),
+                       gdk_pixbuf_get_height(pixbuf),
+                       gdk_pixbuf_get_rowstride(pixbuf),
+                       gdk_pixbuf_get_n_channels(pixbuf), &value)) {
+    return false;
+  }
+  *hash = value;
+  return true;
+}
+
+// 生成剪贴板图像的缩略图（max_side 为 0 时不生成），同时计算原图尺寸与感知哈希。
+// 解码、缩放与编码均在工作线程上进行；优先复用快照中已解码的 pixbuf，
+// 否则从编码字节解码；结果按尺寸缓存于快照
+static void read_snapshot_thumbnail(ClipboardPlugin* self, GBytes* encoded,
+                                    guint max_side,
+                                    ClipboardThumbnailCallback callback) {
+  ClipboardSnapshotCache& snapshot = self->state->snapshot;
+  std::string key = max_side > 0 ? thumbnail_snapshot_key(max_side) : "";
+  GBytes* cached = nullptr;
+  GBytes* cached_info = nullptr;
+  if (snapshot.peek(kSnapshotImageInfoKey, &cached_info) &&
+      (key.empty() || snapshot.lookup(key, &cached))) {
+    ClipboardImageInfo info;
+    if (cached_info != nullptr &&
+        g_bytes_get_size(cached_info) == sizeof(info)) {
+      memcpy(&info, g_bytes_get_data(cached_info, nullptr), sizeof(info));
+    }
+    callback(cached, info);
+    g_clear_pointer(&cached, g_bytes_unref);
+    g_clear_pointer(&cached_info, g_bytes_unref);
+    return;
+  }
+  g_clear_pointer(&cached_info, g_bytes_unref);
+
+  GdkPixbuf* decoded = nullptr;
+  if (!snapshot.lookup_pixbuf(&decoded) && encoded == nullptr) {
+    callback(nullptr, ClipboardImageInfo());
+    return;
+  }
+  GBytes* source = encoded != nullptr ? g_bytes_ref(encoded) : nullptr;
+
+  struct ThumbnailJob {
+    GdkPixbuf* pixbuf = nullptr;
+    GBytes* thumbnail = nullptr;
+    ClipboardImageInfo info;
+  };
+  auto job = std::make_shared<ThumbnailJob>();
+  job->pixbuf = decoded;
+  auto plugin = hold_object(self);
+  guint epoch = snapshot.epoch();
+
+  clipboard_worker_run(
+      [job, source, max_side]() {
+        if (job->pixbuf == nullptr && source != nullptr) {
+          job->pixbuf = decode_image_bytes(source);
+        }
+        if (source != nullptr) {
+          g_bytes_unref(source);
+        }
+        if (job->pixbuf != nullptr) {
+          job->info.width = gdk_pixbuf_get_width(job->pixbuf);
+          job->info.height = gdk_pixbuf_get_height(job->pixbuf);
+          guint64 hash = 0;
+          if (pixbuf_perceptual_hash(job->pixbuf, &hash)) {
+            job->info.has_perceptual_hash = 1;
+            job->info.perceptual_hash = hash;
+          }
+          if (max_side > 0) {
+            job->thumbnail = build_thumbnail(job->pixbuf, max_side);
+          }
+        }
+      },
+      [plugin, job, key, epoch, callback]() {
+        ClipboardSnapshotCache& snapshot = plugin->state->snapshot;
+        GBytes* info = g_bytes_new(&job->info, sizeof(job->info));
+        snapshot.store(epoch, kSnapshotImageInfoKey, info);
+        g_bytes_unref(info);
+        if (!key.empty()) {
+          snapshot.store(epoch, key, job->thumbnail);
+        }
+
+        callback(job->thumbnail, job->info);
+        g_clear_pointer(&job->thumbnail, g_bytes_unref);
+        g_clear_object(&job->pixbuf);
+      });
+}
+
+static void get_clipboard_type(ClipboardPlugin* self,
+                               FlMethodCall* method_call) {
+  auto plugin = hold_object(self);
+  guint timeout_ms = get_read_timeout(method_call);
+  auto call = hold_object(method_call);
+
+  // 类型与可用性均由缓存的 TARGETS 判断，仅文件列表需要读取内容
+  with_clipboard_targets(self, timeout_ms, [plugin, timeout_ms, call](
+      ClipboardReadStatus status, const ClipboardTargets& targets) {
+    if (status == CLIPBOARD_READ_TIMEOUT) {
+      respond_read_timeout(call.get());
+      return;
+    }
+
+    g_autoptr(FlValue) result_map = fl_value_new_map();
+
+    // 优先检查 RTF 格式 (最高优先级)
+    if (targets.contains("text/rtf")) {
+      fl_value_set_string_take(result_map, "type", fl_value_new_string("text"));
+      fl_value_set_string_take(result_map, "hasData", fl_value_new_bool(TRUE));
+      fl_value_set_string_take(result_map, "priority", fl_value_new_int(1));
+    }
+    // 检查 HTML 格式 (第二优先级)
+    else if (targets.contains("text/html")) {
+      fl_value_set_string_take(result_map, "type", fl_value_new_string("text"));
+      fl_value_set_string_take(result_map, "hasData", fl_value_new_bool(TRUE));
+      fl_value_set_string_take(result_map, "priority", fl_value_new_int(2));
+    }
+    // 检查文件类型 (第三优先级) (text/uri-list)
+    else if (targets.contains("text/uri-list")) {
+      read_snapshot_contents(plugin.get(), "text/uri-list", timeout_ms,
+          [call](ClipboardReadStatus status, GBytes* bytes) {
+            if (status == CLIPBOARD_READ_TIMEOUT) {
+              respond_read_timeout(call.get());
+              return;
+            }
+
+            g_autoptr(FlValue) result_map = fl_value_new_map();
+            std::vector<std::string> file_paths;
+            if (bytes != nullptr) {
+              file_paths = parse_file_uri_list(bytes);
+            }
+
+            if (!file_paths.empty()) {
+              const std::string& first_path = file_paths[0];
+              const char* file_type = file_metadata_type_for_path(first_path);
+
+              FlValue* paths_list = fl_value_new_list();
+              for (const auto& path : file_paths) {
+                fl_value_append_take(paths_list, fl_value_new_string(path.c_str()));
+              }
+
+              fl_value_set_string_take(result_map, "type", fl_value_new_string("file"));
+              fl_value_set_string_take(result_map, "content", paths_list);
+              fl_value_set_string_take(result_map, "primaryPath", fl_value_new_string(first_path.c_str()));
+              fl_value_set_string_take(result_map, "primaryType", fl_value_new_string(file_type));
+              fl_value_set_string_take(result_map, "priority", fl_value_new_int(3));
+            }
+
+            fl_method_call_respond_success(call.get(), result_map, nullptr);
+          });
+      return;
+    }
+    // 检查图片类型 (第四优先级)
+    else if (targets.has_image()) {
+      fl_value_set_string_take(result_map, "type", fl_value_new_string("image"));
+      fl_value_set_string_take(result_map, "hasData", fl_value_new_bool(TRUE));
+      fl_value_set_string_take(result_map, "priority", fl_value_new_int(4));
+    }
+    // 检查文本类型 (最低优先级)
+    else if (targets.has_text()) {
+      fl_value_set_string_take(result_map, "type", fl_value_new_string("text"));
+      fl_value_set_string_take(result_map, "hasData", fl_value_new_bool(TRUE));
+      fl_value_set_string_take(result_map, "priority", fl_value_new_int(5));
+    }
+    else {
+      // 未知类型
+      fl_value_set_string_take(result_map, "type", fl_value_new_string("unknown"));
+      fl_value_set_string_take(result_map, "priority", fl_value_new_int(99));
+    }
+
+    fl_method_call_respond_success(call.get(), result_map, nullptr);
+  });
+}
+
+static void get_clipboard_sequence(ClipboardPlugin* self,
+                                   FlMethodCall* method_call) {
+  // 订阅变化事件期间序列号由 owner-change 信号驱动；其余时候
+  // 在轮询时重新计算指纹，内容未变则序列号保持不变
+  if (tracking_owner_change(self)) {
+    g_autoptr(FlValue) result = fl_value_new_int(self->sequence);
+    fl_method_call_respond_success(method_call, result, nullptr);
     return;
   }
-  
-  try {
-    // 初始化 Tesseract OCR 引擎
-    tesseract::TessBaseAPI* ocr = new tesseract::TessBaseAPI();
-    
-    // 初始化 OCR 引擎，使用英文语言包
-    if (ocr->Init(nullptr, "eng") != 0) {
-      delete ocr;
-      g_object_unref(pixbuf);
-      fl_method_call_respond_error(method_call, "OCR_ERROR", 
-                                 "Failed to initialize OCR engine", 
-                                 nullptr, nullptr);
+
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+  refresh_clipboard_state(self, 0, 0, [plugin, call]() {
+    g_autoptr(FlValue) result = fl_value_new_int(plugin->sequence);
+    fl_method_call_respond_success(call.get(), result, nullptr);
+  });
+}
+
+static void get_clipboard_file_paths(ClipboardPlugin* self,
+                                     FlMethodCall* method_call) {
+  auto plugin = hold_object(self);
+  guint timeout_ms = get_read_timeout(method_call);
+  auto call = hold_object(method_call);
+
+  with_clipboard_targets(self, timeout_ms, [plugin, timeout_ms, call](
+      ClipboardReadStatus status, const ClipboardTargets& targets) {
+    if (status == CLIPBOARD_READ_TIMEOUT) {
+      respond_read_timeout(call.get());
+      return;
+    }
+    if (!targets.contains("text/uri-list")) {
+      fl_method_call_respond_success(call.get(), nullptr, nullptr);
+      return;
+    }
+
+    read_snapshot_contents(plugin.get(), "text/uri-list", timeout_ms,
+        [call](ClipboardReadStatus status, GBytes* bytes) {
+          if (status == CLIPBOARD_READ_TIMEOUT) {
+            respond_read_timeout(call.get());
+            return;
+          }
+          if (bytes == nullptr) {
+            fl_method_call_respond_success(call.get(), nullptr, nullptr);
+            return;
+          }
+
+          g_autoptr(FlValue) paths_list = fl_value_new_list();
+          for (const auto& path : parse_file_uri_list(bytes)) {
+            fl_value_append_take(paths_list, fl_value_new_string(path.c_str()));
+          }
+          fl_method_call_respond_success(call.get(), paths_list, nullptr);
+        });
+  });
+}
+
+static void get_clipboard_image_data(ClipboardPlugin* self,
+                                     FlMethodCall* method_call) {
+  auto plugin = hold_object(self);
+  guint timeout_ms = get_read_timeout(method_call);
+  PngEncodeProfile profile = get_png_profile(method_call);
+  auto call = hold_object(method_call);
+
+  with_clipboard_targets(self, timeout_ms, [plugin, timeout_ms, profile, call](
+      ClipboardReadStatus status, const ClipboardTargets& targets) {
+    if (status == CLIPBOARD_READ_TIMEOUT) {
+      respond_read_timeout(call.get());
+      return;
+    }
+    if (!targets.has_image()) {
+      fl_method_call_respond_success(call.get(), nullptr, nullptr);
+      return;
+    }
+
+    read_snapshot_image_encoded(plugin.get(), targets, timeout_ms, profile,
+      [call](ClipboardReadStatus status, GBytes* image) {
+        if (status == CLIPBOARD_READ_TIMEOUT) {
+          respond_read_timeout(call.get());
+          return;
+        }
+        if (image == nullptr) {
+          fl_method_call_respond_success(call.get(), nullptr, nullptr);
+          return;
+        }
+
+        g_autoptr(FlValue) result = fl_value_new_uint8_list_from_bytes(image);
+        fl_method_call_respond_success(call.get(), result, nullptr);
+      });
+  });
+}
+
+// 空闲 OCR 引擎的回收检查间隔（秒）
+static const guint kOcrEvictIntervalSeconds = 60;
+
+// 缩放比例为 1 时的屏幕分辨率
+static const int kOcrBaseScreenDpi = 96;
+
+// 分块并行识别的引擎数上限，每个引擎都要占用一份语言模型内存
+static const gint64 kOcrMaxParallelism = 8;
+
+static gboolean ocr_evict_cb(gpointer user_data);
+
+// 池中有空闲引擎时安排定期回收；回收在工作线程进行（引擎析构会释放大量内存）
+static void schedule_ocr_eviction(ClipboardPlugin* self) {
+  if (self->ocr_evict_source_id != 0 ||
+      self->state->ocr_engines->idle_count() == 0) {
+    return;
+  }
+  self->ocr_evict_source_id = g_timeout_add_seconds_full(
+      G_PRIORITY_LOW, kOcrEvictIntervalSeconds, ocr_evict_cb,
+      g_object_ref(self), g_object_unref);
+}
+
+static gboolean ocr_evict_cb(gpointer user_data) {
+  ClipboardPlugin* self = CLIPBOARD_PLUGIN(user_data);
+  self->ocr_evict_source_id = 0;
+  auto plugin = hold_object(self);
+  std::shared_ptr<OcrEnginePool> engines = self->state->ocr_engines;
+  clipboard_worker_run([engines]() { engines->evict_idle(); },
+                       [plugin]() { schedule_ocr_eviction(plugin.get()); });
+  return G_SOURCE_REMOVE;
+}
+
+// 缓存有改动后延迟写盘，合并短时间内的多次识别
+static const guint kOcrCacheFlushDelaySeconds = 5;
+
+// 未指定 cacheEntries 时 OCR 结果缓存的条目上限
+static const gint64 kOcrCacheDefaultEntries = 512;
+
+static gboolean ocr_cache_flush_cb(gpointer user_data);
+
+static void schedule_ocr_cache_flush(ClipboardPlugin* self) {
+  if (self->ocr_cache_flush_source_id != 0 ||
+      self->state->ocr_cache == nullptr) {
+    return;
+  }
+  self->ocr_cache_flush_source_id = g_timeout_add_seconds_full(
+      G_PRIORITY_LOW, kOcrCacheFlushDelaySeconds, ocr_cache_flush_cb,
+      g_object_ref(self), g_object_unref);
+}
+
+static gboolean ocr_cache_flush_cb(gpointer user_data) {
+  ClipboardPlugin* self = CLIPBOARD_PLUGIN(user_data);
+  self->ocr_cache_flush_source_id = 0;
+  std::shared_ptr<OcrCache> cache = self->state->ocr_cache;
+  if (cache != nullptr) {
+    clipboard_worker_run([cache]() { cache->save(); }, []() {});
+  }
+  return G_SOURCE_REMOVE;
+}
+
+static const char* ocr_error_code(OcrStatus status) {
+  switch (status) {
+    case OCR_STATUS_CANCELLED:
+      return "CANCELLED";
+    case OCR_STATUS_TIMEOUT:
+      return "OCR_TIMEOUT";
+    case OCR_STATUS_IMAGE_ERROR:
+      return "IMAGE_ERROR";
+    default:
+      return "OCR_ERROR";
+  }
+}
+
+// 在工作线程上取得图像并识别，完成后回到主线程响应。
+// load_image 返回新引用（失败时为 nullptr），图像只在工作线程读取。
+// use_cache 时先按像素与配置查 OCR 缓存，识别成功后写入
+static void run_ocr_job(std::shared_ptr<ClipboardPlugin> plugin,
+                        std::shared_ptr<FlMethodCall> call, gint64 job_id,
+                        OcrOptions options, bool use_cache,
+                        std::function<GdkPixbuf*()> load_image) {
+  std::shared_ptr<std::atomic<bool>> cancelled =
+      plugin->state->ocr_jobs.find(job_id);
+  if (cancelled == nullptr) {
+    return;
+  }
+  std::shared_ptr<OcrEnginePool> engines = plugin->state->ocr_engines;
+  std::shared_ptr<OcrCache> cache =
+      use_cache ? plugin->state->ocr_cache : nullptr;
+  auto status = std::make_shared<OcrStatus>(OCR_STATUS_CANCELLED);
+  auto output = std::make_shared<OcrOutput>();
+  clipboard_worker_run(
+      [engines, cache, options, load_image, cancelled, status, output]() {
+        if (cancelled->load()) {
+          return;
+        }
+        GdkPixbuf* pixbuf = load_image();
+        if (pixbuf == nullptr) {
+          *status = OCR_STATUS_IMAGE_ERROR;
+          output->error = "Failed to decode image data";
+          return;
+        }
+        OcrImage image;
+        image.pixels = gdk_pixbuf_read_pixels(pixbuf);
+        image.width = gdk_pixbuf_get_width(pixbuf);
+        image.height = gdk_pixbuf_get_height(pixbuf);
+        image.channels = gdk_pixbuf_get_n_channels(pixbuf);
+        image.rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+
+        // 模型标识要等该语言（或其退回的语言）的引擎初始化过才知道，
+        // 之前不查缓存
+        OcrCacheKey key;
+        uint64_t model_stamp = 0;
+        if (cache != nullptr) {
+          key = ocr_cache_key(image, options);
+          if (engines->model_stamp(options.languages, &model_stamp) &&
+              cache->lookup(key, model_stamp, output.get())) {
+            *status = OCR_STATUS_OK;
+            g_object_unref(pixbuf);
+            return;
+          }
+        }
+        *status = ocr_recognize(engines, image, options, *cancelled,
+                                output.get());
+        // 预判结果不缓存：重新预判的代价与查缓存相当
+        if (cache != nullptr && *status == OCR_STATUS_OK && !output->skipped) {
+          cache->insert(key, *output);
+        }
+        g_object_unref(pixbuf);
+      },
+      [plugin, call, job_id, status, output]() {
+        plugin->state->ocr_jobs.finish(job_id);
+        schedule_ocr_eviction(plugin.get());
+        if (!output->cached && !output->skipped &&
+            *status == OCR_STATUS_OK) {
+          schedule_ocr_cache_flush(plugin.get());
+        }
+        if (*status != OCR_STATUS_OK) {
+          fl_method_call_respond_error(
+              call.get(), ocr_error_code(*status),
+              *status == OCR_STATUS_CANCELLED ? "OCR job was cancelled"
+                                              : output->error.c_str(),
+              nullptr, nullptr);
+          return;
+        }
+        g_autoptr(FlValue) result_map = fl_value_new_map();
+        fl_value_set_string_take(result_map, "text",
+                                 fl_value_new_string(output->text.c_str()));
+        fl_value_set_string_take(result_map, "confidence",
+                                 fl_value_new_float(output->confidence));
+        fl_value_set_string_take(
+            result_map, "languages",
+            fl_value_new_string(output->languages.c_str()));
+
+        const OcrPreprocessStats& stats = output->preprocess;
+        g_autoptr(FlValue) timings = fl_value_new_map();
+        fl_value_set_string_take(timings, "grayscale",
+                                 fl_value_new_float(stats.grayscale_ms));
+        fl_value_set_string_take(timings, "scale",
+                                 fl_value_new_float(stats.scale_ms));
+        fl_value_set_string_take(timings, "binarize",
+                                 fl_value_new_float(stats.binarize_ms));
+        fl_value_set_string_take(timings, "prefilter",
+                                 fl_value_new_float(output->prefilter_ms));
+        fl_value_set_string_take(timings, "deskew",
+                                 fl_value_new_float(stats.deskew_ms));
+        fl_value_set_string_take(timings, "layout",
+                                 fl_value_new_float(output->layout_ms));
+        fl_value_set_string_take(timings, "recognize",
+                                 fl_value_new_float(output->recognize_ms));
+        fl_value_set_string(result_map, "timings", timings);
+        fl_value_set_string_take(result_map, "scale",
+                                 fl_value_new_float(stats.scale));
+        fl_value_set_string_take(result_map, "skewAngle",
+                                 fl_value_new_float(stats.skew_degrees));
+        fl_value_set_string_take(result_map, "cached",
+                                 fl_value_new_bool(output->cached));
+        fl_value_set_string_take(result_map, "skipped",
+                                 fl_value_new_bool(output->skipped));
+        if (output->text_score >= 0) {
+          fl_value_set_string_take(result_map, "textScore",
+                                   fl_value_new_float(output->text_score));
+        }
+        if (!output->regions.empty()) {
+          g_autoptr(FlValue) regions = fl_value_new_list();
+          for (const OcrRegion& region : output->regions) {
+            FlValue* entry = fl_value_new_map();
+            fl_value_set_string_take(entry, "x", fl_value_new_int(region.x));
+            fl_value_set_string_take(entry, "y", fl_value_new_int(region.y));
+            fl_value_set_string_take(entry, "width",
+                                     fl_value_new_int(region.width));
+            fl_value_set_string_take(entry, "height",
+                                     fl_value_new_int(region.height));
+            fl_value_set_string_take(entry, "text",
+                                     fl_value_new_string(region.text.c_str()));
+            fl_value_set_string_take(entry, "confidence",
+                                     fl_value_new_float(region.confidence));
+            fl_value_append_take(regions, entry);
+          }
+          fl_value_set_string(result_map, "regions", regions);
+        }
+        fl_method_call_respond_success(call.get(), result_map, nullptr);
+      });
+}
+
+// 结束尚未进入工作线程的任务（读取剪贴板失败等）
+static void finish_ocr_job(ClipboardPlugin* self, gint64 job_id) {
+  self->state->ocr_jobs.finish(job_id);
+}
+
+// 未给出 sourceDpi 时按主显示器的缩放比例估计截图分辨率
+static int estimate_screen_dpi() {
+  GdkDisplay* display = gdk_display_get_default();
+  if (display == nullptr) {
+    return kOcrBaseScreenDpi;
+  }
+  GdkMonitor* monitor = gdk_display_get_primary_monitor(display);
+  if (monitor == nullptr && gdk_display_get_n_monitors(display) > 0) {
+    monitor = gdk_display_get_monitor(display, 0);
+  }
+  int scale = monitor != nullptr ? gdk_monitor_get_scale_factor(monitor) : 1;
+  return kOcrBaseScreenDpi * std::max(1, scale);
+}
+
+// 读取预处理参数：preprocess、sourceDpi、targetDpi、
+// binarize（"none" / "otsu" / "sauvola"）、deskew
+static OcrPreprocessOptions get_ocr_preprocess_options(
+    FlMethodCall* method_call) {
+  OcrPreprocessOptions options;
+  options.enabled = get_bool_arg(method_call, "preprocess", false);
+  if (!options.enabled) {
+    return options;
+  }
+  gint64 source_dpi = get_int_arg(method_call, "sourceDpi", 0);
+  options.source_dpi = source_dpi > 0
+                           ? static_cast<int>(MIN(source_dpi, G_MAXINT))
+                           : estimate_screen_dpi();
+  options.target_dpi = static_cast<int>(CLAMP(
+      get_int_arg(method_call, "targetDpi", options.target_dpi), 0, G_MAXINT));
+  const gchar* binarize = get_string_arg(method_call, "binarize");
+  if (g_strcmp0(binarize, "none") == 0) {
+    options.binarize = OCR_BINARIZE_NONE;
+  } else if (g_strcmp0(binarize, "otsu") == 0) {
+    options.binarize = OCR_BINARIZE_OTSU;
+  }
+  options.deskew = get_bool_arg(method_call, "deskew", false);
+  return options;
+}
+
+// 识别 imageData 中的图像（未给出时识别剪贴板图像），识别在工作线程进行。
+// 参数：language 为 Dart 侧语言设置（见 ocr_languages_for_locale）；
+// jobId 供 cancelOcr 取消；deadlineMs 为识别截止时间；
+// supersede 为 true 时剪贴板变化即取消（识别剪贴板图像时默认开启）；
+// captureSequence 为所识别图像捕获时的剪贴板序号，给出时任务同样随剪贴板
+// 变化取消，捕获之后剪贴板已变化则直接以 CANCELLED 响应；
+// 预处理参数见 get_ocr_preprocess_options；parallelism 大于 1 时大图分块并行识别。
+// 结果附带 timings（各阶段毫秒数）、scale 与 skewAngle；
+// 分块识别时另有 regions（按阅读顺序的 {x, y, width, height, text, confidence}）。
+// useCache（默认 true）为 false 时跳过 OCR 缓存；结果的 cached 表示是否来自缓存。
+// textThreshold（0~1，默认 0 不预判）：预判的文字可能性低于该值时不识别，
+// 结果的 skipped 为 true、text 为空（太小、预判不可靠的图像照常识别）；
+// 预判过时结果附带 textScore。
+// 被取消时以 CANCELLED 错误响应，超时为 OCR_TIMEOUT
+static void perform_ocr(ClipboardPlugin* self, FlMethodCall* method_call) {
+  auto plugin = hold_object(self);
+  guint timeout_ms = get_read_timeout(method_call);
+  auto call = hold_object(method_call);
+  const gchar* language = get_string_arg(method_call, "language");
+  OcrOptions options;
+  options.languages =
+      ocr_languages_for_locale(language != nullptr ? language : "auto");
+  options.deadline_ms = static_cast<int>(
+      CLAMP(get_int_arg(method_call, "deadlineMs", 0), 0, G_MAXINT));
+  options.preprocess = get_ocr_preprocess_options(method_call);
+  options.parallelism = static_cast<int>(
+      CLAMP(get_int_arg(method_call, "parallelism", 1), 1, kOcrMaxParallelism));
+  bool use_cache = get_bool_arg(method_call, "useCache", true);
+
+  FlValue* args = fl_method_call_get_args(method_call);
+  bool has_args =
+      args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP;
+  FlValue* text_threshold =
+      has_args ? fl_value_lookup_string(args, "textThreshold") : nullptr;
+  if (text_threshold != nullptr &&
+      fl_value_get_type(text_threshold) == FL_VALUE_TYPE_FLOAT) {
+    options.text_threshold =
+        CLAMP(fl_value_get_float(text_threshold), 0.0, 1.0);
+  }
+  FlValue* image_data =
+      has_args ? fl_value_lookup_string(args, "imageData") : nullptr;
+  bool has_image_data =
+      image_data != nullptr &&
+      fl_value_get_type(image_data) == FL_VALUE_TYPE_UINT8_LIST &&
+      fl_value_get_length(image_data) > 0;
+
+  gint64 job_id = get_int_arg(method_call, "jobId", 0);
+  if (job_id <= 0) {
+    // 未指定时使用负数 ID，避免与 Dart 分配的 ID 冲突
+    job_id = self->state->ocr_jobs.next_internal_id();
+  }
+  gint64 capture_sequence = get_int_arg(method_call, "captureSequence",
+                                        OcrJobTable::kNoCapture);
+  if (self->state->ocr_jobs.add(
+          job_id, get_bool_arg(method_call, "supersede", !has_image_data),
+          capture_sequence, self->sequence) == nullptr) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "jobId is already in use", nullptr, nullptr);
+    return;
+  }
+
+  if (has_image_data) {
+    // 方法调用持有参数，工作线程直接解码，无需复制
+    const guint8* data = fl_value_get_uint8_list(image_data);
+    size_t length = fl_value_get_length(image_data);
+    run_ocr_job(plugin, call, job_id, options, use_cache, [data, length]() {
+      GBytes* encoded = g_bytes_new_static(data, length);
+      GdkPixbuf* pixbuf = decode_image_bytes(encoded);
+      g_bytes_unref(encoded);
+      return pixbuf;
+    });
+    return;
+  }
+
+  with_clipboard_targets(self, timeout_ms, [plugin, timeout_ms, call, job_id,
+                                            options, use_cache](
+      ClipboardReadStatus status, const ClipboardTargets& targets) {
+    if (status == CLIPBOARD_READ_TIMEOUT) {
+      finish_ocr_job(plugin.get(), job_id);
+      respond_read_timeout(call.get());
+      return;
+    }
+    // 检查剪贴板是否包含图像
+    if (!targets.has_image()) {
+      finish_ocr_job(plugin.get(), job_id);
+      fl_method_call_respond_error(call.get(), "NO_IMAGE", 
+                                 "No image found in clipboard", 
+                                 nullptr, nullptr);
+      return;
+    }
+
+    // 获取剪贴板图像
+    read_snapshot_image(plugin.get(), timeout_ms,
+      [plugin, call, job_id, options, use_cache](ClipboardReadStatus status,
+                                                 GdkPixbuf* pixbuf) {
+        if (status == CLIPBOARD_READ_TIMEOUT) {
+          finish_ocr_job(plugin.get(), job_id);
+          respond_read_timeout(call.get());
+          return;
+        }
+        // 检查剪贴板是否包含图像
+        if (pixbuf == nullptr) {
+          finish_ocr_job(plugin.get(), job_id);
+          fl_method_call_respond_error(call.get(), "NO_IMAGE", 
+                                     "No image found in clipboard", 
+                                     nullptr, nullptr);
+          return;
+        }
+        auto held = hold_object(pixbuf);
+        run_ocr_job(plugin, call, job_id, options, use_cache, [held]() {
+          return GDK_PIXBUF(g_object_ref(held.get()));
+        });
+      });
+  });
+}
+
+// 取消 OCR 任务：{jobId}，返回任务是否存在
+static void cancel_ocr(ClipboardPlugin* self, FlMethodCall* method_call) {
+  gint64 job_id = get_int_arg(method_call, "jobId", 0);
+  g_autoptr(FlValue) result =
+      fl_value_new_bool(self->state->ocr_jobs.cancel(job_id));
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
+
+// 配置 OCR 引擎池与结果缓存：
+// {poolSize?, idleTimeoutSeconds?, warmLanguage?, cacheDirectory?, cacheEntries?}。
+// 给出 warmLanguage 时在工作线程预先初始化该语言的引擎；
+// 给出 cacheDirectory 时启用持久化的 OCR 结果缓存（cacheEntries 为条目上限）
+static void configure_ocr_engines(ClipboardPlugin* self,
+                                  FlMethodCall* method_call) {
+  std::shared_ptr<OcrEnginePool> engines = self->state->ocr_engines;
+  gint64 pool_size = get_int_arg(method_call, "poolSize", 2);
+  gint64 idle_seconds = get_int_arg(method_call, "idleTimeoutSeconds", 300);
+  engines->configure(static_cast<size_t>(std::max<gint64>(0, pool_size)),
+                     std::chrono::seconds(std::max<gint64>(0, idle_seconds)));
+
+  const gchar* cache_directory = get_string_arg(method_call, "cacheDirectory");
+  size_t cache_entries = static_cast<size_t>(std::max<gint64>(
+      0, get_int_arg(method_call, "cacheEntries", kOcrCacheDefaultEntries)));
+  std::shared_ptr<OcrCache>& cache = self->state->ocr_cache;
+  if (cache_directory != nullptr &&
+      (cache == nullptr || cache->directory() != cache_directory)) {
+    // 切换目录前把旧缓存的改动写回
+    if (cache != nullptr && cache->dirty()) {
+      std::shared_ptr<OcrCache> previous = cache;
+      clipboard_worker_run([previous]() { previous->save(); }, []() {});
+    }
+    cache = std::make_shared<OcrCache>(cache_directory, cache_entries);
+  } else if (cache != nullptr) {
+    cache->set_max_entries(cache_entries);
+  }
+
+  const gchar* warm_language = get_string_arg(method_call, "warmLanguage");
+  if (warm_language == nullptr || pool_size <= 0) {
+    g_autoptr(FlValue) result = fl_value_new_bool(TRUE);
+    fl_method_call_respond_success(method_call, result, nullptr);
+    return;
+  }
+
+  std::string languages = ocr_languages_for_locale(warm_language);
+  auto warmed = std::make_shared<bool>(false);
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+  clipboard_worker_run(
+      [engines, languages, warmed]() {
+        *warmed = engines->warm(languages, 1, nullptr) ||
+                  engines->warm(kOcrFallbackLanguages, 1, nullptr);
+      },
+      [plugin, call, warmed]() {
+        schedule_ocr_eviction(plugin.get());
+        g_autoptr(FlValue) result = fl_value_new_bool(*warmed);
+        fl_method_call_respond_success(call.get(), result, nullptr);
+      });
+}
+
+// getClipboardFormats 可选择的格式位
+typedef enum {
+  CLIPBOARD_FORMAT_TEXT = 1 << 0,
+  CLIPBOARD_FORMAT_RTF = 1 << 1,
+  CLIPBOARD_FORMAT_HTML = 1 << 2,
+  CLIPBOARD_FORMAT_FILES = 1 << 3,
+  CLIPBOARD_FORMAT_IMAGE = 1 << 4,
+  CLIPBOARD_FORMAT_ALL = 0x1f,
+} ClipboardFormatBits;
+
+// 格式名与 Dart 侧结果键一致；target 为空表示经由 GTK 转换读取
+struct ClipboardFormatSpec {
+  const gchar* name;
+  guint bit;
+  const gchar* target;
+};
+
+static const ClipboardFormatSpec kClipboardFormats[] = {
+  {"rtf", CLIPBOARD_FORMAT_RTF, "text/rtf"},
+  {"html", CLIPBOARD_FORMAT_HTML, "text/html"},
+  {"files", CLIPBOARD_FORMAT_FILES, "text/uri-list"},
+  {"image", CLIPBOARD_FORMAT_IMAGE, nullptr},
+  {"text", CLIPBOARD_FORMAT_TEXT, nullptr},
+};
+
+static const size_t kClipboardFormatCount = G_N_ELEMENTS(kClipboardFormats);
+
+// 近似重复查询的默认与最大汉明距离
+static const gint kNearDuplicateDefaultDistance = 10;
+static const gint kNearDuplicateMaxDistance = 32;
+
+// getClipboardFormats 的请求参数
+struct ClipboardFormatsRequest {
+  guint mask = CLIPBOARD_FORMAT_ALL;
+  // 每个格式的最大字节数，0 表示不限制
+  gsize max_bytes[kClipboardFormatCount] = {};
+  // 只返回清单，不读取任何负载
+  bool manifest_only = false;
+  // 是否在结果中附带清单（旧调用方式不附带，保持结果结构不变）
+  bool include_manifest = false;
+  // 只有位图时重新编码 PNG 的档位
+  PngEncodeProfile png_profile = PNG_ENCODE_FAST;
+  // 随图像返回的缩略图最大边长，0 表示不生成
+  guint thumbnail_size = 0;
+  // 除 XXH64 外是否同时计算 SHA-256
+  bool sha256 = false;
+  // 是否计算图像感知哈希并查找近似重复的已有图像
+  bool perceptual_hash = false;
+  gint near_duplicate_distance = kNearDuplicateDefaultDistance;
+};
+
+static gint find_clipboard_format(const gchar* name) {
+  for (size_t i = 0; i < kClipboardFormatCount; i++) {
+    if (strcmp(kClipboardFormats[i].name, name) == 0) {
+      return static_cast<gint>(i);
+    }
+  }
+  return -1;
+}
+
+static bool clipboard_format_available(const ClipboardTargets& targets,
+                                       const ClipboardFormatSpec& spec) {
+  if (spec.target != nullptr) {
+    return targets.contains(spec.target);
+  }
+  return spec.bit == CLIPBOARD_FORMAT_IMAGE ? targets.has_image()
+                                            : targets.has_text();
+}
+
+// 解析参数：formats（格式名列表或位掩码）、maxBytes（格式名 → 字节上限；
+// 快照中没有的格式先查询大小，超过上限即不读取）、manifestOnly。
+// 未带任何参数时与旧行为一致。
+static ClipboardFormatsRequest parse_formats_request(FlMethodCall* method_call) {
+  ClipboardFormatsRequest request;
+  request.png_profile = get_png_profile(method_call);
+  gint64 thumbnail_size = get_int_arg(method_call, "thumbnailSize", 0);
+  if (thumbnail_size > 0) {
+    request.thumbnail_size = CLAMP(thumbnail_size, 16, kThumbnailMaxSide);
+  }
+  FlValue* args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return request;
+  }
+
+  FlValue* sha256 = fl_value_lookup_string(args, "sha256");
+  request.sha256 = sha256 != nullptr &&
+                   fl_value_get_type(sha256) == FL_VALUE_TYPE_BOOL &&
+                   fl_value_get_bool(sha256);
+
+  FlValue* perceptual = fl_value_lookup_string(args, "perceptualHash");
+  request.perceptual_hash =
+      perceptual != nullptr &&
+      fl_value_get_type(perceptual) == FL_VALUE_TYPE_BOOL &&
+      fl_value_get_bool(perceptual);
+  gint64 near_distance = get_int_arg(method_call, "nearDuplicateDistance",
+                                     kNearDuplicateDefaultDistance);
+  request.near_duplicate_distance =
+      CLAMP(near_distance, 0, kNearDuplicateMaxDistance);
+
+  FlValue* formats = fl_value_lookup_string(args, "formats");
+  if (formats != nullptr) {
+    request.include_manifest = true;
+    if (fl_value_get_type(formats) == FL_VALUE_TYPE_INT) {
+      request.mask = fl_value_get_int(formats) & CLIPBOARD_FORMAT_ALL;
+    } else if (fl_value_get_type(formats) == FL_VALUE_TYPE_LIST) {
+      request.mask = 0;
+      for (size_t i = 0; i < fl_value_get_length(formats); i++) {
+        FlValue* item = fl_value_get_list_value(formats, i);
+        if (fl_value_get_type(item) != FL_VALUE_TYPE_STRING) {
+          continue;
+        }
+        gint index = find_clipboard_format(fl_value_get_string(item));
+        if (index >= 0) {
+          request.mask |= kClipboardFormats[index].bit;
+        }
+      }
+    }
+  }
+
+  FlValue* max_bytes = fl_value_lookup_string(args, "maxBytes");
+  if (max_bytes != nullptr && fl_value_get_type(max_bytes) == FL_VALUE_TYPE_MAP) {
+    request.include_manifest = true;
+    for (size_t i = 0; i < fl_value_get_length(max_bytes); i++) {
+      FlValue* key = fl_value_get_map_key(max_bytes, i);
+      FlValue* value = fl_value_get_map_value(max_bytes, i);
+      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING ||
+          fl_value_get_type(value) != FL_VALUE_TYPE_INT) {
+        continue;
+      }
+      gint index = find_clipboard_format(fl_value_get_string(key));
+      if (index >= 0 && fl_value_get_int(value) > 0) {
+        request.max_bytes[index] = fl_value_get_int(value);
+      }
+    }
+  }
+
+  FlValue* manifest_only = fl_value_lookup_string(args, "manifestOnly");
+  if (manifest_only != nullptr &&
+      fl_value_get_type(manifest_only) == FL_VALUE_TYPE_BOOL) {
+    request.manifest_only = fl_value_get_bool(manifest_only);
+    request.include_manifest = request.include_manifest || request.manifest_only;
+  }
+
+  return request;
+}
+
+// getClipboardFormats 的并行读取结果，按 kClipboardFormats 下标存放
+struct ClipboardFormatsResult {
+  // 本次读取到的全部数据，以及其中实际返回给 Dart 的部分
+  GBytes* read[kClipboardFormatCount] = {};
+  GBytes* payloads[kClipboardFormatCount] = {};
+  bool too_large[kClipboardFormatCount] = {};
+
+  // 未读取负载的格式查询到的大小；size_exact 为 false 时是 INCR 声明的
+  // 下限，或重新编码前的大小
+  bool probed[kClipboardFormatCount] = {};
+  gsize probed_size[kClipboardFormatCount] = {};
+  bool size_exact[kClipboardFormatCount] = {};
+
+  // 各格式的内容指纹（十六进制），未计算时为空
+  std::string xxh64[kClipboardFormatCount];
+  std::string sha256[kClipboardFormatCount];
+
+  // 图像缩略图、原图尺寸与感知哈希
+  GBytes* thumbnail = nullptr;
+  ClipboardImageInfo image_info;
+
+  ~ClipboardFormatsResult() {
+    for (auto& bytes : read) {
+      g_clear_pointer(&bytes, g_bytes_unref);
+    }
+    for (auto& payload : payloads) {
+      g_clear_pointer(&payload, g_bytes_unref);
+    }
+    g_clear_pointer(&thumbnail, g_bytes_unref);
+  }
+};
+
+static FlValue* new_string_from_bytes(GBytes* bytes) {
+  gsize length = 0;
+  const gchar* data =
+      static_cast<const gchar*>(g_bytes_get_data(bytes, &length));
+  gchar* text = g_strndup(data, length);
+  FlValue* value = fl_value_new_string(text);
+  g_free(text);
+  return value;
+}
+
+static std::string format_hash_hex(guint64 hash) {
+  gchar buffer[17];
+  g_snprintf(buffer, sizeof(buffer), "%016" G_GINT64_MODIFIER "x", hash);
+  return buffer;
+}
+
+// 快照缓存中格式数据对应的键（未缓存时无法给出大小与哈希）
+static std::string snapshot_key_for_format(const ClipboardTargets& targets,
+                                           const ClipboardFormatSpec& spec) {
+  if (spec.target != nullptr) {
+    return spec.target;
+  }
+  if (spec.bit == CLIPBOARD_FORMAT_IMAGE) {
+    const gchar* encoded_target = negotiate_image_target(targets);
+    return encoded_target != nullptr ? encoded_target : kSnapshotPngKey;
+  }
+  return kSnapshotTextKey;
+}
+
+// 快照缓存中是否已有该格式的数据
+static bool snapshot_has_format(ClipboardPlugin* self,
+                                const ClipboardTargets& targets,
+                                const ClipboardFormatSpec& spec) {
+  GBytes* bytes = nullptr;
+  if (!self->state->snapshot.peek(snapshot_key_for_format(targets, spec),
+                                  &bytes)) {
+    return false;
+  }
+  if (bytes != nullptr) {
+    g_bytes_unref(bytes);
+  }
+  return true;
+}
+
+// 查询大小时请求的目标：与读取负载时相同的格式。只有位图时取首个图像
+// 目标（编码为 PNG 之前的大小），文本取 UTF8_STRING；
+// exact 表示查询到的即是负载的大小
+static GdkAtom size_probe_target(const ClipboardTargets& targets,
+                                 const ClipboardFormatSpec& spec,
+                                 bool* exact) {
+  *exact = true;
+  if (spec.target != nullptr) {
+    return gdk_atom_intern_static_string(spec.target);
+  }
+  if (spec.bit == CLIPBOARD_FORMAT_IMAGE) {
+    const gchar* encoded_target = negotiate_image_target(targets);
+    if (encoded_target != nullptr) {
+      return gdk_atom_intern_static_string(encoded_target);
+    }
+  } else if (targets.contains("UTF8_STRING")) {
+    return gdk_atom_intern_static_string("UTF8_STRING");
+  }
+  *exact = false;
+  for (GdkAtom atom : targets.atoms) {
+    if (spec.bit == CLIPBOARD_FORMAT_IMAGE
+            ? gtk_targets_include_image(&atom, 1, FALSE)
+            : gtk_targets_include_text(&atom, 1)) {
+      return atom;
+    }
+  }
+  return GDK_NONE;
+}
+
+// 快照缓存中格式指纹的键
+static std::string hash_snapshot_key(const ClipboardFormatSpec& spec,
+                                     const gchar* algorithm) {
+  return std::string("x-clip-flow/hash/") + algorithm + "/" + spec.name;
+}
+
+static std::string peek_snapshot_string(const ClipboardSnapshotCache& snapshot,
+                                        const std::string& key) {
+  GBytes* bytes = nullptr;
+  if (!snapshot.peek(key, &bytes) || bytes == nullptr) {
+    return std::string();
+  }
+  gsize length = 0;
+  const gchar* data =
+      static_cast<const gchar*>(g_bytes_get_data(bytes, &length));
+  std::string value(data, length);
+  g_bytes_unref(bytes);
+  return value;
+}
+
+// 构建格式清单：可用的 MIME 类型，已读取格式的字节数与哈希，
+// 以及未读取格式查询到的字节数（sizeExact 为 false 时是下限或编码前的大小）
+static FlValue* build_formats_manifest(ClipboardPlugin* self,
+                                       const ClipboardTargets& targets,
+                                       const ClipboardFormatsRequest& request,
+                                       const ClipboardFormatsResult& result) {
+  FlValue* manifest = fl_value_new_map();
+
+  FlValue* mime_types = fl_value_new_list();
+  for (GdkAtom atom : targets.atoms) {
+    gchar* name = gdk_atom_name(atom);
+    if (name != nullptr) {
+      fl_value_append_take(mime_types, fl_value_new_string(name));
+      g_free(name);
+    }
+  }
+  fl_value_set_string_take(manifest, "mimeTypes", mime_types);
+
+  FlValue* formats = fl_value_new_map();
+  for (size_t i = 0; i < kClipboardFormatCount; i++) {
+    const ClipboardFormatSpec& spec = kClipboardFormats[i];
+    if (!clipboard_format_available(targets, spec)) {
+      continue;
+    }
+
+    FlValue* entry = fl_value_new_map();
+    if (spec.bit == CLIPBOARD_FORMAT_IMAGE) {
+      // 图像负载的实际编码：透传的原始格式，或重新编码的 PNG
+      const gchar* encoded_target = negotiate_image_target(targets);
+      fl_value_set_string_take(
+          entry, "mimeType",
+          fl_value_new_string(encoded_target != nullptr ? encoded_target
+                                                        : "image/png"));
+    }
+    GBytes* bytes = result.read[i] != nullptr ? g_bytes_ref(result.read[i])
+                                              : nullptr;
+    bool from_snapshot = false;
+    if (bytes == nullptr) {
+      from_snapshot =
+          self->state->snapshot.peek(snapshot_key_for_format(targets, spec),
+                                     &bytes);
+    }
+    if (bytes != nullptr) {
+      gsize length = 0;
+      const void* data = g_bytes_get_data(bytes, &length);
+      // 缓存中的文本包含结尾的 NUL
+      if (from_snapshot && spec.bit == CLIPBOARD_FORMAT_TEXT && length > 0) {
+        length--;
+      }
+      fl_value_set_string_take(entry, "size", fl_value_new_int(length));
+      std::string hash = result.xxh64[i];
+      if (hash.empty()) {
+        hash = peek_snapshot_string(self->state->snapshot,
+                                    hash_snapshot_key(spec, "xxh64"));
+      }
+      if (hash.empty()) {
+        hash = format_hash_hex(content_hash_xxh64(data, length));
+      }
+      fl_value_set_string_take(entry, "hash",
+                               fl_value_new_string(hash.c_str()));
+      if (!result.sha256[i].empty()) {
+        fl_value_set_string_take(
+            entry, "sha256", fl_value_new_string(result.sha256[i].c_str()));
+      }
+      g_bytes_unref(bytes);
+    } else if (result.probed[i]) {
+      fl_value_set_string_take(entry, "size",
+                               fl_value_new_int(result.probed_size[i]));
+      if (!result.size_exact[i]) {
+        fl_value_set_string_take(entry, "sizeExact", fl_value_new_bool(FALSE));
+      }
+    }
+    if (result.too_large[i]) {
+      fl_value_set_string_take(entry, "skipped", fl_value_new_string("tooLarge"));
+    } else if (request.manifest_only || !(request.mask & spec.bit)) {
+      fl_value_set_string_take(entry, "skipped", fl_value_new_string("notRequested"));
+    }
+    fl_value_set_string_take(formats, spec.name, entry);
+  }
+  fl_value_set_string_take(manifest, "formats", formats);
+
+  return manifest;
+}
+
+// 低于该总量时直接在主线程计算指纹，省去线程切换
+static const gsize kInlineHashMaxBytes = 256 * 1024;
+
+// 计算本次读取到的各格式指纹：XXH64 恒定计算，SHA-256 按需。
+// 同一剪贴板状态下的结果缓存在快照中；大负载在工作线程上计算
+static void hash_clipboard_formats(ClipboardPlugin* self,
+                                   std::shared_ptr<ClipboardFormatsResult> result,
+                                   bool want_sha256,
+                                   std::function<void()> done) {
+  struct PendingHash {
+    size_t index;
+    GBytes* bytes;
+    bool need_xxh64;
+    bool need_sha256;
+    std::string xxh64;
+    std::string sha256;
+  };
+  auto pending = std::make_shared<std::vector<PendingHash>>();
+  ClipboardSnapshotCache& snapshot = self->state->snapshot;
+  gsize pending_bytes = 0;
+
+  for (size_t i = 0; i < kClipboardFormatCount; i++) {
+    if (result->read[i] == nullptr) {
+      continue;
+    }
+    const ClipboardFormatSpec& spec = kClipboardFormats[i];
+    result->xxh64[i] = peek_snapshot_string(snapshot,
+                                            hash_snapshot_key(spec, "xxh64"));
+    if (want_sha256) {
+      result->sha256[i] = peek_snapshot_string(
+          snapshot, hash_snapshot_key(spec, "sha256"));
+    }
+    bool need_xxh64 = result->xxh64[i].empty();
+    bool need_sha256 = want_sha256 && result->sha256[i].empty();
+    if (need_xxh64 || need_sha256) {
+      pending->push_back({i, g_bytes_ref(result->read[i]), need_xxh64,
+                          need_sha256, std::string(), std::string()});
+      pending_bytes += g_bytes_get_size(result->read[i]);
+    }
+  }
+  if (pending->empty()) {
+    done();
+    return;
+  }
+
+  auto compute = [pending]() {
+    for (PendingHash& item : *pending) {
+      gsize length = 0;
+      const void* data = g_bytes_get_data(item.bytes, &length);
+      if (item.need_xxh64) {
+        item.xxh64 = format_hash_hex(content_hash_xxh64(data, length));
+      }
+      if (item.need_sha256) {
+        gchar* digest = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256,
+                                                     item.bytes);
+        item.sha256 = digest;
+        g_free(digest);
+      }
+    }
+  };
+  auto plugin = hold_object(self);
+  guint epoch = snapshot.epoch();
+  auto finish = [plugin, pending, result, epoch, done]() {
+    ClipboardSnapshotCache& snapshot = plugin->state->snapshot;
+    for (PendingHash& item : *pending) {
+      const ClipboardFormatSpec& spec = kClipboardFormats[item.index];
+      if (item.need_xxh64) {
+        result->xxh64[item.index] = item.xxh64;
+        GBytes* value = g_bytes_new(item.xxh64.data(), item.xxh64.size());
+        snapshot.store(epoch, hash_snapshot_key(spec, "xxh64"), value);
+        g_bytes_unref(value);
+      }
+      if (item.need_sha256) {
+        result->sha256[item.index] = item.sha256;
+        GBytes* value = g_bytes_new(item.sha256.data(), item.sha256.size());
+        snapshot.store(epoch, hash_snapshot_key(spec, "sha256"), value);
+        g_bytes_unref(value);
+      }
+      g_bytes_unref(item.bytes);
+    }
+    done();
+  };
+
+  if (pending_bytes <= kInlineHashMaxBytes) {
+    compute();
+    finish();
+  } else {
+    clipboard_worker_run(compute, finish);
+  }
+}
+
+static void collect_clipboard_formats(ClipboardPlugin* self,
+                                      std::shared_ptr<FlMethodCall> call,
+                                      guint timeout_ms,
+                                      const ClipboardFormatsRequest& request) {
+  auto plugin = hold_object(self);
+  gint64 sequence = self->sequence;
+  gint64 timestamp = self->last_change_time;
+
+  with_clipboard_targets(self, timeout_ms,
+      [plugin, call, timeout_ms, request, sequence, timestamp](
+          ClipboardReadStatus status, const ClipboardTargets& targets) {
+    if (status == CLIPBOARD_READ_TIMEOUT) {
+      respond_read_timeout(call.get());
       return;
     }
-    
-    // 将 GdkPixbuf 转换为 Leptonica PIX 格式
-    gint width = gdk_pixbuf_get_width(pixbuf);
-    gint height = gdk_pixbuf_get_height(pixbuf);
-    gint channels = gdk_pixbuf_get_n_channels(pixbuf);
-    gint rowstride = gdk_pixbuf_get_rowstride(pixbuf);
-    guchar* pixels = gdk_pixbuf_get_pixels(pixbuf);
-    
-    // 创建 PIX 对象
-    PIX* pix = nullptr;
-    if (channels == 3) {
-      // RGB 图像
-      pix = pixCreate(width, height, 24);
-      if (pix != nullptr) {
-        l_uint32* data = pixGetData(pix);
-        for (int y = 0; y < height; y++) {
-          for (int x = 0; x < width; x++) {
-            guchar* pixel = pixels + y * rowstride + x * channels;
-            l_uint32 val = (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
-            SET_DATA_BYTE(data, y * width + x, val);
+
+    auto result = std::make_shared<ClipboardFormatsResult>();
+    auto targets_copy = std::make_shared<ClipboardTargets>(targets);
+    ClipboardReadGroup* group = clipboard_read_group_new(
+        [plugin, call, request, result, targets_copy, sequence, timestamp]() {
+      // 各格式指纹在工作线程上计算完成后再响应
+      hash_clipboard_formats(plugin.get(), result, request.sha256,
+          [plugin, call, request, result, targets_copy, sequence, timestamp]() {
+          g_autoptr(FlValue) result_map = fl_value_new_map();
+
+          // 添加序列号和时间戳（与 getClipboardSequence 共用插件级序列号）
+          fl_value_set_string_take(result_map, "sequence", fl_value_new_int(sequence));
+          fl_value_set_string_take(result_map, "timestamp", fl_value_new_int(timestamp));
+
+          // RTF / HTML 格式
+          for (guint bit : {CLIPBOARD_FORMAT_RTF, CLIPBOARD_FORMAT_HTML}) {
+            for (size_t i = 0; i < kClipboardFormatCount; i++) {
+              if (kClipboardFormats[i].bit == bit && result->payloads[i] != nullptr) {
+                fl_value_set_string_take(result_map, kClipboardFormats[i].name,
+                                         new_string_from_bytes(result->payloads[i]));
+              }
+            }
+          }
+
+          // 文件格式
+          GBytes* uri_list = result->payloads[find_clipboard_format("files")];
+          if (uri_list != nullptr) {
+            std::vector<std::string> file_paths = parse_file_uri_list(uri_list);
+            if (!file_paths.empty()) {
+              FlValue* paths_list = fl_value_new_list();
+              for (const auto& path : file_paths) {
+                fl_value_append_take(paths_list, fl_value_new_string(path.c_str()));
+              }
+              fl_value_set_string_take(result_map, "files", paths_list);
+            }
+          }
+
+          // 图片格式
+          GBytes* image_png = result->payloads[find_clipboard_format("image")];
+          if (image_png != nullptr) {
+            fl_value_set_string_take(result_map, "image",
+                                     fl_value_new_uint8_list_from_bytes(image_png));
           }
+          // 缩略图：超过 maxBytes 未返回原图时同样提供，列表无需解码原图即可渲染
+          if (result->thumbnail != nullptr) {
+            fl_value_set_string_take(
+                result_map, "imageThumbnail",
+                fl_value_new_uint8_list_from_bytes(result->thumbnail));
+            fl_value_set_string_take(result_map, "imageWidth",
+                                     fl_value_new_int(result->image_info.width));
+            fl_value_set_string_take(result_map, "imageHeight",
+                                     fl_value_new_int(result->image_info.height));
+          }
+          // 感知哈希及索引中最接近的已有图像
+          if (request.perceptual_hash &&
+              result->image_info.has_perceptual_hash) {
+            guint64 phash = result->image_info.perceptual_hash;
+            fl_value_set_string_take(
+                result_map, "imagePerceptualHash",
+                fl_value_new_string(format_hash_hex(phash).c_str()));
+            std::string near_id;
+            int distance = 0;
+            if (plugin->state->image_hash_index.nearest(
+                    phash, request.near_duplicate_distance, "", &near_id,
+                    &distance)) {
+              FlValue* near = fl_value_new_map();
+              fl_value_set_string_take(near, "id",
+                                       fl_value_new_string(near_id.c_str()));
+              fl_value_set_string_take(near, "distance",
+                                       fl_value_new_int(distance));
+              fl_value_set_string_take(result_map, "imageNearDuplicate", near);
+            }
+          }
+
+          // 文本格式
+          GBytes* text = result->payloads[find_clipboard_format("text")];
+          if (text != nullptr) {
+            fl_value_set_string_take(result_map, "text", new_string_from_bytes(text));
+          }
+
+          // 各格式的内容指纹，去重无需在 Dart 侧再次读取负载
+          FlValue* hashes = fl_value_new_map();
+          for (size_t i = 0; i < kClipboardFormatCount; i++) {
+            if (result->xxh64[i].empty()) {
+              continue;
+            }
+            FlValue* entry = fl_value_new_map();
+            fl_value_set_string_take(
+                entry, "xxh64", fl_value_new_string(result->xxh64[i].c_str()));
+            if (!result->sha256[i].empty()) {
+              fl_value_set_string_take(
+                  entry, "sha256",
+                  fl_value_new_string(result->sha256[i].c_str()));
+            }
+            fl_value_set_string_take(hashes, kClipboardFormats[i].name, entry);
+          }
+          fl_value_set_string_take(result_map, "hashes", hashes);
+
+          if (request.include_manifest) {
+            fl_value_set_string_take(
+                result_map, "manifest",
+                build_formats_manifest(plugin.get(), *targets_copy, request, *result));
+          }
+
+          fl_method_call_respond_success(call.get(), result_map, nullptr);
+      });
+    });
+
+    // 读取第 i 个格式的负载，在 group 内完成
+    auto read_format = [plugin, group, result, request, targets_copy,
+                        timeout_ms](size_t i) {
+      const ClipboardFormatSpec& spec = kClipboardFormats[i];
+      const ClipboardTargets& targets = *targets_copy;
+      gsize max_bytes = request.max_bytes[i];
+      // 超过上限的负载不返回，只在清单中标记（无法事先查询大小时）
+      auto accept = [result, i, max_bytes](GBytes* bytes, gsize length) {
+        // 超过上限的负载同样计算指纹
+        result->read[i] = g_bytes_ref(bytes);
+        if (max_bytes > 0 && length > max_bytes) {
+          result->too_large[i] = true;
+          return;
         }
+        result->payloads[i] = g_bytes_ref(bytes);
+      };
+
+      clipboard_read_group_enter(group);
+      if (spec.target != nullptr) {
+        read_snapshot_contents(plugin.get(), spec.target, timeout_ms,
+            [group, accept](ClipboardReadStatus status, GBytes* bytes) {
+              if (bytes != nullptr) {
+                accept(bytes, g_bytes_get_size(bytes));
+              }
+              clipboard_read_group_leave(group);
+            });
+      } else if (spec.bit == CLIPBOARD_FORMAT_IMAGE) {
+        // 编码后的图像字节：优先透传原始 PNG/JPEG，仅位图时编码为 PNG
+        guint thumbnail_size = request.thumbnail_size;
+        bool analyze = thumbnail_size > 0 || request.perceptual_hash;
+        read_snapshot_image_encoded(plugin.get(), targets, timeout_ms,
+            request.png_profile,
+            [plugin, group, accept, result, thumbnail_size, analyze](
+                ClipboardReadStatus status, GBytes* image) {
+              if (image != nullptr) {
+                accept(image, g_bytes_get_size(image));
+              }
+              if (image != nullptr && analyze) {
+                read_snapshot_thumbnail(plugin.get(), image, thumbnail_size,
+                    [group, result](GBytes* thumbnail,
+                                    const ClipboardImageInfo& info) {
+                      if (thumbnail != nullptr) {
+                        result->thumbnail = g_bytes_ref(thumbnail);
+                      }
+                      result->image_info = info;
+                      clipboard_read_group_leave(group);
+                    });
+                return;
+              }
+              clipboard_read_group_leave(group);
+            });
+      } else {
+        read_snapshot_text(plugin.get(), timeout_ms,
+            [group, accept](ClipboardReadStatus status, const gchar* text) {
+              if (text != nullptr) {
+                gsize length = strlen(text);
+                GBytes* bytes = g_bytes_new(text, length);
+                accept(bytes, length);
+                g_bytes_unref(bytes);
+              }
+              clipboard_read_group_leave(group);
+            });
       }
-    } else if (channels == 4) {
-      // RGBA 图像，忽略 alpha 通道
-      pix = pixCreate(width, height, 24);
-      if (pix != nullptr) {
-        l_uint32* data = pixGetData(pix);
-        for (int y = 0; y < height; y++) {
-          for (int x = 0; x < width; x++) {
-            guchar* pixel = pixels + y * rowstride + x * channels;
-            l_uint32 val = (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
-            SET_DATA_BYTE(data, y * width + x, val);
-          }
+    };
+
+    // 检查并收集所请求的可用格式，各格式并行读取。
+    // 快照中没有的格式：有字节上限时先查询大小，超过上限即不读取；
+    // 不读取但需要清单的格式只查询大小
+    for (size_t i = 0; i < kClipboardFormatCount; i++) {
+      const ClipboardFormatSpec& spec = kClipboardFormats[i];
+      if (!clipboard_format_available(targets, spec)) {
+        continue;
+      }
+      bool wanted = !request.manifest_only && (request.mask & spec.bit);
+      bool cached = snapshot_has_format(plugin.get(), targets, spec);
+      gsize max_bytes = request.max_bytes[i];
+      if (wanted && (cached || max_bytes == 0)) {
+        read_format(i);
+        continue;
+      }
+      if (cached || (!wanted && !request.include_manifest)) {
+        continue;
+      }
+      bool exact = false;
+      GdkAtom probe_target = size_probe_target(targets, spec, &exact);
+      if (probe_target == GDK_NONE) {
+        if (wanted) {
+          read_format(i);
         }
+        continue;
       }
+
+      clipboard_read_group_enter(group);
+      clipboard_read_size(plugin->clipboard, probe_target, timeout_ms,
+          [group, result, read_format, i, wanted, exact, max_bytes](
+              ClipboardReadStatus status, gsize size, bool lower_bound) {
+            if (status == CLIPBOARD_READ_OK) {
+              result->probed[i] = true;
+              result->probed_size[i] = size;
+              result->size_exact[i] = exact && !lower_bound;
+            }
+            if (wanted) {
+              // 下限已超过上限同样不必读取；编码前的大小不作判断
+              if (status == CLIPBOARD_READ_OK && exact && size > max_bytes) {
+                result->too_large[i] = true;
+              } else {
+                read_format(i);
+              }
+            }
+            clipboard_read_group_leave(group);
+          });
     }
-    
-    if (pix == nullptr) {
-      delete ocr;
-      g_object_unref(pixbuf);
-      fl_method_call_respond_error(method_call, "IMAGE_ERROR", 
-                                 "Failed to convert image format", 
-                                 nullptr, nullptr);
-      return;
+
+    clipboard_read_group_leave(group);
+  });
+}
+
+static void get_clipboard_formats(ClipboardPlugin* self,
+                                  FlMethodCall* method_call) {
+  auto call = hold_object(method_call);
+  guint timeout_ms = get_read_timeout(method_call);
+  ClipboardFormatsRequest request = parse_formats_request(method_call);
+
+  if (tracking_owner_change(self)) {
+    collect_clipboard_formats(self, call, timeout_ms, request);
+    return;
+  }
+
+  // 轮询路径：先刷新指纹以获得准确的序列号
+  auto plugin = hold_object(self);
+  refresh_clipboard_state(self, 0, 0, [plugin, call, timeout_ms, request]() {
+    collect_clipboard_formats(plugin.get(), call, timeout_ms, request);
+  });
+}
+
+// 按需读取单个格式的负载，参数 format 为格式名，maxBytes 可选
+static void get_clipboard_format_data(ClipboardPlugin* self,
+                                      FlMethodCall* method_call) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  FlValue* format = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                        ? fl_value_lookup_string(args, "format")
+                        : nullptr;
+  gint index = format != nullptr && fl_value_get_type(format) == FL_VALUE_TYPE_STRING
+                   ? find_clipboard_format(fl_value_get_string(format))
+                   : -1;
+  if (index < 0) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "Unknown clipboard format", nullptr, nullptr);
+    return;
+  }
+
+  ClipboardFormatsRequest request;
+  request.mask = kClipboardFormats[index].bit;
+  gint64 max_bytes = get_int_arg(method_call, "maxBytes", 0);
+  request.max_bytes[index] = max_bytes > 0 ? max_bytes : 0;
+  request.include_manifest = true;
+  request.png_profile = get_png_profile(method_call);
+
+  collect_clipboard_formats(self, hold_object(method_call),
+                            get_read_timeout(method_call), request);
+}
+
+// 选择流式传输的目标格式：显式 target 优先，否则按格式名映射
+static GdkAtom resolve_stream_target(const ClipboardTargets& targets,
+                                     const gchar* format,
+                                     const gchar* target) {
+  if (target != nullptr) {
+    return targets.contains(target) ? gdk_atom_intern(target, FALSE)
+                                    : GDK_NONE;
+  }
+  if (format == nullptr) {
+    return GDK_NONE;
+  }
+  gint index = find_clipboard_format(format);
+  if (index < 0) {
+    return GDK_NONE;
+  }
+  const ClipboardFormatSpec& spec = kClipboardFormats[index];
+  if (spec.target != nullptr) {
+    return targets.contains(spec.target)
+               ? gdk_atom_intern_static_string(spec.target)
+               : GDK_NONE;
+  }
+  // 流式传输不经过 GTK 转换，只能使用所有者原生提供的格式
+  if (spec.bit == CLIPBOARD_FORMAT_IMAGE) {
+    const gchar* encoded_target = negotiate_image_target(targets);
+    return encoded_target != nullptr
+               ? gdk_atom_intern_static_string(encoded_target)
+               : GDK_NONE;
+  }
+  static const gchar* const kTextTargets[] = {"UTF8_STRING",
+                                              "text/plain;charset=utf-8"};
+  for (const gchar* candidate : kTextTargets) {
+    if (targets.contains(candidate)) {
+      return gdk_atom_intern_static_string(candidate);
     }
-    
-    // 设置图像到 OCR 引擎
-    ocr->SetImage(pix);
-    
-    // 执行 OCR 识别
-    char* recognized_text = ocr->GetUTF8Text();
-    
-    if (recognized_text == nullptr) {
-      delete ocr;
-      pixDestroy(&pix);
-      g_object_unref(pixbuf);
-      fl_method_call_respond_error(method_call, "OCR_ERROR", 
-                                 "OCR recognition failed", 
+  }
+  return GDK_NONE;
+}
+
+// 打开大负载的分块流：返回 streamId，数据块随后经 clipboard_stream 通道送达
+static void open_clipboard_stream(ClipboardPlugin* self,
+                                  FlMethodCall* method_call) {
+  const gchar* format_arg = get_string_arg(method_call, "format");
+  const gchar* target_arg = get_string_arg(method_call, "target");
+  if (format_arg == nullptr && target_arg == nullptr) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "Either format or target is required",
                                  nullptr, nullptr);
-      return;
-    }
-    
-    // 创建返回结果
-    g_autoptr(FlValue) result_map = fl_value_new_map();
-    g_autoptr(FlValue) text_value = fl_value_new_string(recognized_text);
-    g_autoptr(FlValue) confidence_value = fl_value_new_float(ocr->MeanTextConf() / 100.0);
-    
-    fl_value_set_string_take(result_map, "text", fl_value_ref(text_value));
-    fl_value_set_string_take(result_map, "confidence", fl_value_ref(confidence_value));
-    
-    fl_method_call_respond_success(method_call, result_map, nullptr);
-    
-    // 清理资源
-    delete[] recognized_text;
-    delete ocr;
-    pixDestroy(&pix);
-    g_object_unref(pixbuf);
-    
-  } catch (const std::exception& e) {
-    g_object_unref(pixbuf);
-    std::string error_msg = "OCR failed: " + std::string(e.what());
-    fl_method_call_respond_error(method_call, "OCR_ERROR", 
-                               error_msg.c_str(), 
-                               nullptr, nullptr);
-  } catch (...) {
-    g_object_unref(pixbuf);
-    fl_method_call_respond_error(method_call, "OCR_ERROR", 
-                               "Unknown OCR error occurred", 
-                               nullptr, nullptr);
+    return;
+  }
+
+  ClipboardStreamOptions options;
+  gint64 chunk_bytes = get_int_arg(method_call, "chunkBytes", 0);
+  if (chunk_bytes > 0) {
+    options.chunk_bytes = CLAMP(chunk_bytes, 4096, 16 * 1024 * 1024);
+  }
+  gint64 max_bytes = get_int_arg(method_call, "maxBytes", 0);
+  options.max_bytes = max_bytes > 0 ? max_bytes : 0;
+  options.timeout_ms = get_read_timeout(method_call);
+
+  std::string format = format_arg != nullptr ? format_arg : "";
+  std::string target = target_arg != nullptr ? target_arg : "";
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+  with_clipboard_targets(
+      self, options.timeout_ms,
+      [plugin, call, format, target, options](
+          ClipboardReadStatus status, const ClipboardTargets& targets) {
+        if (status == CLIPBOARD_READ_TIMEOUT) {
+          respond_read_timeout(call.get());
+          return;
+        }
+        GdkAtom atom = resolve_stream_target(
+            targets, format.empty() ? nullptr : format.c_str(),
+            target.empty() ? nullptr : target.c_str());
+        if (atom == GDK_NONE || plugin->messenger == nullptr) {
+          fl_method_call_respond_error(call.get(), "NOT_AVAILABLE",
+                                       "Requested format is not on the clipboard",
+                                       nullptr, nullptr);
+          return;
+        }
+
+        ClipboardPluginState* state = plugin->state;
+        gint id = state->next_stream_id++;
+        ClipboardStream* stream = new ClipboardStream(
+            id, plugin->messenger, plugin->clipboard, atom, options,
+            [state](gint finished_id) { state->streams.erase(finished_id); });
+        state->streams[id] = std::unique_ptr<ClipboardStream>(stream);
+
+        gchar* target_name = gdk_atom_name(atom);
+        g_autoptr(FlValue) result = fl_value_new_map();
+        fl_value_set_string_take(result, "streamId", fl_value_new_int(id));
+        fl_value_set_string_take(result, "target",
+                                 fl_value_new_string(target_name));
+        g_free(target_name);
+        fl_method_call_respond_success(call.get(), result, nullptr);
+
+        // 先应答 streamId，Dart 收到首块时已能识别该流
+        stream->start();
+      });
+}
+
+static void cancel_clipboard_stream(ClipboardPlugin* self,
+                                    FlMethodCall* method_call) {
+  gint64 id = get_int_arg(method_call, "streamId", 0);
+  auto it = self->state->streams.find(static_cast<gint>(id));
+  bool found = it != self->state->streams.end();
+  if (found) {
+    it->second->cancel("Cancelled by the caller");
   }
+  g_autoptr(FlValue) result = fl_value_new_bool(found);
+  fl_method_call_respond_success(method_call, result, nullptr);
 }
 
-static void get_clipboard_formats(FlMethodCall* method_call) {
-  GtkClipboard* clipboard = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
+// 读取字符串列表参数；缺失或类型不符时返回 nullptr
+static FlValue* get_string_list_arg(FlMethodCall* method_call,
+                                    const gchar* key) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+  FlValue* value = fl_value_lookup_string(args, key);
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_LIST) {
+    return nullptr;
+  }
+  return value;
+}
 
-  g_autoptr(FlValue) result_map = fl_value_new_map();
+// 批量写入去重索引：hashes 与可选的 ids 一一对应，省略 ids 时 ID 即哈希
+static void dedup_index_add(ClipboardPlugin* self, FlMethodCall* method_call) {
+  FlValue* hashes = get_string_list_arg(method_call, "hashes");
+  FlValue* ids = get_string_list_arg(method_call, "ids");
+  if (hashes == nullptr || (ids != nullptr && fl_value_get_length(ids) !=
+                                                  fl_value_get_length(hashes))) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "hashes (and matching ids) are required",
+                                 nullptr, nullptr);
+    return;
+  }
 
-  // 添加序列号和时间戳
-  static gint64 last_sequence = 0;
-  last_sequence++;
-  gint64 timestamp = g_get_real_time() / 1000; // 转换为毫秒
+  DedupIndex& index = self->state->dedup_index;
+  for (size_t i = 0; i < fl_value_get_length(hashes); i++) {
+    FlValue* hash = fl_value_get_list_value(hashes, i);
+    if (fl_value_get_type(hash) != FL_VALUE_TYPE_STRING) {
+      continue;
+    }
+    const gchar* key = fl_value_get_string(hash);
+    const gchar* id = nullptr;
+    if (ids != nullptr) {
+      FlValue* id_value = fl_value_get_list_value(ids, i);
+      if (fl_value_get_type(id_value) == FL_VALUE_TYPE_STRING) {
+        id = fl_value_get_string(id_value);
+      }
+    }
+    // ID 与哈希相同时不重复保存
+    index.insert(key, id == nullptr || strcmp(id, key) == 0 ? "" : id);
+  }
 
-  fl_value_set_string_take(result_map, "sequence", fl_value_new_int(last_sequence));
-  fl_value_set_string_take(result_map, "timestamp", fl_value_new_int(timestamp));
+  g_autoptr(FlValue) result =
+      fl_value_new_int(static_cast<int64_t>(index.size()));
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
 
-  // 检查并收集所有可用格式
+// 查询哈希对应的剪贴项 ID；未收录时返回 null
+static void dedup_index_lookup(ClipboardPlugin* self,
+                               FlMethodCall* method_call) {
+  const gchar* hash = get_string_arg(method_call, "hash");
+  std::string id;
+  g_autoptr(FlValue) result =
+      hash != nullptr && self->state->dedup_index.lookup(hash, &id)
+          ? fl_value_new_string(id.c_str())
+          : fl_value_new_null();
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
 
-  // RTF 格式
-  if (gtk_clipboard_wait_is_target_available(clipboard, gdk_atom_intern("text/rtf", FALSE))) {
-    GtkSelectionData* selection_data = gtk_clipboard_wait_for_contents(clipboard, gdk_atom_intern("text/rtf", FALSE));
-    if (selection_data != nullptr) {
-      const guchar* data = gtk_selection_data_get_data(selection_data);
-      gint length = gtk_selection_data_get_length(selection_data);
-      if (data != nullptr && length > 0) {
-        gchar* rtf_text = g_strndup((const gchar*)data, length);
-        fl_value_set_string_take(result_map, "rtf", fl_value_new_string(rtf_text));
-        g_free(rtf_text);
+static void dedup_index_remove(ClipboardPlugin* self,
+                               FlMethodCall* method_call) {
+  FlValue* hashes = get_string_list_arg(method_call, "hashes");
+  int64_t removed = 0;
+  if (hashes != nullptr) {
+    for (size_t i = 0; i < fl_value_get_length(hashes); i++) {
+      FlValue* hash = fl_value_get_list_value(hashes, i);
+      if (fl_value_get_type(hash) == FL_VALUE_TYPE_STRING &&
+          self->state->dedup_index.remove(fl_value_get_string(hash))) {
+        removed++;
       }
-      gtk_selection_data_free(selection_data);
     }
   }
+  g_autoptr(FlValue) result = fl_value_new_int(removed);
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
+
+static void dedup_index_clear(ClipboardPlugin* self,
+                              FlMethodCall* method_call) {
+  self->state->dedup_index.clear();
+  fl_method_call_respond_success(method_call, nullptr, nullptr);
+}
+
+// 解析十六进制的 64 位感知哈希
+static bool parse_perceptual_hash(FlValue* value, guint64* hash) {
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_STRING) {
+    return false;
+  }
+  const gchar* text = fl_value_get_string(value);
+  gchar* end = nullptr;
+  guint64 parsed = g_ascii_strtoull(text, &end, 16);
+  if (end == text || *end != '\0') {
+    return false;
+  }
+  *hash = parsed;
+  return true;
+}
+
+// 批量写入图像感知哈希索引：ids 与 hashes（十六进制）一一对应
+static void image_hash_index_add(ClipboardPlugin* self,
+                                 FlMethodCall* method_call) {
+  FlValue* ids = get_string_list_arg(method_call, "ids");
+  FlValue* hashes = get_string_list_arg(method_call, "hashes");
+  if (ids == nullptr || hashes == nullptr ||
+      fl_value_get_length(ids) != fl_value_get_length(hashes)) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "ids and matching hashes are required",
+                                 nullptr, nullptr);
+    return;
+  }
+
+  ImageHashIndex& index = self->state->image_hash_index;
+  for (size_t i = 0; i < fl_value_get_length(ids); i++) {
+    FlValue* id = fl_value_get_list_value(ids, i);
+    guint64 hash = 0;
+    if (fl_value_get_type(id) == FL_VALUE_TYPE_STRING &&
+        parse_perceptual_hash(fl_value_get_list_value(hashes, i), &hash)) {
+      index.insert(fl_value_get_string(id), hash);
+    }
+  }
+
+  g_autoptr(FlValue) result =
+      fl_value_new_int(static_cast<int64_t>(index.size()));
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
+
+// 查找与给定感知哈希最接近的图像：返回 {id, distance}，超出 maxDistance 时为 null
+static void image_hash_index_nearest(ClipboardPlugin* self,
+                                     FlMethodCall* method_call) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  guint64 hash = 0;
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP ||
+      !parse_perceptual_hash(fl_value_lookup_string(args, "hash"), &hash)) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "hash is required", nullptr, nullptr);
+    return;
+  }
+  gint64 max_distance = CLAMP(
+      get_int_arg(method_call, "maxDistance", kNearDuplicateDefaultDistance),
+      0, kNearDuplicateMaxDistance);
+  const gchar* exclude_id = get_string_arg(method_call, "excludeId");
+
+  std::string id;
+  int distance = 0;
+  g_autoptr(FlValue) result = nullptr;
+  if (self->state->image_hash_index.nearest(
+          hash, static_cast<int>(max_distance),
+          exclude_id != nullptr ? exclude_id : "", &id, &distance)) {
+    result = fl_value_new_map();
+    fl_value_set_string_take(result, "id", fl_value_new_string(id.c_str()));
+    fl_value_set_string_take(result, "distance", fl_value_new_int(distance));
+  } else {
+    result = fl_value_new_null();
+  }
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
 
-  // HTML 格式
-  if (gtk_clipboard_wait_is_target_available(clipboard, gdk_atom_intern("text/html", FALSE))) {
-    GtkSelectionData* selection_data = gtk_clipboard_wait_for_contents(clipboard, gdk_atom_intern("text/html", FALSE));
-    if (selection_data != nullptr) {
-      const guchar* data = gtk_selection_data_get_data(selection_data);
-      gint length = gtk_selection_data_get_length(selection_data);
-      if (data != nullptr && length > 0) {
-        gchar* html_text = g_strndup((const gchar*)data, length);
-        fl_value_set_string_take(result_map, "html", fl_value_new_string(html_text));
-        g_free(html_text);
+static void image_hash_index_remove(ClipboardPlugin* self,
+                                    FlMethodCall* method_call) {
+  FlValue* ids = get_string_list_arg(method_call, "ids");
+  int64_t removed = 0;
+  if (ids != nullptr) {
+    for (size_t i = 0; i < fl_value_get_length(ids); i++) {
+      FlValue* id = fl_value_get_list_value(ids, i);
+      if (fl_value_get_type(id) == FL_VALUE_TYPE_STRING &&
+          self->state->image_hash_index.remove(fl_value_get_string(id))) {
+        removed++;
       }
-      gtk_selection_data_free(selection_data);
-    }
-  }
-
-  // 文件格式
-  if (gtk_clipboard_wait_is_target_available(clipboard, gdk_atom_intern("text/uri-list", FALSE))) {
-    GtkSelectionData* selection_data = gtk_clipboard_wait_for_contents(clipboard, gdk_atom_intern("text/uri-list", FALSE));
-    if (selection_data != nullptr) {
-      const guchar* data = gtk_selection_data_get_data(selection_data);
-      gint length = gtk_selection_data_get_length(selection_data);
-      if (data != nullptr && length > 0) {
-        gchar* uris_text = g_strndup((const gchar*)data, length);
-        std::string uris_str(uris_text);
-        std::istringstream iss(uris_str);
-        std::string line;
-        g_autoptr(FlValue) paths_list = fl_value_new_list();
-
-        while (std::getline(iss, line)) {
-          if (!line.empty() && line.find("file://") == 0) {
-            std::string path = line.substr(7); // Remove "file://"
-            fl_value_append_take(paths_list, fl_value_new_string(path.c_str()));
+    }
+  }
+  g_autoptr(FlValue) result = fl_value_new_int(removed);
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
+
+static void image_hash_index_clear(ClipboardPlugin* self,
+                                   FlMethodCall* method_call) {
+  self->state->image_hash_index.clear();
+  fl_method_call_respond_success(method_call, nullptr, nullptr);
+}
+
+// 文本近似重复的默认相似度阈值
+static const double kTextSimilarityDefaultThreshold = 0.8;
+
+// 批量写入文本相似度索引：ids 与 texts 一一对应，签名在工作线程计算
+static void text_index_add(ClipboardPlugin* self, FlMethodCall* method_call) {
+  FlValue* ids = get_string_list_arg(method_call, "ids");
+  FlValue* texts = get_string_list_arg(method_call, "texts");
+  if (ids == nullptr || texts == nullptr ||
+      fl_value_get_length(ids) != fl_value_get_length(texts)) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "ids and matching texts are required",
+                                 nullptr, nullptr);
+    return;
+  }
+
+  struct TextIndexJob {
+    std::vector<std::string> ids;
+    std::vector<std::string> texts;
+    std::vector<MinHashSignature> signatures;
+  };
+  auto job = std::make_shared<TextIndexJob>();
+  for (size_t i = 0; i < fl_value_get_length(ids); i++) {
+    FlValue* id = fl_value_get_list_value(ids, i);
+    FlValue* text = fl_value_get_list_value(texts, i);
+    if (fl_value_get_type(id) == FL_VALUE_TYPE_STRING &&
+        fl_value_get_type(text) == FL_VALUE_TYPE_STRING) {
+      job->ids.emplace_back(fl_value_get_string(id));
+      job->texts.emplace_back(fl_value_get_string(text));
+    }
+  }
+
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+  guint generation = self->state->text_index_generation;
+  clipboard_worker_run(
+      [job]() {
+        job->signatures.resize(job->texts.size());
+        for (size_t i = 0; i < job->texts.size(); i++) {
+          text_minhash(job->texts[i].data(), job->texts[i].size(),
+                       &job->signatures[i]);
+        }
+        job->texts.clear();
+      },
+      [plugin, call, job, generation]() {
+        ClipboardPluginState* state = plugin->state;
+        if (generation == state->text_index_generation) {
+          for (size_t i = 0; i < job->ids.size(); i++) {
+            state->text_index.insert(job->ids[i], job->signatures[i]);
           }
         }
+        g_autoptr(FlValue) result =
+            fl_value_new_int(static_cast<int64_t>(state->text_index.size()));
+        fl_method_call_respond_success(call.get(), result, nullptr);
+      });
+}
+
+// 查找与给定文本最相似的已有文本：返回 {id, similarity}，低于 threshold 时为 null
+static void text_index_query(ClipboardPlugin* self, FlMethodCall* method_call) {
+  const gchar* text = get_string_arg(method_call, "text");
+  if (text == nullptr) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "text is required", nullptr, nullptr);
+    return;
+  }
+  double threshold = kTextSimilarityDefaultThreshold;
+  FlValue* args = fl_method_call_get_args(method_call);
+  FlValue* threshold_value = fl_value_lookup_string(args, "threshold");
+  if (threshold_value != nullptr &&
+      fl_value_get_type(threshold_value) == FL_VALUE_TYPE_FLOAT) {
+    threshold = CLAMP(fl_value_get_float(threshold_value), 0.0, 1.0);
+  }
+  const gchar* exclude_arg = get_string_arg(method_call, "excludeId");
+  std::string exclude_id = exclude_arg != nullptr ? exclude_arg : "";
 
-        if (fl_value_get_length(paths_list) > 0) {
-          fl_value_set_string_take(result_map, "files", fl_value_ref(paths_list));
+  auto signature = std::make_shared<MinHashSignature>();
+  auto source = std::make_shared<std::string>(text);
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+  clipboard_worker_run(
+      [signature, source]() {
+        text_minhash(source->data(), source->size(), signature.get());
+      },
+      [plugin, call, signature, threshold, exclude_id]() {
+        std::string id;
+        double similarity = 0.0;
+        g_autoptr(FlValue) result = nullptr;
+        if (plugin->state->text_index.nearest(*signature, threshold,
+                                              exclude_id, &id, &similarity)) {
+          result = fl_value_new_map();
+          fl_value_set_string_take(result, "id",
+                                   fl_value_new_string(id.c_str()));
+          fl_value_set_string_take(result, "similarity",
+                                   fl_value_new_float(similarity));
+        } else {
+          result = fl_value_new_null();
         }
+        fl_method_call_respond_success(call.get(), result, nullptr);
+      });
+}
 
-        g_free(uris_text);
+static void text_index_remove(ClipboardPlugin* self,
+                              FlMethodCall* method_call) {
+  FlValue* ids = get_string_list_arg(method_call, "ids");
+  int64_t removed = 0;
+  if (ids != nullptr) {
+    for (size_t i = 0; i < fl_value_get_length(ids); i++) {
+      FlValue* id = fl_value_get_list_value(ids, i);
+      if (fl_value_get_type(id) == FL_VALUE_TYPE_STRING &&
+          self->state->text_index.remove(fl_value_get_string(id))) {
+        removed++;
       }
-      gtk_selection_data_free(selection_data);
     }
   }
+  g_autoptr(FlValue) result = fl_value_new_int(removed);
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
+
+static void text_index_clear(ClipboardPlugin* self,
+                             FlMethodCall* method_call) {
+  self->state->text_index.clear();
+  self->state->text_index_generation++;
+  fl_method_call_respond_success(method_call, nullptr, nullptr);
+}
+
+// 计算 target 相对 base 的增量：增量不小于 target 的 maxRatio（默认 0.5）时返回 null
+static void text_delta_encode_call(ClipboardPlugin* self,
+                                   FlMethodCall* method_call) {
+  const gchar* base = get_string_arg(method_call, "base");
+  const gchar* target = get_string_arg(method_call, "target");
+  if (base == nullptr || target == nullptr) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "base and target are required", nullptr,
+                                 nullptr);
+    return;
+  }
+  double max_ratio = 0.5;
+  FlValue* ratio = fl_value_lookup_string(fl_method_call_get_args(method_call),
+                                          "maxRatio");
+  if (ratio != nullptr && fl_value_get_type(ratio) == FL_VALUE_TYPE_FLOAT) {
+    max_ratio = CLAMP(fl_value_get_float(ratio), 0.0, 1.0);
+  }
 
-  // 图片格式
-  if (gtk_clipboard_wait_is_image_available(clipboard)) {
-    GdkPixbuf* pixbuf = gtk_clipboard_wait_for_image(clipboard);
-    if (pixbuf != nullptr) {
-      // 将 GdkPixbuf 转换为 PNG 字节数组
-      gchar* buffer;
-      gsize buffer_size;
-      GError* error = nullptr;
-
-      if (gdk_pixbuf_save_to_buffer(pixbuf, &buffer, &buffer_size, "png", &error, nullptr)) {
-        g_autoptr(FlValue) image_list = fl_value_new_uint8_list(
-            reinterpret_cast<const uint8_t*>(buffer), buffer_size);
-        fl_value_set_string_take(result_map, "image", fl_value_ref(image_list));
-        g_free(buffer);
+  struct DeltaJob {
+    std::string base;
+    std::string target;
+    std::string delta;
+    bool encoded = false;
+  };
+  auto job = std::make_shared<DeltaJob>();
+  job->base = base;
+  job->target = target;
+  auto call = hold_object(method_call);
+  clipboard_worker_run(
+      [job, max_ratio]() {
+        size_t max_bytes =
+            static_cast<size_t>(job->target.size() * max_ratio);
+        job->encoded =
+            text_delta_encode(job->base, job->target, max_bytes, &job->delta);
+      },
+      [call, job]() {
+        g_autoptr(FlValue) result =
+            job->encoded ? fl_value_new_string(job->delta.c_str())
+                         : fl_value_new_null();
+        fl_method_call_respond_success(call.get(), result, nullptr);
+      });
+}
+
+// 由基准文本依次应用 deltas 还原文本；给出 id 时缓存结果
+static void text_delta_apply_call(ClipboardPlugin* self,
+                                  FlMethodCall* method_call) {
+  const gchar* base = get_string_arg(method_call, "base");
+  FlValue* deltas = get_string_list_arg(method_call, "deltas");
+  if (base == nullptr || deltas == nullptr) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "base and deltas are required", nullptr,
+                                 nullptr);
+    return;
+  }
+  const gchar* id_arg = get_string_arg(method_call, "id");
+  std::string id = id_arg != nullptr ? id_arg : "";
+
+  struct ApplyJob {
+    std::string text;
+    std::vector<std::string> deltas;
+    bool applied = true;
+  };
+  auto job = std::make_shared<ApplyJob>();
+  job->text = base;
+  for (size_t i = 0; i < fl_value_get_length(deltas); i++) {
+    FlValue* delta = fl_value_get_list_value(deltas, i);
+    if (fl_value_get_type(delta) != FL_VALUE_TYPE_STRING) {
+      job->applied = false;
+      break;
+    }
+    job->deltas.emplace_back(fl_value_get_string(delta));
+  }
+
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+  clipboard_worker_run(
+      [job]() {
+        for (const std::string& delta : job->deltas) {
+          if (!job->applied) {
+            break;
+          }
+          std::string next;
+          job->applied = text_delta_apply(job->text, delta, &next);
+          job->text = std::move(next);
+        }
+      },
+      [plugin, call, job, id]() {
+        if (job->applied && !id.empty()) {
+          plugin->state->delta_cache.store(id, job->text);
+        }
+        g_autoptr(FlValue) result =
+            job->applied ? fl_value_new_string(job->text.c_str())
+                         : fl_value_new_null();
+        fl_method_call_respond_success(call.get(), result, nullptr);
+      });
+}
+
+// 批量还原：entries 为 [{id, base, deltas}]，base 是 bases 中的下标，
+// 同一链上的条目共享基准文本。返回与 entries 对应的列表，还原失败的位置为 null；
+// 已缓存的条目直接取缓存，其余在一次工作线程任务中还原并写入缓存
+static void text_delta_apply_batch_call(ClipboardPlugin* self,
+                                        FlMethodCall* method_call) {
+  FlValue* bases = get_string_list_arg(method_call, "bases");
+  FlValue* entries = get_string_list_arg(method_call, "entries");
+  if (bases == nullptr || entries == nullptr) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "bases and entries are required", nullptr,
+                                 nullptr);
+    return;
+  }
+
+  struct BatchEntry {
+    std::string id;
+    size_t base = 0;
+    std::vector<std::string> deltas;
+    std::string text;
+    bool cached = false;
+    bool applied = false;
+  };
+  struct BatchJob {
+    std::vector<std::string> bases;
+    std::vector<BatchEntry> entries;
+  };
+  auto job = std::make_shared<BatchJob>();
+  for (size_t i = 0; i < fl_value_get_length(bases); i++) {
+    FlValue* base = fl_value_get_list_value(bases, i);
+    job->bases.emplace_back(fl_value_get_type(base) == FL_VALUE_TYPE_STRING
+                                ? fl_value_get_string(base)
+                                : "");
+  }
+  job->entries.resize(fl_value_get_length(entries));
+  for (size_t i = 0; i < job->entries.size(); i++) {
+    BatchEntry& entry = job->entries[i];
+    FlValue* value = fl_value_get_list_value(entries, i);
+    if (fl_value_get_type(value) != FL_VALUE_TYPE_MAP) {
+      continue;
+    }
+    FlValue* id = fl_value_lookup_string(value, "id");
+    FlValue* base = fl_value_lookup_string(value, "base");
+    FlValue* deltas = fl_value_lookup_string(value, "deltas");
+    if (base == nullptr || fl_value_get_type(base) != FL_VALUE_TYPE_INT ||
+        fl_value_get_int(base) < 0 ||
+        static_cast<size_t>(fl_value_get_int(base)) >= job->bases.size() ||
+        deltas == nullptr || fl_value_get_type(deltas) != FL_VALUE_TYPE_LIST) {
+      continue;
+    }
+    if (id != nullptr && fl_value_get_type(id) == FL_VALUE_TYPE_STRING) {
+      entry.id = fl_value_get_string(id);
+      entry.cached = !entry.id.empty() &&
+                     self->state->delta_cache.lookup(entry.id, &entry.text);
+    }
+    entry.applied = true;
+    if (entry.cached) {
+      continue;
+    }
+    entry.base = static_cast<size_t>(fl_value_get_int(base));
+    for (size_t j = 0; j < fl_value_get_length(deltas); j++) {
+      FlValue* delta = fl_value_get_list_value(deltas, j);
+      if (fl_value_get_type(delta) != FL_VALUE_TYPE_STRING) {
+        entry.applied = false;
+        break;
       }
+      entry.deltas.emplace_back(fl_value_get_string(delta));
+    }
+  }
+
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+  clipboard_worker_run(
+      [job]() {
+        for (BatchEntry& entry : job->entries) {
+          if (!entry.applied || entry.cached) {
+            continue;
+          }
+          entry.text = job->bases[entry.base];
+          for (const std::string& delta : entry.deltas) {
+            std::string next;
+            entry.applied = text_delta_apply(entry.text, delta, &next);
+            if (!entry.applied) {
+              break;
+            }
+            entry.text = std::move(next);
+          }
+        }
+      },
+      [plugin, call, job]() {
+        g_autoptr(FlValue) result = fl_value_new_list();
+        for (const BatchEntry& entry : job->entries) {
+          if (entry.applied && !entry.cached && !entry.id.empty()) {
+            plugin->state->delta_cache.store(entry.id, entry.text);
+          }
+          fl_value_append_take(result,
+                               entry.applied
+                                   ? fl_value_new_string(entry.text.c_str())
+                                   : fl_value_new_null());
+        }
+        fl_method_call_respond_success(call.get(), result, nullptr);
+      });
+}
+
+// 查询已缓存的还原结果，未命中时返回 null
+static void text_delta_lookup(ClipboardPlugin* self,
+                              FlMethodCall* method_call) {
+  const gchar* id = get_string_arg(method_call, "id");
+  std::string text;
+  g_autoptr(FlValue) result =
+      id != nullptr && self->state->delta_cache.lookup(id, &text)
+          ? fl_value_new_string(text.c_str())
+          : fl_value_new_null();
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
+
+// 文件名或相对目录中不允许出现的路径片段
+static bool is_safe_path_component(const gchar* value, bool allow_slash) {
+  return value != nullptr && value[0] != '\0' && value[0] != '/' &&
+         strstr(value, "..") == nullptr &&
+         (allow_slash || strchr(value, '/') == nullptr);
+}
 
-      g_object_unref(pixbuf);
+// 是否为 64 位小写十六进制的 SHA-256
+static bool is_sha256_hex(const gchar* value) {
+  size_t length = 0;
+  for (; value[length] != '\0'; length++) {
+    if (!g_ascii_isdigit(value[length]) &&
+        (value[length] < 'a' || value[length] > 'f')) {
+      return false;
     }
   }
+  return length == 64;
+}
+
+// 扩展名只允许 1~16 个 ASCII 字母或数字
+static bool is_safe_extension(const gchar* value) {
+  size_t length = 0;
+  for (; value[length] != '\0'; length++) {
+    if (!g_ascii_isalnum(value[length])) {
+      return false;
+    }
+  }
+  return length > 0 && length <= 16;
+}
+
+// 把 bytes 写入 root/relativeDir/<prefix>_<哈希前 16 位>.<extension>，
+// 返回 {relativePath, hash, existed}。文件名中的哈希总在工作线程由 bytes
+// 计算 SHA-256 得出；给出的 hash 须与之一致，否则以 HASH_MISMATCH 响应
+static void media_store_write_call(ClipboardPlugin* self,
+                                   FlMethodCall* method_call) {
+  const gchar* root = get_string_arg(method_call, "root");
+  const gchar* relative_dir = get_string_arg(method_call, "relativeDir");
+  const gchar* prefix = get_string_arg(method_call, "prefix");
+  const gchar* extension = get_string_arg(method_call, "extension");
+  const gchar* hash = get_string_arg(method_call, "hash");
+  FlValue* args = fl_method_call_get_args(method_call);
+  FlValue* bytes = args != nullptr &&
+                           fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                       ? fl_value_lookup_string(args, "bytes")
+                       : nullptr;
+  if (root == nullptr || root[0] != '/' ||
+      !is_safe_path_component(relative_dir, true) ||
+      !is_safe_path_component(prefix, false) ||
+      extension == nullptr || !is_safe_extension(extension) ||
+      bytes == nullptr ||
+      fl_value_get_type(bytes) != FL_VALUE_TYPE_UINT8_LIST ||
+      (hash != nullptr && !is_sha256_hex(hash))) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "root, relativeDir, prefix, extension and "
+                                 "bytes are required; hash must be a "
+                                 "lowercase hex SHA-256",
+                                 nullptr, nullptr);
+    return;
+  }
+
+  struct WriteJob {
+    std::string directory;
+    std::string relative_dir;
+    std::string prefix;
+    std::string extension;
+    std::string expected_hash;
+    std::string hash;
+    std::string name;
+    MediaStoreWriteResult result;
+    bool mismatch = false;
+    bool written = false;
+  };
+  auto job = std::make_shared<WriteJob>();
+  job->directory = std::string(root) + "/" + relative_dir;
+  job->relative_dir = relative_dir;
+  job->prefix = prefix;
+  job->extension = extension;
+  job->expected_hash = hash != nullptr ? hash : "";
+
+  // 方法调用持有参数，数据在工作线程中只读访问，无需复制
+  const guint8* data = fl_value_get_uint8_list(bytes);
+  size_t length = fl_value_get_length(bytes);
+  auto call = hold_object(method_call);
+  clipboard_worker_run(
+      [job, data, length]() {
+        gchar* digest =
+            g_compute_checksum_for_data(G_CHECKSUM_SHA256, data, length);
+        job->hash = digest;
+        g_free(digest);
+        if (!job->expected_hash.empty() && job->expected_hash != job->hash) {
+          job->mismatch = true;
+          return;
+        }
+        job->name = job->prefix + "_" + job->hash.substr(0, 16) + "." +
+                    job->extension;
+        job->written = media_store_write(job->directory, job->name, data,
+                                         length, &job->result);
+      },
+      [call, job]() {
+        if (job->mismatch) {
+          fl_method_call_respond_error(call.get(), "HASH_MISMATCH",
+                                       "hash does not match bytes", nullptr,
+                                       nullptr);
+          return;
+        }
+        if (!job->written) {
+          fl_method_call_respond_error(call.get(), "WRITE_FAILED",
+                                       job->result.error.c_str(), nullptr,
+                                       nullptr);
+          return;
+        }
+        std::string relative_path = job->relative_dir + "/" + job->name;
+        g_autoptr(FlValue) result = fl_value_new_map();
+        fl_value_set_string_take(result, "relativePath",
+                                 fl_value_new_string(relative_path.c_str()));
+        fl_value_set_string_take(result, "hash",
+                                 fl_value_new_string(job->hash.c_str()));
+        fl_value_set_string_take(result, "existed",
+                                 fl_value_new_bool(job->result.existed));
+        fl_method_call_respond_success(call.get(), result, nullptr);
+      });
+}
+
+// 导入进度事件的最小间隔（微秒）
+static const gint64 kIngestProgressIntervalUs = 100 * 1000;
+
+static void send_ingest_progress(ClipboardPlugin* self, gint64 job_id,
+                                 FileIngestPhase phase, guint64 done,
+                                 guint64 total) {
+  if (!self->ingest_listening || self->ingest_event_channel == nullptr) {
+    return;
+  }
+  g_autoptr(FlValue) event = fl_value_new_map();
+  fl_value_set_string_take(event, "jobId", fl_value_new_int(job_id));
+  fl_value_set_string_take(event, "phase",
+                           fl_value_new_string(file_ingest_phase_name(phase)));
+  fl_value_set_string_take(event, "done", fl_value_new_int(done));
+  fl_value_set_string_take(event, "total", fl_value_new_int(total));
+  fl_event_channel_send(self->ingest_event_channel, event, nullptr, nullptr);
+}
+
+// 把 source 文件导入 root/relativeDir/<prefix>_<哈希前 16 位>.<extension>，
+// 返回 {relativePath, hash, bytes, existed, method}；
+// 进度经 file_ingest_events 推送，可用 cancelFileIngest 按 jobId 取消
+static void ingest_file_call(ClipboardPlugin* self, FlMethodCall* method_call) {
+  gint64 job_id = get_int_arg(method_call, "jobId", 0);
+  const gchar* source = get_string_arg(method_call, "source");
+  const gchar* root = get_string_arg(method_call, "root");
+  const gchar* relative_dir = get_string_arg(method_call, "relativeDir");
+  const gchar* prefix = get_string_arg(method_call, "prefix");
+  const gchar* extension = get_string_arg(method_call, "extension");
+  if (job_id <= 0 || source == nullptr || root == nullptr || root[0] != '/' ||
+      !is_safe_path_component(relative_dir, true) ||
+      !is_safe_path_component(prefix, false) || extension == nullptr ||
+      !is_safe_extension(extension) ||
+      self->state->ingest_jobs.count(job_id) > 0) {
+    fl_method_call_respond_error(method_call, "INVALID_ARGUMENT",
+                                 "jobId, source, root, relativeDir, prefix "
+                                 "and extension are required",
+                                 nullptr, nullptr);
+    return;
+  }
+
+  auto cancelled = std::make_shared<std::atomic<bool>>(false);
+  self->state->ingest_jobs[job_id] = cancelled;
+
+  FileIngestRequest request;
+  request.source = source;
+  request.directory = std::string(root) + "/" + relative_dir;
+  request.prefix = prefix;
+  request.extension = extension;
+  std::string relative = relative_dir;
+
+  auto result = std::make_shared<FileIngestResult>();
+  auto ok = std::make_shared<bool>(false);
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+  clipboard_worker_run(
+      [plugin, job_id, request, cancelled, result, ok]() {
+        gint64 last_report = 0;
+        auto progress = [plugin, job_id, &last_report](
+                            FileIngestPhase phase, uint64_t done,
+                            uint64_t total) {
+          gint64 now = g_get_monotonic_time();
+          if (done < total && now - last_report < kIngestProgressIntervalUs) {
+            return;
+          }
+          last_report = now;
+          clipboard_main_invoke([plugin, job_id, phase, done, total]() {
+            send_ingest_progress(plugin.get(), job_id, phase, done, total);
+          });
+        };
+        *ok = file_ingest(request, *cancelled, progress, result.get());
+      },
+      [plugin, call, job_id, relative, result, ok]() {
+        plugin->state->ingest_jobs.erase(job_id);
+        if (!*ok) {
+          fl_method_call_respond_error(
+              call.get(), result->cancelled ? "CANCELLED" : "INGEST_FAILED",
+              result->cancelled ? "File ingest was cancelled"
+                                : result->error.c_str(),
+              nullptr, nullptr);
+          return;
+        }
+        std::string relative_path = relative + "/" + result->name;
+        g_autoptr(FlValue) value = fl_value_new_map();
+        fl_value_set_string_take(value, "relativePath",
+                                 fl_value_new_string(relative_path.c_str()));
+        fl_value_set_string_take(value, "hash",
+                                 fl_value_new_string(result->hash.c_str()));
+        fl_value_set_string_take(value, "bytes",
+                                 fl_value_new_int(result->bytes));
+        fl_value_set_string_take(value, "existed",
+                                 fl_value_new_bool(result->existed));
+        if (!result->existed) {
+          fl_value_set_string_take(
+              value, "method",
+              fl_value_new_string(file_ingest_method_name(result->method)));
+        }
+        fl_method_call_respond_success(call.get(), value, nullptr);
+      });
+}
 
-  // 文本格式
-  if (gtk_clipboard_wait_is_text_available(clipboard)) {
-    gchar* text = gtk_clipboard_wait_for_text(clipboard);
-    if (text != nullptr) {
-      fl_value_set_string_take(result_map, "text", fl_value_new_string(text));
-      g_free(text);
+static void cancel_file_ingest(ClipboardPlugin* self,
+                               FlMethodCall* method_call) {
+  gint64 job_id = get_int_arg(method_call, "jobId", 0);
+  auto it = self->state->ingest_jobs.find(job_id);
+  bool found = it != self->state->ingest_jobs.end();
+  if (found) {
+    it->second->store(true);
+  }
+  g_autoptr(FlValue) result = fl_value_new_bool(found);
+  fl_method_call_respond_success(method_call, result, nullptr);
+}
+
+// 每块默认条目数
+static const gint64 kFileInfoDefaultChunkSize = 256;
+
+static FlValue* new_file_metadata_value(const FileMetadata& metadata) {
+  FlValue* value = fl_value_new_map();
+  fl_value_set_string_take(value, "path",
+                           fl_value_new_string(metadata.path.c_str()));
+  fl_value_set_string_take(value, "exists", fl_value_new_bool(metadata.exists));
+  if (metadata.exists) {
+    fl_value_set_string_take(value, "isDirectory",
+                             fl_value_new_bool(metadata.is_directory));
+    fl_value_set_string_take(value, "size", fl_value_new_int(metadata.size));
+    fl_value_set_string_take(value, "modified",
+                             fl_value_new_int(metadata.modified_ms));
+    fl_value_set_string_take(value, "mime",
+                             fl_value_new_string(metadata.mime.c_str()));
+  }
+  fl_value_set_string_take(value, "type", fl_value_new_string(metadata.type));
+  if (!metadata.hash.empty()) {
+    fl_value_set_string_take(value, "hash",
+                             fl_value_new_string(metadata.hash.c_str()));
+  }
+  return value;
+}
+
+static void send_file_info_chunk(ClipboardPlugin* self, gint64 request_id,
+                                 size_t offset,
+                                 const std::vector<FileMetadata>& chunk) {
+  if (!self->file_info_listening || self->file_info_event_channel == nullptr) {
+    return;
+  }
+  g_autoptr(FlValue) event = fl_value_new_map();
+  fl_value_set_string_take(event, "requestId", fl_value_new_int(request_id));
+  fl_value_set_string_take(event, "offset", fl_value_new_int(offset));
+  FlValue* entries = fl_value_new_list();
+  for (const FileMetadata& metadata : chunk) {
+    fl_value_append_take(entries, new_file_metadata_value(metadata));
+  }
+  fl_value_set_string_take(event, "entries", entries);
+  fl_event_channel_send(self->file_info_event_channel, event, nullptr, nullptr);
+}
+
+// 在工作线程上取得路径列表并并行采集元数据，按 get_clipboard_file_info 的约定响应
+static void respond_file_info(
+    std::shared_ptr<ClipboardPlugin> plugin, std::shared_ptr<FlMethodCall> call,
+    gint64 request_id, gint64 chunk_size, FileMetadataHash hash,
+    std::function<std::vector<std::string>()> load_paths) {
+  auto disposed = plugin->state->disposed;
+  auto count = std::make_shared<size_t>(0);
+  auto collected = std::make_shared<std::vector<FileMetadata>>();
+  clipboard_worker_run(
+      [plugin, load_paths, disposed, request_id, chunk_size, hash, count,
+       collected]() {
+        std::vector<std::string> paths = load_paths();
+        *count = paths.size();
+        file_metadata_gather(
+            paths, hash, static_cast<size_t>(chunk_size), *disposed,
+            [plugin, request_id, collected](size_t offset,
+                                            std::vector<FileMetadata> chunk) {
+              if (request_id <= 0) {
+                std::move(chunk.begin(), chunk.end(),
+                          std::back_inserter(*collected));
+                return;
+              }
+              auto shared =
+                  std::make_shared<std::vector<FileMetadata>>(std::move(chunk));
+              clipboard_main_invoke([plugin, request_id, offset, shared]() {
+                send_file_info_chunk(plugin.get(), request_id, offset, *shared);
+              });
+            });
+      },
+      [call, request_id, count, collected]() {
+        if (*count == 0) {
+          fl_method_call_respond_success(call.get(), nullptr, nullptr);
+          return;
+        }
+        if (request_id > 0) {
+          g_autoptr(FlValue) value = fl_value_new_map();
+          fl_value_set_string_take(value, "count", fl_value_new_int(*count));
+          fl_method_call_respond_success(call.get(), value, nullptr);
+          return;
+        }
+        g_autoptr(FlValue) entries = fl_value_new_list();
+        for (const FileMetadata& metadata : *collected) {
+          fl_value_append_take(entries, new_file_metadata_value(metadata));
+        }
+        fl_method_call_respond_success(call.get(), entries, nullptr);
+      });
+}
+
+// 并行采集文件元数据：{path, exists, isDirectory, size, modified, mime, type, hash?}，
+// 顺序与输入一致。给出 paths 时采集这些路径，否则采集剪贴板 text/uri-list 中的文件。
+// 参数 hash 为 "xxh64" / "sha256" 时附带内容哈希。
+// 给出 requestId 时结果按 chunkSize 分块、按顺序经 file_metadata_events 推送，
+// 全部送出后响应 {count}；否则直接响应完整列表。没有文件时响应 null
+static void get_clipboard_file_info(ClipboardPlugin* self,
+                                    FlMethodCall* method_call) {
+  gint64 request_id = get_int_arg(method_call, "requestId", 0);
+  gint64 chunk_size =
+      get_int_arg(method_call, "chunkSize", kFileInfoDefaultChunkSize);
+  const gchar* hash_name = get_string_arg(method_call, "hash");
+  FileMetadataHash hash = FILE_METADATA_HASH_NONE;
+  if (g_strcmp0(hash_name, "xxh64") == 0) {
+    hash = FILE_METADATA_HASH_XXH64;
+  } else if (g_strcmp0(hash_name, "sha256") == 0) {
+    hash = FILE_METADATA_HASH_SHA256;
+  }
+  if (chunk_size <= 0) {
+    chunk_size = kFileInfoDefaultChunkSize;
+  }
+
+  auto plugin = hold_object(self);
+  auto call = hold_object(method_call);
+
+  FlValue* paths_arg = get_string_list_arg(method_call, "paths");
+  if (paths_arg != nullptr) {
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < fl_value_get_length(paths_arg); i++) {
+      FlValue* path = fl_value_get_list_value(paths_arg, i);
+      if (fl_value_get_type(path) == FL_VALUE_TYPE_STRING) {
+        paths.push_back(fl_value_get_string(path));
+      }
     }
+    respond_file_info(plugin, call, request_id, chunk_size, hash,
+                      [paths]() { return paths; });
+    return;
   }
 
-  fl_method_call_respond_success(method_call, result_map, nullptr);
+  guint timeout_ms = get_read_timeout(method_call);
+  with_clipboard_targets(self, timeout_ms, [plugin, timeout_ms, call,
+                                            request_id, chunk_size, hash](
+      ClipboardReadStatus status, const ClipboardTargets& targets) {
+    if (status == CLIPBOARD_READ_TIMEOUT) {
+      respond_read_timeout(call.get());
+      return;
+    }
+    if (!targets.contains("text/uri-list")) {
+      fl_method_call_respond_success(call.get(), nullptr, nullptr);
+      return;
+    }
+
+    read_snapshot_contents(plugin.get(), "text/uri-list", timeout_ms,
+        [plugin, call, request_id, chunk_size, hash](ClipboardReadStatus status,
+                                                     GBytes* bytes) {
+          if (status == CLIPBOARD_READ_TIMEOUT) {
+            respond_read_timeout(call.get());
+            return;
+          }
+          if (bytes == nullptr) {
+            fl_method_call_respond_success(call.get(), nullptr, nullptr);
+            return;
+          }
+          // 列表在工作线程上直接解析剪贴板缓冲区
+          std::shared_ptr<GBytes> list(g_bytes_ref(bytes), g_bytes_unref);
+          respond_file_info(plugin, call, request_id, chunk_size, hash,
+                            [list]() { return parse_file_uri_list(list.get()); });
+        });
+  });
 }
 
 static void clipboard_plugin_handle_method_call(
@@ -602,17 +3629,67 @@ static void clipboard_plugin_handle_method_call(
   const gchar* method = fl_method_call_get_name(method_call);
 
   if (strcmp(method, "getClipboardFormats") == 0) {
-    get_clipboard_formats(method_call);
+    get_clipboard_formats(self, method_call);
+  } else if (strcmp(method, "getClipboardFormatData") == 0) {
+    get_clipboard_format_data(self, method_call);
+  } else if (strcmp(method, "openClipboardStream") == 0) {
+    open_clipboard_stream(self, method_call);
+  } else if (strcmp(method, "cancelClipboardStream") == 0) {
+    cancel_clipboard_stream(self, method_call);
+  } else if (strcmp(method, "dedupIndexAdd") == 0) {
+    dedup_index_add(self, method_call);
+  } else if (strcmp(method, "dedupIndexLookup") == 0) {
+    dedup_index_lookup(self, method_call);
+  } else if (strcmp(method, "dedupIndexRemove") == 0) {
+    dedup_index_remove(self, method_call);
+  } else if (strcmp(method, "dedupIndexClear") == 0) {
+    dedup_index_clear(self, method_call);
+  } else if (strcmp(method, "imageHashIndexAdd") == 0) {
+    image_hash_index_add(self, method_call);
+  } else if (strcmp(method, "imageHashIndexNearest") == 0) {
+    image_hash_index_nearest(self, method_call);
+  } else if (strcmp(method, "imageHashIndexRemove") == 0) {
+    image_hash_index_remove(self, method_call);
+  } else if (strcmp(method, "imageHashIndexClear") == 0) {
+    image_hash_index_clear(self, method_call);
+  } else if (strcmp(method, "textIndexAdd") == 0) {
+    text_index_add(self, method_call);
+  } else if (strcmp(method, "textIndexQuery") == 0) {
+    text_index_query(self, method_call);
+  } else if (strcmp(method, "textIndexRemove") == 0) {
+    text_index_remove(self, method_call);
+  } else if (strcmp(method, "textIndexClear") == 0) {
+    text_index_clear(self, method_call);
+  } else if (strcmp(method, "textDeltaEncode") == 0) {
+    text_delta_encode_call(self, method_call);
+  } else if (strcmp(method, "textDeltaApply") == 0) {
+    text_delta_apply_call(self, method_call);
+  } else if (strcmp(method, "textDeltaApplyBatch") == 0) {
+    text_delta_apply_batch_call(self, method_call);
+  } else if (strcmp(method, "textDeltaLookup") == 0) {
+    text_delta_lookup(self, method_call);
+  } else if (strcmp(method, "mediaStoreWrite") == 0) {
+    media_store_write_call(self, method_call);
+  } else if (strcmp(method, "ingestFile") == 0) {
+    ingest_file_call(self, method_call);
+  } else if (strcmp(method, "cancelFileIngest") == 0) {
+    cancel_file_ingest(self, method_call);
   } else if (strcmp(method, "getClipboardType") == 0) {
-    get_clipboard_type(method_call);
+    get_clipboard_type(self, method_call);
   } else if (strcmp(method, "getClipboardSequence") == 0) {
-    get_clipboard_sequence(method_call);
+    get_clipboard_sequence(self, method_call);
+  } else if (strcmp(method, "getClipboardFileInfo") == 0) {
+    get_clipboard_file_info(self, method_call);
   } else if (strcmp(method, "getClipboardFilePaths") == 0) {
-    get_clipboard_file_paths(method_call);
+    get_clipboard_file_paths(self, method_call);
   } else if (strcmp(method, "getClipboardImageData") == 0) {
-    get_clipboard_image_data(method_call);
+    get_clipboard_image_data(self, method_call);
   } else if (strcmp(method, "performOCR") == 0) {
-    perform_ocr(method_call);
+    perform_ocr(self, method_call);
+  } else if (strcmp(method, "cancelOcr") == 0) {
+    cancel_ocr(self, method_call);
+  } else if (strcmp(method, "configureOcrEngines") == 0) {
+    configure_ocr_engines(self, method_call);
   } else {
     fl_method_call_respond_not_implemented(method_call, nullptr);
   }
@@ -0,0 +1,333 @@
+#include "clipboard_reader.h"
+
+#include <utility>
+
+#ifdef GDK_WINDOWING_X11
+#include <gdk/gdkx.h>
+#endif
+
+typedef enum {
+  CLIPBOARD_READ_KIND_TARGETS,
+  CLIPBOARD_READ_KIND_CONTENTS,
+  CLIPBOARD_READ_KIND_TEXT,
+  CLIPBOARD_READ_KIND_IMAGE,
+} ClipboardReadKind;
+
+// 单次读取的状态，由 GTK 回调与超时源共同持有
+struct ClipboardRead {
+  ClipboardReadKind kind;
+  ClipboardTargetsCallback on_targets;
+  ClipboardContentsCallback on_contents;
+  ClipboardTextCallback on_text;
+  ClipboardImageCallback on_image;
+  guint timeout_id;
+  gboolean finished;
+  gint ref_count;
+};
+
+struct _ClipboardReadGroup {
+  gint pending;
+  std::function<void()> done;
+};
+
+static ClipboardRead* clipboard_read_new(ClipboardReadKind kind) {
+  ClipboardRead* read = new ClipboardRead();
+  read->kind = kind;
+  read->timeout_id = 0;
+  read->finished = FALSE;
+  // 一个引用属于 GTK 回调，一个属于超时源
+  read->ref_count = 2;
+  return read;
+}
+
+static void clipboard_read_unref(gpointer data) {
+  ClipboardRead* read = static_cast<ClipboardRead*>(data);
+  if (--read->ref_count == 0) {
+    delete read;
+  }
+}
+
+// 标记完成并取消超时；返回 FALSE 表示结果已迟到
+static gboolean clipboard_read_finish(ClipboardRead* read) {
+  if (read->finished) {
+    return FALSE;
+  }
+  read->finished = TRUE;
+  if (read->timeout_id != 0) {
+    guint timeout_id = read->timeout_id;
+    read->timeout_id = 0;
+    g_source_remove(timeout_id);
+  }
+  return TRUE;
+}
+
+// 完成后立即释放回调，避免迟到的 GTK 回调延长捕获对象的生命周期
+static void clipboard_read_release_callbacks(ClipboardRead* read) {
+  read->on_targets = nullptr;
+  read->on_contents = nullptr;
+  read->on_text = nullptr;
+  read->on_image = nullptr;
+}
+
+static gboolean clipboard_read_timeout_cb(gpointer user_data) {
+  ClipboardRead* read = static_cast<ClipboardRead*>(user_data);
+  read->timeout_id = 0;
+  if (read->finished) {
+    return G_SOURCE_REMOVE;
+  }
+  read->finished = TRUE;
+
+  switch (read->kind) {
+    case CLIPBOARD_READ_KIND_TARGETS:
+      read->on_targets(CLIPBOARD_READ_TIMEOUT, nullptr, 0);
+      break;
+    case CLIPBOARD_READ_KIND_CONTENTS:
+      read->on_contents(CLIPBOARD_READ_TIMEOUT, nullptr);
+      break;
+    case CLIPBOARD_READ_KIND_TEXT:
+      read->on_text(CLIPBOARD_READ_TIMEOUT, nullptr);
+      break;
+    case CLIPBOARD_READ_KIND_IMAGE:
+      read->on_image(CLIPBOARD_READ_TIMEOUT, nullptr);
+      break;
+  }
+  clipboard_read_release_callbacks(read);
+  return G_SOURCE_REMOVE;
+}
+
+static void clipboard_read_start_timeout(ClipboardRead* read,
+                                         guint timeout_ms) {
+  read->timeout_id = g_timeout_add_full(G_PRIORITY_DEFAULT, timeout_ms,
+                                        clipboard_read_timeout_cb, read,
+                                        clipboard_read_unref);
+}
+
+static void targets_received_cb(GtkClipboard* clipboard, GdkAtom* atoms,
+                                gint n_atoms, gpointer user_data) {
+  ClipboardRead* read = static_cast<ClipboardRead*>(user_data);
+  if (clipboard_read_finish(read)) {
+    gboolean ok = atoms != nullptr && n_atoms > 0;
+    read->on_targets(ok ? CLIPBOARD_READ_OK : CLIPBOARD_READ_EMPTY, atoms,
+                     ok ? n_atoms : 0);
+    clipboard_read_release_callbacks(read);
+  }
+  clipboard_read_unref(read);
+}
+
+static void contents_received_cb(GtkClipboard* clipboard,
+                                 GtkSelectionData* selection_data,
+                                 gpointer user_data) {
+  ClipboardRead* read = static_cast<ClipboardRead*>(user_data);
+  if (clipboard_read_finish(read)) {
+    const guchar* data = selection_data != nullptr
+                             ? gtk_selection_data_get_data(selection_data)
+                             : nullptr;
+    gint length = selection_data != nullptr
+                      ? gtk_selection_data_get_length(selection_data)
+                      : -1;
+    if (data != nullptr && length > 0) {
+      GBytes* bytes = g_bytes_new(data, length);
+      read->on_contents(CLIPBOARD_READ_OK, bytes);
+      g_bytes_unref(bytes);
+    } else {
+      read->on_contents(CLIPBOARD_READ_EMPTY, nullptr);
+    }
+    clipboard_read_release_callbacks(read);
+  }
+  clipboard_read_unref(read);
+}
+
+static void text_received_cb(GtkClipboard* clipboard, const gchar* text,
+                             gpointer user_data) {
+  ClipboardRead* read = static_cast<ClipboardRead*>(user_data);
+  if (clipboard_read_finish(read)) {
+    read->on_text(text != nullptr ? CLIPBOARD_READ_OK : CLIPBOARD_READ_EMPTY,
+                  text);
+    clipboard_read_release_callbacks(read);
+  }
+  clipboard_read_unref(read);
+}
+
+static void image_received_cb(GtkClipboard* clipboard, GdkPixbuf* pixbuf,
+                              gpointer user_data) {
+  ClipboardRead* read = static_cast<ClipboardRead*>(user_data);
+  if (clipboard_read_finish(read)) {
+    read->on_image(
+        pixbuf != nullptr ? CLIPBOARD_READ_OK : CLIPBOARD_READ_EMPTY, pixbuf);
+    clipboard_read_release_callbacks(read);
+  }
+  clipboard_read_unref(read);
+}
+
+void clipboard_read_targets(GtkClipboard* clipboard, guint timeout_ms,
+                            ClipboardTargetsCallback callback) {
+  ClipboardRead* read = clipboard_read_new(CLIPBOARD_READ_KIND_TARGETS);
+  read->on_targets = std::move(callback);
+  clipboard_read_start_timeout(read, timeout_ms);
+  gtk_clipboard_request_targets(clipboard, targets_received_cb, read);
+}
+
+void clipboard_read_contents(GtkClipboard* clipboard, GdkAtom target,
+                             guint timeout_ms,
+                             ClipboardContentsCallback callback) {
+  ClipboardRead* read = clipboard_read_new(CLIPBOARD_READ_KIND_CONTENTS);
+  read->on_contents = std::move(callback);
+  clipboard_read_start_timeout(read, timeout_ms);
+  gtk_clipboard_request_contents(clipboard, target, contents_received_cb,
+                                 read);
+}
+
+void clipboard_read_text(GtkClipboard* clipboard, guint timeout_ms,
+                         ClipboardTextCallback callback) {
+  ClipboardRead* read = clipboard_read_new(CLIPBOARD_READ_KIND_TEXT);
+  read->on_text = std::move(callback);
+  clipboard_read_start_timeout(read, timeout_ms);
+  gtk_clipboard_request_text(clipboard, text_received_cb, read);
+}
+
+void clipboard_read_image(GtkClipboard* clipboard, guint timeout_ms,
+                          ClipboardImageCallback callback) {
+  ClipboardRead* read = clipboard_read_new(CLIPBOARD_READ_KIND_IMAGE);
+  read->on_image = std::move(callback);
+  clipboard_read_start_timeout(read, timeout_ms);
+  gtk_clipboard_request_image(clipboard, image_received_cb, read);
+}
+
+#ifdef GDK_WINDOWING_X11
+
+// 大小查询：在不可见的专用窗口上请求转换，收到 SelectionNotify 后只读取
+// 属性的长度。INCR 属性不删除，销毁窗口即放弃这次传输
+struct ClipboardSizeProbe {
+  ClipboardSizeCallback callback;
+  Display* xdisplay;
+  Window window;
+  Atom property;
+  Atom incr;
+  guint timeout_id;
+};
+
+static GdkFilterReturn size_probe_filter_cb(GdkXEvent* gdk_xevent,
+                                            GdkEvent* event, gpointer data);
+
+static void size_probe_finish(ClipboardSizeProbe* probe,
+                              ClipboardReadStatus status, gsize size,
+                              bool lower_bound) {
+  gdk_window_remove_filter(nullptr, size_probe_filter_cb, probe);
+  if (probe->timeout_id != 0) {
+    g_source_remove(probe->timeout_id);
+  }
+  XDestroyWindow(probe->xdisplay, probe->window);
+  XFlush(probe->xdisplay);
+  ClipboardSizeCallback callback = std::move(probe->callback);
+  delete probe;
+  callback(status, size, lower_bound);
+}
+
+static gboolean size_probe_timeout_cb(gpointer user_data) {
+  ClipboardSizeProbe* probe = static_cast<ClipboardSizeProbe*>(user_data);
+  probe->timeout_id = 0;
+  size_probe_finish(probe, CLIPBOARD_READ_TIMEOUT, 0, false);
+  return G_SOURCE_REMOVE;
+}
+
+static GdkFilterReturn size_probe_filter_cb(GdkXEvent* gdk_xevent,
+                                            GdkEvent* event, gpointer data) {
+  ClipboardSizeProbe* probe = static_cast<ClipboardSizeProbe*>(data);
+  XEvent* xevent = static_cast<XEvent*>(gdk_xevent);
+  if (xevent->type != SelectionNotify ||
+      xevent->xselection.requestor != probe->window) {
+    return GDK_FILTER_CONTINUE;
+  }
+  if (xevent->xselection.property == None) {
+    size_probe_finish(probe, CLIPBOARD_READ_EMPTY, 0, false);
+    return GDK_FILTER_REMOVE;
+  }
+
+  // 只取一个 32 位单元：INCR 的值即大小下限，其余类型由 bytes_after 得出总长
+  Atom type = None;
+  int format = 0;
+  unsigned long n_items = 0;
+  unsigned long bytes_after = 0;
+  unsigned char* value = nullptr;
+  if (XGetWindowProperty(probe->xdisplay, probe->window, probe->property, 0,
+                         1, False, AnyPropertyType, &type, &format, &n_items,
+                         &bytes_after, &value) != Success ||
+      type == None) {
+    size_probe_finish(probe, CLIPBOARD_READ_EMPTY, 0, false);
+    return GDK_FILTER_REMOVE;
+  }
+  gsize size = 0;
+  bool lower_bound = type == probe->incr;
+  if (lower_bound) {
+    // 格式 32 的数据在客户端以 long 存放
+    size = n_items > 0 && format == 32
+               ? static_cast<gsize>(*reinterpret_cast<long*>(value))
+               : 0;
+  } else {
+    size = n_items * static_cast<gsize>(format / 8) + bytes_after;
+    XDeleteProperty(probe->xdisplay, probe->window, probe->property);
+  }
+  if (value != nullptr) {
+    XFree(value);
+  }
+  size_probe_finish(probe, CLIPBOARD_READ_OK, size, lower_bound);
+  return GDK_FILTER_REMOVE;
+}
+
+void clipboard_read_size(GtkClipboard* clipboard, GdkAtom target,
+                         guint timeout_ms, ClipboardSizeCallback callback) {
+  GdkDisplay* display = gtk_clipboard_get_display(clipboard);
+  if (display == nullptr || !GDK_IS_X11_DISPLAY(display)) {
+    callback(CLIPBOARD_READ_EMPTY, 0, false);
+    return;
+  }
+  ClipboardSizeProbe* probe = new ClipboardSizeProbe();
+  probe->callback = std::move(callback);
+  probe->xdisplay = gdk_x11_display_get_xdisplay(display);
+  probe->property = XInternAtom(probe->xdisplay, "CLIP_FLOW_SIZE", False);
+  probe->incr = XInternAtom(probe->xdisplay, "INCR", False);
+  probe->window = XCreateSimpleWindow(probe->xdisplay,
+                                      DefaultRootWindow(probe->xdisplay), 0,
+                                      0, 1, 1, 0, 0, 0);
+  probe->timeout_id = g_timeout_add(timeout_ms, size_probe_timeout_cb, probe);
+
+  gchar* target_name = gdk_atom_name(target);
+  Atom xtarget = XInternAtom(probe->xdisplay, target_name, False);
+  g_free(target_name);
+  gdk_window_add_filter(nullptr, size_probe_filter_cb, probe);
+  XConvertSelection(probe->xdisplay,
+                    XInternAtom(probe->xdisplay, "CLIPBOARD", False), xtarget,
+                    probe->property, probe->window, CurrentTime);
+  XFlush(probe->xdisplay);
+}
+
+#else
+
+void clipboard_read_size(GtkClipboard* clipboard, GdkAtom target,
+                         guint timeout_ms, ClipboardSizeCallback callback) {
+  callback(CLIPBOARD_READ_EMPTY, 0, false);
+}
+
+#endif  // GDK_WINDOWING_X11
+
+ClipboardReadGroup* clipboard_read_group_new(std::function<void()> done) {
+  ClipboardReadGroup* group = new ClipboardReadGroup();
+  group->pending = 1;
+  group->done = std::move(done);
+  return group;
+}
+
+void clipboard_read_group_enter(ClipboardReadGroup* group) {
+  group->pending++;
+}
+
+void clipboard_read_group_leave(ClipboardReadGroup* group) {
+  if (--group->pending > 0) {
+    return;
+  }
+  std::function<void()> done = std::move(group->done);
+  delete group;
+  if (done) {
+    done();
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef CLIP_FLOW_CLIPBOARD_READER_H_
+#define CLIP_FLOW_CLIPBOARD_READER_H_
+
+#include <gtk/gtk.h>
+
+#include <functional>
+
+// 基于 gtk_clipboard_request_* 的异步剪贴板读取。
+// 回调始终在 GTK 主线程上恰好调用一次：读取完成、失败或超时。
+// 超时后到达的迟到结果会被丢弃，选区所有者挂起不会阻塞主循环。
+
+// 默认单次读取超时（毫秒）
+constexpr guint kClipboardReadTimeoutMs = 2000;
+
+typedef enum {
+  CLIPBOARD_READ_OK,
+  CLIPBOARD_READ_EMPTY,    // 所有者拒绝转换或没有数据
+  CLIPBOARD_READ_TIMEOUT,  // 超过读取时限
+} ClipboardReadStatus;
+
+// atoms 仅在回调期间有效
+using ClipboardTargetsCallback =
+    std::function<void(ClipboardReadStatus status, GdkAtom* atoms,
+                       gint n_atoms)>;
+// bytes 仅在回调期间有效，需要保留时自行 g_bytes_ref
+using ClipboardContentsCallback =
+    std::function<void(ClipboardReadStatus status, GBytes* bytes)>;
+using ClipboardTextCallback =
+    std::function<void(ClipboardReadStatus status, const gchar* text)>;
+using ClipboardImageCallback =
+    std::function<void(ClipboardReadStatus status, GdkPixbuf* pixbuf)>;
+
+void clipboard_read_targets(GtkClipboard* clipboard, guint timeout_ms,
+                            ClipboardTargetsCallback callback);
+
+void clipboard_read_contents(GtkClipboard* clipboard, GdkAtom target,
+                             guint timeout_ms,
+                             ClipboardContentsCallback callback);
+
+void clipboard_read_text(GtkClipboard* clipboard, guint timeout_ms,
+                         ClipboardTextCallback callback);
+
+void clipboard_read_image(GtkClipboard* clipboard, guint timeout_ms,
+                          ClipboardImageCallback callback);
+
+// size 为字节数；lower_bound 为 true 时所有者使用 INCR 增量传输，
+// size 是其声明的下限
+using ClipboardSizeCallback = std::function<void(
+    ClipboardReadStatus status, gsize size, bool lower_bound)>;
+
+// 只查询 target 格式的负载大小，不传输内容（仅 X11）：请求转换后只取
+// 属性长度，INCR 传输不会开始。无法查询时以 CLIPBOARD_READ_EMPTY 回调
+void clipboard_read_size(GtkClipboard* clipboard, GdkAtom target,
+                         guint timeout_ms, ClipboardSizeCallback callback);
+
+// 并行读取的汇合点：创建时计数为 1，每发起一次读取 enter，
+// 每完成一次 leave；计数归零时调用 done 并释放自身。
+typedef struct _ClipboardReadGroup ClipboardReadGroup;
+
+ClipboardReadGroup* clipboard_read_group_new(std::function<void()> done);
+void clipboard_read_group_enter(ClipboardReadGroup* group);
+void clipboard_read_group_leave(ClipboardReadGroup* group);
+
+#endif  // CLIP_FLOW_CLIPBOARD_READER_H_
@@ -0,0 +1,130 @@
+#include "clipboard_snapshot.h"
+
+ClipboardSnapshotCache::ClipboardSnapshotCache(gsize max_bytes)
+    : max_bytes_(max_bytes) {}
+
+ClipboardSnapshotCache::~ClipboardSnapshotCache() {
+  clear();
+}
+
+void ClipboardSnapshotCache::clear() {
+  for (auto& entry : entries_) {
+    if (entry.bytes != nullptr) {
+      g_bytes_unref(entry.bytes);
+    }
+  }
+  entries_.clear();
+  g_clear_object(&pixbuf_);
+  has_pixbuf_ = FALSE;
+  size_bytes_ = 0;
+}
+
+void ClipboardSnapshotCache::reset(gint64 sequence) {
+  clear();
+  sequence_ = sequence;
+  epoch_++;
+}
+
+gboolean ClipboardSnapshotCache::lookup(const std::string& key,
+                                        GBytes** bytes) {
+  for (const auto& entry : entries_) {
+    if (entry.key == key) {
+      *bytes = entry.bytes != nullptr ? g_bytes_ref(entry.bytes) : nullptr;
+      hits_++;
+      return TRUE;
+    }
+  }
+  misses_++;
+  return FALSE;
+}
+
+gboolean ClipboardSnapshotCache::peek(const std::string& key,
+                                      GBytes** bytes) const {
+  for (const auto& entry : entries_) {
+    if (entry.key == key) {
+      *bytes = entry.bytes != nullptr ? g_bytes_ref(entry.bytes) : nullptr;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+void ClipboardSnapshotCache::store(guint epoch, const std::string& key,
+                                   GBytes* bytes) {
+  if (epoch != epoch_) {
+    return;
+  }
+  gsize size = bytes != nullptr ? g_bytes_get_size(bytes) : 0;
+  if (size > max_bytes_) {
+    return;
+  }
+
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->key == key) {
+      size_bytes_ -= it->size;
+      if (it->bytes != nullptr) {
+        g_bytes_unref(it->bytes);
+      }
+      entries_.erase(it);
+      break;
+    }
+  }
+
+  evict_for(size);
+  entries_.push_back(
+      Entry{key, bytes != nullptr ? g_bytes_ref(bytes) : nullptr, size});
+  size_bytes_ += size;
+}
+
+gboolean ClipboardSnapshotCache::lookup_pixbuf(GdkPixbuf** pixbuf) {
+  if (!has_pixbuf_) {
+    misses_++;
+    return FALSE;
+  }
+  *pixbuf = pixbuf_ != nullptr ? GDK_PIXBUF(g_object_ref(pixbuf_)) : nullptr;
+  hits_++;
+  return TRUE;
+}
+
+void ClipboardSnapshotCache::store_pixbuf(guint epoch, GdkPixbuf* pixbuf) {
+  if (epoch != epoch_) {
+    return;
+  }
+  gsize size = pixbuf_size(pixbuf);
+  if (size > max_bytes_) {
+    return;
+  }
+
+  size_bytes_ -= pixbuf_size(pixbuf_);
+  g_clear_object(&pixbuf_);
+
+  evict_for(size);
+  pixbuf_ = pixbuf != nullptr ? GDK_PIXBUF(g_object_ref(pixbuf)) : nullptr;
+  has_pixbuf_ = TRUE;
+  size_bytes_ += size;
+}
+
+gsize ClipboardSnapshotCache::pixbuf_size(GdkPixbuf* pixbuf) {
+  if (pixbuf == nullptr) {
+    return 0;
+  }
+  return static_cast<gsize>(gdk_pixbuf_get_rowstride(pixbuf)) *
+         gdk_pixbuf_get_height(pixbuf);
+}
+
+void ClipboardSnapshotCache::evict_for(gsize incoming) {
+  while (!entries_.empty() && size_bytes_ + incoming > max_bytes_) {
+    Entry& oldest = entries_.front();
+    size_bytes_ -= oldest.size;
+    if (oldest.bytes != nullptr) {
+      g_bytes_unref(oldest.bytes);
+    }
+    entries_.pop_front();
+  }
+  // 仍然放不下时再丢弃已解码的图像
+  if (size_bytes_ + incoming > max_bytes_ && pixbuf_ != nullptr) {
+    size_bytes_ -= pixbuf_size(pixbuf_);
+    g_clear_object(&pixbuf_);
+    has_pixbuf_ = FALSE;
+  }
+}
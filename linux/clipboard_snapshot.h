@@ -0,0 +1,65 @@
+#ifndef CLIP_FLOW_CLIPBOARD_SNAPSHOT_H_
+#define CLIP_FLOW_CLIPBOARD_SNAPSHOT_H_
+
+#include <gtk/gtk.h>
+
+#include <list>
+#include <string>
+
+// 剪贴板快照缓存：保存当前剪贴板状态（一个序列号）下已读取过的各格式数据，
+// 同一状态下的后续方法调用直接从内存返回，无需再次向选区所有者请求。
+// 剪贴板状态变化时整体清空；总大小受 max_bytes 限制，超出时淘汰最早写入的条目。
+class ClipboardSnapshotCache {
+ public:
+  explicit ClipboardSnapshotCache(gsize max_bytes);
+  ~ClipboardSnapshotCache();
+
+  ClipboardSnapshotCache(const ClipboardSnapshotCache&) = delete;
+  ClipboardSnapshotCache& operator=(const ClipboardSnapshotCache&) = delete;
+
+  // 清空缓存并进入新的纪元；之前发起的读取结果将不再写入
+  void reset(gint64 sequence);
+
+  gint64 sequence() const { return sequence_; }
+  guint epoch() const { return epoch_; }
+  gsize size_bytes() const { return size_bytes_; }
+
+  // 查找格式数据；found 为 FALSE 表示未缓存。
+  // 命中时 *bytes 为新引用，nullptr 表示所有者明确不提供该格式。
+  gboolean lookup(const std::string& key, GBytes** bytes);
+  // 与 lookup 相同但不计入命中统计（用于构建清单）
+  gboolean peek(const std::string& key, GBytes** bytes) const;
+  // 写入格式数据（bytes 可为 nullptr 表示“无数据”）；epoch 不匹配时忽略
+  void store(guint epoch, const std::string& key, GBytes* bytes);
+
+  // 解码后的图像（返回新引用）
+  gboolean lookup_pixbuf(GdkPixbuf** pixbuf);
+  void store_pixbuf(guint epoch, GdkPixbuf* pixbuf);
+
+  guint64 hits() const { return hits_; }
+  guint64 misses() const { return misses_; }
+
+ private:
+  struct Entry {
+    std::string key;
+    GBytes* bytes;
+    gsize size;
+  };
+
+  static gsize pixbuf_size(GdkPixbuf* pixbuf);
+  void evict_for(gsize incoming);
+  void clear();
+
+  gsize max_bytes_;
+  gsize size_bytes_ = 0;
+  gint64 sequence_ = -1;
+  guint epoch_ = 0;
+  // 按写入顺序排列，淘汰时从头部开始
+  std::list<Entry> entries_;
+  GdkPixbuf* pixbuf_ = nullptr;
+  gboolean has_pixbuf_ = FALSE;
+  guint64 hits_ = 0;
+  guint64 misses_ = 0;
+};
+
+#endif  // CLIP_FLOW_CLIPBOARD_SNAPSHOT_H_
@@ -0,0 +1,464 @@
+#include "clipboard_stream.h"
+
+#include "clipboard_reader.h"
+
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifdef GDK_WINDOWING_X11
+#include <gdk/gdkx.h>
+#endif
+
+namespace {
+
+// 消息头部：int32 stream_id | int32 flags | int64 offset（小端）
+constexpr gsize kHeaderSize = 16;
+
+void write_le32(guint8* out, guint32 value) {
+  for (int i = 0; i < 4; i++) {
+    out[i] = static_cast<guint8>(value >> (8 * i));
+  }
+}
+
+void write_le64(guint8* out, guint64 value) {
+  for (int i = 0; i < 8; i++) {
+    out[i] = static_cast<guint8>(value >> (8 * i));
+  }
+}
+
+}  // namespace
+
+#ifdef GDK_WINDOWING_X11
+
+// 基于 Xlib 的选区读取，支持 INCR 增量传输。
+// 在不可见的专用窗口上接收 SelectionNotify / PropertyNotify，
+// 通过 GDK 全局事件过滤器挂入 GTK 主循环。
+class ClipboardStream::X11Reader {
+ public:
+  using ChunkCallback = std::function<void(GBytes* chunk)>;
+  using DoneCallback = std::function<void(bool ok, const gchar* error)>;
+
+  // 不是 X11 显示时返回 nullptr
+  static X11Reader* create(GtkClipboard* clipboard, GdkAtom target) {
+    GdkDisplay* display = gtk_clipboard_get_display(clipboard);
+    if (display == nullptr || !GDK_IS_X11_DISPLAY(display)) {
+      return nullptr;
+    }
+    return new X11Reader(display, target);
+  }
+
+  ~X11Reader() {
+    gdk_window_remove_filter(nullptr, event_filter_cb, this);
+    if (window_ != None) {
+      XDestroyWindow(xdisplay_, window_);
+      XFlush(xdisplay_);
+    }
+  }
+
+  // 请求转换；每收到一块调用 on_chunk，调用方处理完后调用 release_chunk
+  // 以通知所有者继续发送
+  void start(ChunkCallback on_chunk, DoneCallback on_done) {
+    on_chunk_ = std::move(on_chunk);
+    on_done_ = std::move(on_done);
+
+    gdk_window_add_filter(nullptr, event_filter_cb, this);
+    XConvertSelection(xdisplay_, selection_, target_, property_, window_,
+                      CurrentTime);
+    XFlush(xdisplay_);
+  }
+
+  void release_chunk() {
+    // 删除属性即向 INCR 所有者请求下一块
+    XDeleteProperty(xdisplay_, window_, property_);
+    XFlush(xdisplay_);
+  }
+
+ private:
+  X11Reader(GdkDisplay* display, GdkAtom target)
+      : xdisplay_(gdk_x11_display_get_xdisplay(display)) {
+    selection_ = XInternAtom(xdisplay_, "CLIPBOARD", False);
+    incr_ = XInternAtom(xdisplay_, "INCR", False);
+    property_ = XInternAtom(xdisplay_, "CLIP_FLOW_STREAM", False);
+    gchar* target_name = gdk_atom_name(target);
+    target_ = XInternAtom(xdisplay_, target_name, False);
+    g_free(target_name);
+
+    window_ = XCreateSimpleWindow(xdisplay_, DefaultRootWindow(xdisplay_), 0,
+                                  0, 1, 1, 0, 0, 0);
+    XSelectInput(xdisplay_, window_, PropertyChangeMask);
+  }
+
+  static GdkFilterReturn event_filter_cb(GdkXEvent* gdk_xevent,
+                                         GdkEvent* event, gpointer data) {
+    X11Reader* reader = static_cast<X11Reader*>(data);
+    XEvent* xevent = static_cast<XEvent*>(gdk_xevent);
+
+    if (xevent->type == SelectionNotify &&
+        xevent->xselection.requestor == reader->window_) {
+      reader->handle_selection_notify(xevent->xselection);
+      return GDK_FILTER_REMOVE;
+    }
+    if (xevent->type == PropertyNotify &&
+        xevent->xproperty.window == reader->window_) {
+      if (xevent->xproperty.atom == reader->property_ &&
+          xevent->xproperty.state == PropertyNewValue && reader->incremental_) {
+        reader->handle_incremental_chunk();
+      }
+      return GDK_FILTER_REMOVE;
+    }
+    return GDK_FILTER_CONTINUE;
+  }
+
+  // 读取属性内容；格式 32 的数据在客户端以 long 存放
+  GBytes* read_property(Atom* type) {
+    unsigned char* data = nullptr;
+    int format = 0;
+    unsigned long n_items = 0;
+    unsigned long bytes_after = 0;
+    if (XGetWindowProperty(xdisplay_, window_, property_, 0, LONG_MAX / 4,
+                           False, AnyPropertyType, type, &format, &n_items,
+                           &bytes_after, &data) != Success) {
+      return nullptr;
+    }
+    gsize unit = format == 32 ? sizeof(long) : static_cast<gsize>(format / 8);
+    GBytes* bytes = g_bytes_new(data, n_items * unit);
+    if (data != nullptr) {
+      XFree(data);
+    }
+    return bytes;
+  }
+
+  void handle_selection_notify(const XSelectionEvent& event) {
+    if (event.property == None) {
+      complete(false, "Clipboard owner refused the conversion");
+      return;
+    }
+
+    Atom type = None;
+    GBytes* bytes = read_property(&type);
+    if (bytes == nullptr) {
+      complete(false, "Failed to read the selection property");
+      return;
+    }
+
+    if (type == incr_) {
+      // INCR：删除属性后所有者开始逐块写入
+      incremental_ = true;
+      g_bytes_unref(bytes);
+      release_chunk();
+      return;
+    }
+
+    // 一次性传输：整块交给调用方，结束由 release_chunk 之后的 complete 通知
+    whole_transfer_ = true;
+    on_chunk_(bytes);
+    g_bytes_unref(bytes);
+  }
+
+  void handle_incremental_chunk() {
+    Atom type = None;
+    GBytes* bytes = read_property(&type);
+    if (bytes == nullptr) {
+      complete(false, "Failed to read an incremental chunk");
+      return;
+    }
+    if (g_bytes_get_size(bytes) == 0) {
+      // 长度为 0 的块表示传输结束
+      g_bytes_unref(bytes);
+      XDeleteProperty(xdisplay_, window_, property_);
+      XFlush(xdisplay_);
+      complete(true, nullptr);
+      return;
+    }
+    on_chunk_(bytes);
+    g_bytes_unref(bytes);
+  }
+
+  void complete(bool ok, const gchar* error) {
+    if (on_done_) {
+      DoneCallback done = std::move(on_done_);
+      on_done_ = nullptr;
+      done(ok, error);
+    }
+  }
+
+ public:
+  // 一次性传输的数据块被处理完后调用，用于发出完成通知
+  bool whole_transfer() const { return whole_transfer_; }
+  void complete_whole_transfer() {
+    release_chunk();
+    complete(true, nullptr);
+  }
+
+ private:
+  Display* xdisplay_;
+  Window window_ = None;
+  Atom selection_;
+  Atom target_;
+  Atom property_;
+  Atom incr_;
+  bool incremental_ = false;
+  bool whole_transfer_ = false;
+  ChunkCallback on_chunk_;
+  DoneCallback on_done_;
+};
+
+#else
+
+class ClipboardStream::X11Reader {
+ public:
+  static X11Reader* create(GtkClipboard* clipboard, GdkAtom target) {
+    return nullptr;
+  }
+};
+
+#endif  // GDK_WINDOWING_X11
+
+ClipboardStream::ClipboardStream(gint id, FlBinaryMessenger* messenger,
+                                 GtkClipboard* clipboard, GdkAtom target,
+                                 const ClipboardStreamOptions& options,
+                                 FinishedCallback on_finished)
+    : id_(id),
+      messenger_(FL_BINARY_MESSENGER(g_object_ref(messenger))),
+      clipboard_(clipboard),
+      target_(target),
+      options_(options),
+      on_finished_(std::move(on_finished)) {
+  if (options_.chunk_bytes == 0) {
+    options_.chunk_bytes = ClipboardStreamOptions().chunk_bytes;
+  }
+}
+
+ClipboardStream::~ClipboardStream() {
+  *alive_ = false;
+  disarm_timeout();
+  if (notify_id_ != 0) {
+    g_source_remove(notify_id_);
+  }
+  delete x11_reader_;
+  g_clear_pointer(&pending_bytes_, g_bytes_unref);
+  g_object_unref(messenger_);
+}
+
+void ClipboardStream::start() {
+  arm_timeout();
+
+  x11_reader_ = X11Reader::create(clipboard_, target_);
+  if (x11_reader_ == nullptr) {
+    start_gtk_fallback();
+    return;
+  }
+
+#ifdef GDK_WINDOWING_X11
+  x11_reader_->start(
+      [this](GBytes* chunk) {
+        // 所有者写入一块：暂停超时，等待 Dart 处理完后再请求下一块
+        disarm_timeout();
+        send_data(chunk, [this]() {
+          if (x11_reader_->whole_transfer()) {
+            x11_reader_->complete_whole_transfer();
+          } else {
+            arm_timeout();
+            x11_reader_->release_chunk();
+          }
+        });
+      },
+      [this](bool ok, const gchar* error) {
+        if (ok) {
+          finish_success();
+        } else {
+          abort(error);
+        }
+      });
+#endif
+}
+
+// Wayland 等非 X11 后端：由 GTK 读取完整数据后分块发送
+void ClipboardStream::start_gtk_fallback() {
+  std::shared_ptr<bool> alive = alive_;
+  clipboard_read_contents(
+      clipboard_, target_, options_.timeout_ms,
+      [this, alive](ClipboardReadStatus status, GBytes* bytes) {
+        if (!*alive || finished_) {
+          return;
+        }
+        if (status == CLIPBOARD_READ_TIMEOUT) {
+          abort("Clipboard stream timed out");
+          return;
+        }
+        if (status != CLIPBOARD_READ_OK || bytes == nullptr) {
+          abort("Clipboard owner refused the conversion");
+          return;
+        }
+        disarm_timeout();
+        send_data(bytes, [this]() { finish_success(); });
+      });
+}
+
+void ClipboardStream::send_data(GBytes* bytes, std::function<void()> done) {
+  if (finished_) {
+    return;
+  }
+  gsize length = g_bytes_get_size(bytes);
+  if (options_.max_bytes > 0 && offset_ + length > options_.max_bytes) {
+    abort("Clipboard payload exceeds the configured size cap");
+    return;
+  }
+
+  g_clear_pointer(&pending_bytes_, g_bytes_unref);
+  pending_bytes_ = g_bytes_ref(bytes);
+  pending_offset_ = 0;
+  pending_done_ = std::move(done);
+  send_next_piece();
+}
+
+void ClipboardStream::send_next_piece() {
+  gsize length = 0;
+  const guint8* data =
+      static_cast<const guint8*>(g_bytes_get_data(pending_bytes_, &length));
+
+  if (pending_offset_ >= length) {
+    g_clear_pointer(&pending_bytes_, g_bytes_unref);
+    std::function<void()> done = std::move(pending_done_);
+    pending_done_ = nullptr;
+    if (done) {
+      done();
+    }
+    return;
+  }
+
+  gsize piece = MIN(options_.chunk_bytes, length - pending_offset_);
+  send_message(0, data + pending_offset_, piece);
+  pending_offset_ += piece;
+  offset_ += piece;
+}
+
+void ClipboardStream::send_message(gint flags, const void* data,
+                                   gsize length) {
+  std::vector<guint8> message(kHeaderSize + length);
+  write_le32(message.data(), static_cast<guint32>(id_));
+  write_le32(message.data() + 4, static_cast<guint32>(flags));
+  write_le64(message.data() + 8, offset_);
+  if (length > 0) {
+    memcpy(message.data() + kHeaderSize, data, length);
+  }
+
+  GBytes* bytes = g_bytes_new(message.data(), message.size());
+  reply_pending_ = true;
+  // 等待 Dart 应答期间也受超时约束
+  if (!(flags & (CLIPBOARD_STREAM_FLAG_END | CLIPBOARD_STREAM_FLAG_ABORTED))) {
+    arm_timeout();
+  }
+  // 插件销毁时流对象会先于应答释放，回调经 alive 判断后再访问
+  SendContext* context = new SendContext{this, alive_};
+  fl_binary_messenger_send_on_channel(messenger_, kClipboardStreamChannel,
+                                      bytes, nullptr, send_reply_cb, context);
+  g_bytes_unref(bytes);
+}
+
+void ClipboardStream::send_reply_cb(GObject* object, GAsyncResult* result,
+                                    gpointer user_data) {
+  std::unique_ptr<SendContext> context(static_cast<SendContext*>(user_data));
+
+  g_autoptr(GError) error = nullptr;
+  GBytes* reply = fl_binary_messenger_send_on_channel_finish(
+      FL_BINARY_MESSENGER(object), result, &error);
+  bool proceed = false;
+  if (reply != nullptr) {
+    gsize length = 0;
+    const guint8* data =
+        static_cast<const guint8*>(g_bytes_get_data(reply, &length));
+    proceed = length > 0 && data[0] != 0;
+    g_bytes_unref(reply);
+  }
+  if (!*context->alive) {
+    return;
+  }
+
+  ClipboardStream* self = context->stream;
+  self->reply_pending_ = false;
+  if (self->finished_) {
+    self->notify_finished();
+    return;
+  }
+  self->disarm_timeout();
+  if (!proceed) {
+    self->abort("Cancelled by the receiver");
+    return;
+  }
+  self->send_next_piece();
+}
+
+void ClipboardStream::finish_success() {
+  if (finished_) {
+    return;
+  }
+  send_message(CLIPBOARD_STREAM_FLAG_END, nullptr, 0);
+  finish();
+}
+
+void ClipboardStream::cancel(const gchar* reason) {
+  abort(reason);
+}
+
+void ClipboardStream::abort(const gchar* reason) {
+  if (finished_) {
+    return;
+  }
+  // 上一条消息的应答尚未返回时不再发送，避免 Dart 侧乱序
+  if (!reply_pending_) {
+    send_message(CLIPBOARD_STREAM_FLAG_ABORTED, reason,
+                 reason != nullptr ? strlen(reason) : 0);
+  }
+  finish();
+}
+
+void ClipboardStream::finish() {
+  finished_ = true;
+  disarm_timeout();
+  // 读取窗口可能正处于事件回调中，随对象在空闲回调里一并销毁；
+  // 此后到达的数据块因 finished_ 被忽略
+  g_clear_pointer(&pending_bytes_, g_bytes_unref);
+  pending_done_ = nullptr;
+  if (!reply_pending_) {
+    notify_finished();
+  }
+}
+
+// 延迟到空闲回调中通知，调用方可以在回调里安全地销毁本对象
+void ClipboardStream::notify_finished() {
+  if (notify_id_ == 0) {
+    notify_id_ = g_idle_add(notify_finished_cb, this);
+  }
+}
+
+gboolean ClipboardStream::notify_finished_cb(gpointer user_data) {
+  ClipboardStream* self = static_cast<ClipboardStream*>(user_data);
+  self->notify_id_ = 0;
+  if (self->on_finished_) {
+    self->on_finished_(self->id_);
+  }
+  return G_SOURCE_REMOVE;
+}
+
+void ClipboardStream::arm_timeout() {
+  disarm_timeout();
+  timeout_id_ = g_timeout_add(options_.timeout_ms, timeout_cb, this);
+}
+
+void ClipboardStream::disarm_timeout() {
+  if (timeout_id_ != 0) {
+    g_source_remove(timeout_id_);
+    timeout_id_ = 0;
+  }
+}
+
+gboolean ClipboardStream::timeout_cb(gpointer user_data) {
+  ClipboardStream* self = static_cast<ClipboardStream*>(user_data);
+  self->timeout_id_ = 0;
+  self->abort("Clipboard stream timed out");
+  return G_SOURCE_REMOVE;
+}
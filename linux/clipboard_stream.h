@@ -0,0 +1,107 @@
+#ifndef CLIP_FLOW_CLIPBOARD_STREAM_H_
+#define CLIP_FLOW_CLIPBOARD_STREAM_H_
+
+#include <flutter_linux/flutter_linux.h>
+#include <gtk/gtk.h>
+
+#include <functional>
+#include <memory>
+
+// 大体积剪贴板负载的分块流式传输。
+//
+// X11 下直接以 ConvertSelection 请求目标格式，所有者使用 INCR 协议时逐块读取，
+// 每块经由二进制消息通道 kClipboardStreamChannel 发送给 Dart，Dart 应答后才删除
+// 属性以通知所有者发送下一块，从而把 Dart 侧的处理速度反压到选区所有者。
+// 非 X11 后端回退为 GTK 整体读取后再分块发送。
+//
+// 每条消息为 16 字节小端头部 + 负载：
+//   int32 stream_id | int32 flags | int64 offset
+// flags 取 ClipboardStreamFlags；中止消息的负载为 UTF-8 原因。
+// Dart 应答 1 字节：1 继续，0 取消；无应答（未注册处理器）视为取消。
+
+constexpr char kClipboardStreamChannel[] = "clipboard_stream";
+
+typedef enum {
+  CLIPBOARD_STREAM_FLAG_END = 1 << 0,      // 最后一块
+  CLIPBOARD_STREAM_FLAG_ABORTED = 1 << 1,  // 传输中止
+} ClipboardStreamFlags;
+
+struct ClipboardStreamOptions {
+  // 单条消息的最大负载
+  gsize chunk_bytes = 1024 * 1024;
+  // 累计超过该大小时中止，0 表示不限制
+  gsize max_bytes = 0;
+  // 所有者或 Dart 无响应的时限
+  guint timeout_ms = 5000;
+};
+
+class ClipboardStream {
+ public:
+  using FinishedCallback = std::function<void(gint id)>;
+
+  ClipboardStream(gint id, FlBinaryMessenger* messenger,
+                  GtkClipboard* clipboard, GdkAtom target,
+                  const ClipboardStreamOptions& options,
+                  FinishedCallback on_finished);
+  ~ClipboardStream();
+
+  ClipboardStream(const ClipboardStream&) = delete;
+  ClipboardStream& operator=(const ClipboardStream&) = delete;
+
+  gint id() const { return id_; }
+  gsize transferred() const { return offset_; }
+
+  void start();
+  // 取消传输，并向 Dart 发送中止消息
+  void cancel(const gchar* reason);
+
+ private:
+  class X11Reader;
+
+  // 发送一段数据（按 chunk_bytes 切分），全部被应答后调用 done
+  void send_data(GBytes* bytes, std::function<void()> done);
+  void send_next_piece();
+  void send_message(gint flags, const void* data, gsize length);
+  static void send_reply_cb(GObject* object, GAsyncResult* result,
+                            gpointer user_data);
+
+  // send_reply_cb 的上下文，随每条消息分配
+  struct SendContext {
+    ClipboardStream* stream;
+    std::shared_ptr<bool> alive;
+  };
+
+  void finish_success();
+  void abort(const gchar* reason);
+  void finish();
+  void notify_finished();
+  static gboolean notify_finished_cb(gpointer user_data);
+  void start_gtk_fallback();
+
+  void arm_timeout();
+  void disarm_timeout();
+  static gboolean timeout_cb(gpointer user_data);
+
+  gint id_;
+  FlBinaryMessenger* messenger_;
+  GtkClipboard* clipboard_;
+  GdkAtom target_;
+  ClipboardStreamOptions options_;
+  FinishedCallback on_finished_;
+
+  X11Reader* x11_reader_ = nullptr;
+  gsize offset_ = 0;
+  bool finished_ = false;
+  bool reply_pending_ = false;
+  guint timeout_id_ = 0;
+  guint notify_id_ = 0;
+  // 异步读取与消息应答的回调持有其副本，用于判断对象是否已销毁
+  std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
+
+  // 正在分片发送的数据
+  GBytes* pending_bytes_ = nullptr;
+  gsize pending_offset_ = 0;
+  std::function<void()> pending_done_;
+};
+
+#endif  // CLIP_FLOW_CLIPBOARD_STREAM_H_
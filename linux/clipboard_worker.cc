@@ -0,0 +1,57 @@
+#include "clipboard_worker.h"
+
+#include <utility>
+
+namespace {
+
+struct ClipboardWorkerJob {
+  std::function<void()> work;
+  std::function<void()> done;
+};
+
+void worker_thread_func(GTask* task, gpointer source_object,
+                        gpointer task_data, GCancellable* cancellable) {
+  ClipboardWorkerJob* job = static_cast<ClipboardWorkerJob*>(task_data);
+  job->work();
+  g_task_return_boolean(task, TRUE);
+}
+
+void worker_done_cb(GObject* source_object, GAsyncResult* result,
+                    gpointer user_data) {
+  ClipboardWorkerJob* job = static_cast<ClipboardWorkerJob*>(
+      g_task_get_task_data(G_TASK(result)));
+  if (job->done) {
+    job->done();
+  }
+}
+
+void worker_job_free(gpointer data) {
+  delete static_cast<ClipboardWorkerJob*>(data);
+}
+
+gboolean main_invoke_cb(gpointer user_data) {
+  (*static_cast<std::function<void()>*>(user_data))();
+  return G_SOURCE_REMOVE;
+}
+
+void main_invoke_free(gpointer data) {
+  delete static_cast<std::function<void()>*>(data);
+}
+
+}  // namespace
+
+void clipboard_worker_run(std::function<void()> work,
+                          std::function<void()> done) {
+  ClipboardWorkerJob* job = new ClipboardWorkerJob{std::move(work),
+                                                   std::move(done)};
+  GTask* task = g_task_new(nullptr, nullptr, worker_done_cb, nullptr);
+  g_task_set_task_data(task, job, worker_job_free);
+  g_task_run_in_thread(task, worker_thread_func);
+  g_object_unref(task);
+}
+
+void clipboard_main_invoke(std::function<void()> callback) {
+  g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, main_invoke_cb,
+                             new std::function<void()>(std::move(callback)),
+                             main_invoke_free);
+}
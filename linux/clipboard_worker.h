@@ -0,0 +1,17 @@
+#ifndef CLIP_FLOW_CLIPBOARD_WORKER_H_
+#define CLIP_FLOW_CLIPBOARD_WORKER_H_
+
+#include <gtk/gtk.h>
+
+#include <functional>
+
+// 在 GLib 线程池上执行耗时的纯计算任务（解码、缩放、编码、哈希等），
+// 完成后回到发起调用的主循环上下文（GTK 主线程）调用 done。
+// work 中不得访问 GTK 对象或插件状态；需要的数据由调用方预先复制或持有引用。
+void clipboard_worker_run(std::function<void()> work,
+                          std::function<void()> done);
+
+// 从工作线程把回调投递到 GTK 主线程执行（如进度通知）
+void clipboard_main_invoke(std::function<void()> callback);
+
+#endif  // CLIP_FLOW_CLIPBOARD_WORKER_H_
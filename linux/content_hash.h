@@ -0,0 +1,14 @@
+#ifndef CLIP_FLOW_CONTENT_HASH_H_
+#define CLIP_FLOW_CONTENT_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// 非加密内容指纹（XXH64 算法），用于剪贴板变化判定与去重键
+uint64_t content_hash_xxh64(const void* data, size_t length,
+                            uint64_t seed = 0);
+
+// 将两个指纹有序合并为一个（用于多格式组合指纹）
+uint64_t content_hash_combine(uint64_t seed, uint64_t value);
+
+#endif  // CLIP_FLOW_CONTENT_HASH_H_
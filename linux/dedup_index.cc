@@ -0,0 +1,249 @@
+#include "dedup_index.h"
+
+#include <cstring>
+#include <utility>
+
+#include "content_hash.h"
+
+namespace {
+
+constexpr size_t kInitialSlots = 1024;
+constexpr size_t kInitialBuckets = 256;
+// 哈希表负载上限（分子/分母），超过后容量翻倍
+constexpr size_t kMaxLoadNum = 7;
+constexpr size_t kMaxLoadDen = 10;
+// 布谷鸟过滤器单次插入的最大踢出次数
+constexpr int kMaxKicks = 500;
+
+inline uint16_t fingerprint_of(uint64_t hash) {
+  // 0 表示空位，指纹取值 1..65535
+  uint16_t fp = static_cast<uint16_t>(hash >> 48);
+  return fp == 0 ? 1 : fp;
+}
+
+// 指纹的扰动哈希（MurmurHash3 finalizer），用于计算备用桶
+inline uint64_t mix64(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+}  // namespace
+
+DedupIndex::DedupIndex() {
+  clear();
+}
+
+uint64_t DedupIndex::hash_key(const std::string& key) {
+  return content_hash_xxh64(key.data(), key.size());
+}
+
+void DedupIndex::clear() {
+  slots_.assign(kInitialSlots, Slot{0, kEmptySlot});
+  entries_.clear();
+  free_entries_.clear();
+  count_ = 0;
+  Bucket empty;
+  std::memset(&empty, 0, sizeof(empty));
+  filter_.assign(kInitialBuckets, empty);
+}
+
+size_t DedupIndex::find_slot(uint64_t hash, const std::string& key) const {
+  const size_t mask = slots_.size() - 1;
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    const Slot& slot = slots_[i];
+    if (slot.entry == kEmptySlot) {
+      return i;
+    }
+    if (slot.hash == hash && entries_[slot.entry].key == key) {
+      return i;
+    }
+  }
+}
+
+void DedupIndex::place_slot(uint64_t hash, uint32_t entry) {
+  const size_t mask = slots_.size() - 1;
+  size_t i = hash & mask;
+  while (slots_[i].entry != kEmptySlot) {
+    i = (i + 1) & mask;
+  }
+  slots_[i] = Slot{hash, entry};
+}
+
+void DedupIndex::grow_table() {
+  std::vector<Slot> old = std::move(slots_);
+  slots_.assign(old.size() * 2, Slot{0, kEmptySlot});
+  for (const Slot& slot : old) {
+    if (slot.entry != kEmptySlot) {
+      place_slot(slot.hash, slot.entry);
+    }
+  }
+}
+
+bool DedupIndex::insert(const std::string& key, const std::string& id) {
+  uint64_t hash = hash_key(key);
+  size_t index = find_slot(hash, key);
+  if (slots_[index].entry != kEmptySlot) {
+    entries_[slots_[index].entry].id = id;
+    return false;
+  }
+
+  if ((count_ + 1) * kMaxLoadDen > slots_.size() * kMaxLoadNum) {
+    grow_table();
+  }
+
+  uint32_t entry;
+  if (!free_entries_.empty()) {
+    entry = free_entries_.back();
+    free_entries_.pop_back();
+    entries_[entry] = Entry{key, id};
+  } else {
+    entry = static_cast<uint32_t>(entries_.size());
+    entries_.push_back(Entry{key, id});
+  }
+  place_slot(hash, entry);
+  count_++;
+
+  if (!filter_insert(hash)) {
+    // 过滤器过满：扩容并由表中全部键重建（此时已包含新键）
+    rebuild_filter(filter_.size() * 2);
+  }
+  return true;
+}
+
+bool DedupIndex::remove(const std::string& key) {
+  uint64_t hash = hash_key(key);
+  if (!filter_contains(hash)) {
+    return false;
+  }
+  size_t index = find_slot(hash, key);
+  if (slots_[index].entry == kEmptySlot) {
+    return false;
+  }
+
+  uint32_t entry = slots_[index].entry;
+  entries_[entry] = Entry();
+  free_entries_.push_back(entry);
+  count_--;
+  filter_remove(hash);
+
+  // 线性探测的回移删除：把后续簇中可前移的元素填入空位
+  const size_t mask = slots_.size() - 1;
+  size_t hole = index;
+  slots_[hole].entry = kEmptySlot;
+  for (size_t i = (hole + 1) & mask; slots_[i].entry != kEmptySlot;
+       i = (i + 1) & mask) {
+    size_t home = slots_[i].hash & mask;
+    // home 不在 (hole, i] 区间内时，该元素可以移到 hole
+    bool movable = hole <= i ? (home <= hole || home > i)
+                             : (home <= hole && home > i);
+    if (movable) {
+      slots_[hole] = slots_[i];
+      slots_[i].entry = kEmptySlot;
+      hole = i;
+    }
+  }
+  return true;
+}
+
+bool DedupIndex::lookup(const std::string& key, std::string* id) const {
+  uint64_t hash = hash_key(key);
+  // 过滤器未命中即可确定内容从未出现，无需探测哈希表
+  if (!filter_contains(hash)) {
+    return false;
+  }
+  size_t index = find_slot(hash, key);
+  if (slots_[index].entry == kEmptySlot) {
+    return false;
+  }
+  if (id != nullptr) {
+    const Entry& entry = entries_[slots_[index].entry];
+    *id = entry.id.empty() ? entry.key : entry.id;
+  }
+  return true;
+}
+
+size_t DedupIndex::alt_bucket(size_t bucket, uint16_t fingerprint) const {
+  return (bucket ^ mix64(fingerprint)) & (filter_.size() - 1);
+}
+
+bool DedupIndex::filter_contains(uint64_t hash) const {
+  uint16_t fp = fingerprint_of(hash);
+  size_t b1 = hash & (filter_.size() - 1);
+  size_t b2 = alt_bucket(b1, fp);
+  for (size_t bucket : {b1, b2}) {
+    for (uint16_t stored : filter_[bucket].fingerprints) {
+      if (stored == fp) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool DedupIndex::filter_insert(uint64_t hash) {
+  uint16_t fp = fingerprint_of(hash);
+  size_t b1 = hash & (filter_.size() - 1);
+  size_t b2 = alt_bucket(b1, fp);
+  for (size_t bucket : {b1, b2}) {
+    for (uint16_t& stored : filter_[bucket].fingerprints) {
+      if (stored == 0) {
+        stored = fp;
+        return true;
+      }
+    }
+  }
+
+  // 两个桶都满：随机踢出一个指纹到它的备用桶
+  size_t bucket = (kick_seed_ & 1) ? b1 : b2;
+  for (int kick = 0; kick < kMaxKicks; kick++) {
+    kick_seed_ = kick_seed_ * 1103515245u + 12345u;
+    uint16_t& victim = filter_[bucket].fingerprints[(kick_seed_ >> 16) %
+                                                    kBucketSize];
+    std::swap(fp, victim);
+    bucket = alt_bucket(bucket, fp);
+    for (uint16_t& stored : filter_[bucket].fingerprints) {
+      if (stored == 0) {
+        stored = fp;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void DedupIndex::filter_remove(uint64_t hash) {
+  uint16_t fp = fingerprint_of(hash);
+  size_t b1 = hash & (filter_.size() - 1);
+  size_t b2 = alt_bucket(b1, fp);
+  for (size_t bucket : {b1, b2}) {
+    for (uint16_t& stored : filter_[bucket].fingerprints) {
+      if (stored == fp) {
+        stored = 0;
+        return;
+      }
+    }
+  }
+}
+
+void DedupIndex::rebuild_filter(size_t bucket_count) {
+  for (;;) {
+    Bucket empty;
+    std::memset(&empty, 0, sizeof(empty));
+    filter_.assign(bucket_count, empty);
+    bool ok = true;
+    for (const Slot& slot : slots_) {
+      if (slot.entry != kEmptySlot && !filter_insert(slot.hash)) {
+        ok = false;
+        break;
+      }
+    }
+    if (ok) {
+      return;
+    }
+    bucket_count *= 2;
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef CLIP_FLOW_DEDUP_INDEX_H_
+#define CLIP_FLOW_DEDUP_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 内容哈希 → 剪贴项 ID 的内存去重索引。
+//
+// 前置布谷鸟过滤器（每桶 4 个 16 位指纹，支持删除）快速排除未出现过的内容，
+// 过滤器命中后再查开放寻址哈希表（线性探测，删除时回移，不留墓碑）。
+// 过滤器与哈希表始终同步增删；过滤器插入失败时按表中的键扩容重建。
+class DedupIndex {
+ public:
+  DedupIndex();
+
+  // 插入或更新映射；返回是否为新增的键
+  bool insert(const std::string& key, const std::string& id);
+  // 删除键；返回键是否存在
+  bool remove(const std::string& key);
+  // 查询键，命中时写入对应的 ID
+  bool lookup(const std::string& key, std::string* id) const;
+  void clear();
+
+  size_t size() const { return count_; }
+  size_t table_capacity() const { return slots_.size(); }
+  size_t filter_capacity() const { return filter_.size() * kBucketSize; }
+
+ private:
+  static constexpr size_t kBucketSize = 4;
+  static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+  struct Slot {
+    uint64_t hash;
+    uint32_t entry;
+  };
+  struct Entry {
+    std::string key;
+    std::string id;
+  };
+  struct Bucket {
+    uint16_t fingerprints[kBucketSize];
+  };
+
+  static uint64_t hash_key(const std::string& key);
+
+  // 开放寻址表
+  size_t find_slot(uint64_t hash, const std::string& key) const;
+  void grow_table();
+  void place_slot(uint64_t hash, uint32_t entry);
+
+  // 布谷鸟过滤器
+  bool filter_contains(uint64_t hash) const;
+  bool filter_insert(uint64_t hash);
+  void filter_remove(uint64_t hash);
+  void rebuild_filter(size_t bucket_count);
+  size_t alt_bucket(size_t bucket, uint16_t fingerprint) const;
+
+  std::vector<Slot> slots_;
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> free_entries_;
+  size_t count_ = 0;
+
+  std::vector<Bucket> filter_;
+  uint32_t kick_seed_ = 0;
+};
+
+#endif  // CLIP_FLOW_DEDUP_INDEX_H_
@@ -0,0 +1,290 @@
+#include "file_ingest.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glib.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "media_store.h"
+
+namespace {
+
+// 计算哈希与缓冲复制时单次读取的大小
+constexpr size_t kReadChunkBytes = 1024 * 1024;
+// 内核复制的分块大小，也是检查取消与报告进度的粒度
+constexpr size_t kCopyChunkBytes = 16 * 1024 * 1024;
+
+typedef enum {
+  COPY_DONE,
+  // 当前方式不适用（首块即失败），可换下一种方式继续
+  COPY_UNSUPPORTED,
+  COPY_FAILED,
+  COPY_CANCELLED,
+} CopyStatus;
+
+// 单步复制：从 offset 起最多复制 length 字节，返回实际字节数，出错返回 -1
+using CopyStep =
+    std::function<ssize_t(int source, int target, uint64_t offset,
+                          size_t length)>;
+
+std::string errno_message(const char* what, int error) {
+  return std::string(what) + ": " + g_strerror(error);
+}
+
+bool is_unsupported_errno(int error) {
+  return error == EXDEV || error == ENOSYS || error == EOPNOTSUPP ||
+         error == EINVAL || error == ENOTTY;
+}
+
+bool hash_file(int fd, uint64_t size, const std::atomic<bool>& cancelled,
+               const FileIngestProgressCallback& progress,
+               FileIngestResult* result) {
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+  std::vector<guchar> buffer(kReadChunkBytes);
+  uint64_t offset = 0;
+  uint64_t next_report = kCopyChunkBytes;
+  bool ok = true;
+  for (;;) {
+    if (cancelled.load(std::memory_order_relaxed)) {
+      result->cancelled = true;
+      ok = false;
+      break;
+    }
+    ssize_t n = pread(fd, buffer.data(), buffer.size(), offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      result->error = errno_message("read", errno);
+      ok = false;
+      break;
+    }
+    if (n == 0) {
+      break;
+    }
+    g_checksum_update(checksum, buffer.data(), n);
+    offset += static_cast<uint64_t>(n);
+    if (offset >= next_report) {
+      progress(FILE_INGEST_PHASE_HASH, offset, size);
+      next_report = offset + kCopyChunkBytes;
+    }
+  }
+  if (ok) {
+    result->hash = g_checksum_get_string(checksum);
+    result->bytes = offset;
+    progress(FILE_INGEST_PHASE_HASH, offset, size);
+  }
+  g_checksum_free(checksum);
+  return ok;
+}
+
+CopyStatus copy_chunks(int source, int target, uint64_t size,
+                       uint64_t* copied, const CopyStep& step,
+                       const std::atomic<bool>& cancelled,
+                       const FileIngestProgressCallback& progress,
+                       int* error) {
+  const uint64_t start = *copied;
+  while (*copied < size) {
+    if (cancelled.load(std::memory_order_relaxed)) {
+      return COPY_CANCELLED;
+    }
+    size_t length =
+        static_cast<size_t>(std::min<uint64_t>(kCopyChunkBytes, size - *copied));
+    ssize_t n = step(source, target, *copied, length);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      *error = errno;
+      return *copied == start && is_unsupported_errno(errno)
+                 ? COPY_UNSUPPORTED
+                 : COPY_FAILED;
+    }
+    if (n == 0) {
+      // 源文件在复制期间被截短
+      *error = EIO;
+      return COPY_FAILED;
+    }
+    *copied += static_cast<uint64_t>(n);
+    progress(FILE_INGEST_PHASE_COPY, *copied, size);
+  }
+  return COPY_DONE;
+}
+
+ssize_t copy_range_step(int source, int target, uint64_t offset,
+                        size_t length) {
+  loff_t in = static_cast<loff_t>(offset);
+  loff_t out = static_cast<loff_t>(offset);
+  return copy_file_range(source, &in, target, &out, length, 0);
+}
+
+ssize_t sendfile_step(int source, int target, uint64_t offset, size_t length) {
+  if (lseek(target, static_cast<off_t>(offset), SEEK_SET) < 0) {
+    return -1;
+  }
+  off_t in = static_cast<off_t>(offset);
+  return sendfile(target, source, &in, length);
+}
+
+bool reflink(int source, int target) {
+#ifdef FICLONE
+  return ioctl(target, FICLONE, source) == 0;
+#else
+  return false;
+#endif
+}
+
+// 依次尝试各种复制方式，换用下一种时从已复制的位置继续
+CopyStatus copy_file(int source, int target, uint64_t size,
+                     const std::atomic<bool>& cancelled,
+                     const FileIngestProgressCallback& progress,
+                     FileIngestResult* result) {
+  if (size > 0 && reflink(source, target)) {
+    result->method = FILE_INGEST_REFLINK;
+    progress(FILE_INGEST_PHASE_COPY, size, size);
+    return COPY_DONE;
+  }
+
+  std::vector<char> buffer;
+  CopyStep buffered_step = [&buffer](int source, int target, uint64_t offset,
+                                     size_t length) -> ssize_t {
+    buffer.resize(kReadChunkBytes);
+    size_t total = 0;
+    while (total < length) {
+      size_t want = std::min(buffer.size(), length - total);
+      ssize_t n = pread(source, buffer.data(), want, offset + total);
+      if (n <= 0) {
+        return total > 0 ? static_cast<ssize_t>(total) : n;
+      }
+      for (ssize_t written = 0; written < n;) {
+        ssize_t w = pwrite(target, buffer.data() + written, n - written,
+                           offset + total + written);
+        if (w < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          return -1;
+        }
+        written += w;
+      }
+      total += static_cast<size_t>(n);
+    }
+    return static_cast<ssize_t>(total);
+  };
+
+  const struct {
+    FileIngestMethod method;
+    CopyStep step;
+  } methods[] = {
+      {FILE_INGEST_COPY_FILE_RANGE, copy_range_step},
+      {FILE_INGEST_SENDFILE, sendfile_step},
+      {FILE_INGEST_BUFFERED, buffered_step},
+  };
+
+  uint64_t copied = 0;
+  int error = 0;
+  for (const auto& entry : methods) {
+    result->method = entry.method;
+    CopyStatus status = copy_chunks(source, target, size, &copied, entry.step,
+                                    cancelled, progress, &error);
+    if (status != COPY_UNSUPPORTED) {
+      if (status == COPY_FAILED) {
+        result->error = errno_message("copy", error);
+      }
+      return status;
+    }
+  }
+  result->error = errno_message("copy", error);
+  return COPY_FAILED;
+}
+
+// 源文件的大小与修改时间是否仍与 before 一致
+bool source_unchanged(int fd, const struct stat& before) {
+  struct stat after;
+  return fstat(fd, &after) == 0 && after.st_size == before.st_size &&
+         after.st_mtim.tv_sec == before.st_mtim.tv_sec &&
+         after.st_mtim.tv_nsec == before.st_mtim.tv_nsec;
+}
+
+}  // namespace
+
+const char* file_ingest_method_name(FileIngestMethod method) {
+  switch (method) {
+    case FILE_INGEST_REFLINK:
+      return "reflink";
+    case FILE_INGEST_COPY_FILE_RANGE:
+      return "copy_file_range";
+    case FILE_INGEST_SENDFILE:
+      return "sendfile";
+    case FILE_INGEST_BUFFERED:
+      return "buffered";
+  }
+  return "buffered";
+}
+
+const char* file_ingest_phase_name(FileIngestPhase phase) {
+  return phase == FILE_INGEST_PHASE_HASH ? "hash" : "copy";
+}
+
+bool file_ingest(const FileIngestRequest& request,
+                 const std::atomic<bool>& cancelled,
+                 const FileIngestProgressCallback& progress,
+                 FileIngestResult* result) {
+  int source = open(request.source.c_str(), O_RDONLY | O_CLOEXEC);
+  if (source < 0) {
+    result->error = errno_message("open", errno);
+    return false;
+  }
+  struct stat st;
+  if (fstat(source, &st) != 0 || !S_ISREG(st.st_mode)) {
+    result->error = "Source is not a regular file";
+    close(source);
+    return false;
+  }
+
+  bool ok = hash_file(source, static_cast<uint64_t>(st.st_size), cancelled,
+                      progress, result);
+  if (ok) {
+    result->name = request.prefix + "_" + result->hash.substr(0, 16) + "." +
+                   request.extension;
+    result->existed =
+        media_store_exists(request.directory, result->name, result->bytes);
+  }
+  if (!ok || result->existed) {
+    close(source);
+    return ok;
+  }
+
+  MediaStorePending pending;
+  if (!media_store_begin(request.directory, result->name, &pending,
+                         &result->error)) {
+    close(source);
+    return false;
+  }
+  CopyStatus status =
+      copy_file(source, pending.fd, result->bytes, cancelled, progress, result);
+  // 哈希与复制分两遍读取源文件，期间被改写时复制的内容与文件名中的哈希
+  // 可能不一致，放弃本次导入
+  if (status == COPY_DONE && !source_unchanged(source, st)) {
+    result->error = "Source file changed during import";
+    status = COPY_FAILED;
+  }
+  close(source);
+
+  if (status != COPY_DONE) {
+    result->cancelled = status == COPY_CANCELLED;
+    media_store_abort(&pending);
+    return false;
+  }
+  return media_store_commit(&pending, &result->error);
+}
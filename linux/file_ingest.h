@@ -0,0 +1,66 @@
+#ifndef CLIP_FLOW_FILE_INGEST_H_
+#define CLIP_FLOW_FILE_INGEST_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// 文件导入：把用户复制的文件收入媒体目录。
+//
+// 先顺序读取源文件计算 SHA-256 决定文件名（<prefix>_<哈希前 16 位>.<extension>），
+// 目标已存在即跳过；否则依次尝试：
+//   1. FICLONE 写时复制（btrfs/xfs 等，只共享数据块，不占额外空间）
+//   2. copy_file_range（内核内复制，部分文件系统可做服务端/块级复制）
+//   3. sendfile
+//   4. 用户态缓冲读写
+// 复制完成后重新检查源文件的大小与修改时间，导入期间源文件被改写则放弃。
+// 结果经媒体存储的组提交原子出现在目标路径。
+// 复制分块进行，每块之间检查取消标志并报告进度。
+
+typedef enum {
+  FILE_INGEST_REFLINK,
+  FILE_INGEST_COPY_FILE_RANGE,
+  FILE_INGEST_SENDFILE,
+  FILE_INGEST_BUFFERED,
+} FileIngestMethod;
+
+typedef enum {
+  FILE_INGEST_PHASE_HASH,
+  FILE_INGEST_PHASE_COPY,
+} FileIngestPhase;
+
+const char* file_ingest_method_name(FileIngestMethod method);
+const char* file_ingest_phase_name(FileIngestPhase phase);
+
+struct FileIngestRequest {
+  std::string source;
+  // 目标目录（绝对路径）
+  std::string directory;
+  std::string prefix;
+  std::string extension;
+};
+
+struct FileIngestResult {
+  // 目标文件名与源文件内容的 SHA-256
+  std::string name;
+  std::string hash;
+  uint64_t bytes = 0;
+  // 相同内容已存在，未复制
+  bool existed = false;
+  FileIngestMethod method = FILE_INGEST_BUFFERED;
+  bool cancelled = false;
+  std::string error;
+};
+
+// 进度回调在工作线程调用：已处理字节数 / 总字节数
+using FileIngestProgressCallback =
+    std::function<void(FileIngestPhase phase, uint64_t done, uint64_t total)>;
+
+// 阻塞执行导入（须在工作线程调用）
+bool file_ingest(const FileIngestRequest& request,
+                 const std::atomic<bool>& cancelled,
+                 const FileIngestProgressCallback& progress,
+                 FileIngestResult* result);
+
+#endif  // CLIP_FLOW_FILE_INGEST_H_
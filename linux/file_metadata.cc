@@ -0,0 +1,473 @@
+#include "file_metadata.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "content_hash.h"
+
+namespace {
+
+// I/O 密集，线程数可以多于核心数
+constexpr unsigned kMinThreads = 4;
+constexpr unsigned kMaxThreads = 16;
+// 路径较少时不值得启动线程
+constexpr size_t kParallelMinPaths = 8;
+// 分块未满时最多等待该时长即送出已完成的前缀
+constexpr auto kChunkFlushInterval = std::chrono::milliseconds(50);
+// 嗅探文件头读取的字节数
+constexpr size_t kSniffBytes = 64;
+constexpr size_t kHashBufferBytes = 1 << 20;
+
+struct ExtensionMime {
+  const char* extension;
+  const char* mime;
+};
+
+const ExtensionMime kExtensionMimes[] = {
+    {"png", "image/png"},
+    {"jpg", "image/jpeg"},
+    {"jpeg", "image/jpeg"},
+    {"gif", "image/gif"},
+    {"webp", "image/webp"},
+    {"bmp", "image/bmp"},
+    {"tif", "image/tiff"},
+    {"tiff", "image/tiff"},
+    {"svg", "image/svg+xml"},
+    {"ico", "image/vnd.microsoft.icon"},
+    {"heic", "image/heic"},
+    {"heif", "image/heif"},
+    {"mp3", "audio/mpeg"},
+    {"wav", "audio/wav"},
+    {"aac", "audio/aac"},
+    {"flac", "audio/flac"},
+    {"ogg", "audio/ogg"},
+    {"m4a", "audio/mp4"},
+    {"wma", "audio/x-ms-wma"},
+    {"aiff", "audio/aiff"},
+    {"au", "audio/basic"},
+    {"mp4", "video/mp4"},
+    {"m4v", "video/mp4"},
+    {"avi", "video/x-msvideo"},
+    {"mov", "video/quicktime"},
+    {"wmv", "video/x-ms-wmv"},
+    {"flv", "video/x-flv"},
+    {"webm", "video/webm"},
+    {"mkv", "video/x-matroska"},
+    {"3gp", "video/3gpp"},
+    {"ts", "video/mp2t"},
+    {"pdf", "application/pdf"},
+    {"doc", "application/msword"},
+    {"docx",
+     "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
+    {"xls", "application/vnd.ms-excel"},
+    {"xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
+    {"ppt", "application/vnd.ms-powerpoint"},
+    {"pptx",
+     "application/vnd.openxmlformats-officedocument.presentationml.presentation"},
+    {"odt", "application/vnd.oasis.opendocument.text"},
+    {"ods", "application/vnd.oasis.opendocument.spreadsheet"},
+    {"odp", "application/vnd.oasis.opendocument.presentation"},
+    {"epub", "application/epub+zip"},
+    {"txt", "text/plain"},
+    {"md", "text/markdown"},
+    {"csv", "text/csv"},
+    {"rtf", "application/rtf"},
+    {"html", "text/html"},
+    {"htm", "text/html"},
+    {"json", "application/json"},
+    {"xml", "application/xml"},
+    {"zip", "application/zip"},
+    {"jar", "application/java-archive"},
+    {"apk", "application/vnd.android.package-archive"},
+    {"rar", "application/vnd.rar"},
+    {"7z", "application/x-7z-compressed"},
+    {"tar", "application/x-tar"},
+    {"gz", "application/gzip"},
+    {"bz2", "application/x-bzip2"},
+    {"xz", "application/x-xz"},
+    {"c", "text/x-c"},
+    {"h", "text/x-c"},
+    {"cpp", "text/x-c++"},
+    {"cs", "text/x-csharp"},
+    {"js", "text/javascript"},
+    {"py", "text/x-python"},
+    {"java", "text/x-java"},
+    {"go", "text/x-go"},
+    {"rs", "text/x-rust"},
+    {"php", "application/x-php"},
+    {"rb", "text/x-ruby"},
+    {"kt", "text/x-kotlin"},
+    {"dart", "text/x-dart"},
+};
+
+struct Magic {
+  size_t offset;
+  const char* bytes;
+  size_t length;
+  const char* mime;
+};
+
+const Magic kMagics[] = {
+    {0, "\x89PNG\r\n\x1a\n", 8, "image/png"},
+    {0, "\xff\xd8\xff", 3, "image/jpeg"},
+    {0, "GIF87a", 6, "image/gif"},
+    {0, "GIF89a", 6, "image/gif"},
+    {8, "WEBP", 4, "image/webp"},
+    {0, "BM", 2, "image/bmp"},
+    {0, "II*\0", 4, "image/tiff"},
+    {0, "MM\0*", 4, "image/tiff"},
+    {0, "\0\0\1\0", 4, "image/vnd.microsoft.icon"},
+    {4, "ftypheic", 8, "image/heic"},
+    {4, "ftypmif1", 8, "image/heif"},
+    {4, "ftypqt", 6, "video/quicktime"},
+    {4, "ftypM4A", 7, "audio/mp4"},
+    {4, "ftyp3gp", 7, "video/3gpp"},
+    {4, "ftyp", 4, "video/mp4"},
+    {8, "WAVE", 4, "audio/wav"},
+    {8, "AVI ", 4, "video/x-msvideo"},
+    {0, "ID3", 3, "audio/mpeg"},
+    {0, "fLaC", 4, "audio/flac"},
+    {0, "OggS", 4, "audio/ogg"},
+    {0, "FORM", 4, "audio/aiff"},
+    {0, "\x1a\x45\xdf\xa3", 4, "video/x-matroska"},
+    {0, "FLV", 3, "video/x-flv"},
+    {0, "%PDF-", 5, "application/pdf"},
+    {0, "{\\rtf", 5, "application/rtf"},
+    {0, "\xd0\xcf\x11\xe0\xa1\xb1\x1a\xe1", 8, "application/x-ole-storage"},
+    {0, "PK\x03\x04", 4, "application/zip"},
+    {0, "PK\x05\x06", 4, "application/zip"},
+    {0, "Rar!\x1a\x07", 6, "application/vnd.rar"},
+    {0, "7z\xbc\xaf\x27\x1c", 6, "application/x-7z-compressed"},
+    {0, "\x1f\x8b", 2, "application/gzip"},
+    {0, "BZh", 3, "application/x-bzip2"},
+    {0, "\xfd" "7zXZ\0", 6, "application/x-xz"},
+    {257, "ustar", 5, "application/x-tar"},
+    {0, "\x7f" "ELF", 4, "application/x-executable"},
+    {0, "SQLite format 3\0", 16, "application/vnd.sqlite3"},
+};
+
+std::string lower_extension(const std::string& path) {
+  size_t slash = path.find_last_of('/');
+  size_t dot = path.find_last_of('.');
+  if (dot == std::string::npos ||
+      (slash != std::string::npos && dot < slash)) {
+    return std::string();
+  }
+  std::string extension = path.substr(dot + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return g_ascii_tolower(c); });
+  return extension;
+}
+
+const char* mime_for_extension(const std::string& extension) {
+  for (const ExtensionMime& entry : kExtensionMimes) {
+    if (extension == entry.extension) {
+      return entry.mime;
+    }
+  }
+  return nullptr;
+}
+
+const char* mime_for_magic(const uint8_t* head, size_t length) {
+  for (const Magic& magic : kMagics) {
+    if (magic.offset + magic.length <= length &&
+        memcmp(head + magic.offset, magic.bytes, magic.length) == 0) {
+      return magic.mime;
+    }
+  }
+  return nullptr;
+}
+
+// 识别不出魔数时，无 NUL 且为合法 UTF-8 的文件头视为文本
+bool looks_like_text(const uint8_t* head, size_t length) {
+  if (length == 0 || memchr(head, '\0', length) != nullptr) {
+    return false;
+  }
+  const gchar* end = nullptr;
+  if (g_utf8_validate(reinterpret_cast<const gchar*>(head), length, &end)) {
+    return true;
+  }
+  // 文件头可能截断在多字节字符中间
+  return reinterpret_cast<const uint8_t*>(end) + 4 > head + length;
+}
+
+// 魔数优先（扩展名可能被改错）；容器格式（ZIP / OLE / RIFF）
+// 交给扩展名细分，如 docx、xlsx、jar 的文件头都是 ZIP
+std::string resolve_mime(const std::string& path, const uint8_t* head,
+                         size_t head_length) {
+  const char* by_extension = mime_for_extension(lower_extension(path));
+  const char* by_magic = mime_for_magic(head, head_length);
+  if (by_magic != nullptr) {
+    bool container = strcmp(by_magic, "application/zip") == 0 ||
+                     strcmp(by_magic, "application/x-ole-storage") == 0;
+    if (container && by_extension != nullptr) {
+      return by_extension;
+    }
+    if (strcmp(by_magic, "application/x-ole-storage") == 0) {
+      return "application/octet-stream";
+    }
+    return by_magic;
+  }
+  if (by_extension != nullptr) {
+    return by_extension;
+  }
+  return looks_like_text(head, head_length) ? "text/plain"
+                                            : "application/octet-stream";
+}
+
+const char* type_for_mime(const std::string& mime, const std::string& path) {
+  if (mime.compare(0, 6, "image/") == 0) {
+    return "image";
+  }
+  if (mime.compare(0, 6, "audio/") == 0) {
+    return "audio";
+  }
+  if (mime.compare(0, 6, "video/") == 0) {
+    return "video";
+  }
+  return file_metadata_type_for_path(path);
+}
+
+std::string hex_u64(uint64_t value) {
+  gchar buffer[17];
+  g_snprintf(buffer, sizeof(buffer), "%016" G_GINT64_MODIFIER "x",
+             static_cast<guint64>(value));
+  return buffer;
+}
+
+bool hash_xxh64(int fd, uint64_t size, std::string* hash) {
+  if (size == 0) {
+    *hash = hex_u64(content_hash_xxh64(nullptr, 0));
+    return true;
+  }
+  void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+  madvise(mapped, size, MADV_SEQUENTIAL);
+  *hash = hex_u64(content_hash_xxh64(mapped, size));
+  munmap(mapped, size);
+  return true;
+}
+
+bool hash_sha256(int fd, std::string* hash) {
+  g_autoptr(GChecksum) checksum = g_checksum_new(G_CHECKSUM_SHA256);
+  std::vector<guchar> buffer(kHashBufferBytes);
+  off_t offset = 0;
+  while (true) {
+    ssize_t got = pread(fd, buffer.data(), buffer.size(), offset);
+    if (got < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (got == 0) {
+      break;
+    }
+    g_checksum_update(checksum, buffer.data(), got);
+    offset += got;
+  }
+  *hash = g_checksum_get_string(checksum);
+  return true;
+}
+
+}  // namespace
+
+const char* file_metadata_type_for_path(const std::string& path) {
+  static const char* const kImage[] = {"png", "jpg",  "jpeg", "gif",
+                                       "webp", "bmp", "tiff", "tif",
+                                       "svg", "ico",  "heic", "heif"};
+  static const char* const kAudio[] = {"mp3", "wav", "aac", "flac", "ogg",
+                                       "m4a", "wma", "aiff", "au"};
+  static const char* const kVideo[] = {"mp4", "avi", "mov", "wmv", "flv",
+                                       "webm", "mkv", "m4v", "3gp", "ts"};
+  static const char* const kDocument[] = {"pdf", "doc",  "docx", "xls", "xlsx",
+                                          "ppt", "pptx", "txt",  "rtf"};
+  static const char* const kArchive[] = {"zip", "rar", "7z", "tar",
+                                         "gz",  "bz2", "xz"};
+  static const char* const kCode[] = {"cpp", "c",  "h",  "cs",  "js",
+                                      "ts",  "py", "java", "go", "rs",
+                                      "php", "rb", "kt", "dart"};
+  struct Category {
+    const char* type;
+    const char* const* extensions;
+    size_t count;
+  };
+  static const Category kCategories[] = {
+      {"image", kImage, G_N_ELEMENTS(kImage)},
+      {"audio", kAudio, G_N_ELEMENTS(kAudio)},
+      {"video", kVideo, G_N_ELEMENTS(kVideo)},
+      {"document", kDocument, G_N_ELEMENTS(kDocument)},
+      {"archive", kArchive, G_N_ELEMENTS(kArchive)},
+      {"code", kCode, G_N_ELEMENTS(kCode)},
+  };
+
+  std::string extension = lower_extension(path);
+  if (extension.empty()) {
+    return "file";
+  }
+  for (const Category& category : kCategories) {
+    for (size_t i = 0; i < category.count; i++) {
+      if (extension == category.extensions[i]) {
+        return category.type;
+      }
+    }
+  }
+  return "file";
+}
+
+void file_metadata_gather_one(const std::string& path, FileMetadataHash hash,
+                              FileMetadata* metadata) {
+  metadata->path = path;
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    metadata->type = file_metadata_type_for_path(path);
+    return;
+  }
+  metadata->exists = true;
+  metadata->modified_ms = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000 +
+                          st.st_mtim.tv_nsec / 1000000;
+  if (S_ISDIR(st.st_mode)) {
+    metadata->is_directory = true;
+    metadata->mime = "inode/directory";
+    return;
+  }
+  metadata->size = static_cast<uint64_t>(st.st_size);
+  if (!S_ISREG(st.st_mode)) {
+    metadata->mime = "application/octet-stream";
+    return;
+  }
+
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  uint8_t head[kSniffBytes];
+  ssize_t head_length = 0;
+  if (fd >= 0) {
+    do {
+      head_length = pread(fd, head, sizeof(head), 0);
+    } while (head_length < 0 && errno == EINTR);
+  }
+  if (head_length < 0) {
+    head_length = 0;
+  }
+  metadata->mime = resolve_mime(path, head, head_length);
+  metadata->type = type_for_mime(metadata->mime, path);
+
+  if (fd >= 0) {
+    if (hash == FILE_METADATA_HASH_XXH64) {
+      hash_xxh64(fd, metadata->size, &metadata->hash);
+    } else if (hash == FILE_METADATA_HASH_SHA256) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+      hash_sha256(fd, &metadata->hash);
+    }
+    close(fd);
+  }
+}
+
+bool file_metadata_gather(const std::vector<std::string>& paths,
+                          FileMetadataHash hash, size_t chunk_size,
+                          const std::atomic<bool>& cancelled,
+                          const FileMetadataChunkCallback& on_chunk) {
+  const size_t count = paths.size();
+  chunk_size = std::max<size_t>(1, chunk_size);
+
+  if (count < kParallelMinPaths) {
+    for (size_t offset = 0; offset < count; offset += chunk_size) {
+      if (cancelled.load()) {
+        return false;
+      }
+      size_t end = std::min(count, offset + chunk_size);
+      std::vector<FileMetadata> chunk(end - offset);
+      for (size_t i = offset; i < end; i++) {
+        file_metadata_gather_one(paths[i], hash, &chunk[i - offset]);
+      }
+      on_chunk(offset, std::move(chunk));
+    }
+    return !cancelled.load();
+  }
+
+  std::vector<FileMetadata> results(count);
+  // ready 与 active 由 mutex 保护；results[i] 在 ready[i] 置位后只由调用线程访问
+  std::vector<bool> ready(count, false);
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::atomic<size_t> next{0};
+
+  unsigned threads = std::max(kMinThreads, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned>(
+      std::min<size_t>(std::min(threads, kMaxThreads), count));
+  unsigned active = threads;
+
+  auto worker = [&]() {
+    while (!cancelled.load()) {
+      size_t index = next.fetch_add(1);
+      if (index >= count) {
+        break;
+      }
+      file_metadata_gather_one(paths[index], hash, &results[index]);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready[index] = true;
+      }
+      cv.notify_one();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    active--;
+    cv.notify_one();
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (unsigned i = 0; i < threads; i++) {
+    workers.emplace_back(worker);
+  }
+
+  // 调用线程按顺序送出已完成的前缀：凑满一块，或等待超时时有多少送多少
+  size_t emitted = 0;
+  size_t completed = 0;
+  while (emitted < count && !cancelled.load()) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      auto deadline = std::chrono::steady_clock::now() + kChunkFlushInterval;
+      bool timed_out = false;
+      while (true) {
+        while (completed < count && ready[completed]) {
+          completed++;
+        }
+        if (completed - emitted >= chunk_size || completed == count ||
+            active == 0 || (timed_out && completed > emitted)) {
+          break;
+        }
+        if (cv.wait_until(lock, deadline) == std::cv_status::timeout) {
+          timed_out = true;
+          deadline = std::chrono::steady_clock::now() + kChunkFlushInterval;
+        }
+      }
+    }
+    if (completed == emitted) {
+      break;
+    }
+    size_t end = std::min(completed, emitted + chunk_size);
+    std::vector<FileMetadata> chunk(
+        std::make_move_iterator(results.begin() + emitted),
+        std::make_move_iterator(results.begin() + end));
+    on_chunk(emitted, std::move(chunk));
+    emitted = end;
+  }
+
+  for (std::thread& thread : workers) {
+    thread.join();
+  }
+  return emitted == count;
+}
@@ -0,0 +1,57 @@
+#ifndef CLIP_FLOW_FILE_METADATA_H_
+#define CLIP_FLOW_FILE_METADATA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 批量采集文件元数据：stat 信息、MIME 类型（扩展名 + 文件头魔数）、
+// 可选的内容哈希。
+//
+// 在文件管理器中复制整个目录时剪贴板里可能有上千个路径，逐个串行 stat
+// 会被慢速磁盘或网络文件系统拖住；这里由线程池并行处理，
+// 按原始顺序分块交给调用方，先完成的前缀可以立即送出。
+
+typedef enum {
+  FILE_METADATA_HASH_NONE,
+  FILE_METADATA_HASH_XXH64,
+  FILE_METADATA_HASH_SHA256,
+} FileMetadataHash;
+
+struct FileMetadata {
+  std::string path;
+  bool exists = false;
+  bool is_directory = false;
+  uint64_t size = 0;
+  // 修改时间（Unix 毫秒）
+  int64_t modified_ms = 0;
+  std::string mime;
+  // 与 Dart 侧 ClipType 对应的粗分类：image / audio / video / document /
+  // archive / code / file
+  const char* type = "file";
+  // 十六进制内容哈希；未请求或无法读取时为空
+  std::string hash;
+};
+
+// 按扩展名粗分类
+const char* file_metadata_type_for_path(const std::string& path);
+
+// 采集单个文件（阻塞，须在工作线程调用）
+void file_metadata_gather_one(const std::string& path, FileMetadataHash hash,
+                              FileMetadata* metadata);
+
+// 分块回调在调用线程按顺序执行：offset 为本块首项在 paths 中的下标
+using FileMetadataChunkCallback =
+    std::function<void(size_t offset, std::vector<FileMetadata> chunk)>;
+
+// 并行采集全部路径，按 chunk_size 分块有序回调（阻塞，须在工作线程调用）。
+// cancelled 置位后尚未开始的路径不再处理，也不再回调；返回是否完整处理
+bool file_metadata_gather(const std::vector<std::string>& paths,
+                          FileMetadataHash hash, size_t chunk_size,
+                          const std::atomic<bool>& cancelled,
+                          const FileMetadataChunkCallback& on_chunk);
+
+#endif  // CLIP_FLOW_FILE_METADATA_H_
@@ -0,0 +1,127 @@
+#include "image_hash_index.h"
+
+#include <utility>
+
+#include "perceptual_hash.h"
+
+namespace {
+
+// 标记删除的节点少于该数量时不重建
+constexpr size_t kMinRebuildDeleted = 64;
+
+}  // namespace
+
+void ImageHashIndex::insert(const std::string& id, uint64_t hash) {
+  auto it = ids_.find(id);
+  if (it != ids_.end()) {
+    if (nodes_[it->second].hash == hash) {
+      return;
+    }
+    remove(id);
+  }
+  add_node(id, hash);
+}
+
+void ImageHashIndex::add_node(const std::string& id, uint64_t hash) {
+  uint32_t index = static_cast<uint32_t>(nodes_.size());
+  nodes_.push_back(Node{hash, id, false, {}});
+  ids_[id] = index;
+  if (index == 0) {
+    return;
+  }
+
+  uint32_t current = 0;
+  for (;;) {
+    uint8_t distance = static_cast<uint8_t>(
+        perceptual_hash_distance(nodes_[current].hash, hash));
+    uint32_t next = UINT32_MAX;
+    for (const auto& child : nodes_[current].children) {
+      if (child.first == distance) {
+        next = child.second;
+        break;
+      }
+    }
+    if (next == UINT32_MAX) {
+      nodes_[current].children.emplace_back(distance, index);
+      return;
+    }
+    current = next;
+  }
+}
+
+bool ImageHashIndex::remove(const std::string& id) {
+  auto it = ids_.find(id);
+  if (it == ids_.end()) {
+    return false;
+  }
+  nodes_[it->second].deleted = true;
+  ids_.erase(it);
+  deleted_++;
+  if (deleted_ >= kMinRebuildDeleted && deleted_ > ids_.size()) {
+    rebuild();
+  }
+  return true;
+}
+
+void ImageHashIndex::clear() {
+  nodes_.clear();
+  ids_.clear();
+  deleted_ = 0;
+}
+
+void ImageHashIndex::rebuild() {
+  std::vector<Node> old = std::move(nodes_);
+  clear();
+  nodes_.reserve(old.size() - deleted_);
+  for (Node& node : old) {
+    if (!node.deleted) {
+      add_node(node.id, node.hash);
+    }
+  }
+}
+
+bool ImageHashIndex::nearest(uint64_t hash, int max_distance,
+                             const std::string& exclude_id, std::string* id,
+                             int* distance) const {
+  if (nodes_.empty() || max_distance < 0) {
+    return false;
+  }
+
+  int best = -1;
+  uint32_t best_index = 0;
+  int radius = max_distance;
+  std::vector<uint32_t> stack = {0};
+  while (!stack.empty()) {
+    const Node& node = nodes_[stack.back()];
+    uint32_t index = stack.back();
+    stack.pop_back();
+
+    int d = perceptual_hash_distance(node.hash, hash);
+    if (!node.deleted && d <= radius && (best < 0 || d < best) &&
+        (exclude_id.empty() || node.id != exclude_id)) {
+      best = d;
+      best_index = index;
+      if (d == 0) {
+        break;
+      }
+      // 之后只需寻找更近的结果
+      radius = d - 1;
+    }
+    for (const auto& child : node.children) {
+      if (child.first >= d - radius && child.first <= d + radius) {
+        stack.push_back(child.second);
+      }
+    }
+  }
+
+  if (best < 0) {
+    return false;
+  }
+  if (id != nullptr) {
+    *id = nodes_[best_index].id;
+  }
+  if (distance != nullptr) {
+    *distance = best;
+  }
+  return true;
+}
@@ -0,0 +1,46 @@
+#ifndef CLIP_FLOW_IMAGE_HASH_INDEX_H_
+#define CLIP_FLOW_IMAGE_HASH_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 图像感知哈希的近邻索引（BK 树，汉明距离）。
+//
+// 查询半径为 r 时，只需访问与当前节点距离落在 [d - r, d + r] 的子树；
+// 最近邻查询以当前最优距离不断收缩半径。删除只做标记，
+// 已删除节点超过存活节点时整体重建。
+class ImageHashIndex {
+ public:
+  // 添加或替换某个剪贴项的哈希
+  void insert(const std::string& id, uint64_t hash);
+  // 删除剪贴项；返回是否存在
+  bool remove(const std::string& id);
+  void clear();
+
+  // 查找距离不超过 max_distance 的最近图像；exclude_id 非空时跳过该项
+  bool nearest(uint64_t hash, int max_distance, const std::string& exclude_id,
+               std::string* id, int* distance) const;
+
+  size_t size() const { return ids_.size(); }
+
+ private:
+  struct Node {
+    uint64_t hash;
+    std::string id;
+    bool deleted;
+    // (距离, 子节点下标)，距离各不相同
+    std::vector<std::pair<uint8_t, uint32_t>> children;
+  };
+
+  void add_node(const std::string& id, uint64_t hash);
+  void rebuild();
+
+  std::vector<Node> nodes_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  size_t deleted_ = 0;
+};
+
+#endif  // CLIP_FLOW_IMAGE_HASH_INDEX_H_
@@ -0,0 +1,193 @@
+#include "image_scale.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// 水平权重之和为 2^14，水平结果保留 8 位小数（最大 255 << 8，可放入 uint16）
+constexpr int kHorizontalBits = 14;
+constexpr int kHorizontalShift = kHorizontalBits - 8;
+// 垂直权重之和为 2^15，乘积累加最大约 2^31，可放入 uint32
+constexpr int kVerticalBits = 15;
+constexpr int kVerticalShift = kVerticalBits + 8;
+
+// 一个目标像素（行或列）覆盖的源区间及其权重
+struct Contribution {
+  uint32_t start;
+  uint32_t count;
+  size_t weight_offset;
+};
+
+void compute_contributions(uint32_t src_size, uint32_t dst_size, int bits,
+                           std::vector<Contribution>* contributions,
+                           std::vector<uint16_t>* weights) {
+  const double scale = static_cast<double>(src_size) / dst_size;
+  const uint32_t total = 1u << bits;
+  contributions->resize(dst_size);
+  weights->clear();
+
+  for (uint32_t i = 0; i < dst_size; i++) {
+    double begin = i * scale;
+    double end = std::min<double>(src_size, (i + 1) * scale);
+    uint32_t first = static_cast<uint32_t>(begin);
+    uint32_t last = std::min(
+        src_size, static_cast<uint32_t>(std::ceil(end - 1e-9)));
+    if (last <= first) {
+      last = first + 1;
+    }
+
+    Contribution& c = (*contributions)[i];
+    c.start = first;
+    c.count = last - first;
+    c.weight_offset = weights->size();
+
+    // 按覆盖面积分配权重，舍入误差补到覆盖最多的源像素上，保证权重和精确
+    uint32_t assigned = 0;
+    size_t heaviest = c.weight_offset;
+    for (uint32_t s = first; s < last; s++) {
+      double overlap = std::min<double>(s + 1, end) - std::max<double>(s, begin);
+      uint32_t w = static_cast<uint32_t>(std::lround(overlap / scale * total));
+      weights->push_back(static_cast<uint16_t>(std::min(w, total)));
+      assigned += weights->back();
+      if (weights->back() > (*weights)[heaviest]) {
+        heaviest = weights->size() - 1;
+      }
+    }
+    int32_t correction = static_cast<int32_t>(total) - static_cast<int32_t>(assigned);
+    (*weights)[heaviest] = static_cast<uint16_t>(
+        std::max<int32_t>(0, (*weights)[heaviest] + correction));
+  }
+}
+
+// 水平缩小一行：输出为带 8 位小数的 uint16
+void downscale_row(const uint8_t* src, int channels,
+                   const std::vector<Contribution>& contributions,
+                   const std::vector<uint16_t>& weights, uint16_t* out) {
+  const uint32_t round = 1u << (kHorizontalShift - 1);
+  for (size_t x = 0; x < contributions.size(); x++) {
+    const Contribution& c = contributions[x];
+    const uint16_t* w = weights.data() + c.weight_offset;
+    const uint8_t* p = src + static_cast<size_t>(c.start) * channels;
+
+#if defined(__SSE2__)
+    if (channels == 4) {
+      const __m128i zero = _mm_setzero_si128();
+      __m128i acc = _mm_setzero_si128();
+      for (uint32_t i = 0; i < c.count; i++) {
+        uint32_t pixel;
+        std::memcpy(&pixel, p + i * 4, sizeof(pixel));
+        __m128i px = _mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), zero);
+        __m128i wv = _mm_set1_epi16(static_cast<short>(w[i]));
+        __m128i lo = _mm_mullo_epi16(px, wv);
+        __m128i hi = _mm_mulhi_epu16(px, wv);
+        acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(lo, hi));
+      }
+      acc = _mm_srli_epi32(_mm_add_epi32(acc, _mm_set1_epi32(round)),
+                           kHorizontalShift);
+      uint32_t lanes[4];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+      for (int ch = 0; ch < 4; ch++) {
+        out[x * 4 + ch] = static_cast<uint16_t>(lanes[ch]);
+      }
+      continue;
+    }
+#endif
+
+    for (int ch = 0; ch < channels; ch++) {
+      uint32_t acc = 0;
+      for (uint32_t i = 0; i < c.count; i++) {
+        acc += static_cast<uint32_t>(w[i]) * p[i * channels + ch];
+      }
+      out[x * channels + ch] =
+          static_cast<uint16_t>((acc + round) >> kHorizontalShift);
+    }
+  }
+}
+
+// acc[i] += row[i] * weight
+void accumulate_row(const uint16_t* row, uint16_t weight, size_t length,
+                    uint32_t* acc) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i wv = _mm_set1_epi16(static_cast<short>(weight));
+  for (; i + 8 <= length; i += 8) {
+    __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+    __m128i lo = _mm_mullo_epi16(values, wv);
+    __m128i hi = _mm_mulhi_epu16(values, wv);
+    __m128i* a = reinterpret_cast<__m128i*>(acc + i);
+    _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a),
+                                      _mm_unpacklo_epi16(lo, hi)));
+    _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1),
+                                          _mm_unpackhi_epi16(lo, hi)));
+  }
+#endif
+  for (; i < length; i++) {
+    acc[i] += static_cast<uint32_t>(row[i]) * weight;
+  }
+}
+
+}  // namespace
+
+void image_fit_size(uint32_t width, uint32_t height, uint32_t max_side,
+                    uint32_t* out_width, uint32_t* out_height) {
+  if (width <= max_side && height <= max_side) {
+    *out_width = width;
+    *out_height = height;
+    return;
+  }
+  double scale = static_cast<double>(max_side) / std::max(width, height);
+  *out_width = std::max(1u, static_cast<uint32_t>(std::lround(width * scale)));
+  *out_height =
+      std::max(1u, static_cast<uint32_t>(std::lround(height * scale)));
+}
+
+bool image_downscale_area(const uint8_t* src, uint32_t src_width,
+                          uint32_t src_height, size_t src_stride, int channels,
+                          uint8_t* dst, uint32_t dst_width,
+                          uint32_t dst_height, size_t dst_stride) {
+  if (src == nullptr || dst == nullptr || (channels != 1 && channels != 3 && channels != 4) ||
+      dst_width == 0 || dst_height == 0 || dst_width > src_width ||
+      dst_height > src_height) {
+    return false;
+  }
+
+  std::vector<Contribution> columns;
+  std::vector<uint16_t> column_weights;
+  compute_contributions(src_width, dst_width, kHorizontalBits, &columns,
+                        &column_weights);
+  std::vector<Contribution> rows;
+  std::vector<uint16_t> row_weights;
+  compute_contributions(src_height, dst_height, kVerticalBits, &rows,
+                        &row_weights);
+
+  const size_t line = static_cast<size_t>(dst_width) * channels;
+  // 逐目标行处理，只保留一行水平结果与一行累加器；
+  // 相邻目标行共享的边界源行会被水平缩小两次
+  std::vector<uint16_t> reduced(line);
+  std::vector<uint32_t> acc(line);
+  const uint32_t round = 1u << (kVerticalShift - 1);
+
+  for (uint32_t y = 0; y < dst_height; y++) {
+    const Contribution& c = rows[y];
+    std::fill(acc.begin(), acc.end(), 0);
+    for (uint32_t i = 0; i < c.count; i++) {
+      downscale_row(src + static_cast<size_t>(c.start + i) * src_stride,
+                    channels, columns, column_weights, reduced.data());
+      accumulate_row(reduced.data(), row_weights[c.weight_offset + i], line,
+                     acc.data());
+    }
+    uint8_t* out = dst + static_cast<size_t>(y) * dst_stride;
+    for (size_t i = 0; i < line; i++) {
+      out[i] = static_cast<uint8_t>(
+          std::min<uint32_t>(255, (acc[i] + round) >> kVerticalShift));
+    }
+  }
+  return true;
+}
@@ -0,0 +1,23 @@
+#ifndef CLIP_FLOW_IMAGE_SCALE_H_
+#define CLIP_FLOW_IMAGE_SCALE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// 面积平均（box）缩小，用于生成缩略图。
+// 先水平后垂直两趟定点运算，每个目标像素为其覆盖的源像素区域按面积加权的均值；
+// x86 上的累加部分使用 SSE2，其他平台为等价的标量实现。
+
+// 计算在 max_side 范围内保持宽高比的目标尺寸；源图不大于该范围时保持原尺寸
+void image_fit_size(uint32_t width, uint32_t height, uint32_t max_side,
+                    uint32_t* out_width, uint32_t* out_height);
+
+// 将 8 位灰度（channels = 1）、RGB（channels = 3）或 RGBA（channels = 4）
+// 图像缩小到目标尺寸。
+// 目标尺寸不得大于源尺寸。
+bool image_downscale_area(const uint8_t* src, uint32_t src_width,
+                          uint32_t src_height, size_t src_stride, int channels,
+                          uint8_t* dst, uint32_t dst_width,
+                          uint32_t dst_height, size_t dst_stride);
+
+#endif  // CLIP_FLOW_IMAGE_SCALE_H_
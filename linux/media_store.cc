@@ -0,0 +1,249 @@
+#include "media_store.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace {
+
+// 同一批待落盘文件达到该数量时改为对文件系统 syncfs 一次
+constexpr size_t kSyncfsMinBatch = 4;
+
+// 已写完、等待落盘并链接到目标路径的文件
+struct PendingLink {
+  int fd;
+  // 退回临时文件时的路径；使用 O_TMPFILE 时为空
+  std::string temp_path;
+  std::string directory;
+  std::string path;
+  bool done = false;
+  int error = 0;
+};
+
+std::mutex commit_mutex;
+std::condition_variable commit_cv;
+std::vector<PendingLink*> commit_queue;
+bool committing = false;
+
+std::string errno_message(const char* what, int error) {
+  return std::string(what) + ": " + g_strerror(error);
+}
+
+bool write_all(int fd, const void* data, size_t length) {
+  const char* cursor = static_cast<const char*>(data);
+  while (length > 0) {
+    ssize_t written = write(fd, cursor, length);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    cursor += written;
+    length -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+// 打开目录下的匿名文件；文件系统不支持 O_TMPFILE 或需要覆盖已有文件
+// （linkat 不能替换目标）时创建 .tmp 临时文件
+int open_temp_file(const std::string& directory, const std::string& path,
+                   bool replace, std::string* temp_path) {
+#ifdef O_TMPFILE
+  if (!replace) {
+    int fd = open(directory.c_str(), O_TMPFILE | O_WRONLY | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+      temp_path->clear();
+      return fd;
+    }
+    if (errno != EOPNOTSUPP && errno != EISDIR && errno != EINVAL) {
+      return -1;
+    }
+  }
+#endif
+  // 孤儿文件清理会跳过 .tmp 后缀
+  std::string pattern = path + ".XXXXXX.tmp";
+  int fd_fallback = g_mkstemp_full(&pattern[0], O_WRONLY | O_CLOEXEC, 0644);
+  if (fd_fallback >= 0) {
+    *temp_path = pattern;
+  }
+  return fd_fallback;
+}
+
+bool sync_files(const std::vector<PendingLink*>& batch) {
+  if (batch.size() < kSyncfsMinBatch) {
+    for (PendingLink* link : batch) {
+      if (fdatasync(link->fd) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // 每个文件系统 syncfs 一次
+  std::set<dev_t> devices;
+  for (PendingLink* link : batch) {
+    struct stat st;
+    if (fstat(link->fd, &st) != 0) {
+      return false;
+    }
+    if (devices.insert(st.st_dev).second && syncfs(link->fd) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void link_file(PendingLink* link) {
+  if (link->temp_path.empty()) {
+    gchar proc_path[64];
+    g_snprintf(proc_path, sizeof(proc_path), "/proc/self/fd/%d", link->fd);
+    // 相同路径即相同内容：并发写入同一内容时后到者直接复用
+    if (linkat(AT_FDCWD, proc_path, AT_FDCWD, link->path.c_str(),
+               AT_SYMLINK_FOLLOW) != 0 &&
+        errno != EEXIST) {
+      link->error = errno;
+    }
+  } else if (rename(link->temp_path.c_str(), link->path.c_str()) != 0) {
+    link->error = errno;
+  }
+}
+
+void sync_directories(const std::vector<PendingLink*>& batch) {
+  std::set<std::string> directories;
+  for (PendingLink* link : batch) {
+    if (link->error == 0) {
+      directories.insert(link->directory);
+    }
+  }
+  for (const std::string& directory : directories) {
+    int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+      fsync(fd);
+      close(fd);
+    }
+  }
+}
+
+// 先让整批文件内容落盘，再链接到目标路径，最后同步所在目录
+void commit_batch(const std::vector<PendingLink*>& batch) {
+  if (!sync_files(batch)) {
+    int error = errno;
+    for (PendingLink* link : batch) {
+      link->error = error;
+    }
+    return;
+  }
+  for (PendingLink* link : batch) {
+    link_file(link);
+  }
+  sync_directories(batch);
+}
+
+// 加入组提交队列并等待本文件完成；没有进行中的提交时由当前线程执行
+void commit_and_wait(PendingLink* link) {
+  std::unique_lock<std::mutex> lock(commit_mutex);
+  commit_queue.push_back(link);
+  while (!link->done) {
+    if (committing) {
+      commit_cv.wait(lock);
+      continue;
+    }
+    committing = true;
+    std::vector<PendingLink*> batch;
+    batch.swap(commit_queue);
+    lock.unlock();
+    commit_batch(batch);
+    lock.lock();
+    for (PendingLink* pending : batch) {
+      pending->done = true;
+    }
+    committing = false;
+    commit_cv.notify_all();
+  }
+}
+
+}  // namespace
+
+bool media_store_exists(const std::string& directory, const std::string& name,
+                        size_t size) {
+  struct stat st;
+  std::string path = directory + "/" + name;
+  return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode) &&
+         static_cast<size_t>(st.st_size) == size;
+}
+
+bool media_store_begin(const std::string& directory, const std::string& name,
+                       MediaStorePending* pending, std::string* error) {
+  if (g_mkdir_with_parents(directory.c_str(), 0755) != 0) {
+    *error = errno_message("mkdir", errno);
+    return false;
+  }
+
+  // 同名文件（如早先未写完的文件）需要覆盖
+  std::string path = directory + "/" + name;
+  struct stat st;
+  bool replace = stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+  pending->fd = open_temp_file(directory, path, replace, &pending->temp_path);
+  if (pending->fd < 0) {
+    *error = errno_message("open", errno);
+    return false;
+  }
+  pending->directory = directory;
+  pending->path = path;
+  return true;
+}
+
+bool media_store_commit(MediaStorePending* pending, std::string* error) {
+  PendingLink link;
+  link.fd = pending->fd;
+  link.temp_path = pending->temp_path;
+  link.directory = pending->directory;
+  link.path = pending->path;
+  commit_and_wait(&link);
+  if (link.error != 0) {
+    *error = errno_message("commit", link.error);
+    media_store_abort(pending);
+    return false;
+  }
+  close(pending->fd);
+  pending->fd = -1;
+  return true;
+}
+
+void media_store_abort(MediaStorePending* pending) {
+  if (pending->fd >= 0) {
+    close(pending->fd);
+    pending->fd = -1;
+  }
+  if (!pending->temp_path.empty()) {
+    unlink(pending->temp_path.c_str());
+  }
+}
+
+bool media_store_write(const std::string& directory, const std::string& name,
+                       const void* data, size_t length,
+                       MediaStoreWriteResult* result) {
+  if (media_store_exists(directory, name, length)) {
+    result->existed = true;
+    return true;
+  }
+
+  MediaStorePending pending;
+  if (!media_store_begin(directory, name, &pending, &result->error)) {
+    return false;
+  }
+  if (!write_all(pending.fd, data, length)) {
+    result->error = errno_message("write", errno);
+    media_store_abort(&pending);
+    return false;
+  }
+  return media_store_commit(&pending, &result->error);
+}
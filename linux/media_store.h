@@ -0,0 +1,50 @@
+#ifndef CLIP_FLOW_MEDIA_STORE_H_
+#define CLIP_FLOW_MEDIA_STORE_H_
+
+#include <cstddef>
+#include <string>
+
+// 内容寻址的媒体文件存储。
+//
+// 文件名由调用方按内容哈希生成，目标已存在且大小一致即视为同一内容，跳过写入。
+// 新内容先写入目录下的匿名文件（O_TMPFILE；文件系统不支持时退回 .tmp 临时文件），
+// 落盘后再用 linkat / rename 原子地出现在目标路径，崩溃不会留下半截文件。
+//
+// 落盘采用组提交：一个写入者执行 fsync 期间到达的其他写入排队，
+// 由下一个写入者一次性处理（批量较大时对整个文件系统 syncfs 一次），
+// 连续复制时吞吐不再受单个文件 fsync 延迟限制。
+
+struct MediaStoreWriteResult {
+  // 目标已存在，未写入
+  bool existed = false;
+  // 失败时的错误说明
+  std::string error;
+};
+
+// 阻塞写入 directory/name（须在工作线程调用）；目录不存在时自动创建
+bool media_store_write(const std::string& directory, const std::string& name,
+                       const void* data, size_t length,
+                       MediaStoreWriteResult* result);
+
+// 由调用方自行填充内容的写入（如文件导入）：
+// media_store_begin 打开待提交文件，写完后 media_store_commit 落盘并链接，
+// 放弃时 media_store_abort。以下函数同样须在工作线程调用。
+struct MediaStorePending {
+  int fd = -1;
+  // 退回临时文件时的路径；使用 O_TMPFILE 时为空
+  std::string temp_path;
+  std::string directory;
+  std::string path;
+};
+
+// 目标是否已存在且大小为 size
+bool media_store_exists(const std::string& directory, const std::string& name,
+                        size_t size);
+
+bool media_store_begin(const std::string& directory, const std::string& name,
+                       MediaStorePending* pending, std::string* error);
+// 成功与否都会关闭文件
+bool media_store_commit(MediaStorePending* pending, std::string* error);
+void media_store_abort(MediaStorePending* pending);
+
+#endif  // CLIP_FLOW_MEDIA_STORE_H_
@@ -0,0 +1,283 @@
+#include "ocr_cache.h"
+
+#include <glib.h>
+
+#include <cstring>
+#include <utility>
+
+#include "content_hash.h"
+
+namespace {
+
+const char kCacheFileName[] = "ocr_cache.bin";
+
+// 文件头：魔数与格式版本；格式变化时递增版本，旧文件整体丢弃
+const char kCacheMagic[4] = {'C', 'F', 'O', 'C'};
+constexpr uint32_t kCacheVersion = 1;
+
+// 单个字符串的长度上限，超出即视为文件损坏
+constexpr uint32_t kMaxStringLength = 16 * 1024 * 1024;
+
+class Writer {
+ public:
+  explicit Writer(std::string* out) : out_(out) {}
+
+  template <typename T>
+  void put(T value) {
+    out_->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void put_string(const std::string& value) {
+    put(static_cast<uint32_t>(value.size()));
+    out_->append(value);
+  }
+
+ private:
+  std::string* out_;
+};
+
+// 越界读取后 ok() 为 false，之后的读取均返回零值
+class Reader {
+ public:
+  Reader(const char* data, size_t length) : data_(data), left_(length) {}
+
+  template <typename T>
+  T get() {
+    T value{};
+    if (left_ < sizeof(value)) {
+      left_ = 0;
+      ok_ = false;
+      return value;
+    }
+    std::memcpy(&value, data_, sizeof(value));
+    data_ += sizeof(value);
+    left_ -= sizeof(value);
+    return value;
+  }
+  std::string get_string() {
+    uint32_t length = get<uint32_t>();
+    if (!ok_ || length > kMaxStringLength || length > left_) {
+      ok_ = false;
+      left_ = 0;
+      return std::string();
+    }
+    std::string value(data_, length);
+    data_ += length;
+    left_ -= length;
+    return value;
+  }
+  bool ok() const { return ok_; }
+  bool done() const { return left_ == 0; }
+
+ private:
+  const char* data_;
+  size_t left_;
+  bool ok_ = true;
+};
+
+}  // namespace
+
+OcrCacheKey ocr_cache_key(const OcrImage& image, const OcrOptions& options) {
+  OcrCacheKey key;
+  uint64_t seed = content_hash_combine(
+      content_hash_combine(static_cast<uint64_t>(image.width),
+                           static_cast<uint64_t>(image.height)),
+      static_cast<uint64_t>(image.channels));
+  const size_t row_bytes = static_cast<size_t>(image.width) * image.channels;
+  for (int y = 0; y < image.height; y++) {
+    seed = content_hash_xxh64(
+        image.pixels + static_cast<size_t>(y) * image.rowstride, row_bytes,
+        seed);
+  }
+  key.pixels = seed;
+
+  const OcrPreprocessOptions& preprocess = options.preprocess;
+  std::string config = options.languages;
+  config += '|' + std::to_string(options.parallelism > 1);
+  if (preprocess.enabled) {
+    config += '|' + std::to_string(preprocess.source_dpi) + ',' +
+              std::to_string(preprocess.target_dpi) + ',' +
+              std::to_string(preprocess.binarize) + ',' +
+              std::to_string(preprocess.deskew);
+  }
+  key.config = content_hash_xxh64(config.data(), config.size());
+  return key;
+}
+
+OcrCache::OcrCache(const std::string& directory, size_t max_entries)
+    : directory_(directory),
+      path_(directory + "/" + kCacheFileName),
+      max_entries_(max_entries) {}
+
+bool OcrCache::lookup(const OcrCacheKey& key, uint64_t model_stamp,
+                      OcrOutput* output) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  load_locked();
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+  if (it->second->model_stamp != model_stamp) {
+    // 语言包或 Tesseract 已更新
+    entries_.erase(it->second);
+    index_.erase(it);
+    dirty_ = true;
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  const Entry& entry = entries_.front();
+  output->text = entry.text;
+  output->confidence = entry.confidence;
+  output->languages = entry.languages;
+  output->regions = entry.regions;
+  output->model_stamp = entry.model_stamp;
+  output->cached = true;
+  return true;
+}
+
+void OcrCache::insert(const OcrCacheKey& key, const OcrOutput& output) {
+  Entry entry;
+  entry.key = key;
+  entry.model_stamp = output.model_stamp;
+  entry.confidence = output.confidence;
+  entry.text = output.text;
+  entry.languages = output.languages;
+  entry.regions = output.regions;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  load_locked();
+  insert_locked(std::move(entry));
+  trim_locked();
+  dirty_ = true;
+}
+
+void OcrCache::insert_locked(Entry entry) {
+  auto it = index_.find(entry.key);
+  if (it != index_.end()) {
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  entries_.push_front(std::move(entry));
+  index_[entries_.front().key] = entries_.begin();
+}
+
+void OcrCache::trim_locked() {
+  while (entries_.size() > max_entries_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+    dirty_ = true;
+  }
+}
+
+void OcrCache::set_max_entries(size_t max_entries) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_entries_ = max_entries;
+  trim_locked();
+}
+
+bool OcrCache::dirty() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dirty_;
+}
+
+size_t OcrCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void OcrCache::load_locked() {
+  if (loaded_) {
+    return;
+  }
+  loaded_ = true;
+  gchar* contents = nullptr;
+  gsize length = 0;
+  if (!g_file_get_contents(path_.c_str(), &contents, &length, nullptr)) {
+    return;
+  }
+
+  Reader reader(contents, length);
+  char magic[sizeof(kCacheMagic)];
+  for (char& c : magic) {
+    c = reader.get<char>();
+  }
+  uint32_t version = reader.get<uint32_t>();
+  uint32_t count = reader.get<uint32_t>();
+  if (!reader.ok() || std::memcmp(magic, kCacheMagic, sizeof(magic)) != 0 ||
+      version != kCacheVersion) {
+    g_free(contents);
+    return;
+  }
+
+  // 文件中由旧到新，依次插入表头即恢复 LRU 顺序
+  for (uint32_t i = 0; i < count && reader.ok(); i++) {
+    Entry entry;
+    entry.key.pixels = reader.get<uint64_t>();
+    entry.key.config = reader.get<uint64_t>();
+    entry.model_stamp = reader.get<uint64_t>();
+    entry.confidence = reader.get<double>();
+    entry.text = reader.get_string();
+    entry.languages = reader.get_string();
+    uint32_t region_count = reader.get<uint32_t>();
+    for (uint32_t r = 0; r < region_count && reader.ok(); r++) {
+      OcrRegion region;
+      region.x = reader.get<int32_t>();
+      region.y = reader.get<int32_t>();
+      region.width = reader.get<int32_t>();
+      region.height = reader.get<int32_t>();
+      region.confidence = reader.get<double>();
+      region.text = reader.get_string();
+      entry.regions.push_back(std::move(region));
+    }
+    if (reader.ok()) {
+      insert_locked(std::move(entry));
+    }
+  }
+  g_free(contents);
+  trim_locked();
+  // 载入时截断或丢弃了损坏部分的，下次保存时重写
+  dirty_ = !reader.ok() || !reader.done() || entries_.size() < count;
+}
+
+bool OcrCache::save() {
+  std::lock_guard<std::mutex> save_lock(save_mutex_);
+  std::string data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!dirty_) {
+      return true;
+    }
+    Writer writer(&data);
+    for (char c : kCacheMagic) {
+      writer.put(c);
+    }
+    writer.put(kCacheVersion);
+    writer.put(static_cast<uint32_t>(entries_.size()));
+    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+      writer.put(it->key.pixels);
+      writer.put(it->key.config);
+      writer.put(it->model_stamp);
+      writer.put(it->confidence);
+      writer.put_string(it->text);
+      writer.put_string(it->languages);
+      writer.put(static_cast<uint32_t>(it->regions.size()));
+      for (const OcrRegion& region : it->regions) {
+        writer.put(static_cast<int32_t>(region.x));
+        writer.put(static_cast<int32_t>(region.y));
+        writer.put(static_cast<int32_t>(region.width));
+        writer.put(static_cast<int32_t>(region.height));
+        writer.put(region.confidence);
+        writer.put_string(region.text);
+      }
+    }
+    dirty_ = false;
+  }
+
+  if (g_mkdir_with_parents(directory_.c_str(), 0755) != 0 ||
+      !g_file_set_contents(path_.c_str(), data.data(),
+                           static_cast<gssize>(data.size()), nullptr)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_ = true;
+    return false;
+  }
+  return true;
+}
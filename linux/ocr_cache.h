@@ -0,0 +1,85 @@
+#ifndef CLIP_FLOW_OCR_CACHE_H_
+#define CLIP_FLOW_OCR_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ocr_recognizer.h"
+
+// OCR 结果缓存。
+//
+// 键为解码后像素的 XXH64 与识别配置（语言、预处理、分块参数）的指纹；
+// 条目另记产生结果的模型标识，与当前引擎的标识不符时视为失效并删除。
+// 内存中按 LRU 保留至多 max_entries 项，整体序列化为目录下的一个二进制文件，
+// 首次访问时载入。各方法线程安全；访问磁盘的方法须在工作线程调用。
+
+struct OcrCacheKey {
+  uint64_t pixels = 0;
+  uint64_t config = 0;
+
+  bool operator==(const OcrCacheKey& other) const {
+    return pixels == other.pixels && config == other.config;
+  }
+};
+
+// 计算图像与识别配置的缓存键（逐行哈希，忽略行尾填充）
+OcrCacheKey ocr_cache_key(const OcrImage& image, const OcrOptions& options);
+
+class OcrCache {
+ public:
+  OcrCache(const std::string& directory, size_t max_entries);
+
+  const std::string& directory() const { return directory_; }
+
+  // 命中且模型标识一致时写入 output（text、confidence、languages、regions）
+  bool lookup(const OcrCacheKey& key, uint64_t model_stamp,
+              OcrOutput* output);
+  void insert(const OcrCacheKey& key, const OcrOutput& output);
+
+  void set_max_entries(size_t max_entries);
+
+  // 有未写入的改动时整体写入磁盘（先写临时文件再替换）
+  bool save();
+  bool dirty() const;
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    OcrCacheKey key;
+    uint64_t model_stamp;
+    double confidence;
+    std::string text;
+    std::string languages;
+    std::vector<OcrRegion> regions;
+  };
+  struct KeyHash {
+    size_t operator()(const OcrCacheKey& key) const {
+      return static_cast<size_t>(key.pixels ^ (key.config * 31));
+    }
+  };
+
+  void load_locked();
+  void insert_locked(Entry entry);
+  void trim_locked();
+
+  std::string directory_;
+  std::string path_;
+  size_t max_entries_;
+
+  mutable std::mutex mutex_;
+  // 串行化 save，避免较旧的快照覆盖较新的
+  std::mutex save_mutex_;
+  // 表头为最近使用
+  std::list<Entry> entries_;
+  std::unordered_map<OcrCacheKey, std::list<Entry>::iterator, KeyHash> index_;
+  bool loaded_ = false;
+  bool dirty_ = false;
+};
+
+#endif  // CLIP_FLOW_OCR_CACHE_H_
@@ -0,0 +1,256 @@
+#include "ocr_engine_pool.h"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+#include "content_hash.h"
+
+namespace {
+
+struct LocaleLanguage {
+  const char* prefix;
+  const char* languages;
+};
+
+// 按前缀匹配，较具体的放在前面
+const LocaleLanguage kLocaleLanguages[] = {
+    {"zh-hant", "chi_tra"}, {"zh-tw", "chi_tra"}, {"zh-hk", "chi_tra"},
+    {"zh", "chi_sim"},      {"en", "eng"},        {"ja", "jpn"},
+    {"ko", "kor"},          {"fr", "fra"},        {"de", "deu"},
+    {"es", "spa"},          {"it", "ita"},        {"pt", "por"},
+    {"ru", "rus"},
+};
+
+// Tesseract 版本与各语言 traineddata 的大小、修改时间
+uint64_t compute_model_stamp(tesseract::TessBaseAPI* engine,
+                             const std::string& languages) {
+  std::string identity = tesseract::TessBaseAPI::Version();
+  std::string datapath = engine->GetDatapath();
+  if (!datapath.empty() && datapath.back() != '/') {
+    datapath += '/';
+  }
+  size_t start = 0;
+  while (start <= languages.size()) {
+    size_t end = languages.find('+', start);
+    if (end == std::string::npos) {
+      end = languages.size();
+    }
+    std::string path =
+        datapath + languages.substr(start, end - start) + ".traineddata";
+    struct stat st;
+    identity += '|';
+    identity += path;
+    if (stat(path.c_str(), &st) == 0) {
+      identity += ':' + std::to_string(st.st_size) + ':' +
+                  std::to_string(st.st_mtim.tv_sec) + '.' +
+                  std::to_string(st.st_mtim.tv_nsec);
+    }
+    start = end + 1;
+  }
+  return content_hash_xxh64(identity.data(), identity.size());
+}
+
+}  // namespace
+
+const char kOcrFallbackLanguages[] = "eng";
+
+OcrEnginePool::Lease& OcrEnginePool::Lease::operator=(Lease&& other) {
+  if (this != &other) {
+    release();
+    pool_ = std::move(other.pool_);
+    languages_ = std::move(other.languages_);
+    engine_ = std::move(other.engine_);
+    reused_ = other.reused_;
+    model_stamp_ = other.model_stamp_;
+  }
+  return *this;
+}
+
+OcrEnginePool::Lease::~Lease() { release(); }
+
+void OcrEnginePool::Lease::discard() { engine_.reset(); }
+
+void OcrEnginePool::Lease::release() {
+  if (pool_ != nullptr && engine_ != nullptr) {
+    pool_->release(languages_, std::move(engine_), model_stamp_);
+  }
+  engine_.reset();
+  pool_.reset();
+}
+
+std::unique_ptr<tesseract::TessBaseAPI> OcrEnginePool::create_engine(
+    const std::string& languages, uint64_t* model_stamp, std::string* error) {
+  std::unique_ptr<tesseract::TessBaseAPI> engine(new tesseract::TessBaseAPI());
+  if (engine->Init(nullptr, languages.c_str()) != 0) {
+    if (error != nullptr) {
+      *error = "Failed to initialize OCR engine for " + languages;
+    }
+    return nullptr;
+  }
+  *model_stamp = compute_model_stamp(engine.get(), languages);
+  std::lock_guard<std::mutex> lock(mutex_);
+  model_stamps_[languages] = *model_stamp;
+  fallbacks_.erase(languages);
+  return engine;
+}
+
+OcrEnginePool::Lease OcrEnginePool::acquire(
+    const std::shared_ptr<OcrEnginePool>& pool, const std::string& languages,
+    std::string* error) {
+  Lease lease;
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex_);
+    auto it = pool->idle_.find(languages);
+    if (it != pool->idle_.end() && !it->second.empty()) {
+      // 取最近归还的引擎，较早的更可能因空闲超时被释放
+      lease.engine_ = std::move(it->second.back().engine);
+      lease.model_stamp_ = it->second.back().model_stamp;
+      it->second.pop_back();
+      lease.reused_ = true;
+    }
+  }
+  if (lease.engine_ == nullptr) {
+    lease.engine_ =
+        pool->create_engine(languages, &lease.model_stamp_, error);
+    if (lease.engine_ == nullptr) {
+      return lease;
+    }
+  }
+  lease.pool_ = pool;
+  lease.languages_ = languages;
+  return lease;
+}
+
+void OcrEnginePool::configure(size_t max_idle,
+                              std::chrono::seconds idle_timeout) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_idle_ = max_idle;
+  idle_timeout_ = idle_timeout;
+  for (auto& entry : idle_) {
+    if (entry.second.size() > max_idle_) {
+      entry.second.erase(entry.second.begin(),
+                         entry.second.end() - max_idle_);
+    }
+  }
+}
+
+bool OcrEnginePool::warm(const std::string& languages, size_t count,
+                         std::string* error) {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      count = std::min(count, max_idle_);
+      if (idle_[languages].size() >= count) {
+        return true;
+      }
+    }
+    uint64_t model_stamp = 0;
+    std::unique_ptr<tesseract::TessBaseAPI> engine =
+        create_engine(languages, &model_stamp, error);
+    if (engine == nullptr) {
+      return false;
+    }
+    release(languages, std::move(engine), model_stamp);
+  }
+}
+
+void OcrEnginePool::release(const std::string& languages,
+                            std::unique_ptr<tesseract::TessBaseAPI> engine,
+                            uint64_t model_stamp) {
+  engine->Clear();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<IdleEngine>& engines = idle_[languages];
+    if (engines.size() < max_idle_) {
+      engines.push_back(
+          {std::move(engine), std::chrono::steady_clock::now(), model_stamp});
+      return;
+    }
+  }
+  // 超出上限的引擎在锁外析构
+}
+
+size_t OcrEnginePool::evict_idle() {
+  std::vector<std::unique_ptr<tesseract::TessBaseAPI>> expired;
+  size_t remaining = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto deadline = std::chrono::steady_clock::now() - idle_timeout_;
+    for (auto it = idle_.begin(); it != idle_.end();) {
+      std::vector<IdleEngine>& engines = it->second;
+      auto keep = std::partition(
+          engines.begin(), engines.end(),
+          [deadline](const IdleEngine& idle) { return idle.since <= deadline; });
+      for (auto expired_it = engines.begin(); expired_it != keep;
+           ++expired_it) {
+        expired.push_back(std::move(expired_it->engine));
+      }
+      engines.erase(engines.begin(), keep);
+      remaining += engines.size();
+      it = engines.empty() ? idle_.erase(it) : std::next(it);
+    }
+  }
+  // 引擎在锁外析构
+  return remaining;
+}
+
+void OcrEnginePool::clear() {
+  // engines 先于锁声明，引擎在解锁后析构
+  std::map<std::string, std::vector<IdleEngine>> engines;
+  std::lock_guard<std::mutex> lock(mutex_);
+  engines.swap(idle_);
+}
+
+size_t OcrEnginePool::idle_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto& entry : idle_) {
+    count += entry.second.size();
+  }
+  return count;
+}
+
+bool OcrEnginePool::model_stamp(const std::string& languages,
+                                uint64_t* stamp) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto fallback = fallbacks_.find(languages);
+  auto it = model_stamps_.find(
+      fallback != fallbacks_.end() ? fallback->second : languages);
+  if (it == model_stamps_.end()) {
+    return false;
+  }
+  *stamp = it->second;
+  return true;
+}
+
+void OcrEnginePool::record_fallback(const std::string& requested,
+                                    const std::string& loaded) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  fallbacks_[requested] = loaded;
+}
+
+std::string ocr_languages_for_locale(const std::string& locale) {
+  std::string lower = locale;
+  std::transform(lower.begin(), lower.end(), lower.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  std::replace(lower.begin(), lower.end(), '_', '-');
+  if (lower.empty() || lower == "auto") {
+    return "eng";
+  }
+  for (const LocaleLanguage& entry : kLocaleLanguages) {
+    size_t length = strlen(entry.prefix);
+    if (lower.compare(0, length, entry.prefix) == 0 &&
+        (lower.size() == length || lower[length] == '-')) {
+      return entry.languages;
+    }
+  }
+  // Tesseract 代码：小写字母、下划线与 +
+  bool tesseract_code = std::all_of(locale.begin(), locale.end(), [](char c) {
+    return (c >= 'a' && c <= 'z') || c == '_' || c == '+';
+  });
+  return tesseract_code ? locale : "eng";
+}
@@ -0,0 +1,114 @@
+#ifndef CLIP_FLOW_OCR_ENGINE_POOL_H_
+#define CLIP_FLOW_OCR_ENGINE_POOL_H_
+
+#include <tesseract/baseapi.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 已初始化的 Tesseract 引擎池。
+//
+// Init 需要从磁盘加载并解析 traineddata，耗时常在数百毫秒，
+// 远超小截图的识别本身。池按语言组合（如 "eng+chi_sim"）保存空闲引擎，
+// 用完后 Clear() 清除图像与识别结果再放回，下次直接复用。
+// 每种语言组合最多保留 max_idle 个空闲引擎，空闲超过 idle_timeout 的由
+// evict_idle 释放。各方法线程安全；acquire / warm 会阻塞，须在工作线程调用。
+class OcrEnginePool {
+ public:
+  // 借出的引擎，析构时归还
+  class Lease {
+   public:
+    Lease() = default;
+    Lease(Lease&& other) = default;
+    Lease& operator=(Lease&& other);
+    ~Lease();
+
+    tesseract::TessBaseAPI* get() const { return engine_.get(); }
+    tesseract::TessBaseAPI* operator->() const { return engine_.get(); }
+    explicit operator bool() const { return engine_ != nullptr; }
+    const std::string& languages() const { return languages_; }
+    // 本次借出的是否为已有的空闲引擎
+    bool reused() const { return reused_; }
+    // 引擎初始化时加载的模型标识，见 OcrEnginePool::model_stamp
+    uint64_t model_stamp() const { return model_stamp_; }
+
+    // 引擎状态不可信（如识别被中断）时丢弃而不归还
+    void discard();
+
+   private:
+    friend class OcrEnginePool;
+
+    void release();
+
+    std::shared_ptr<OcrEnginePool> pool_;
+    std::string languages_;
+    std::unique_ptr<tesseract::TessBaseAPI> engine_;
+    bool reused_ = false;
+    uint64_t model_stamp_ = 0;
+  };
+
+  // 取得已初始化的引擎；没有空闲引擎时新建并 Init。
+  // pool 须为持有本对象的 shared_ptr（借出期间保持存活）
+  static Lease acquire(const std::shared_ptr<OcrEnginePool>& pool,
+                       const std::string& languages, std::string* error);
+
+  void configure(size_t max_idle, std::chrono::seconds idle_timeout);
+
+  // 预热：确保该语言组合至少有 count 个空闲引擎
+  bool warm(const std::string& languages, size_t count, std::string* error);
+
+  // 释放空闲超时的引擎，返回剩余的空闲引擎数
+  size_t evict_idle();
+
+  // 释放全部空闲引擎
+  void clear();
+
+  size_t idle_count() const;
+
+  // 该语言组合最近一次初始化引擎时的模型标识：由 Tesseract 版本与各
+  // traineddata 文件的大小、修改时间得出，语言包更新后随之改变。
+  // 该语言组合记录过退回时取实际加载的语言组合的标识。
+  // 尚未初始化过对应的引擎时返回 false
+  bool model_stamp(const std::string& languages, uint64_t* stamp) const;
+
+  // 记录 requested 初始化失败、实际改用 loaded；requested 之后初始化成功时清除
+  void record_fallback(const std::string& requested, const std::string& loaded);
+
+ private:
+  struct IdleEngine {
+    std::unique_ptr<tesseract::TessBaseAPI> engine;
+    std::chrono::steady_clock::time_point since;
+    uint64_t model_stamp;
+  };
+
+  // 新建并初始化引擎，记录其模型标识
+  std::unique_ptr<tesseract::TessBaseAPI> create_engine(
+      const std::string& languages, uint64_t* model_stamp, std::string* error);
+
+  void release(const std::string& languages,
+               std::unique_ptr<tesseract::TessBaseAPI> engine,
+               uint64_t model_stamp);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::vector<IdleEngine>> idle_;
+  std::map<std::string, uint64_t> model_stamps_;
+  // 请求的语言组合 -> 退回后实际加载的语言组合
+  std::map<std::string, std::string> fallbacks_;
+  size_t max_idle_ = 2;
+  std::chrono::seconds idle_timeout_{300};
+};
+
+// 语言包缺失时退回的语言组合
+extern const char kOcrFallbackLanguages[];
+
+// 把 Dart 侧的语言设置（"auto"、"en-US"、"zh-Hans" 等）转换为
+// Tesseract 语言组合；已是 Tesseract 代码（如 "chi_sim"、"eng+jpn"）时原样返回
+std::string ocr_languages_for_locale(const std::string& locale);
+
+#endif  // CLIP_FLOW_OCR_ENGINE_POOL_H_
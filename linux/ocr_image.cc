@@ -0,0 +1,327 @@
+#include "ocr_image.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CLIP_FLOW_OCR_IMAGE_AVX2 1
+#endif
+
+namespace {
+
+constexpr uint32_t kAlphaMask = 0xff000000u;
+
+// c * a / 255 + (255 - a)，即 (255 * 255 - a * (255 - c)) / 255，四舍五入
+inline uint8_t flatten_channel(uint32_t c, uint32_t a) {
+  uint32_t x = 255 * 255 - a * (255 - c) + 128;
+  return static_cast<uint8_t>((x + (x >> 8)) >> 8);
+}
+
+bool row_has_transparency_scalar(const uint8_t* row, uint32_t count) {
+  for (uint32_t x = 0; x < count; x++) {
+    if (row[x * 4 + 3] != 255) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void flatten_row_scalar(const uint8_t* src, uint8_t* dst, uint32_t count) {
+  for (uint32_t x = 0; x < count; x++) {
+    uint32_t a = src[x * 4 + 3];
+    dst[x * 4] = flatten_channel(src[x * 4], a);
+    dst[x * 4 + 1] = flatten_channel(src[x * 4 + 1], a);
+    dst[x * 4 + 2] = flatten_channel(src[x * 4 + 2], a);
+    dst[x * 4 + 3] = 255;
+  }
+}
+
+// BT.601 亮度权重，和为 256
+constexpr uint32_t kLumaRed = 77;
+constexpr uint32_t kLumaGreen = 150;
+constexpr uint32_t kLumaBlue = 29;
+
+inline uint32_t luma(const uint8_t* p) {
+  return (kLumaRed * p[0] + kLumaGreen * p[1] + kLumaBlue * p[2] + 128) >> 8;
+}
+
+void gray_row_scalar(const uint8_t* src, int channels, uint8_t* dst,
+                     uint32_t count) {
+  for (uint32_t x = 0; x < count; x++) {
+    const uint8_t* p = src + x * channels;
+    dst[x] = channels == 4 ? flatten_channel(luma(p), p[3])
+                           : static_cast<uint8_t>(luma(p));
+  }
+}
+
+#if defined(__SSE2__)
+// 每次 4 个像素；返回已处理的像素数
+uint32_t row_has_transparency_sse2(const uint8_t* row, uint32_t count,
+                                   bool* found) {
+  const __m128i mask = _mm_set1_epi32(static_cast<int>(kAlphaMask));
+  uint32_t x = 0;
+  for (; x + 4 <= count; x += 4) {
+    __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x * 4));
+    __m128i eq = _mm_cmpeq_epi32(_mm_and_si128(px, mask), mask);
+    if (_mm_movemask_epi8(eq) != 0xffff) {
+      *found = true;
+      return x;
+    }
+  }
+  return x;
+}
+
+// 16 位通道上的合成：255 * 255 - a * (255 - c)，再除以 255
+inline __m128i flatten_epi16_sse2(__m128i px) {
+  const __m128i c255 = _mm_set1_epi16(255);
+  // 每个像素的 alpha 广播到 4 个通道
+  __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px, 0xff), 0xff);
+  __m128i x = _mm_sub_epi16(_mm_set1_epi16(static_cast<short>(255 * 255 + 128)),
+                            _mm_mullo_epi16(alpha, _mm_sub_epi16(c255, px)));
+  x = _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+  return x;
+}
+
+uint32_t flatten_row_sse2(const uint8_t* src, uint8_t* dst, uint32_t count) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i opaque = _mm_set1_epi32(static_cast<int>(kAlphaMask));
+  uint32_t x = 0;
+  for (; x + 4 <= count; x += 4) {
+    __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+    __m128i lo = flatten_epi16_sse2(_mm_unpacklo_epi8(px, zero));
+    __m128i hi = flatten_epi16_sse2(_mm_unpackhi_epi8(px, zero));
+    __m128i out = _mm_or_si128(_mm_packus_epi16(lo, hi), opaque);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), out);
+  }
+  return x;
+}
+
+// 4 个 RGBA 像素的亮度，每个 32 位通道一个。
+// 各分量只占低 16 位，可用 madd 做 32 位乘法
+inline __m128i gray_epi32_sse2(__m128i px) {
+  const __m128i byte = _mm_set1_epi32(0xff);
+  __m128i r = _mm_and_si128(px, byte);
+  __m128i g = _mm_and_si128(_mm_srli_epi32(px, 8), byte);
+  __m128i b = _mm_and_si128(_mm_srli_epi32(px, 16), byte);
+  __m128i y = _mm_add_epi32(
+      _mm_add_epi32(_mm_madd_epi16(r, _mm_set1_epi32(kLumaRed)),
+                    _mm_madd_epi16(g, _mm_set1_epi32(kLumaGreen))),
+      _mm_add_epi32(_mm_madd_epi16(b, _mm_set1_epi32(kLumaBlue)),
+                    _mm_set1_epi32(128)));
+  y = _mm_srli_epi32(y, 8);
+  __m128i a = _mm_srli_epi32(px, 24);
+  __m128i x = _mm_sub_epi32(
+      _mm_set1_epi32(255 * 255 + 128),
+      _mm_madd_epi16(a, _mm_sub_epi32(_mm_set1_epi32(255), y)));
+  return _mm_srli_epi32(_mm_add_epi32(x, _mm_srli_epi32(x, 8)), 8);
+}
+
+// SSE2 没有字节重排指令，RGB 交给标量或 AVX2 路径
+uint32_t gray_row_sse2(const uint8_t* src, uint8_t* dst, uint32_t count) {
+  uint32_t x = 0;
+  for (; x + 8 <= count; x += 8) {
+    __m128i lo = gray_epi32_sse2(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4)));
+    __m128i hi = gray_epi32_sse2(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4 + 16)));
+    __m128i packed = _mm_packs_epi32(lo, hi);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x),
+                     _mm_packus_epi16(packed, packed));
+  }
+  return x;
+}
+#endif
+
+#if defined(CLIP_FLOW_OCR_IMAGE_AVX2)
+__attribute__((target("avx2"))) uint32_t row_has_transparency_avx2(
+    const uint8_t* row, uint32_t count, bool* found) {
+  const __m256i mask = _mm256_set1_epi32(static_cast<int>(kAlphaMask));
+  uint32_t x = 0;
+  for (; x + 8 <= count; x += 8) {
+    __m256i px =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x * 4));
+    __m256i eq = _mm256_cmpeq_epi32(_mm256_and_si256(px, mask), mask);
+    if (static_cast<uint32_t>(_mm256_movemask_epi8(eq)) != 0xffffffffu) {
+      *found = true;
+      return x;
+    }
+  }
+  return x;
+}
+
+__attribute__((target("avx2"))) inline __m256i flatten_epi16_avx2(
+    __m256i px) {
+  const __m256i c255 = _mm256_set1_epi16(255);
+  __m256i alpha =
+      _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(px, 0xff), 0xff);
+  __m256i x =
+      _mm256_sub_epi16(_mm256_set1_epi16(static_cast<short>(255 * 255 + 128)),
+                       _mm256_mullo_epi16(alpha, _mm256_sub_epi16(c255, px)));
+  return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+// unpack / pack 均在 128 位通道内进行，像素顺序保持不变
+__attribute__((target("avx2"))) uint32_t flatten_row_avx2(const uint8_t* src,
+                                                          uint8_t* dst,
+                                                          uint32_t count) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i opaque = _mm256_set1_epi32(static_cast<int>(kAlphaMask));
+  uint32_t x = 0;
+  for (; x + 8 <= count; x += 8) {
+    __m256i px =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 4));
+    __m256i lo = flatten_epi16_avx2(_mm256_unpacklo_epi8(px, zero));
+    __m256i hi = flatten_epi16_avx2(_mm256_unpackhi_epi8(px, zero));
+    __m256i out = _mm256_or_si256(_mm256_packus_epi16(lo, hi), opaque);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), out);
+  }
+  return x;
+}
+
+// 8 个像素的亮度；with_alpha 为 false 时不做背景合成
+__attribute__((target("avx2"))) inline __m256i gray_epi32_avx2(
+    __m256i px, bool with_alpha) {
+  const __m256i byte = _mm256_set1_epi32(0xff);
+  __m256i r = _mm256_and_si256(px, byte);
+  __m256i g = _mm256_and_si256(_mm256_srli_epi32(px, 8), byte);
+  __m256i b = _mm256_and_si256(_mm256_srli_epi32(px, 16), byte);
+  __m256i y = _mm256_add_epi32(
+      _mm256_add_epi32(_mm256_madd_epi16(r, _mm256_set1_epi32(kLumaRed)),
+                       _mm256_madd_epi16(g, _mm256_set1_epi32(kLumaGreen))),
+      _mm256_add_epi32(_mm256_madd_epi16(b, _mm256_set1_epi32(kLumaBlue)),
+                       _mm256_set1_epi32(128)));
+  y = _mm256_srli_epi32(y, 8);
+  if (!with_alpha) {
+    return y;
+  }
+  __m256i a = _mm256_srli_epi32(px, 24);
+  __m256i x = _mm256_sub_epi32(
+      _mm256_set1_epi32(255 * 255 + 128),
+      _mm256_madd_epi16(a, _mm256_sub_epi32(_mm256_set1_epi32(255), y)));
+  return _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_srli_epi32(x, 8)), 8);
+}
+
+// 8 个 RGB 像素展开为 RGBX：两个 128 位通道各取 4 个像素（12 字节）
+__attribute__((target("avx2"))) inline __m256i load_rgb_avx2(
+    const uint8_t* src) {
+  const __m256i expand = _mm256_setr_epi8(
+      0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+      0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  __m256i px = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12)), 1);
+  return _mm256_shuffle_epi8(px, expand);
+}
+
+__attribute__((target("avx2"))) uint32_t gray_row_avx2(const uint8_t* src,
+                                                       int channels,
+                                                       uint8_t* dst,
+                                                       uint32_t count) {
+  // packs 在 128 位通道内交错，按 32 位重排回像素顺序
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  uint32_t x = 0;
+  if (channels == 4) {
+    for (; x + 16 <= count; x += 16) {
+      __m256i lo = gray_epi32_avx2(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x * 4)),
+          true);
+      __m256i hi = gray_epi32_avx2(
+          _mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(src + x * 4 + 32)),
+          true);
+      __m256i packed = _mm256_packs_epi32(lo, hi);
+      packed = _mm256_permutevar8x32_epi32(
+          _mm256_packus_epi16(packed, packed), order);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                       _mm256_castsi256_si128(packed));
+    }
+    return x;
+  }
+  // 每 8 个像素读取 28 字节，末尾留出余量
+  for (; x + 16 + 2 <= count; x += 16) {
+    __m256i lo = gray_epi32_avx2(load_rgb_avx2(src + x * 3), false);
+    __m256i hi = gray_epi32_avx2(load_rgb_avx2(src + x * 3 + 24), false);
+    __m256i packed = _mm256_packs_epi32(lo, hi);
+    packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(packed, packed),
+                                         order);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                     _mm256_castsi256_si128(packed));
+  }
+  return x;
+}
+
+bool cpu_has_avx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+#endif
+
+}  // namespace
+
+bool ocr_image_has_transparency(const uint8_t* pixels, uint32_t width,
+                                uint32_t height, size_t stride) {
+  for (uint32_t y = 0; y < height; y++) {
+    const uint8_t* row = pixels + static_cast<size_t>(y) * stride;
+    uint32_t x = 0;
+    bool found = false;
+#if defined(CLIP_FLOW_OCR_IMAGE_AVX2)
+    if (cpu_has_avx2()) {
+      x = row_has_transparency_avx2(row, width, &found);
+    }
+#endif
+#if defined(__SSE2__)
+    if (!found) {
+      x += row_has_transparency_sse2(row + x * 4, width - x, &found);
+    }
+#endif
+    if (found || row_has_transparency_scalar(row + x * 4, width - x)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ocr_image_flatten_alpha(const uint8_t* src, uint32_t width,
+                             uint32_t height, size_t src_stride, uint8_t* dst,
+                             size_t dst_stride) {
+  for (uint32_t y = 0; y < height; y++) {
+    const uint8_t* in = src + static_cast<size_t>(y) * src_stride;
+    uint8_t* out = dst + static_cast<size_t>(y) * dst_stride;
+    uint32_t x = 0;
+#if defined(CLIP_FLOW_OCR_IMAGE_AVX2)
+    if (cpu_has_avx2()) {
+      x = flatten_row_avx2(in, out, width);
+    }
+#endif
+#if defined(__SSE2__)
+    x += flatten_row_sse2(in + x * 4, out + x * 4, width - x);
+#endif
+    flatten_row_scalar(in + x * 4, out + x * 4, width - x);
+  }
+}
+
+void ocr_image_to_gray(const uint8_t* src, uint32_t width, uint32_t height,
+                       size_t src_stride, int channels, uint8_t* dst,
+                       size_t dst_stride) {
+  for (uint32_t y = 0; y < height; y++) {
+    const uint8_t* in = src + static_cast<size_t>(y) * src_stride;
+    uint8_t* out = dst + static_cast<size_t>(y) * dst_stride;
+    uint32_t x = 0;
+#if defined(CLIP_FLOW_OCR_IMAGE_AVX2)
+    if (cpu_has_avx2()) {
+      x = gray_row_avx2(in, channels, out, width);
+    }
+#endif
+#if defined(__SSE2__)
+    if (channels == 4) {
+      x += gray_row_sse2(in + x * 4, out + x, width - x);
+    }
+#endif
+    gray_row_scalar(in + x * channels, channels, out + x, width - x);
+  }
+}
@@ -0,0 +1,41 @@
+#ifndef CLIP_FLOW_OCR_IMAGE_H_
+#define CLIP_FLOW_OCR_IMAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// 交给 Tesseract 之前的像素处理。
+//
+// GdkPixbuf 的 RGB / RGBA 行布局可直接经 SetImage(data, w, h, bpp, stride)
+// 交给 Tesseract，无需先转换为 Leptonica PIX。唯一需要改写像素的情况是
+// 带透明度的 RGBA：截图的透明区域多为 (0, 0, 0, 0)，直接识别时会变成黑底，
+// 与深色文字混在一起，因此先合成到白色背景上。
+//
+// x86 上使用 SSE2，CPU 支持时在运行期切换到 AVX2；其他平台为等价的标量实现。
+
+// 8 位 RGB / RGBA 像素，识别期间须保持有效
+struct OcrImage {
+  const uint8_t* pixels = nullptr;
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  int rowstride = 0;
+};
+
+// RGBA 图像中是否存在不透明度小于 255 的像素
+bool ocr_image_has_transparency(const uint8_t* pixels, uint32_t width,
+                                uint32_t height, size_t stride);
+
+// 把 RGBA 图像合成到白色背景上，结果仍为 RGBA（alpha 均为 255）。
+// dst 可与 src 相同
+void ocr_image_flatten_alpha(const uint8_t* src, uint32_t width,
+                             uint32_t height, size_t src_stride, uint8_t* dst,
+                             size_t dst_stride);
+
+// 把 RGB（channels = 3）或 RGBA（channels = 4）图像转换为 8 位灰度
+// （BT.601 亮度），RGBA 同时合成到白色背景上
+void ocr_image_to_gray(const uint8_t* src, uint32_t width, uint32_t height,
+                       size_t src_stride, int channels, uint8_t* dst,
+                       size_t dst_stride);
+
+#endif  // CLIP_FLOW_OCR_IMAGE_H_
@@ -0,0 +1,50 @@
+#include "ocr_jobs.h"
+
+constexpr int64_t OcrJobTable::kNoCapture;
+
+OcrJobTable::CancelFlag OcrJobTable::add(int64_t id, bool supersede,
+                                         int64_t capture_sequence,
+                                         int64_t current_sequence) {
+  if (jobs_.count(id) > 0) {
+    return nullptr;
+  }
+  Job job;
+  job.cancelled = std::make_shared<std::atomic<bool>>(false);
+  job.supersede = supersede || capture_sequence != kNoCapture;
+  job.capture_sequence = capture_sequence;
+  if (capture_sequence != kNoCapture && capture_sequence < current_sequence) {
+    job.cancelled->store(true);
+  }
+  jobs_[id] = job;
+  return job.cancelled;
+}
+
+OcrJobTable::CancelFlag OcrJobTable::find(int64_t id) const {
+  auto it = jobs_.find(id);
+  return it != jobs_.end() ? it->second.cancelled : nullptr;
+}
+
+bool OcrJobTable::cancel(int64_t id) {
+  auto it = jobs_.find(id);
+  if (it == jobs_.end()) {
+    return false;
+  }
+  it->second.cancelled->store(true);
+  return true;
+}
+
+void OcrJobTable::supersede(int64_t sequence) {
+  for (auto& job : jobs_) {
+    if (job.second.supersede &&
+        (job.second.capture_sequence == kNoCapture ||
+         job.second.capture_sequence < sequence)) {
+      job.second.cancelled->store(true);
+    }
+  }
+}
+
+void OcrJobTable::cancel_all() {
+  for (auto& job : jobs_) {
+    job.second.cancelled->store(true);
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef CLIP_FLOW_OCR_JOBS_H_
+#define CLIP_FLOW_OCR_JOBS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+// 进行中的 OCR 任务表，按 jobId 索引，只在主线程访问。
+//
+// 每个任务有一个取消标志，工作线程在识别过程中轮询。可被取代的任务
+// （识别剪贴板图像、或属于某次剪贴板捕获的识别）在剪贴板序号前进时
+// 一并取消：它们的识别对象已不是当前内容。
+class OcrJobTable {
+ public:
+  using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+  // 不属于任何一次捕获
+  static constexpr int64_t kNoCapture = -1;
+
+  // 登记任务，id 已存在时返回 nullptr。
+  // capture_sequence 为任务所属捕获时的剪贴板序号：早于 current_sequence
+  // 时剪贴板已经变化，任务登记后即为已取消
+  CancelFlag add(int64_t id, bool supersede, int64_t capture_sequence,
+                 int64_t current_sequence);
+
+  // 未指定 jobId 的任务使用递减的负数 ID，避免与 Dart 分配的 ID 冲突
+  int64_t next_internal_id() { return --next_internal_id_; }
+
+  // 任务的取消标志，任务不存在时返回 nullptr
+  CancelFlag find(int64_t id) const;
+
+  // 取消任务，返回任务是否存在
+  bool cancel(int64_t id);
+
+  // 剪贴板序号前进到 sequence：取消可被取代、且所属捕获早于 sequence 的任务
+  void supersede(int64_t sequence);
+
+  void cancel_all();
+
+  // 任务结束（已响应）后移除
+  void finish(int64_t id) { jobs_.erase(id); }
+
+  bool contains(int64_t id) const { return jobs_.count(id) > 0; }
+  size_t size() const { return jobs_.size(); }
+
+ private:
+  struct Job {
+    CancelFlag cancelled;
+    bool supersede;
+    int64_t capture_sequence;
+  };
+
+  std::map<int64_t, Job> jobs_;
+  int64_t next_internal_id_ = 0;
+};
+
+#endif  // CLIP_FLOW_OCR_JOBS_H_
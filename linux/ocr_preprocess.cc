@@ -0,0 +1,377 @@
+#include "ocr_preprocess.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "image_scale.h"
+
+namespace {
+
+// 缩放比例范围：放大过多只会拖慢识别
+constexpr double kMinScale = 0.25;
+constexpr double kMaxScale = 2.0;
+// 比例接近 1 时不缩放
+constexpr double kScaleTolerance = 0.05;
+// 放大后的像素数上限
+constexpr double kMaxUpscalePixels = 8.0 * 1024 * 1024;
+
+// Sauvola 参数：窗口约为 1/10 英寸，k 取常用值，R 为 8 位标准差的动态范围
+constexpr int kSauvolaMinWindow = 15;
+constexpr int kSauvolaMaxWindow = 63;
+constexpr int kSauvolaDefaultWindow = 31;
+constexpr float kSauvolaK = 0.34f;
+constexpr float kSauvolaRange = 128.0f;
+
+// 倾斜检测：先以 0.5° 粗搜，再在最优值附近以 0.05° 细搜
+constexpr double kMaxSkewDegrees = 5.0;
+constexpr double kCoarseSkewStep = 0.5;
+constexpr double kFineSkewStep = 0.05;
+// 小于该角度不旋转
+constexpr double kMinSkewDegrees = 0.1;
+// 参与检测的前景采样点数上限与下限
+constexpr size_t kMaxSkewSamples = 200000;
+constexpr size_t kMinSkewSamples = 100;
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 双线性放大（16 位定点）
+void upscale_bilinear(const uint8_t* src, int width, int height, uint8_t* dst,
+                      int dst_width, int dst_height) {
+  std::vector<int> x0(dst_width);
+  std::vector<int> fx(dst_width);
+  for (int x = 0; x < dst_width; x++) {
+    double sx = std::max(0.0, (x + 0.5) * width / dst_width - 0.5);
+    x0[x] = std::min(static_cast<int>(sx), width - 1);
+    fx[x] = static_cast<int>((sx - x0[x]) * 256);
+  }
+  for (int y = 0; y < dst_height; y++) {
+    double sy = std::max(0.0, (y + 0.5) * height / dst_height - 0.5);
+    int y0 = std::min(static_cast<int>(sy), height - 1);
+    int y1 = std::min(y0 + 1, height - 1);
+    int fy = static_cast<int>((sy - y0) * 256);
+    const uint8_t* row0 = src + static_cast<size_t>(y0) * width;
+    const uint8_t* row1 = src + static_cast<size_t>(y1) * width;
+    uint8_t* out = dst + static_cast<size_t>(y) * dst_width;
+    for (int x = 0; x < dst_width; x++) {
+      int xa = x0[x];
+      int xb = std::min(xa + 1, width - 1);
+      int top = row0[xa] * (256 - fx[x]) + row0[xb] * fx[x];
+      int bottom = row1[xa] * (256 - fx[x]) + row1[xb] * fx[x];
+      out[x] = static_cast<uint8_t>(
+          (top * (256 - fy) + bottom * fy + (1 << 15)) >> 16);
+    }
+  }
+}
+
+double choose_scale(const OcrImage& image,
+                    const OcrPreprocessOptions& options) {
+  if (options.source_dpi <= 0 || options.target_dpi <= 0) {
+    return 1;
+  }
+  double scale = std::min(
+      kMaxScale,
+      std::max(kMinScale,
+               static_cast<double>(options.target_dpi) / options.source_dpi));
+  double pixels = static_cast<double>(image.width) * image.height;
+  if (scale > 1 && pixels * scale * scale > kMaxUpscalePixels) {
+    scale = std::max(1.0, std::sqrt(kMaxUpscalePixels / pixels));
+  }
+  return std::fabs(scale - 1) < kScaleTolerance ? 1 : scale;
+}
+
+void rescale(OcrGrayImage* image, double scale) {
+  int width = std::max(1, static_cast<int>(std::lround(image->width * scale)));
+  int height =
+      std::max(1, static_cast<int>(std::lround(image->height * scale)));
+  std::vector<uint8_t> scaled(static_cast<size_t>(width) * height);
+  if (scale < 1) {
+    image_downscale_area(image->pixels.data(), image->width, image->height,
+                         image->width, 1, scaled.data(), width, height, width);
+  } else {
+    upscale_bilinear(image->pixels.data(), image->width, image->height,
+                     scaled.data(), width, height);
+  }
+  image->pixels.swap(scaled);
+  image->width = width;
+  image->height = height;
+}
+
+int otsu_threshold(const std::vector<uint8_t>& pixels) {
+  uint64_t histogram[256] = {};
+  for (uint8_t value : pixels) {
+    histogram[value]++;
+  }
+  double total = static_cast<double>(pixels.size());
+  double sum = 0;
+  for (int i = 0; i < 256; i++) {
+    sum += static_cast<double>(i) * histogram[i];
+  }
+  double background_sum = 0;
+  double background_weight = 0;
+  double best_variance = -1;
+  int best = 127;
+  for (int t = 0; t < 256; t++) {
+    background_weight += histogram[t];
+    if (background_weight == 0) {
+      continue;
+    }
+    double foreground_weight = total - background_weight;
+    if (foreground_weight == 0) {
+      break;
+    }
+    background_sum += static_cast<double>(t) * histogram[t];
+    double mean_background = background_sum / background_weight;
+    double mean_foreground = (sum - background_sum) / foreground_weight;
+    double variance = background_weight * foreground_weight *
+                      (mean_background - mean_foreground) *
+                      (mean_background - mean_foreground);
+    if (variance > best_variance) {
+      best_variance = variance;
+      best = t;
+    }
+  }
+  return best;
+}
+
+void binarize_otsu(OcrGrayImage* image) {
+  int threshold = otsu_threshold(image->pixels);
+  for (uint8_t& value : image->pixels) {
+    value = value > threshold ? 255 : 0;
+  }
+}
+
+// 窗口内均值与标准差由列累加和滑动求得，内存只与宽度成正比
+void binarize_sauvola(OcrGrayImage* image, int dpi) {
+  const int width = image->width;
+  const int height = image->height;
+  int window = dpi > 0 ? (dpi / 10) | 1 : kSauvolaDefaultWindow;
+  window = std::max(kSauvolaMinWindow, std::min(kSauvolaMaxWindow, window));
+  const int radius = window / 2;
+  const uint8_t* src = image->pixels.data();
+
+  std::vector<uint8_t> output(image->pixels.size());
+  std::vector<uint32_t> column_sum(width, 0);
+  std::vector<uint32_t> column_squares(width, 0);
+  auto add_row = [&](int y) {
+    const uint8_t* row = src + static_cast<size_t>(y) * width;
+    for (int x = 0; x < width; x++) {
+      column_sum[x] += row[x];
+      column_squares[x] += static_cast<uint32_t>(row[x]) * row[x];
+    }
+  };
+  auto remove_row = [&](int y) {
+    const uint8_t* row = src + static_cast<size_t>(y) * width;
+    for (int x = 0; x < width; x++) {
+      column_sum[x] -= row[x];
+      column_squares[x] -= static_cast<uint32_t>(row[x]) * row[x];
+    }
+  };
+  for (int y = 0; y < std::min(radius, height); y++) {
+    add_row(y);
+  }
+
+  for (int y = 0; y < height; y++) {
+    if (y + radius < height) {
+      add_row(y + radius);
+    }
+    if (y - radius - 1 >= 0) {
+      remove_row(y - radius - 1);
+    }
+    int rows = std::min(height - 1, y + radius) - std::max(0, y - radius) + 1;
+
+    uint32_t sum = 0;
+    uint32_t squares = 0;
+    for (int x = 0; x < std::min(radius, width); x++) {
+      sum += column_sum[x];
+      squares += column_squares[x];
+    }
+    const uint8_t* row = src + static_cast<size_t>(y) * width;
+    uint8_t* out = output.data() + static_cast<size_t>(y) * width;
+    for (int x = 0; x < width; x++) {
+      if (x + radius < width) {
+        sum += column_sum[x + radius];
+        squares += column_squares[x + radius];
+      }
+      if (x - radius - 1 >= 0) {
+        sum -= column_sum[x - radius - 1];
+        squares -= column_squares[x - radius - 1];
+      }
+      int columns =
+          std::min(width - 1, x + radius) - std::max(0, x - radius) + 1;
+      float count = static_cast<float>(rows * columns);
+      float mean = sum / count;
+      float variance = std::max(0.0f, squares / count - mean * mean);
+      float threshold =
+          mean * (1 + kSauvolaK * (std::sqrt(variance) / kSauvolaRange - 1));
+      out[x] = row[x] > threshold ? 255 : 0;
+    }
+  }
+  image->pixels.swap(output);
+}
+
+// 投影轮廓法：文本行与某一角度对齐时，沿该角度投影的行直方图起伏最大
+// 采样点按 step 隔行选取，直方图的行宽也取 step，避免空行造成的虚假起伏
+double projection_score(const std::vector<int>& xs, const std::vector<int>& ys,
+                        double degrees, int height, int width, int step,
+                        std::vector<uint32_t>* bins) {
+  double slope = std::tan(degrees * M_PI / 180);
+  int margin = static_cast<int>(std::ceil(std::fabs(slope) * width / step)) + 1;
+  bins->assign(height / step + 2 * margin + 1, 0);
+  for (size_t i = 0; i < xs.size(); i++) {
+    int bin =
+        static_cast<int>(std::lround((ys[i] - xs[i] * slope) / step)) + margin;
+    (*bins)[bin]++;
+  }
+  double score = 0;
+  for (size_t i = 1; i < bins->size(); i++) {
+    double diff = static_cast<double>((*bins)[i]) - (*bins)[i - 1];
+    score += diff * diff;
+  }
+  return score;
+}
+
+// 估计文本行的倾斜角：行方向为 y = y0 + x * tan(角度)
+double find_skew(const OcrGrayImage& image, int threshold) {
+  size_t foreground = 0;
+  for (uint8_t value : image.pixels) {
+    foreground += value <= threshold;
+  }
+  if (foreground < kMinSkewSamples) {
+    return 0;
+  }
+  int step = 1;
+  while (foreground / (static_cast<size_t>(step) * step) > kMaxSkewSamples) {
+    step++;
+  }
+  std::vector<int> xs;
+  std::vector<int> ys;
+  for (int y = 0; y < image.height; y += step) {
+    const uint8_t* row =
+        image.pixels.data() + static_cast<size_t>(y) * image.width;
+    for (int x = 0; x < image.width; x += step) {
+      if (row[x] <= threshold) {
+        xs.push_back(x);
+        ys.push_back(y);
+      }
+    }
+  }
+  if (xs.size() < kMinSkewSamples) {
+    return 0;
+  }
+
+  std::vector<uint32_t> bins;
+  auto search = [&](double from, double to, double step_degrees,
+                    double best) {
+    double best_score =
+        projection_score(xs, ys, best, image.height, image.width, step, &bins);
+    for (double degrees = from; degrees <= to + 1e-9; degrees += step_degrees) {
+      double score = projection_score(xs, ys, degrees, image.height,
+                                      image.width, step, &bins);
+      if (score > best_score) {
+        best_score = score;
+        best = degrees;
+      }
+    }
+    return best;
+  };
+  double coarse =
+      search(-kMaxSkewDegrees, kMaxSkewDegrees, kCoarseSkewStep, 0);
+  return search(coarse - kCoarseSkewStep, coarse + kCoarseSkewStep,
+                kFineSkewStep, coarse);
+}
+
+// 绕中心旋转校正倾斜，超出原图的部分填白；二值图旋转后重新取阈值
+void rotate(OcrGrayImage* image, double degrees, bool binary) {
+  const int width = image->width;
+  const int height = image->height;
+  const double radians = degrees * M_PI / 180;
+  const double cos_a = std::cos(radians);
+  const double sin_a = std::sin(radians);
+  const double cx = (width - 1) / 2.0;
+  const double cy = (height - 1) / 2.0;
+  const uint8_t* src = image->pixels.data();
+  auto at = [&](int x, int y) -> int {
+    return x < 0 || y < 0 || x >= width || y >= height
+               ? 255
+               : src[static_cast<size_t>(y) * width + x];
+  };
+
+  std::vector<uint8_t> output(image->pixels.size());
+  for (int v = 0; v < height; v++) {
+    uint8_t* out = output.data() + static_cast<size_t>(v) * width;
+    for (int u = 0; u < width; u++) {
+      double sx = cx + (u - cx) * cos_a - (v - cy) * sin_a;
+      double sy = cy + (u - cx) * sin_a + (v - cy) * cos_a;
+      int x0 = static_cast<int>(std::floor(sx));
+      int y0 = static_cast<int>(std::floor(sy));
+      double fx = sx - x0;
+      double fy = sy - y0;
+      double top = at(x0, y0) * (1 - fx) + at(x0 + 1, y0) * fx;
+      double bottom = at(x0, y0 + 1) * (1 - fx) + at(x0 + 1, y0 + 1) * fx;
+      int value = static_cast<int>(top * (1 - fy) + bottom * fy + 0.5);
+      out[u] = binary ? (value >= 128 ? 255 : 0) : static_cast<uint8_t>(value);
+    }
+  }
+  image->pixels.swap(output);
+}
+
+}  // namespace
+
+bool ocr_preprocess(const OcrImage& image, const OcrPreprocessOptions& options,
+                    const std::atomic<bool>& cancelled, OcrGrayImage* output,
+                    OcrPreprocessStats* stats) {
+  auto start = std::chrono::steady_clock::now();
+  output->width = image.width;
+  output->height = image.height;
+  output->pixels.resize(static_cast<size_t>(image.width) * image.height);
+  ocr_image_to_gray(image.pixels, image.width, image.height, image.rowstride,
+                    image.channels, output->pixels.data(), image.width);
+  stats->grayscale_ms = elapsed_ms(start);
+  stats->dpi = std::max(0, options.source_dpi);
+  if (cancelled.load()) {
+    return false;
+  }
+
+  double scale = choose_scale(image, options);
+  if (scale != 1) {
+    start = std::chrono::steady_clock::now();
+    rescale(output, scale);
+    stats->scale_ms = elapsed_ms(start);
+    stats->scale = scale;
+    stats->dpi = static_cast<int>(std::lround(options.source_dpi * scale));
+    if (cancelled.load()) {
+      return false;
+    }
+  }
+
+  if (options.binarize != OCR_BINARIZE_NONE) {
+    start = std::chrono::steady_clock::now();
+    if (options.binarize == OCR_BINARIZE_OTSU) {
+      binarize_otsu(output);
+    } else {
+      binarize_sauvola(output, stats->dpi);
+    }
+    stats->binarize_ms = elapsed_ms(start);
+    if (cancelled.load()) {
+      return false;
+    }
+  }
+
+  if (options.deskew) {
+    start = std::chrono::steady_clock::now();
+    bool binary = options.binarize != OCR_BINARIZE_NONE;
+    double skew =
+        find_skew(*output, binary ? 127 : otsu_threshold(output->pixels));
+    if (std::fabs(skew) >= kMinSkewDegrees) {
+      rotate(output, skew, binary);
+      stats->skew_degrees = skew;
+    }
+    stats->deskew_ms = elapsed_ms(start);
+  }
+  return !cancelled.load();
+}
@@ -0,0 +1,61 @@
+#ifndef CLIP_FLOW_OCR_PREPROCESS_H_
+#define CLIP_FLOW_OCR_PREPROCESS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "ocr_image.h"
+
+// 识别前的预处理：灰度化 → 缩放到目标分辨率 → 二值化 → 可选的倾斜校正。
+//
+// 截图本身通常不带分辨率，由调用方按显示器缩放比例估计 source_dpi。
+// Tesseract 的 LSTM 把文本行归一化到约 36 像素高，屏幕上 12pt 的文字在
+// 200 DPI 时正好接近该高度，因此默认以 200 DPI 为目标：更高分辨率的截图
+// 缩小后像素数成倍减少，识别随之变快；低分屏截图中的小字适度放大。
+// 各阶段分别计时，随识别结果上报。
+
+typedef enum {
+  OCR_BINARIZE_NONE,
+  // 全局阈值，适合背景均匀的截图
+  OCR_BINARIZE_OTSU,
+  // 局部自适应阈值，适合渐变背景与阴影
+  OCR_BINARIZE_SAUVOLA,
+} OcrBinarize;
+
+struct OcrPreprocessOptions {
+  bool enabled = false;
+  // 源图像分辨率（DPI），0 为未知，此时不缩放
+  int source_dpi = 0;
+  int target_dpi = 200;
+  OcrBinarize binarize = OCR_BINARIZE_SAUVOLA;
+  bool deskew = false;
+};
+
+struct OcrPreprocessStats {
+  // 各阶段耗时（毫秒），未执行的阶段为 0
+  double grayscale_ms = 0;
+  double scale_ms = 0;
+  double binarize_ms = 0;
+  double deskew_ms = 0;
+  // 实际缩放比例
+  double scale = 1;
+  // 缩放后的分辨率，0 为未知
+  int dpi = 0;
+  // 已校正的倾斜角（度）
+  double skew_degrees = 0;
+};
+
+// 预处理结果：8 位灰度（二值化后只有 0 与 255），行跨度等于宽度
+struct OcrGrayImage {
+  std::vector<uint8_t> pixels;
+  int width = 0;
+  int height = 0;
+};
+
+// 在工作线程执行预处理；阶段之间检查 cancelled，被取消时返回 false
+bool ocr_preprocess(const OcrImage& image, const OcrPreprocessOptions& options,
+                    const std::atomic<bool>& cancelled, OcrGrayImage* output,
+                    OcrPreprocessStats* stats);
+
+#endif  // CLIP_FLOW_OCR_PREPROCESS_H_
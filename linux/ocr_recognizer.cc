@@ -0,0 +1,395 @@
+#include "ocr_recognizer.h"
+
+#include <leptonica/allheaders.h>
+#include <tesseract/baseapi.h>
+#include <tesseract/ocrclass.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "ocr_text_detect.h"
+
+namespace {
+
+// 小于该像素数的图像单个引擎即可很快完成，不做版面分析
+constexpr int64_t kOcrParallelMinPixels = 2 * 1024 * 1024;
+
+// Tesseract 在识别每个词前调用，返回 true 即中止
+bool cancel_requested(void* cancel_this, int words) {
+  return static_cast<const std::atomic<bool>*>(cancel_this)->load();
+}
+
+bool is_supported(const OcrImage& image) {
+  return image.pixels != nullptr && image.width > 0 && image.height > 0 &&
+         (image.channels == 3 || image.channels == 4) &&
+         image.rowstride >= image.width * image.channels;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 交给引擎的像素。分块识别时多个引擎共享同一份只读像素
+struct EngineInput {
+  const uint8_t* data = nullptr;
+  int width = 0;
+  int height = 0;
+  int bytes_per_pixel = 0;
+  int stride = 0;
+  // 0 为未知
+  int dpi = 0;
+  // 相对原图的缩放比例，用于换算区域坐标
+  double scale = 1;
+};
+
+// 预处理后为灰度图；否则 RGB 与不透明的 RGBA 按原行跨度直接传入，
+// 带透明度的 RGBA 先合成到白色背景（写入 flattened）
+EngineInput prepare_input(const OcrImage& image, const OcrOptions& options,
+                          const OcrGrayImage& gray,
+                          const OcrPreprocessStats& stats,
+                          std::vector<uint8_t>* flattened) {
+  EngineInput input;
+  if (options.preprocess.enabled) {
+    input.data = gray.pixels.data();
+    input.width = gray.width;
+    input.height = gray.height;
+    input.bytes_per_pixel = 1;
+    input.stride = gray.width;
+    input.dpi = stats.dpi;
+    input.scale = stats.scale;
+    return input;
+  }
+  input.data = image.pixels;
+  input.width = image.width;
+  input.height = image.height;
+  input.bytes_per_pixel = image.channels;
+  input.stride = image.rowstride;
+  input.dpi = options.preprocess.source_dpi;
+  if (image.channels == 4 &&
+      ocr_image_has_transparency(image.pixels, image.width, image.height,
+                                 image.rowstride)) {
+    input.stride = image.width * 4;
+    flattened->resize(static_cast<size_t>(input.stride) * image.height);
+    ocr_image_flatten_alpha(image.pixels, image.width, image.height,
+                            image.rowstride, flattened->data(), input.stride);
+    input.data = flattened->data();
+  }
+  return input;
+}
+
+// SetImage 会把像素复制进引擎
+void set_input(tesseract::TessBaseAPI* ocr, const EngineInput& input) {
+  ocr->SetImage(input.data, input.width, input.height, input.bytes_per_pixel,
+                input.stride);
+  if (input.dpi > 0) {
+    ocr->SetSourceResolution(input.dpi);
+  }
+}
+
+// 截止时间为整个任务共用的绝对时间点
+struct Deadline {
+  bool enabled = false;
+  std::chrono::steady_clock::time_point at;
+
+  // 剩余毫秒数，至少为 1 以免被当作不限时
+  int remaining_ms() const {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        at - std::chrono::steady_clock::now());
+    return static_cast<int>(std::max<int64_t>(1, left.count()));
+  }
+  bool passed() const {
+    return enabled && std::chrono::steady_clock::now() >= at;
+  }
+};
+
+void init_monitor(tesseract::ETEXT_DESC* monitor,
+                  const std::atomic<bool>& cancelled,
+                  const Deadline& deadline) {
+  monitor->cancel = cancel_requested;
+  monitor->cancel_this =
+      const_cast<void*>(static_cast<const void*>(&cancelled));
+  if (deadline.enabled) {
+    monitor->set_deadline_msecs(deadline.remaining_ms());
+  }
+}
+
+// 版面分析：按 Tesseract 的阅读顺序返回文本块。
+// 池中引擎会被复用，分析完成后恢复原来的分割模式
+std::vector<OcrRegion> find_regions(tesseract::TessBaseAPI* ocr) {
+  std::vector<OcrRegion> regions;
+  tesseract::PageSegMode mode = ocr->GetPageSegMode();
+  ocr->SetPageSegMode(tesseract::PSM_AUTO_ONLY);
+  Boxa* boxes =
+      ocr->GetComponentImages(tesseract::RIL_BLOCK, true, nullptr, nullptr);
+  ocr->SetPageSegMode(mode);
+  if (boxes == nullptr) {
+    return regions;
+  }
+  for (l_int32 i = 0; i < boxaGetCount(boxes); i++) {
+    OcrRegion region;
+    if (boxaGetBoxGeometry(boxes, i, &region.x, &region.y, &region.width,
+                           &region.height) == 0 &&
+        region.width > 0 && region.height > 0) {
+      regions.push_back(region);
+    }
+  }
+  boxaDestroy(&boxes);
+  return regions;
+}
+
+// 多个引擎并行识别各区域；区域按序号领取，先空闲的引擎先领。
+// 调用线程使用已做完版面分析的 ocr，其余线程各自从池中借出引擎
+OcrStatus recognize_regions(const std::shared_ptr<OcrEnginePool>& engines,
+                            OcrEnginePool::Lease* ocr,
+                            const EngineInput& input,
+                            std::vector<OcrRegion>* regions,
+                            size_t parallelism,
+                            const std::atomic<bool>& cancelled,
+                            const Deadline& deadline, std::string* error) {
+  const size_t count = regions->size();
+  // 各线程只写自己领取的下标；不用 vector<bool>，其元素共享字节
+  std::vector<char> done(count, 0);
+  std::atomic<size_t> next(0);
+  std::atomic<bool> timed_out(false);
+  std::atomic<bool> stop(false);
+
+  auto work = [&](OcrEnginePool::Lease* lease, bool needs_input) {
+    try {
+      if (needs_input) {
+        set_input(lease->get(), input);
+      }
+      for (size_t i = next++; i < count && !stop.load(); i = next++) {
+        OcrRegion& region = (*regions)[i];
+        (*lease)->SetRectangle(region.x, region.y, region.width,
+                               region.height);
+        tesseract::ETEXT_DESC monitor;
+        init_monitor(&monitor, cancelled, deadline);
+        int recognized = (*lease)->Recognize(&monitor);
+        if (cancelled.load() ||
+            (deadline.enabled && monitor.deadline_exceeded())) {
+          timed_out.store(!cancelled.load());
+          stop.store(true);
+          return;
+        }
+        if (recognized != 0) {
+          // 该区域交还给其他引擎重试无意义，整体按失败处理
+          lease->discard();
+          stop.store(true);
+          return;
+        }
+        char* text = (*lease)->GetUTF8Text();
+        if (text == nullptr) {
+          stop.store(true);
+          return;
+        }
+        region.text = text;
+        delete[] text;
+        region.confidence = (*lease)->MeanTextConf() / 100.0;
+        done[i] = 1;
+      }
+    } catch (...) {
+      lease->discard();
+      stop.store(true);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  std::vector<OcrEnginePool::Lease> leases(parallelism - 1);
+  std::string languages = ocr->languages();
+  for (size_t t = 0; t + 1 < parallelism; t++) {
+    threads.emplace_back([&, t]() {
+      leases[t] = OcrEnginePool::acquire(engines, languages, nullptr);
+      if (leases[t]) {
+        work(&leases[t], true);
+      }
+    });
+  }
+  work(ocr, false);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (cancelled.load()) {
+    return OCR_STATUS_CANCELLED;
+  }
+  if (timed_out.load()) {
+    *error = "OCR deadline exceeded";
+    return OCR_STATUS_TIMEOUT;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (!done[i]) {
+      *error = "OCR recognition failed";
+      return OCR_STATUS_FAILED;
+    }
+  }
+  return OCR_STATUS_OK;
+}
+// 按区域顺序合并文本，置信度按各区域文本长度加权
+void merge_regions(const std::vector<OcrRegion>& regions, double scale,
+                   OcrOutput* output) {
+  double weighted = 0;
+  size_t characters = 0;
+  for (const OcrRegion& region : regions) {
+    size_t end = region.text.find_last_not_of(" \n");
+    if (end == std::string::npos) {
+      continue;
+    }
+    if (!output->text.empty()) {
+      output->text += "\n\n";
+    }
+    output->text.append(region.text, 0, end + 1);
+    weighted += region.confidence * (end + 1);
+    characters += end + 1;
+  }
+  if (!output->text.empty()) {
+    output->text += "\n";
+  }
+  output->confidence = characters > 0 ? weighted / characters : 0;
+
+  // 区域坐标换算回原图
+  output->regions = regions;
+  if (scale != 1) {
+    for (OcrRegion& region : output->regions) {
+      region.x = static_cast<int>(region.x / scale);
+      region.y = static_cast<int>(region.y / scale);
+      region.width = static_cast<int>(region.width / scale + 0.5);
+      region.height = static_cast<int>(region.height / scale + 0.5);
+    }
+  }
+}
+
+OcrStatus recognize(const std::shared_ptr<OcrEnginePool>& engines,
+                    const OcrImage& image, const OcrOptions& options,
+                    const std::atomic<bool>& cancelled, OcrOutput* output) {
+  if (!is_supported(image)) {
+    output->error = "Unsupported image format";
+    return OCR_STATUS_IMAGE_ERROR;
+  }
+  if (options.text_threshold > 0) {
+    OcrTextEstimate estimate;
+    ocr_estimate_text(image, &estimate);
+    output->text_score = estimate.score;
+    output->prefilter_ms = estimate.elapsed_ms;
+    // 小图的预判不可靠，照常识别，代价也低
+    if (estimate.conclusive && estimate.score < options.text_threshold) {
+      output->skipped = true;
+      return OCR_STATUS_OK;
+    }
+  }
+  Deadline deadline;
+  deadline.enabled = options.deadline_ms > 0;
+  deadline.at = std::chrono::steady_clock::now() +
+                std::chrono::milliseconds(options.deadline_ms);
+
+  // 预处理在借出引擎之前进行，不占用池中的引擎
+  OcrGrayImage gray;
+  if (options.preprocess.enabled &&
+      !ocr_preprocess(image, options.preprocess, cancelled, &gray,
+                      &output->preprocess)) {
+    return OCR_STATUS_CANCELLED;
+  }
+  std::vector<uint8_t> flattened;
+  EngineInput input =
+      prepare_input(image, options, gray, output->preprocess, &flattened);
+
+  OcrEnginePool::Lease ocr =
+      OcrEnginePool::acquire(engines, options.languages, &output->error);
+  if (!ocr && options.languages != kOcrFallbackLanguages) {
+    ocr = OcrEnginePool::acquire(engines, kOcrFallbackLanguages, &output->error);
+    if (ocr) {
+      // 缓存按请求的语言查找，需知道它实际对应哪个模型
+      engines->record_fallback(options.languages, ocr.languages());
+    }
+  }
+  if (!ocr) {
+    return OCR_STATUS_ENGINE_ERROR;
+  }
+  output->languages = ocr.languages();
+  output->model_stamp = ocr.model_stamp();
+  if (cancelled.load()) {
+    return OCR_STATUS_CANCELLED;
+  }
+  set_input(ocr.get(), input);
+
+  // 大图先做版面分析，多于一个文本块时分块并行识别
+  size_t parallelism = std::min<size_t>(
+      std::max(1, options.parallelism),
+      std::max(1u, std::thread::hardware_concurrency()));
+  if (parallelism > 1 &&
+      static_cast<int64_t>(input.width) * input.height >=
+          kOcrParallelMinPixels) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<OcrRegion> regions = find_regions(ocr.get());
+    output->layout_ms = elapsed_ms(start);
+    if (cancelled.load()) {
+      return OCR_STATUS_CANCELLED;
+    }
+    if (deadline.passed()) {
+      output->error = "OCR deadline exceeded";
+      return OCR_STATUS_TIMEOUT;
+    }
+    if (regions.size() > 1) {
+      start = std::chrono::steady_clock::now();
+      OcrStatus status = recognize_regions(
+          engines, &ocr, input, &regions,
+          std::min(parallelism, regions.size()), cancelled, deadline,
+          &output->error);
+      output->recognize_ms = elapsed_ms(start);
+      if (status == OCR_STATUS_OK) {
+        merge_regions(regions, input.scale, output);
+      }
+      return status;
+    }
+    // 清除版面分析结果，按引擎原来的分割模式识别整图
+    ocr->SetRectangle(0, 0, input.width, input.height);
+  }
+
+  tesseract::ETEXT_DESC monitor;
+  init_monitor(&monitor, cancelled, deadline);
+  auto start = std::chrono::steady_clock::now();
+  int recognized = ocr->Recognize(&monitor);
+  output->recognize_ms = elapsed_ms(start);
+  if (cancelled.load()) {
+    return OCR_STATUS_CANCELLED;
+  }
+  if (deadline.enabled && monitor.deadline_exceeded()) {
+    output->error = "OCR deadline exceeded";
+    return OCR_STATUS_TIMEOUT;
+  }
+  if (recognized != 0) {
+    // 识别失败后的引擎状态不可信，不再放回池中
+    ocr.discard();
+    output->error = "OCR recognition failed";
+    return OCR_STATUS_FAILED;
+  }
+
+  char* text = ocr->GetUTF8Text();
+  if (text == nullptr) {
+    output->error = "OCR recognition failed";
+    return OCR_STATUS_FAILED;
+  }
+  output->text = text;
+  delete[] text;
+  output->confidence = ocr->MeanTextConf() / 100.0;
+  return OCR_STATUS_OK;
+}
+
+}  // namespace
+
+OcrStatus ocr_recognize(const std::shared_ptr<OcrEnginePool>& engines,
+                        const OcrImage& image, const OcrOptions& options,
+                        const std::atomic<bool>& cancelled, OcrOutput* output) {
+  try {
+    return recognize(engines, image, options, cancelled, output);
+  } catch (const std::exception& e) {
+    output->error = "OCR failed: " + std::string(e.what());
+  } catch (...) {
+    output->error = "Unknown OCR error occurred";
+  }
+  return OCR_STATUS_FAILED;
+}
@@ -0,0 +1,90 @@
+#ifndef CLIP_FLOW_OCR_RECOGNIZER_H_
+#define CLIP_FLOW_OCR_RECOGNIZER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ocr_engine_pool.h"
+#include "ocr_image.h"
+#include "ocr_preprocess.h"
+
+// 在工作线程执行的 OCR 识别。
+//
+// 引擎从 OcrEnginePool 借出，识别经 Tesseract 的 ETEXT_DESC 监视器进行：
+// 取消标志与截止时间在识别过程中被轮询，被取消或超时的任务尽快退出，
+// 不再占用引擎与 CPU。启用预处理时，预处理在借出引擎之前完成。
+//
+// 大图可分块并行：先以一个引擎做版面分析得到各文本块，再由多个引擎
+// 同时识别不同的块（共享同一份像素，各自 SetRectangle），按阅读顺序合并。
+//
+// 给出 text_threshold 时先做文字存在性预判（见 ocr_text_detect.h），
+// 判定不含文字的图像不经预处理与识别，直接返回空文本；预判不足以下结论
+// 的小图照常识别。
+
+typedef enum {
+  OCR_STATUS_OK,
+  OCR_STATUS_CANCELLED,
+  OCR_STATUS_TIMEOUT,
+  // 引擎初始化失败（语言包缺失等）
+  OCR_STATUS_ENGINE_ERROR,
+  // 像素格式不受支持
+  OCR_STATUS_IMAGE_ERROR,
+  OCR_STATUS_FAILED,
+} OcrStatus;
+
+struct OcrOptions {
+  // Tesseract 语言组合，如 "eng+chi_sim"；无法加载时退回英文
+  std::string languages = "eng";
+  // 识别截止时间（毫秒），0 为不限
+  int deadline_ms = 0;
+  OcrPreprocessOptions preprocess;
+  // 大图分块并行识别的最大引擎数，1 为不分块
+  int parallelism = 1;
+  // 文字可能性（0~1）低于该值时跳过识别，0 为不预判
+  double text_threshold = 0;
+};
+
+// 分块识别时的一个文本区域（原图坐标）
+struct OcrRegion {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+  std::string text;
+  // 置信度 0~1
+  double confidence = 0;
+};
+
+struct OcrOutput {
+  std::string text;
+  // 平均置信度 0~1
+  double confidence = 0;
+  // 实际使用的语言组合
+  std::string languages;
+  // 所用引擎的模型标识（见 OcrEnginePool::model_stamp）
+  uint64_t model_stamp = 0;
+  // 结果来自 OcrCache
+  bool cached = false;
+  // 预判不含文字而未识别
+  bool skipped = false;
+  // 预判的文字可能性，未预判时为 -1
+  double text_score = -1;
+  double prefilter_ms = 0;
+  // 预处理各阶段与识别本身的耗时
+  OcrPreprocessStats preprocess;
+  double layout_ms = 0;
+  double recognize_ms = 0;
+  // 分块识别的各区域，按阅读顺序；整图识别时为空
+  std::vector<OcrRegion> regions;
+  std::string error;
+};
+
+// 阻塞识别（须在工作线程调用）
+OcrStatus ocr_recognize(const std::shared_ptr<OcrEnginePool>& engines,
+                        const OcrImage& image, const OcrOptions& options,
+                        const std::atomic<bool>& cancelled, OcrOutput* output);
+
+#endif  // CLIP_FLOW_OCR_RECOGNIZER_H_
@@ -0,0 +1,156 @@
+#include "ocr_text_detect.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// 采样行数上限：行距不超过约 1/500 图高，才能落在文本行之间的空隙里
+constexpr int kMaxSampledRows = 540;
+constexpr int kSegmentWidth = 128;
+// 相邻像素亮度差达到该值计为边缘（抗锯齿文字的笔画边缘远高于此）
+constexpr int kEdgeThreshold = 48;
+// 分段内不超过该边缘数的行视为空白
+constexpr int kQuietEdges = 1;
+// 文本行高度范围（像素）
+constexpr int kMinLineHeight = 6;
+constexpr int kMaxLineHeight = 100;
+// 文本行平均每行的边缘密度范围（每像素）
+constexpr double kMinLineDensity = 0.05;
+constexpr double kMaxLineDensity = 0.6;
+// 文本行内相邻采样行之间的垂直边缘密度下限
+constexpr double kMinLineVerticalDensity = 0.02;
+// 达到该数量的文本行分段即视为确定含文字；照片通常不超过 1 个
+constexpr double kConfidentSegments = 8;
+// 估计图像能容纳多少文本行时假定的行距（像素）
+constexpr int kTypicalLinePitch = 32;
+
+int count_edges_scalar(const uint8_t* a, const uint8_t* b, int length) {
+  int count = 0;
+  for (int x = 0; x < length; ++x) {
+    int diff = a[x] - b[x];
+    if (diff >= kEdgeThreshold || -diff >= kEdgeThreshold) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+// 统计 a[i] 与 b[i] 亮度差达到阈值的位置数（i < length）
+int count_edges(const uint8_t* a, const uint8_t* b, int length) {
+#if defined(__SSE2__)
+  const __m128i threshold = _mm_set1_epi8(kEdgeThreshold - 1);
+  const __m128i zero = _mm_setzero_si128();
+  int count = 0;
+  int x = 0;
+  for (; x + 16 <= length; x += 16) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x));
+    __m128i diff = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+    // 差值不足阈值的字节饱和减为 0
+    __m128i weak = _mm_cmpeq_epi8(_mm_subs_epu8(diff, threshold), zero);
+    count += 16 - __builtin_popcount(_mm_movemask_epi8(weak));
+  }
+  return count + count_edges_scalar(a + x, b + x, length - x);
+#else
+  return count_edges_scalar(a, b, length);
+#endif
+}
+
+}  // namespace
+
+void ocr_estimate_text(const OcrImage& image, OcrTextEstimate* estimate) {
+  auto start = std::chrono::steady_clock::now();
+  *estimate = OcrTextEstimate();
+  int width = image.width;
+  int height = image.height;
+  if (width < 2 || height < kMinLineHeight) {
+    return;
+  }
+
+  int step = std::max(1, (height + kMaxSampledRows - 1) / kMaxSampledRows);
+  int rows = (height + step - 1) / step;
+  int segments = (width - 1 + kSegmentWidth - 1) / kSegmentWidth;
+  // 每个采样行每个分段的水平边缘数（相邻像素）与垂直边缘数（与上一采样行）
+  std::vector<uint8_t> gray(width);
+  std::vector<uint8_t> previous(width);
+  std::vector<uint16_t> edges(static_cast<size_t>(rows) * segments);
+  std::vector<uint16_t> vertical_edges(static_cast<size_t>(rows) * segments);
+  for (int r = 0; r < rows; ++r) {
+    ocr_image_to_gray(image.pixels + static_cast<size_t>(r) * step *
+                                         image.rowstride,
+                      width, 1, image.rowstride, image.channels, gray.data(),
+                      width);
+    for (int s = 0; s < segments; ++s) {
+      int x = s * kSegmentWidth;
+      int length = std::min(kSegmentWidth, width - 1 - x);
+      size_t index = static_cast<size_t>(r) * segments + s;
+      edges[index] = static_cast<uint16_t>(
+          count_edges(gray.data() + x, gray.data() + x + 1, length));
+      if (r > 0) {
+        vertical_edges[index] = static_cast<uint16_t>(
+            count_edges(gray.data() + x, previous.data() + x, length));
+      }
+    }
+    gray.swap(previous);
+  }
+
+  // 逐列分段寻找被空白行或图像边界夹住的边缘密集条带。
+  // 只含一行字的裁剪图中文字常贴着上下边界，边界同样视为条带的端点
+  int min_rows = std::max(2, kMinLineHeight / step);
+  int max_rows = std::max(min_rows, kMaxLineHeight / step);
+  long long line_pixels = 0;
+  for (int s = 0; s < segments; ++s) {
+    int length = std::min(kSegmentWidth, width - 1 - s * kSegmentWidth);
+    int run_start = 0;
+    int run_edges = 0;
+    int run_vertical_edges = 0;
+    // r == rows 为图像下边界，结束最后一个条带
+    for (int r = 0; r <= rows; ++r) {
+      size_t index = static_cast<size_t>(r) * segments + s;
+      int count = r < rows ? edges[index] : 0;
+      if (count > kQuietEdges) {
+        // 条带首行与上方空白行的差异不计入
+        if (r > run_start) {
+          run_vertical_edges += vertical_edges[index];
+        }
+        run_edges += count;
+        continue;
+      }
+      int run_rows = r - run_start;
+      if (run_rows >= min_rows && run_rows <= max_rows) {
+        double density = static_cast<double>(run_edges) / run_rows / length;
+        // 字形逐行变化；逐行相同的竖线（表格、网格）没有垂直边缘
+        double vertical_density =
+            static_cast<double>(run_vertical_edges) / (run_rows - 1) / length;
+        if (density >= kMinLineDensity && density <= kMaxLineDensity &&
+            vertical_density >= kMinLineVerticalDensity) {
+          ++estimate->line_segments;
+          line_pixels += static_cast<long long>(run_rows) * step * length;
+        }
+      }
+      run_start = r + 1;
+      run_edges = 0;
+      run_vertical_edges = 0;
+    }
+  }
+
+  // 按图像能容纳的文本行分段数归一化：一行字的小裁剪图只有一两个分段，
+  // 全部命中即可得满分；容纳不下 kConfidentSegments 个分段的图像，
+  // 找不到文本行也不足以断定没有文字
+  double expected = static_cast<double>(segments) *
+                    std::max(1, height / kTypicalLinePitch);
+  estimate->conclusive = expected >= kConfidentSegments;
+  estimate->coverage = static_cast<double>(line_pixels) /
+                       (static_cast<double>(width) * height);
+  estimate->score = std::min(
+      1.0, estimate->line_segments / std::min(kConfidentSegments, expected));
+  estimate->elapsed_ms = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+}
@@ -0,0 +1,30 @@
+#ifndef CLIP_FLOW_OCR_TEXT_DETECT_H_
+#define CLIP_FLOW_OCR_TEXT_DETECT_H_
+
+#include "ocr_image.h"
+
+// 识别前的文字存在性预判，用于跳过照片、图标等不含文字的图片。
+//
+// 每隔若干行取一行转为灰度，按 128 像素宽的分段统计相邻像素的强边缘数
+// （SSE2 一次比较 16 个像素）。文字行在分段内表现为边缘密集、且上下被
+// 几乎没有边缘的空白行（或图像边界）夹住、高度与字号相当的一段；照片的
+// 纹理要么边缘稀疏，要么连成大片，很少形成这样的条带。
+// 得分按图像能容纳的文本行数归一化，只有一行字的小裁剪图也能得到高分。
+// 只读取约 500 行，千万像素的截图也只需几毫秒。
+
+struct OcrTextEstimate {
+  // 含文字的可能性 0~1
+  double score = 0;
+  // 疑似文本行的分段数
+  int line_segments = 0;
+  // 疑似文本行覆盖的面积占比
+  double coverage = 0;
+  // 图像是否大到足以据此判定不含文字；为 false 时低分不应跳过识别
+  bool conclusive = false;
+  double elapsed_ms = 0;
+};
+
+// 估计 image 是否含文字（可在任意线程调用）
+void ocr_estimate_text(const OcrImage& image, OcrTextEstimate* estimate);
+
+#endif  // CLIP_FLOW_OCR_TEXT_DETECT_H_
@@ -0,0 +1,189 @@
+#include "perceptual_hash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "image_scale.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CLIP_FLOW_PERCEPTUAL_HASH_AVX2 1
+#endif
+
+namespace {
+
+constexpr uint32_t kSampleSize = 32;
+constexpr uint32_t kHashSize = 8;
+
+// DCT-II 基函数表：values[n][k] = cos((2n + 1) k π / 2N)，只需前 8 个频率。
+// 按采样点存放，一个采样点的 8 个频率连续，便于按频率并行累加
+struct DctTable {
+  alignas(32) float values[kSampleSize][kHashSize];
+
+  DctTable() {
+    for (uint32_t n = 0; n < kSampleSize; n++) {
+      for (uint32_t k = 0; k < kHashSize; k++) {
+        values[n][k] = static_cast<float>(
+            std::cos((2.0 * n + 1.0) * k * M_PI / (2.0 * kSampleSize)));
+      }
+    }
+  }
+};
+
+const DctTable& dct_table() {
+  static const DctTable table;
+  return table;
+}
+
+// 一维 DCT 的前 8 个系数：out[k] = Σ input[n * step] * table[n][k]。
+// 各路径都按 n 递增的顺序对每个 k 做乘加（向量化在 k 方向），x86 上
+// AVX2 与 SSE2 的结果逐位一致，有无 AVX2 的机器对同一张图得到相同的哈希。
+#if !defined(__SSE2__)
+void dct_8_scalar(const float* input, size_t step, const DctTable& table,
+                  float* out) {
+  float sum[kHashSize] = {};
+  for (uint32_t n = 0; n < kSampleSize; n++) {
+    float x = input[n * step];
+    for (uint32_t k = 0; k < kHashSize; k++) {
+      sum[k] += x * table.values[n][k];
+    }
+  }
+  std::copy_n(sum, kHashSize, out);
+}
+#else
+void dct_8_sse2(const float* input, size_t step, const DctTable& table,
+                float* out) {
+  __m128 low = _mm_setzero_ps();
+  __m128 high = _mm_setzero_ps();
+  for (uint32_t n = 0; n < kSampleSize; n++) {
+    __m128 x = _mm_set1_ps(input[n * step]);
+    low = _mm_add_ps(low, _mm_mul_ps(x, _mm_load_ps(table.values[n])));
+    high = _mm_add_ps(high, _mm_mul_ps(x, _mm_load_ps(table.values[n] + 4)));
+  }
+  _mm_storeu_ps(out, low);
+  _mm_storeu_ps(out + 4, high);
+}
+#endif
+
+#if defined(CLIP_FLOW_PERCEPTUAL_HASH_AVX2)
+// 乘与加分开做（不用 FMA），舍入与其他路径相同
+__attribute__((target("avx2"))) void dct_8_avx2(const float* input,
+                                                size_t step,
+                                                const DctTable& table,
+                                                float* out) {
+  __m256 sum = _mm256_setzero_ps();
+  for (uint32_t n = 0; n < kSampleSize; n++) {
+    __m256 x = _mm256_set1_ps(input[n * step]);
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(x, _mm256_load_ps(table.values[n])));
+  }
+  _mm256_storeu_ps(out, sum);
+}
+
+bool cpu_has_avx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+#endif
+
+void dct_8(const float* input, size_t step, const DctTable& table,
+           float* out) {
+#if defined(CLIP_FLOW_PERCEPTUAL_HASH_AVX2)
+  if (cpu_has_avx2()) {
+    dct_8_avx2(input, step, table, out);
+    return;
+  }
+#endif
+#if defined(__SSE2__)
+  dct_8_sse2(input, step, table, out);
+#else
+  dct_8_scalar(input, step, table, out);
+#endif
+}
+
+// 将 32x32 RGB(A) 转为灰度（BT.601 整数系数），透明部分按白底合成
+void to_grayscale(const uint8_t* pixels, size_t stride, int channels,
+                  float* gray) {
+  for (uint32_t y = 0; y < kSampleSize; y++) {
+    const uint8_t* row = pixels + y * stride;
+    for (uint32_t x = 0; x < kSampleSize; x++) {
+      const uint8_t* p = row + x * channels;
+      uint32_t luma = (77u * p[0] + 150u * p[1] + 29u * p[2]) >> 8;
+      if (channels == 4) {
+        uint32_t alpha = p[3];
+        luma = (luma * alpha + 255u * (255u - alpha) + 127u) / 255u;
+      }
+      gray[y * kSampleSize + x] = static_cast<float>(luma);
+    }
+  }
+}
+
+}  // namespace
+
+bool perceptual_hash(const uint8_t* pixels, uint32_t width, uint32_t height,
+                     size_t stride, int channels, uint64_t* out) {
+  if (pixels == nullptr || out == nullptr || width == 0 || height == 0 ||
+      (channels != 3 && channels != 4)) {
+    return false;
+  }
+
+  // 缩小到 32x32；不足 32 像素的边按最近邻放大
+  const size_t sample_stride = kSampleSize * channels;
+  std::vector<uint8_t> sample(sample_stride * kSampleSize);
+  if (width >= kSampleSize && height >= kSampleSize) {
+    if (!image_downscale_area(pixels, width, height, stride, channels,
+                              sample.data(), kSampleSize, kSampleSize,
+                              sample_stride)) {
+      return false;
+    }
+  } else {
+    for (uint32_t y = 0; y < kSampleSize; y++) {
+      const uint8_t* src_row = pixels + (y * height / kSampleSize) * stride;
+      for (uint32_t x = 0; x < kSampleSize; x++) {
+        std::copy_n(src_row + (x * width / kSampleSize) * channels, channels,
+                    sample.data() + y * sample_stride + x * channels);
+      }
+    }
+  }
+
+  float gray[kSampleSize * kSampleSize];
+  to_grayscale(sample.data(), sample_stride, channels, gray);
+
+  // 可分离 DCT：先对每行求前 8 个系数，再对列求前 8 个系数
+  const DctTable& table = dct_table();
+  float rows[kSampleSize][kHashSize];
+  for (uint32_t y = 0; y < kSampleSize; y++) {
+    dct_8(gray + y * kSampleSize, 1, table, rows[y]);
+  }
+  // 列变换的结果先按 [u][v] 存放，再转置为 [v][u]
+  float columns[kHashSize][kHashSize];
+  for (uint32_t u = 0; u < kHashSize; u++) {
+    dct_8(&rows[0][u], kHashSize, table, columns[u]);
+  }
+  float coefficients[kHashSize * kHashSize];
+  for (uint32_t v = 0; v < kHashSize; v++) {
+    for (uint32_t u = 0; u < kHashSize; u++) {
+      coefficients[v * kHashSize + u] = columns[u][v];
+    }
+  }
+
+  // 以中位数为阈值，高于中位数的系数置 1
+  float sorted[kHashSize * kHashSize];
+  std::copy_n(coefficients, kHashSize * kHashSize, sorted);
+  const size_t middle = kHashSize * kHashSize / 2;
+  std::nth_element(sorted, sorted + middle, sorted + kHashSize * kHashSize);
+  float median = sorted[middle];
+
+  uint64_t hash = 0;
+  for (uint32_t i = 0; i < kHashSize * kHashSize; i++) {
+    if (coefficients[i] > median) {
+      hash |= 1ULL << i;
+    }
+  }
+  *out = hash;
+  return true;
+}
@@ -0,0 +1,20 @@
+#ifndef CLIP_FLOW_PERCEPTUAL_HASH_H_
+#define CLIP_FLOW_PERCEPTUAL_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// 图像感知哈希（pHash），用于识别重新压缩、轻微缩放或裁剪后的同一张图。
+// 图像先面积平均缩小到 32x32（SSE2，见 image_scale.h）并转为灰度，
+// 取二维 DCT（SSE2/AVX2）左上角 8x8 的低频系数，与其中位数比较得到 64 位哈希。
+
+// 8 位 RGB（channels = 3）或 RGBA（channels = 4）图像；透明像素按白底合成
+bool perceptual_hash(const uint8_t* pixels, uint32_t width, uint32_t height,
+                     size_t stride, int channels, uint64_t* out);
+
+// 两个哈希的汉明距离（0..64），越小越相似
+inline int perceptual_hash_distance(uint64_t a, uint64_t b) {
+  return __builtin_popcountll(a ^ b);
+}
+
+#endif  // CLIP_FLOW_PERCEPTUAL_HASH_H_
@@ -0,0 +1,314 @@
+#include "png_encoder.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// 每个条带至少包含的原始字节数，过小的条带线程开销大于收益
+constexpr size_t kMinBandBytes = 256 * 1024;
+constexpr unsigned kMaxThreads = 8;
+// 单个 IDAT 块的最大长度
+constexpr size_t kMaxIdatBytes = 8 * 1024 * 1024;
+
+constexpr uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a,
+                                      '\n'};
+
+enum RowFilter : uint8_t {
+  FILTER_NONE = 0,
+  FILTER_SUB = 1,
+  FILTER_UP = 2,
+  FILTER_AVERAGE = 3,
+  FILTER_PAETH = 4,
+};
+
+struct ProfileSettings {
+  int level;
+  bool adaptive_filter;
+};
+
+ProfileSettings settings_for_profile(PngEncodeProfile profile) {
+  switch (profile) {
+    case PNG_ENCODE_FAST:
+      return {1, false};
+    case PNG_ENCODE_SMALL:
+      return {9, true};
+    case PNG_ENCODE_BALANCED:
+    default:
+      return {3, true};
+  }
+}
+
+inline uint8_t paeth_predictor(int a, int b, int c) {
+  int p = a + b - c;
+  int pa = std::abs(p - a);
+  int pb = std::abs(p - b);
+  int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) {
+    return static_cast<uint8_t>(a);
+  }
+  return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+// 对一行应用指定过滤器；prev 为上一行（首行时为 nullptr）
+void filter_row(RowFilter filter, const uint8_t* row, const uint8_t* prev,
+                size_t length, int bpp, uint8_t* out) {
+  switch (filter) {
+    case FILTER_NONE:
+      std::memcpy(out, row, length);
+      break;
+    case FILTER_SUB:
+      for (size_t i = 0; i < length; i++) {
+        uint8_t left = i >= static_cast<size_t>(bpp) ? row[i - bpp] : 0;
+        out[i] = static_cast<uint8_t>(row[i] - left);
+      }
+      break;
+    case FILTER_UP:
+      for (size_t i = 0; i < length; i++) {
+        out[i] = static_cast<uint8_t>(row[i] - (prev != nullptr ? prev[i] : 0));
+      }
+      break;
+    case FILTER_AVERAGE:
+      for (size_t i = 0; i < length; i++) {
+        int left = i >= static_cast<size_t>(bpp) ? row[i - bpp] : 0;
+        int up = prev != nullptr ? prev[i] : 0;
+        out[i] = static_cast<uint8_t>(row[i] - ((left + up) >> 1));
+      }
+      break;
+    case FILTER_PAETH:
+      for (size_t i = 0; i < length; i++) {
+        int left = i >= static_cast<size_t>(bpp) ? row[i - bpp] : 0;
+        int up = prev != nullptr ? prev[i] : 0;
+        int up_left =
+            prev != nullptr && i >= static_cast<size_t>(bpp) ? prev[i - bpp] : 0;
+        out[i] = static_cast<uint8_t>(row[i] - paeth_predictor(left, up, up_left));
+      }
+      break;
+  }
+}
+
+// libpng 的启发式：选择有符号残差绝对值之和最小的过滤器
+uint64_t filtered_cost(const uint8_t* data, size_t length) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < length; i++) {
+    sum += data[i] < 128 ? data[i] : 256 - data[i];
+  }
+  return sum;
+}
+
+struct Band {
+  uint32_t first_row = 0;
+  uint32_t row_count = 0;
+  bool last = false;
+  std::vector<uint8_t> deflated;
+  uLong adler = 1;
+  size_t filtered_length = 0;
+  bool ok = false;
+};
+
+void encode_band(const uint8_t* pixels, size_t stride, size_t row_bytes,
+                 int bpp, const ProfileSettings& settings, Band* band) {
+  const size_t line_bytes = row_bytes + 1;
+  std::vector<uint8_t> filtered(line_bytes * band->row_count);
+  std::vector<uint8_t> candidate(settings.adaptive_filter ? row_bytes : 0);
+
+  for (uint32_t r = 0; r < band->row_count; r++) {
+    uint32_t y = band->first_row + r;
+    const uint8_t* row = pixels + static_cast<size_t>(y) * stride;
+    // 条带首行同样以原图中的上一行为参照，与整图串行过滤结果一致
+    const uint8_t* prev = y > 0 ? row - stride : nullptr;
+    uint8_t* line = filtered.data() + r * line_bytes;
+
+    if (!settings.adaptive_filter) {
+      line[0] = FILTER_UP;
+      filter_row(FILTER_UP, row, prev, row_bytes, bpp, line + 1);
+      continue;
+    }
+
+    uint64_t best_cost = UINT64_MAX;
+    for (uint8_t f = FILTER_NONE; f <= FILTER_PAETH; f++) {
+      RowFilter filter = static_cast<RowFilter>(f);
+      filter_row(filter, row, prev, row_bytes, bpp, candidate.data());
+      uint64_t cost = filtered_cost(candidate.data(), row_bytes);
+      if (cost < best_cost) {
+        best_cost = cost;
+        line[0] = f;
+        std::memcpy(line + 1, candidate.data(), row_bytes);
+      }
+    }
+  }
+
+  band->filtered_length = filtered.size();
+  band->adler = adler32(adler32(0L, Z_NULL, 0), filtered.data(),
+                        static_cast<uInt>(filtered.size()));
+
+  // 原始 deflate 流（无 zlib 头尾），便于各条带直接拼接
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (deflateInit2(&stream, settings.level, Z_DEFLATED, -15, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return;
+  }
+  band->deflated.resize(deflateBound(&stream, filtered.size()) + 16);
+  stream.next_in = filtered.data();
+  stream.avail_in = static_cast<uInt>(filtered.size());
+  stream.next_out = band->deflated.data();
+  stream.avail_out = static_cast<uInt>(band->deflated.size());
+
+  // 非末尾条带以同步刷新结束：输出按字节对齐且不含结束块
+  int flush = band->last ? Z_FINISH : Z_SYNC_FLUSH;
+  int status = Z_OK;
+  for (;;) {
+    status = deflate(&stream, flush);
+    bool done = band->last ? status == Z_STREAM_END
+                           : status == Z_OK && stream.avail_out > 0;
+    if (done || (status != Z_OK && status != Z_BUF_ERROR)) {
+      break;
+    }
+    size_t used = band->deflated.size() - stream.avail_out;
+    band->deflated.resize(band->deflated.size() * 2);
+    stream.next_out = band->deflated.data() + used;
+    stream.avail_out = static_cast<uInt>(band->deflated.size() - used);
+  }
+  band->deflated.resize(band->deflated.size() - stream.avail_out);
+  deflateEnd(&stream);
+  band->ok = band->last ? status == Z_STREAM_END : status == Z_OK;
+}
+
+void append_be32(std::vector<uint8_t>* out, uint32_t value) {
+  out->push_back(static_cast<uint8_t>(value >> 24));
+  out->push_back(static_cast<uint8_t>(value >> 16));
+  out->push_back(static_cast<uint8_t>(value >> 8));
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+void append_chunk(std::vector<uint8_t>* out, const char type[4],
+                  const uint8_t* data, size_t length) {
+  append_be32(out, static_cast<uint32_t>(length));
+  size_t type_offset = out->size();
+  out->insert(out->end(), type, type + 4);
+  if (length > 0) {
+    out->insert(out->end(), data, data + length);
+  }
+  uLong crc = crc32(0L, out->data() + type_offset,
+                    static_cast<uInt>(length + 4));
+  append_be32(out, static_cast<uint32_t>(crc));
+}
+
+}  // namespace
+
+bool png_encode_profile_from_name(const char* name,
+                                  PngEncodeProfile* profile) {
+  if (name == nullptr) {
+    return false;
+  }
+  if (std::strcmp(name, "fast") == 0) {
+    *profile = PNG_ENCODE_FAST;
+  } else if (std::strcmp(name, "balanced") == 0) {
+    *profile = PNG_ENCODE_BALANCED;
+  } else if (std::strcmp(name, "small") == 0) {
+    *profile = PNG_ENCODE_SMALL;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool png_encode(const uint8_t* pixels, uint32_t width, uint32_t height,
+                size_t stride, int channels, PngEncodeProfile profile,
+                std::vector<uint8_t>* out, unsigned max_threads) {
+  if (pixels == nullptr || out == nullptr || width == 0 || height == 0 ||
+      (channels != 3 && channels != 4)) {
+    return false;
+  }
+  const size_t row_bytes = static_cast<size_t>(width) * channels;
+  if (stride < row_bytes) {
+    return false;
+  }
+  const ProfileSettings settings = settings_for_profile(profile);
+
+  unsigned threads = max_threads > 0 ? max_threads
+                                     : std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(threads, kMaxThreads);
+  const size_t total_bytes = row_bytes * height;
+  threads = static_cast<unsigned>(std::min<size_t>(
+      threads, std::max<size_t>(1, total_bytes / kMinBandBytes)));
+  threads = std::min(threads, height);
+
+  std::vector<Band> bands(threads);
+  uint32_t rows_per_band = (height + threads - 1) / threads;
+  for (unsigned i = 0; i < threads; i++) {
+    bands[i].first_row = std::min(height, i * rows_per_band);
+    bands[i].row_count =
+        std::min(height, bands[i].first_row + rows_per_band) - bands[i].first_row;
+  }
+  // 行数不能整除时末尾可能出现空条带
+  while (bands.size() > 1 && bands.back().row_count == 0) {
+    bands.pop_back();
+  }
+  bands.back().last = true;
+
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < bands.size(); i++) {
+    workers.emplace_back(encode_band, pixels, stride, row_bytes, channels,
+                         std::cref(settings), &bands[i]);
+  }
+  encode_band(pixels, stride, row_bytes, channels, settings, &bands[0]);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  size_t deflated_size = 0;
+  uLong adler = bands[0].adler;
+  for (size_t i = 0; i < bands.size(); i++) {
+    if (!bands[i].ok) {
+      return false;
+    }
+    deflated_size += bands[i].deflated.size();
+    if (i > 0) {
+      adler = adler32_combine(adler, bands[i].adler,
+                              static_cast<z_off_t>(bands[i].filtered_length));
+    }
+  }
+
+  // zlib 流：2 字节头 + 拼接后的 deflate 数据 + Adler-32
+  std::vector<uint8_t> zdata;
+  zdata.reserve(deflated_size + 6);
+  uint8_t level_flag = settings.level <= 1 ? 0 : settings.level < 6 ? 1 : 3;
+  uint8_t cmf = 0x78;
+  uint8_t flg = static_cast<uint8_t>(level_flag << 6);
+  flg = static_cast<uint8_t>(flg + (31 - ((cmf << 8) + flg) % 31));
+  zdata.push_back(cmf);
+  zdata.push_back(flg);
+  for (const Band& band : bands) {
+    zdata.insert(zdata.end(), band.deflated.begin(), band.deflated.end());
+  }
+  append_be32(&zdata, static_cast<uint32_t>(adler));
+
+  out->clear();
+  out->reserve(zdata.size() + 128);
+  out->insert(out->end(), kPngSignature, kPngSignature + sizeof(kPngSignature));
+
+  uint8_t ihdr[13];
+  for (int i = 0; i < 4; i++) {
+    ihdr[i] = static_cast<uint8_t>(width >> (24 - 8 * i));
+    ihdr[4 + i] = static_cast<uint8_t>(height >> (24 - 8 * i));
+  }
+  ihdr[8] = 8;                        // 位深
+  ihdr[9] = channels == 4 ? 6 : 2;    // 颜色类型：RGBA / RGB
+  ihdr[10] = 0;                       // 压缩方法
+  ihdr[11] = 0;                       // 过滤方法
+  ihdr[12] = 0;                       // 非隔行
+  append_chunk(out, "IHDR", ihdr, sizeof(ihdr));
+
+  for (size_t offset = 0; offset < zdata.size(); offset += kMaxIdatBytes) {
+    append_chunk(out, "IDAT", zdata.data() + offset,
+                 std::min(kMaxIdatBytes, zdata.size() - offset));
+  }
+  append_chunk(out, "IEND", nullptr, 0);
+  return true;
+}
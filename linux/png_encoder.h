@@ -0,0 +1,31 @@
+#ifndef CLIP_FLOW_PNG_ENCODER_H_
+#define CLIP_FLOW_PNG_ENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 截图用 PNG 编码器。
+// 图像按行分成若干条带，在多个线程上分别做行过滤与 deflate，
+// 各条带的原始 deflate 流以同步刷新对齐后拼接，Adler-32 按长度合并，
+// 输出为标准 PNG（单个 zlib 流）。
+
+typedef enum {
+  // 固定 Up 过滤 + zlib 1 级：速度优先，适合之后可能在后台重新压缩的截图
+  PNG_ENCODE_FAST,
+  // 自适应过滤 + zlib 3 级
+  PNG_ENCODE_BALANCED,
+  // 自适应过滤 + zlib 9 级：体积优先
+  PNG_ENCODE_SMALL,
+} PngEncodeProfile;
+
+// 按名称解析编码档位（"fast" / "balanced" / "small"），未知名称返回 false
+bool png_encode_profile_from_name(const char* name, PngEncodeProfile* profile);
+
+// 将 8 位 RGB（channels = 3）或 RGBA（channels = 4）像素编码为 PNG。
+// stride 为相邻两行的字节间距；max_threads 为 0 时按 CPU 核数决定。
+bool png_encode(const uint8_t* pixels, uint32_t width, uint32_t height,
+                size_t stride, int channels, PngEncodeProfile profile,
+                std::vector<uint8_t>* out, unsigned max_threads = 0);
+
+#endif  // CLIP_FLOW_PNG_ENCODER_H_
@@ -0,0 +1,77 @@
+// OcrJobTable：剪贴板变化时取代以旧内容为对象的识别任务。
+
+#include "ocr_jobs.h"
+
+#include "test_check.h"
+
+int g_test_failures = 0;
+
+namespace {
+
+// 第二次捕获（剪贴板序号前进）取消第一次捕获的识别
+void test_second_capture_cancels_first() {
+  OcrJobTable jobs;
+  int64_t sequence = 1;
+  OcrJobTable::CancelFlag first = jobs.add(1, false, sequence, sequence);
+  TEST_CHECK(first != nullptr);
+  TEST_CHECK(!first->load());
+
+  ++sequence;
+  jobs.supersede(sequence);
+  OcrJobTable::CancelFlag second = jobs.add(2, false, sequence, sequence);
+  TEST_CHECK(first->load());
+  TEST_CHECK(!second->load());
+}
+
+// 登记时剪贴板已经变化的捕获任务直接取消
+void test_stale_capture_starts_cancelled() {
+  OcrJobTable jobs;
+  OcrJobTable::CancelFlag job = jobs.add(1, false, 3, 4);
+  TEST_CHECK(job != nullptr);
+  TEST_CHECK(job->load());
+}
+
+// 识别给定字节、又不属于任何捕获的任务不受剪贴板变化影响
+void test_unrelated_job_survives_change() {
+  OcrJobTable jobs;
+  OcrJobTable::CancelFlag job =
+      jobs.add(1, false, OcrJobTable::kNoCapture, 1);
+  OcrJobTable::CancelFlag clipboard =
+      jobs.add(2, true, OcrJobTable::kNoCapture, 1);
+  jobs.supersede(2);
+  TEST_CHECK(!job->load());
+  TEST_CHECK(clipboard->load());
+}
+
+// 同一序号的重复通知不取消该次捕获自身的识别
+void test_same_sequence_does_not_cancel() {
+  OcrJobTable jobs;
+  OcrJobTable::CancelFlag job = jobs.add(1, false, 5, 5);
+  jobs.supersede(5);
+  TEST_CHECK(!job->load());
+}
+
+void test_ids() {
+  OcrJobTable jobs;
+  TEST_CHECK(jobs.add(7, false, OcrJobTable::kNoCapture, 0) != nullptr);
+  TEST_CHECK(jobs.add(7, false, OcrJobTable::kNoCapture, 0) == nullptr);
+  int64_t internal = jobs.next_internal_id();
+  TEST_CHECK(internal < 0);
+  TEST_CHECK(jobs.next_internal_id() < internal);
+  TEST_CHECK(jobs.cancel(7));
+  TEST_CHECK(jobs.find(7)->load());
+  jobs.finish(7);
+  TEST_CHECK(!jobs.cancel(7));
+  TEST_CHECK(jobs.find(7) == nullptr);
+}
+
+}  // namespace
+
+int main() {
+  TEST_RUN(test_second_capture_cancels_first);
+  TEST_RUN(test_stale_capture_starts_cancelled);
+  TEST_RUN(test_unrelated_job_survives_change);
+  TEST_RUN(test_same_sequence_does_not_cancel);
+  TEST_RUN(test_ids);
+  return g_test_failures == 0 ? 0 : 1;
+}
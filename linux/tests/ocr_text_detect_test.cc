@@ -0,0 +1,172 @@
+// ocr_estimate_text 的文字存在性预判：单行、单词裁剪图不应被判为无文字。
+
+#include "ocr_text_detect.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "test_check.h"
+
+int g_test_failures = 0;
+
+namespace {
+
+// ClipConstants.ocrTextThreshold
+constexpr double kTextThreshold = 0.2;
+
+// 白底 RGB 图像
+struct TestImage {
+  int width;
+  int height;
+  std::vector<uint8_t> pixels;
+
+  TestImage(int w, int h)
+      : width(w), height(h), pixels(static_cast<size_t>(w) * h * 3, 0xff) {}
+
+  OcrImage view() const {
+    OcrImage image;
+    image.pixels = pixels.data();
+    image.width = width;
+    image.height = height;
+    image.channels = 3;
+    image.rowstride = width * 3;
+    return image;
+  }
+
+  void set(int x, int y, uint8_t value) {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+      return;
+    }
+    uint8_t* p = pixels.data() + (static_cast<size_t>(y) * width + x) * 3;
+    p[0] = p[1] = p[2] = value;
+  }
+};
+
+// 固定种子的伪随机数，保证字形可复现
+uint32_t next_random(uint32_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+// 从 (x, y) 起画 count 个高 glyph_height 的字形：每个字形 2~4 笔横竖
+// 笔画，笔画两侧一像素灰边模拟抗锯齿；单词之间空一个字宽
+void draw_words(TestImage* image, int x, int y, int glyph_height,
+                const std::vector<int>& words, uint32_t seed) {
+  uint32_t state = seed;
+  int cell = std::max(4, glyph_height * 9 / 14);
+  int stroke = std::max(1, glyph_height / 10);
+  for (int letters : words) {
+    for (int i = 0; i < letters; ++i) {
+      int strokes = 2 + static_cast<int>(next_random(&state) % 3);
+      for (int k = 0; k < strokes; ++k) {
+        int x0, y0, x1, y1;
+        if (next_random(&state) & 1) {
+          x0 = x + static_cast<int>(next_random(&state) % (cell - stroke));
+          x1 = x0 + stroke;
+          y0 = y + static_cast<int>(next_random(&state) % (glyph_height / 3));
+          y1 = y + glyph_height -
+               static_cast<int>(next_random(&state) % (glyph_height / 3));
+        } else {
+          y0 = y + static_cast<int>(next_random(&state) %
+                                    (glyph_height - stroke));
+          y1 = y0 + stroke;
+          x0 = x + static_cast<int>(next_random(&state) % (cell / 3));
+          x1 = x + cell - 1 - static_cast<int>(next_random(&state) % (cell / 3));
+        }
+        for (int py = y0 - 1; py <= y1; ++py) {
+          for (int px = x0 - 1; px <= x1; ++px) {
+            bool inside = px >= x0 && px < x1 && py >= y0 && py < y1;
+            image->set(px, py, inside ? 0x20 : 0xa0);
+          }
+        }
+      }
+      x += cell;
+    }
+    x += cell;
+  }
+}
+
+OcrTextEstimate estimate(const TestImage& image) {
+  OcrTextEstimate result;
+  ocr_estimate_text(image.view(), &result);
+  return result;
+}
+
+// 一行字的截图裁剪：上下各留几像素空白
+void test_single_line_crop() {
+  TestImage image(420, 24);
+  draw_words(&image, 6, 5, 14, {5, 3, 7, 4, 6}, 1);
+  OcrTextEstimate result = estimate(image);
+  TEST_CHECK(result.line_segments >= 2);
+  TEST_CHECK(result.score >= kTextThreshold);
+}
+
+// 紧贴文字裁剪的单个单词：文字顶到上下边界
+void test_single_word_crop() {
+  TestImage image(90, 14);
+  draw_words(&image, 2, 0, 14, {7}, 2);
+  OcrTextEstimate result = estimate(image);
+  TEST_CHECK(result.line_segments >= 1);
+  TEST_CHECK(result.score >= kTextThreshold);
+}
+
+// 同一行字放进更高的图像，得分不应远高于裁剪图
+void test_single_line_in_tall_image() {
+  TestImage crop(420, 24);
+  draw_words(&crop, 6, 5, 14, {5, 3, 7, 4, 6}, 1);
+  TestImage tall(420, 200);
+  draw_words(&tall, 6, 93, 14, {5, 3, 7, 4, 6}, 1);
+  OcrTextEstimate crop_result = estimate(crop);
+  OcrTextEstimate tall_result = estimate(tall);
+  TEST_CHECK(tall_result.score >= kTextThreshold);
+  TEST_CHECK(crop_result.score >= tall_result.score);
+}
+
+// 小图即使得分低也不足以断定没有文字
+void test_small_blank_is_inconclusive() {
+  TestImage image(120, 30);
+  OcrTextEstimate result = estimate(image);
+  TEST_CHECK(result.score == 0);
+  TEST_CHECK(!result.conclusive);
+}
+
+// 大面积平滑渐变（照片、壁纸）可以据此跳过识别
+void test_large_gradient_is_conclusive() {
+  TestImage image(1280, 720);
+  for (int y = 0; y < image.height; ++y) {
+    for (int x = 0; x < image.width; ++x) {
+      image.set(x, y, static_cast<uint8_t>((x + y) * 255 /
+                                           (image.width + image.height)));
+    }
+  }
+  OcrTextEstimate result = estimate(image);
+  TEST_CHECK(result.conclusive);
+  TEST_CHECK(result.score < kTextThreshold);
+}
+
+// 多行正文的截图
+void test_paragraph_screenshot() {
+  TestImage image(1280, 720);
+  for (int line = 0; line < 20; ++line) {
+    draw_words(&image, 40, 40 + line * 24, 14, {6, 4, 8, 3, 5, 7, 2, 6, 9, 4},
+               static_cast<uint32_t>(line + 10));
+  }
+  OcrTextEstimate result = estimate(image);
+  TEST_CHECK(result.conclusive);
+  TEST_CHECK(result.score == 1.0);
+}
+
+}  // namespace
+
+int main() {
+  TEST_RUN(test_single_line_crop);
+  TEST_RUN(test_single_word_crop);
+  TEST_RUN(test_single_line_in_tall_image);
+  TEST_RUN(test_small_blank_is_inconclusive);
+  TEST_RUN(test_large_gradient_is_conclusive);
+  TEST_RUN(test_paragraph_screenshot);
+  return g_test_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+// perceptual_hash 的 DCT 向量化：哈希须与逐项累加的标量实现逐位一致，
+// 已保存的哈希与新算出的哈希才能继续比较。
+
+#include "perceptual_hash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "test_check.h"
+
+int g_test_failures = 0;
+
+namespace {
+
+constexpr uint32_t kSampleSize = 32;
+constexpr uint32_t kHashSize = 8;
+
+uint32_t next_random(uint32_t* state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+std::vector<uint8_t> random_image(uint32_t width, uint32_t height, int channels,
+                                  uint32_t seed) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * channels);
+  uint32_t state = seed;
+  for (uint8_t& value : pixels) {
+    value = static_cast<uint8_t>(next_random(&state));
+  }
+  return pixels;
+}
+
+// 向量化之前的实现：不足 32 像素的边按最近邻放大，灰度后逐项累加 DCT
+uint64_t reference_hash(const uint8_t* pixels, uint32_t width, uint32_t height,
+                        int channels) {
+  float table[kHashSize][kSampleSize];
+  for (uint32_t k = 0; k < kHashSize; k++) {
+    for (uint32_t n = 0; n < kSampleSize; n++) {
+      table[k][n] = static_cast<float>(
+          std::cos((2.0 * n + 1.0) * k * M_PI / (2.0 * kSampleSize)));
+    }
+  }
+
+  float gray[kSampleSize * kSampleSize];
+  for (uint32_t y = 0; y < kSampleSize; y++) {
+    for (uint32_t x = 0; x < kSampleSize; x++) {
+      const uint8_t* p = pixels + ((y * height / kSampleSize) * width +
+                                   x * width / kSampleSize) *
+                                      channels;
+      uint32_t luma = (77u * p[0] + 150u * p[1] + 29u * p[2]) >> 8;
+      if (channels == 4) {
+        uint32_t alpha = p[3];
+        luma = (luma * alpha + 255u * (255u - alpha) + 127u) / 255u;
+      }
+      gray[y * kSampleSize + x] = static_cast<float>(luma);
+    }
+  }
+
+  float rows[kSampleSize][kHashSize];
+  for (uint32_t y = 0; y < kSampleSize; y++) {
+    for (uint32_t k = 0; k < kHashSize; k++) {
+      float sum = 0.0f;
+      for (uint32_t n = 0; n < kSampleSize; n++) {
+        sum += gray[y * kSampleSize + n] * table[k][n];
+      }
+      rows[y][k] = sum;
+    }
+  }
+  float coefficients[kHashSize * kHashSize];
+  for (uint32_t v = 0; v < kHashSize; v++) {
+    for (uint32_t u = 0; u < kHashSize; u++) {
+      float sum = 0.0f;
+      for (uint32_t n = 0; n < kSampleSize; n++) {
+        sum += rows[n][u] * table[v][n];
+      }
+      coefficients[v * kHashSize + u] = sum;
+    }
+  }
+
+  float sorted[kHashSize * kHashSize];
+  std::copy_n(coefficients, kHashSize * kHashSize, sorted);
+  const size_t middle = kHashSize * kHashSize / 2;
+  std::nth_element(sorted, sorted + middle, sorted + kHashSize * kHashSize);
+  uint64_t hash = 0;
+  for (uint32_t i = 0; i < kHashSize * kHashSize; i++) {
+    if (coefficients[i] > sorted[middle]) {
+      hash |= 1ULL << i;
+    }
+  }
+  return hash;
+}
+
+// 小图走最近邻放大，输入与参考实现完全相同，哈希应逐位一致
+void test_matches_reference() {
+  const int channel_counts[] = {3, 4};
+  for (int channels : channel_counts) {
+    for (uint32_t seed = 1; seed <= 64; seed++) {
+      uint32_t width = 8 + seed % 24;
+      uint32_t height = 8 + (seed * 7) % 24;
+      std::vector<uint8_t> pixels =
+          random_image(width, height, channels, seed);
+      uint64_t hash = 0;
+      TEST_CHECK(perceptual_hash(pixels.data(), width, height,
+                                 width * channels, channels, &hash));
+      TEST_CHECK(hash == reference_hash(pixels.data(), width, height,
+                                        channels));
+    }
+  }
+}
+
+// 缩小一半后哈希几乎不变
+void test_downscaled_copy_is_near() {
+  const uint32_t size = 256;
+  std::vector<uint8_t> large(size * size * 3);
+  std::vector<uint8_t> small(size / 2 * size / 2 * 3);
+  for (uint32_t y = 0; y < size; y++) {
+    for (uint32_t x = 0; x < size; x++) {
+      uint8_t* p = large.data() + (y * size + x) * 3;
+      // 几个亮度不同的圆斑叠在渐变上
+      double value = x * 0.3 + y * 0.2;
+      value += std::hypot(x - 70.0, y - 90.0) < 40 ? 90 : 0;
+      value += std::hypot(x - 180.0, y - 60.0) < 30 ? 60 : 0;
+      value += std::hypot(x - 150.0, y - 190.0) < 50 ? 120 : 0;
+      p[0] = p[1] = p[2] = static_cast<uint8_t>(std::min(value, 255.0));
+    }
+  }
+  for (uint32_t y = 0; y < size / 2; y++) {
+    for (uint32_t x = 0; x < size / 2; x++) {
+      for (int c = 0; c < 3; c++) {
+        const uint8_t* p = large.data() + (2 * y * size + 2 * x) * 3 + c;
+        small[(y * size / 2 + x) * 3 + c] = static_cast<uint8_t>(
+            (p[0] + p[3] + p[size * 3] + p[size * 3 + 3] + 2) / 4);
+      }
+    }
+  }
+  uint64_t large_hash = 0;
+  uint64_t small_hash = 0;
+  TEST_CHECK(perceptual_hash(large.data(), size, size, size * 3, 3,
+                             &large_hash));
+  TEST_CHECK(perceptual_hash(small.data(), size / 2, size / 2, size / 2 * 3,
+                             3, &small_hash));
+  TEST_CHECK(perceptual_hash_distance(large_hash, small_hash) <= 4);
+}
+
+}  // namespace
+
+int main() {
+  TEST_RUN(test_matches_reference);
+  TEST_RUN(test_downscaled_copy_is_near);
+  return g_test_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+#ifndef CLIP_FLOW_TEST_CHECK_H_
+#define CLIP_FLOW_TEST_CHECK_H_
+
+#include <cstdio>
+
+// 原生测试共用的最小断言：失败时打印位置并计数，main 以失败数为退出码
+
+extern int g_test_failures;
+
+#define TEST_CHECK(condition)                                           \
+  do {                                                                  \
+    if (!(condition)) {                                                 \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, \
+              #condition);                                              \
+      ++g_test_failures;                                                \
+    }                                                                   \
+  } while (0)
+
+#define TEST_RUN(test)                                                 \
+  do {                                                                 \
+    int failures_before = g_test_failures;                             \
+    test();                                                            \
+    printf("%s %s\n", g_test_failures == failures_before ? "PASS" : "FAIL", \
+           #test);                                                     \
+  } while (0)
+
+#endif  // CLIP_FLOW_TEST_CHECK_H_
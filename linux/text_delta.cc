@@ -0,0 +1,271 @@
+#include "text_delta.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "content_hash.h"
+
+namespace {
+
+// Myers 算法允许的最大编辑距离（行），回溯表占用 O(D^2) 内存
+constexpr int kMaxEditDistance = 512;
+
+struct Line {
+  size_t offset;
+  size_t length;
+  uint64_t hash;
+};
+
+// 按行切分（保留换行符），末尾不完整的行同样算一行
+std::vector<Line> split_lines(const std::string& text) {
+  std::vector<Line> lines;
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find('\n', start);
+    end = end == std::string::npos ? text.size() : end + 1;
+    lines.push_back(
+        Line{start, end - start,
+             content_hash_xxh64(text.data() + start, end - start)});
+    start = end;
+  }
+  return lines;
+}
+
+// 增量操作：copy 为真时复制基准文本 [offset, offset + length)，
+// 否则插入目标文本的同一区间
+struct Op {
+  bool copy;
+  size_t offset;
+  size_t length;
+};
+
+void push_op(std::vector<Op>* ops, bool copy, size_t offset, size_t length) {
+  if (length == 0) {
+    return;
+  }
+  if (!ops->empty()) {
+    Op& last = ops->back();
+    if (last.copy == copy && last.offset + last.length == offset) {
+      last.length += length;
+      return;
+    }
+  }
+  ops->push_back(Op{copy, offset, length});
+}
+
+// 对 a[a_begin, a_end) 与 b[b_begin, b_end) 做 Myers 差分，
+// 结果为 b 的每一行是否来自 a（matched[j] 为对应的 a 行号，否则为 -1）
+bool myers_match(const std::vector<Line>& a, size_t a_begin, size_t a_end,
+                 const std::vector<Line>& b, size_t b_begin, size_t b_end,
+                 std::vector<long>* matched) {
+  const long n = static_cast<long>(a_end - a_begin);
+  const long m = static_cast<long>(b_end - b_begin);
+  const long max_d = std::min<long>(n + m, kMaxEditDistance);
+  const long offset = max_d + 1;
+  std::vector<long> v(2 * offset + 1, 0);
+  std::vector<std::vector<long>> trace;
+
+  auto same = [&](long x, long y) {
+    return a[a_begin + x].hash == b[b_begin + y].hash;
+  };
+
+  long found_d = -1;
+  for (long d = 0; d <= max_d && found_d < 0; d++) {
+    trace.push_back(v);
+    for (long k = -d; k <= d; k += 2) {
+      long x;
+      if (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) {
+        x = v[offset + k + 1];
+      } else {
+        x = v[offset + k - 1] + 1;
+      }
+      long y = x - k;
+      while (x < n && y < m && same(x, y)) {
+        x++;
+        y++;
+      }
+      v[offset + k] = x;
+      if (x >= n && y >= m) {
+        found_d = d;
+        break;
+      }
+    }
+  }
+  if (found_d < 0) {
+    return false;
+  }
+
+  // 回溯：trace[d] 为第 d 轮开始前的 V
+  long x = n;
+  long y = m;
+  for (long d = found_d; d > 0; d--) {
+    const std::vector<long>& prev = trace[d];
+    long k = x - y;
+    long prev_k;
+    if (k == -d || (k != d && prev[offset + k - 1] < prev[offset + k + 1])) {
+      prev_k = k + 1;
+    } else {
+      prev_k = k - 1;
+    }
+    long prev_x = prev[offset + prev_k];
+    long prev_y = prev_x - prev_k;
+    while (x > prev_x && y > prev_y) {
+      x--;
+      y--;
+      (*matched)[b_begin + y] = static_cast<long>(a_begin + x);
+    }
+    x = prev_x;
+    y = prev_y;
+  }
+  while (x > 0 && y > 0) {
+    x--;
+    y--;
+    (*matched)[b_begin + y] = static_cast<long>(a_begin + x);
+  }
+  return true;
+}
+
+bool read_number(const std::string& text, size_t* pos, char terminator,
+                 size_t* value) {
+  size_t start = *pos;
+  size_t result = 0;
+  while (*pos < text.size() && text[*pos] >= '0' && text[*pos] <= '9') {
+    result = result * 10 + static_cast<size_t>(text[*pos] - '0');
+    (*pos)++;
+  }
+  if (*pos == start || *pos >= text.size() || text[*pos] != terminator) {
+    return false;
+  }
+  (*pos)++;
+  *value = result;
+  return true;
+}
+
+}  // namespace
+
+bool text_delta_encode(const std::string& base, const std::string& target,
+                       size_t max_bytes, std::string* delta) {
+  std::vector<Line> a = split_lines(base);
+  std::vector<Line> b = split_lines(target);
+
+  // 去掉公共前后缀，只对中间部分做差分
+  std::vector<long> matched(b.size(), -1);
+  size_t prefix = 0;
+  while (prefix < a.size() && prefix < b.size() &&
+         a[prefix].hash == b[prefix].hash) {
+    matched[prefix] = static_cast<long>(prefix);
+    prefix++;
+  }
+  size_t suffix = 0;
+  while (suffix < a.size() - prefix && suffix < b.size() - prefix &&
+         a[a.size() - 1 - suffix].hash == b[b.size() - 1 - suffix].hash) {
+    matched[b.size() - 1 - suffix] = static_cast<long>(a.size() - 1 - suffix);
+    suffix++;
+  }
+  if (!myers_match(a, prefix, a.size() - suffix, b, prefix, b.size() - suffix,
+                   &matched)) {
+    return false;
+  }
+
+  std::vector<Op> ops;
+  for (size_t j = 0; j < b.size(); j++) {
+    if (matched[j] >= 0) {
+      const Line& line = a[matched[j]];
+      push_op(&ops, true, line.offset, line.length);
+    } else {
+      push_op(&ops, false, b[j].offset, b[j].length);
+    }
+  }
+
+  std::string encoded;
+  for (const Op& op : ops) {
+    if (op.copy) {
+      encoded += '=' + std::to_string(op.offset) + ',' +
+                 std::to_string(op.length) + '\n';
+    } else {
+      encoded += '+' + std::to_string(op.length) + '\n';
+      encoded.append(target, op.offset, op.length);
+    }
+    if (encoded.size() >= max_bytes) {
+      return false;
+    }
+  }
+
+  // 行哈希碰撞等任何问题都会在回放时暴露
+  std::string check;
+  if (!text_delta_apply(base, encoded, &check) || check != target) {
+    return false;
+  }
+  *delta = std::move(encoded);
+  return true;
+}
+
+bool text_delta_apply(const std::string& base, const std::string& delta,
+                      std::string* out) {
+  std::string result;
+  size_t pos = 0;
+  while (pos < delta.size()) {
+    char op = delta[pos++];
+    if (op == '=') {
+      size_t offset = 0;
+      size_t length = 0;
+      if (!read_number(delta, &pos, ',', &offset) ||
+          !read_number(delta, &pos, '\n', &length) || offset > base.size() ||
+          length > base.size() - offset) {
+        return false;
+      }
+      result.append(base, offset, length);
+    } else if (op == '+') {
+      size_t length = 0;
+      if (!read_number(delta, &pos, '\n', &length) ||
+          length > delta.size() - pos) {
+        return false;
+      }
+      result.append(delta, pos, length);
+      pos += length;
+    } else {
+      return false;
+    }
+  }
+  *out = std::move(result);
+  return true;
+}
+
+bool TextReconstructionCache::lookup(const std::string& id, std::string* text) {
+  auto it = index_.find(id);
+  if (it == index_.end()) {
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  *text = it->second->second;
+  return true;
+}
+
+void TextReconstructionCache::store(const std::string& id,
+                                    const std::string& text) {
+  if (text.size() > max_bytes_) {
+    return;
+  }
+  auto it = index_.find(id);
+  if (it != index_.end()) {
+    bytes_ -= it->second->second.size();
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  entries_.emplace_front(id, text);
+  index_[id] = entries_.begin();
+  bytes_ += text.size();
+  while (bytes_ > max_bytes_) {
+    const Entry& last = entries_.back();
+    bytes_ -= last.second.size();
+    index_.erase(last.first);
+    entries_.pop_back();
+  }
+}
+
+void TextReconstructionCache::clear() {
+  entries_.clear();
+  index_.clear();
+  bytes_ = 0;
+}
@@ -0,0 +1,44 @@
+#ifndef CLIP_FLOW_TEXT_DELTA_H_
+#define CLIP_FLOW_TEXT_DELTA_H_
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// 文本增量存储：以行为单位做 Myers 差分，把新文本表示为对基准文本的增量。
+//
+// 增量为纯文本，可直接存入 TEXT 列：
+//   =<offset>,<length>\n   复制基准文本中的一段字节
+//   +<length>\n<bytes>     插入新字节（均为完整的行，保持 UTF-8 有效）
+// 编码后会立即回放校验，任何不一致都视为编码失败。
+
+// 计算 target 相对 base 的增量；编辑距离（行数）超过上限或增量不小于
+// max_bytes 时返回 false，此时应保存全文
+bool text_delta_encode(const std::string& base, const std::string& target,
+                       size_t max_bytes, std::string* delta);
+
+// 由基准文本与增量还原文本；增量格式错误或越界时返回 false
+bool text_delta_apply(const std::string& base, const std::string& delta,
+                      std::string* out);
+
+// 还原结果的 LRU 缓存，按总字节数淘汰
+class TextReconstructionCache {
+ public:
+  explicit TextReconstructionCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  bool lookup(const std::string& id, std::string* text);
+  void store(const std::string& id, const std::string& text);
+  void clear();
+
+ private:
+  using Entry = std::pair<std::string, std::string>;
+
+  size_t max_bytes_;
+  size_t bytes_ = 0;
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+#endif  // CLIP_FLOW_TEXT_DELTA_H_
@@ -0,0 +1,223 @@
+#include "text_similarity.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "content_hash.h"
+
+namespace {
+
+constexpr size_t kShingleSize = 5;
+constexpr size_t kMaxSignatureBytes = 64 * 1024;
+
+inline uint64_t mix64(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// 128 组乘移位哈希参数 h_i(x) = (a_i * x + b_i) >> 32，由固定种子生成
+struct MinHashParams {
+  uint64_t a[kMinHashSize];
+  uint64_t b[kMinHashSize];
+
+  MinHashParams() {
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < kMinHashSize; i++) {
+      state += 0x9e3779b97f4a7c15ULL;
+      a[i] = mix64(state) | 1;
+      state += 0x9e3779b97f4a7c15ULL;
+      b[i] = mix64(state);
+    }
+  }
+};
+
+const MinHashParams& minhash_params() {
+  static const MinHashParams params;
+  return params;
+}
+
+// ASCII 字母转小写、连续空白合并为一个空格并去掉首尾空白
+std::string normalize_text(const char* text, size_t length) {
+  std::string out;
+  out.reserve(std::min(length, kMaxSignatureBytes));
+  bool pending_space = false;
+  for (size_t i = 0; i < length && out.size() < kMaxSignatureBytes; i++) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+        c == '\v') {
+      pending_space = !out.empty();
+      continue;
+    }
+    if (pending_space) {
+      out.push_back(' ');
+      pending_space = false;
+    }
+    out.push_back(c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32)
+                                       : static_cast<char>(c));
+  }
+  return out;
+}
+
+}  // namespace
+
+void text_minhash(const char* text, size_t length, MinHashSignature* out) {
+  std::string normalized = normalize_text(text, length);
+
+  // 相同 shingle 只需参与一次最小值计算
+  std::vector<uint64_t> shingles;
+  if (normalized.size() <= kShingleSize) {
+    shingles.push_back(
+        content_hash_xxh64(normalized.data(), normalized.size()));
+  } else {
+    shingles.reserve(normalized.size() - kShingleSize + 1);
+    for (size_t i = 0; i + kShingleSize <= normalized.size(); i++) {
+      uint64_t packed = 0;
+      std::memcpy(&packed, normalized.data() + i, kShingleSize);
+      shingles.push_back(mix64(packed));
+    }
+    std::sort(shingles.begin(), shingles.end());
+    shingles.erase(std::unique(shingles.begin(), shingles.end()),
+                   shingles.end());
+  }
+
+  const MinHashParams& params = minhash_params();
+  out->fill(UINT32_MAX);
+  for (uint64_t shingle : shingles) {
+    // 内层循环无分支依赖，编译器可向量化
+    for (size_t i = 0; i < kMinHashSize; i++) {
+      uint32_t h =
+          static_cast<uint32_t>((params.a[i] * shingle + params.b[i]) >> 32);
+      (*out)[i] = std::min((*out)[i], h);
+    }
+  }
+}
+
+double minhash_similarity(const MinHashSignature& a,
+                          const MinHashSignature& b) {
+  size_t equal = 0;
+  for (size_t i = 0; i < kMinHashSize; i++) {
+    equal += a[i] == b[i];
+  }
+  return static_cast<double>(equal) / kMinHashSize;
+}
+
+uint64_t TextSimilarityIndex::band_key(const MinHashSignature& signature,
+                                       size_t band) {
+  return content_hash_xxh64(signature.data() + band * kRows,
+                            kRows * sizeof(uint32_t));
+}
+
+void TextSimilarityIndex::insert(const std::string& id,
+                                 const MinHashSignature& signature) {
+  remove(id);
+
+  uint32_t index;
+  if (!free_nodes_.empty()) {
+    index = free_nodes_.back();
+    free_nodes_.pop_back();
+    nodes_[index] = Node{id, signature, true};
+  } else {
+    index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(Node{id, signature, true});
+  }
+  ids_[id] = index;
+  for (size_t band = 0; band < kBands; band++) {
+    bands_[band][band_key(signature, band)].push_back(index);
+  }
+}
+
+bool TextSimilarityIndex::remove(const std::string& id) {
+  auto it = ids_.find(id);
+  if (it == ids_.end()) {
+    return false;
+  }
+  uint32_t index = it->second;
+  ids_.erase(it);
+
+  Node& node = nodes_[index];
+  for (size_t band = 0; band < kBands; band++) {
+    auto bucket = bands_[band].find(band_key(node.signature, band));
+    if (bucket == bands_[band].end()) {
+      continue;
+    }
+    Bucket& members = bucket->second;
+    auto member = std::find(members.begin(), members.end(), index);
+    if (member != members.end()) {
+      *member = members.back();
+      members.pop_back();
+    }
+    if (members.empty()) {
+      bands_[band].erase(bucket);
+    }
+  }
+  node.live = false;
+  node.id.clear();
+  free_nodes_.push_back(index);
+  return true;
+}
+
+void TextSimilarityIndex::clear() {
+  nodes_.clear();
+  free_nodes_.clear();
+  ids_.clear();
+  for (auto& band : bands_) {
+    band.clear();
+  }
+  visited_.clear();
+  visit_epoch_ = 0;
+}
+
+bool TextSimilarityIndex::nearest(const MinHashSignature& signature,
+                                  double threshold,
+                                  const std::string& exclude_id,
+                                  std::string* id, double* similarity) const {
+  if (ids_.empty()) {
+    return false;
+  }
+  if (visited_.size() < nodes_.size()) {
+    visited_.resize(nodes_.size(), 0);
+  }
+  if (++visit_epoch_ == 0) {
+    std::fill(visited_.begin(), visited_.end(), 0);
+    visit_epoch_ = 1;
+  }
+
+  double best = -1.0;
+  uint32_t best_index = 0;
+  for (size_t band = 0; band < kBands; band++) {
+    auto bucket = bands_[band].find(band_key(signature, band));
+    if (bucket == bands_[band].end()) {
+      continue;
+    }
+    for (uint32_t index : bucket->second) {
+      if (visited_[index] == visit_epoch_) {
+        continue;
+      }
+      visited_[index] = visit_epoch_;
+      const Node& node = nodes_[index];
+      if (!node.live || (!exclude_id.empty() && node.id == exclude_id)) {
+        continue;
+      }
+      double estimate = minhash_similarity(signature, node.signature);
+      if (estimate >= threshold && estimate > best) {
+        best = estimate;
+        best_index = index;
+      }
+    }
+  }
+
+  if (best < 0) {
+    return false;
+  }
+  if (id != nullptr) {
+    *id = nodes_[best_index].id;
+  }
+  if (similarity != nullptr) {
+    *similarity = best;
+  }
+  return true;
+}
@@ -0,0 +1,65 @@
+#ifndef CLIP_FLOW_TEXT_SIMILARITY_H_
+#define CLIP_FLOW_TEXT_SIMILARITY_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 文本近似重复检测：字符 shingle + MinHash 签名 + LSH 分带索引。
+//
+// 文本先规范化（ASCII 转小写、连续空白合并为一个空格），取长度为 5 字节的
+// shingle，对每个 shingle 用 128 个乘移位哈希求最小值得到签名；
+// 两个签名相同位置取值相等的比例即 Jaccard 相似度的无偏估计。
+// 索引把签名分为 16 带 × 8 行，任一带完全相同即成为候选，
+// 相似度约 0.7 以上的文本大概率至少命中一带，候选再用完整签名校验。
+
+constexpr size_t kMinHashSize = 128;
+using MinHashSignature = std::array<uint32_t, kMinHashSize>;
+
+// 计算文本的 MinHash 签名；只取规范化后前 64 KiB 参与计算
+void text_minhash(const char* text, size_t length, MinHashSignature* out);
+
+// 由签名估计 Jaccard 相似度（0..1）
+double minhash_similarity(const MinHashSignature& a, const MinHashSignature& b);
+
+class TextSimilarityIndex {
+ public:
+  static constexpr size_t kBands = 16;
+  static constexpr size_t kRows = kMinHashSize / kBands;
+
+  // 添加或替换某个剪贴项的签名
+  void insert(const std::string& id, const MinHashSignature& signature);
+  // 删除剪贴项；返回是否存在
+  bool remove(const std::string& id);
+  void clear();
+
+  // 查找估计相似度不低于 threshold 的最相似文本；exclude_id 非空时跳过该项
+  bool nearest(const MinHashSignature& signature, double threshold,
+               const std::string& exclude_id, std::string* id,
+               double* similarity) const;
+
+  size_t size() const { return ids_.size(); }
+
+ private:
+  struct Node {
+    std::string id;
+    MinHashSignature signature;
+    bool live;
+  };
+  using Bucket = std::vector<uint32_t>;
+
+  static uint64_t band_key(const MinHashSignature& signature, size_t band);
+
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> free_nodes_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  std::unordered_map<uint64_t, Bucket> bands_[kBands];
+  // 查询时的去重标记，避免同一候选在多带中重复校验
+  mutable std::vector<uint32_t> visited_;
+  mutable uint32_t visit_epoch_ = 0;
+};
+
+#endif  // CLIP_FLOW_TEXT_SIMILARITY_H_
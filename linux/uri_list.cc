@@ -0,0 +1,121 @@
+#include "uri_list.h"
+
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr char kFileScheme[] = "file://";
+constexpr size_t kFileSchemeLength = sizeof(kFileScheme) - 1;
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+bool has_prefix_ignore_case(const char* data, size_t length,
+                            const char* prefix, size_t prefix_length) {
+  if (length < prefix_length) {
+    return false;
+  }
+  for (size_t i = 0; i < prefix_length; i++) {
+    char c = data[i];
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+    if (c != prefix[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool uri_list_decode_file_uri(const char* uri, size_t length,
+                              std::string* path) {
+  if (!has_prefix_ignore_case(uri, length, kFileScheme, kFileSchemeLength)) {
+    return false;
+  }
+  const char* cursor = uri + kFileSchemeLength;
+  const char* end = uri + length;
+
+  // file://host/path：主机部分到第一个 / 为止
+  const char* slash =
+      static_cast<const char*>(memchr(cursor, '/', end - cursor));
+  if (slash == nullptr) {
+    return false;
+  }
+  size_t host_length = slash - cursor;
+  if (host_length != 0 &&
+      (host_length != 9 ||
+       !has_prefix_ignore_case(cursor, host_length, "localhost", 9))) {
+    return false;
+  }
+
+  path->clear();
+  path->reserve(end - slash);
+  for (const char* p = slash; p < end; p++) {
+    // 查询串与片段不属于路径
+    if (*p == '?' || *p == '#') {
+      break;
+    }
+    if (*p == '%' && end - p >= 3) {
+      int high = hex_value(p[1]);
+      int low = hex_value(p[2]);
+      if (high >= 0 && low >= 0) {
+        char decoded = static_cast<char>((high << 4) | low);
+        // 路径中不允许出现 NUL
+        if (decoded == '\0') {
+          return false;
+        }
+        path->push_back(decoded);
+        p += 2;
+        continue;
+      }
+    }
+    path->push_back(*p);
+  }
+  return !path->empty();
+}
+
+std::vector<std::string> uri_list_file_paths(const char* data, size_t length) {
+  std::vector<std::string> paths;
+  if (data == nullptr) {
+    return paths;
+  }
+  const char* cursor = data;
+  const char* end = data + length;
+  std::string path;
+  while (cursor < end) {
+    const char* newline =
+        static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+    const char* line_end = newline != nullptr ? newline : end;
+    const char* line_begin = cursor;
+    cursor = newline != nullptr ? newline + 1 : end;
+
+    if (line_end > line_begin && line_end[-1] == '\r') {
+      line_end--;
+    }
+    // 部分程序会在末尾附带 NUL
+    while (line_end > line_begin && line_end[-1] == '\0') {
+      line_end--;
+    }
+    if (line_end == line_begin || *line_begin == '#') {
+      continue;
+    }
+    if (uri_list_decode_file_uri(line_begin, line_end - line_begin, &path)) {
+      paths.push_back(std::move(path));
+      path = std::string();
+    }
+  }
+  return paths;
+}
@@ -0,0 +1,22 @@
+#ifndef CLIP_FLOW_URI_LIST_H_
+#define CLIP_FLOW_URI_LIST_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// text/uri-list 解析（RFC 2483）。
+//
+// 直接在剪贴板缓冲区上按行切分，不复制整段数据；
+// 只有最终的文件路径需要分配（百分号解码后的字节序列）。
+// 忽略 # 开头的注释行与空行，兼容 LF 与 CRLF 分隔。
+
+// 把单个 file:// URI 解码为本地路径；
+// 主机名须为空或 localhost，其他主机及非 file 协议返回 false
+bool uri_list_decode_file_uri(const char* uri, size_t length,
+                              std::string* path);
+
+// 返回列表中全部本地文件路径，顺序与列表一致
+std::vector<std::string> uri_list_file_paths(const char* data, size_t length);
+
+#endif  // CLIP_FLOW_URI_LIST_H_
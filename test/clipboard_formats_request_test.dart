@@ -0,0 +1,162 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:clip_flow/core/constants/clip_constants.dart';
+import 'package:clip_flow/core/services/clipboard/clipboard_processor.dart';
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+/// Linux 捕获先取格式清单、再只读取需要的格式
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  const clipboardChannel = MethodChannel('clipboard_service');
+  // 清单中可用的格式及其大小
+  var available = <String, Map<String, Object?>>{};
+  final requests = <Map<Object?, Object?>>[];
+  // 以流读取时依次推送的负载
+  var streamChunks = <String>[];
+  final streamRequests = <Map<Object?, Object?>>[];
+
+  // 按原生侧的格式推送一条流消息：16 字节小端头部 + 负载
+  Future<void> pushStreamMessage(int streamId, int flags, List<int> payload) {
+    final header = ByteData(16)
+      ..setInt32(0, streamId, Endian.little)
+      ..setInt32(4, flags, Endian.little);
+    final message = Uint8List.fromList([
+      ...header.buffer.asUint8List(),
+      ...payload,
+    ]);
+    return TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .handlePlatformMessage(
+          'clipboard_stream',
+          ByteData.sublistView(message),
+          (_) {},
+        );
+  }
+
+  setUp(() {
+    requests.clear();
+    streamRequests.clear();
+    clipboardChannel.setMockMethodCallHandler((call) async {
+      if (call.method == 'openClipboardStream') {
+        streamRequests.add(call.arguments as Map);
+        const streamId = 7;
+        // 应答 streamId 之后再推送数据块，与原生侧顺序一致
+        Future<void>(() async {
+          for (final chunk in streamChunks) {
+            await pushStreamMessage(streamId, 0, utf8.encode(chunk));
+          }
+          await pushStreamMessage(streamId, 1, const []);
+        });
+        return {'streamId': streamId, 'target': 'UTF8_STRING'};
+      }
+      if (call.method != 'getClipboardFormats') return null;
+      final args = call.arguments as Map;
+      requests.add(args);
+      if (args['manifestOnly'] == true) {
+        return {
+          'sequence': 1,
+          'manifest': {
+            'formats': {
+              for (final entry in available.entries)
+                entry.key: {...entry.value, 'skipped': 'notRequested'},
+            },
+          },
+        };
+      }
+      final maxBytes = (args['maxBytes'] as Map?) ?? const {};
+      return {
+        'sequence': 1,
+        'manifest': {
+          'formats': {
+            for (final entry in available.entries)
+              entry.key: {
+                ...entry.value,
+                if (maxBytes[entry.key] is int &&
+                    (entry.value['size']! as int) > (maxBytes[entry.key] as int))
+                  'skipped': 'tooLarge',
+              },
+          },
+        },
+      };
+    });
+  });
+
+  tearDown(() {
+    clipboardChannel.setMockMethodCallHandler(null);
+  });
+
+  group(
+    '格式清单与按需读取',
+    () {
+      test('有文件列表时只读取文件与文本', () async {
+        available = {
+          'files': {'size': 64},
+          'text': {'size': 60},
+          'image': {'size': 4096, 'sizeExact': false},
+          'html': {'size': 300},
+        };
+        await ClipboardProcessor().processClipboardContent();
+
+        expect(requests, hasLength(2));
+        expect(requests.first['manifestOnly'], isTrue);
+        expect(requests.last['formats'], unorderedEquals(['files', 'text']));
+        expect(requests.last.containsKey('maxBytes'), isFalse);
+      });
+
+      test('图片带大小上限读取', () async {
+        available = {
+          'image': {'size': 2048},
+          'html': {'size': 300},
+        };
+        await ClipboardProcessor().processClipboardContent();
+
+        expect(requests.last['formats'], unorderedEquals(['image', 'html']));
+        expect(
+          (requests.last['maxBytes'] as Map)['image'],
+          equals(1024 * 1024),
+        );
+      });
+
+      test('超过上限的图片不读取负载也不保存', () async {
+        available = {
+          'image': {'size': 8 * 1024 * 1024},
+          'text': {'size': 12},
+        };
+        final item = await ClipboardProcessor().processClipboardContent();
+
+        expect(item, isNull);
+        expect(requests, hasLength(2));
+      });
+
+      test('超大的文本分块流式读取', () async {
+        available = {
+          'text': {'size': ClipConstants.clipboardStreamThreshold + 1},
+          'html': {'size': 300},
+        };
+        streamChunks = ['第一块 ', 'second chunk'];
+        final item = await ClipboardProcessor().processClipboardContent();
+
+        expect(requests.last['formats'], equals(['html']));
+        expect(streamRequests.single['format'], equals('text'));
+        expect(
+          streamRequests.single['maxBytes'],
+          equals(ClipConstants.clipboardStreamMaxBytes),
+        );
+        expect(item?.content, equals('第一块 second chunk'));
+      });
+
+      test('剪贴板为空时不再读取', () async {
+        available = {};
+        final item = await ClipboardProcessor().processClipboardContent();
+
+        expect(item, isNull);
+        expect(requests, hasLength(1));
+      });
+    },
+    // 清单与按需读取只有 Linux 原生实现
+    skip: !Platform.isLinux,
+  );
+}
@@ -1,8 +1,18 @@
+import 'dart:io';
+
+import 'package:clip_flow/core/constants/clip_constants.dart';
 import 'package:clip_flow/core/models/clip_item.dart';
+import 'package:clip_flow/core/services/clipboard/clipboard_processor.dart';
+import 'package:clip_flow/core/services/storage/index.dart';
 import 'package:flutter/services.dart';
 import 'package:flutter_test/flutter_test.dart';
+import 'package:image/image.dart' as img;
+
+import 'database_test_helper.dart';
 
 void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
   group('ClipboardProcessor 测试', () {
     setUp(() {
       // 测试设置
@@ -224,6 +234,139 @@ void main() {
       });
     });
   });
+
+  group('去重与版本组', () {
+    // 下一次 getClipboardFormats 返回的负载
+    var payload = <String, Object?>{};
+    // 下一次 textIndexQuery 返回的近似文本
+    Map<String, Object?>? textNearest;
+    var sequence = 0;
+
+    Future<ClipItem?> capture(
+      ClipboardProcessor processor,
+      Map<String, Object?> formats,
+    ) {
+      payload = {...formats, 'sequence': ++sequence};
+      return processor.processClipboardContent();
+    }
+
+    // 8x8 纯色 PNG；dot 为 true 时左上角多一个红点（感知哈希相近、字节不同）
+    Uint8List pngImage({bool dot = false}) {
+      final image = img.Image(width: 8, height: 8);
+      img.fill(image, color: img.ColorRgb8(40, 80, 160));
+      if (dot) image.setPixelRgb(0, 0, 255, 0, 0);
+      return img.encodePng(image);
+    }
+
+    late ClipboardProcessor processor;
+
+    setUpDatabaseTest(
+      onClipboardCall: (call) async {
+        switch (call.method) {
+          case 'getClipboardFormats':
+            return payload;
+          case 'textIndexQuery':
+            return textNearest;
+          default:
+            return null;
+        }
+      },
+    );
+
+    setUp(() {
+      processor = ClipboardProcessor();
+      textNearest = null;
+    });
+
+    test('完全相同的内容合并到已有条目', () async {
+      final first = await capture(processor, {'text': 'exact duplicate'});
+      expect(first, isNotNull);
+      await DatabaseService.instance.insertClipItem(first!);
+
+      final second = await capture(processor, {'text': 'exact duplicate'});
+      expect(second, isNotNull);
+      expect(second!.id, equals(first.id));
+      expect(second.metadata.containsKey('variantOf'), isFalse);
+    });
+
+    test('近似重复的图片照常保存并归入版本组', () async {
+      final first = await capture(processor, {'image': pngImage()});
+      expect(first, isNotNull);
+      await DatabaseService.instance.insertClipItem(first!);
+
+      final second = await capture(processor, {
+        'image': pngImage(dot: true),
+        'imageNearDuplicate': {
+          'id': first.id,
+          'distance': ClipConstants.imageNearDuplicateDistance - 1,
+        },
+      });
+      expect(second, isNotNull);
+      expect(second!.id, isNot(equals(first.id)));
+      expect(second.type, ClipType.image);
+      expect(second.metadata['variantOf'], equals(first.id));
+      expect(
+        second.metadata['variantDistance'],
+        ClipConstants.imageNearDuplicateDistance - 1,
+      );
+
+      await DatabaseService.instance.insertClipItem(second);
+      expect(
+        await DatabaseService.instance.getClipItemById(first.id),
+        isNotNull,
+      );
+      expect(
+        await DatabaseService.instance.getClipItemById(second.id),
+        isNotNull,
+      );
+    });
+
+    test('感知哈希距离超出阈值时不归组', () async {
+      final first = await capture(processor, {'image': pngImage()});
+      await DatabaseService.instance.insertClipItem(first!);
+
+      final second = await capture(processor, {
+        'image': pngImage(dot: true),
+        'imageNearDuplicate': {
+          'id': first.id,
+          'distance': ClipConstants.imageNearDuplicateDistance + 1,
+        },
+      });
+      expect(second, isNotNull);
+      expect(second!.metadata.containsKey('variantOf'), isFalse);
+    });
+
+    test(
+      '近似文本归入最早版本所在的组',
+      () async {
+        final base = 'line of a long document that keeps growing\n' * 4;
+        final root = await capture(processor, {'text': base});
+        await DatabaseService.instance.insertClipItem(root!);
+
+        textNearest = {'id': root.id, 'similarity': 0.9};
+        final edited = await capture(processor, {'text': '$base edited'});
+        expect(edited, isNotNull);
+        expect(edited!.id, isNot(equals(root.id)));
+        expect(edited.metadata['variantOf'], equals(root.id));
+        expect(
+          edited.metadata[TextDeltaCodec.baseMetadataKey],
+          equals(root.id),
+        );
+        await DatabaseService.instance.insertClipItem(edited);
+
+        // 与第二版相近的第三版仍归到根条目，增量基准为最相近的第二版
+        textNearest = {'id': edited.id, 'similarity': 0.95};
+        final again = await capture(processor, {'text': '$base edited twice'});
+        expect(again!.metadata['variantOf'], equals(root.id));
+        expect(
+          again.metadata[TextDeltaCodec.baseMetadataKey],
+          equals(edited.id),
+        );
+      },
+      // 文本近似索引只有 Linux 原生实现
+      skip: !Platform.isLinux,
+    );
+  });
 }
 
 /// 测试辅助类，用于模拟 MethodChannel 调用
@@ -0,0 +1,180 @@
+import 'dart:io';
+
+import 'package:clip_flow/core/models/clip_item.dart';
+import 'package:clip_flow/core/services/storage/index.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+import '../../database_test_helper.dart';
+
+/// 以增量形式保存的文本的写入、读取与搜索往返
+///
+/// 原生增量编解码由一个纯 Dart 的替身代替：增量记录公共前缀与后缀的长度
+/// 以及中间被替换的文本，格式为 `前缀长度:后缀长度:中间文本`。
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  final calls = <String, int>{};
+
+  String encode(String base, String target) {
+    var prefix = 0;
+    while (prefix < base.length &&
+        prefix < target.length &&
+        base[prefix] == target[prefix]) {
+      prefix++;
+    }
+    var suffix = 0;
+    while (suffix < base.length - prefix &&
+        suffix < target.length - prefix &&
+        base[base.length - 1 - suffix] == target[target.length - 1 - suffix]) {
+      suffix++;
+    }
+    return '$prefix:$suffix:${target.substring(prefix, target.length - suffix)}';
+  }
+
+  String apply(String base, String delta) {
+    final first = delta.indexOf(':');
+    final second = delta.indexOf(':', first + 1);
+    final prefix = int.parse(delta.substring(0, first));
+    final suffix = int.parse(delta.substring(first + 1, second));
+    return base.substring(0, prefix) +
+        delta.substring(second + 1) +
+        base.substring(base.length - suffix);
+  }
+
+  setUpDatabaseTest(
+    onClipboardCall: (call) async {
+      calls[call.method] = (calls[call.method] ?? 0) + 1;
+      final args = call.arguments is Map ? call.arguments as Map : const {};
+      switch (call.method) {
+        case 'textDeltaEncode':
+          return encode(args['base'] as String, args['target'] as String);
+        case 'textDeltaApply':
+          return (args['deltas'] as List).cast<String>().fold<String>(
+            args['base'] as String,
+            apply,
+          );
+        case 'textDeltaApplyBatch':
+          final bases = (args['bases'] as List).cast<String>();
+          return [
+            for (final entry in (args['entries'] as List).cast<Map>())
+              (entry['deltas'] as List).cast<String>().fold<String>(
+                bases[entry['base'] as int],
+                apply,
+              ),
+          ];
+        default:
+          return null;
+      }
+    },
+  );
+
+  setUp(calls.clear);
+
+  group(
+    'DatabaseService 增量存储',
+    () {
+      final base = List.generate(
+        200,
+        (i) => 'line $i of the release notes draft',
+      ).join('\n');
+      final edited = base.replaceFirst('line 120 of', 'line 120 (edited) of');
+
+      Future<(ClipItem, ClipItem)> insertPair() async {
+        final root = ClipItem(
+          type: ClipType.text,
+          content: base,
+          metadata: const {},
+        );
+        await DatabaseService.instance.insertClipItem(root);
+        final variant = ClipItem(
+          type: ClipType.text,
+          content: edited,
+          metadata: {
+            'variantOf': root.id,
+            TextDeltaCodec.baseMetadataKey: root.id,
+          },
+          createdAt: root.createdAt.add(const Duration(seconds: 1)),
+        );
+        await DatabaseService.instance.insertClipItem(variant);
+        return (root, variant);
+      }
+
+      test('写入后读取得到完整文本', () async {
+        final (_, variant) = await insertPair();
+        expect(calls['textDeltaEncode'], 1);
+
+        final loaded = await DatabaseService.instance.getClipItemById(
+          variant.id,
+        );
+        expect(loaded?.content, equals(edited));
+      });
+
+      test('按还原后的全文搜索增量行', () async {
+        final (root, variant) = await insertPair();
+
+        // 关键字只出现在链根的原文中，增量本身不包含它
+        final results = await DatabaseService.instance.searchClipItems(
+          'line 7 of the release',
+        );
+        expect(
+          results.map((item) => item.id),
+          containsAll(<String>[root.id, variant.id]),
+        );
+        expect(
+          results.firstWhere((item) => item.id == variant.id).content,
+          equals(edited),
+        );
+
+        // 增量的编码（`前缀长度:后缀长度:`）不应被当作内容匹配
+        final delta = encode(base, edited);
+        final header = delta.substring(
+          0,
+          delta.indexOf(':', delta.indexOf(':') + 1) + 1,
+        );
+        expect(
+          await DatabaseService.instance.searchClipItems(header),
+          isEmpty,
+        );
+      });
+
+      test('重复搜索复用已还原的全文', () async {
+        final (_, variant) = await insertPair();
+
+        await DatabaseService.instance.searchClipItems('release notes');
+        expect(calls['textDeltaApplyBatch'], 1);
+        final results = await DatabaseService.instance.searchClipItems(
+          'line 120 (edited)',
+        );
+        expect(calls['textDeltaApplyBatch'], 1);
+        expect(results.map((item) => item.id), equals([variant.id]));
+
+        // 修改内容后缓存失效，搜索按新内容匹配
+        await DatabaseService.instance.updateClipItem(
+          variant.copyWith(content: edited.replaceFirst('edited', 'revised')),
+        );
+        expect(
+          await DatabaseService.instance.searchClipItems('line 120 (edited)'),
+          isEmpty,
+        );
+        expect(
+          (await DatabaseService.instance.searchClipItems(
+            'line 120 (revised)',
+          )).map((item) => item.id),
+          equals([variant.id]),
+        );
+      });
+
+      test('整页的增量行一次批量还原', () async {
+        await insertPair();
+        calls.clear();
+
+        final page = await DatabaseService.instance.getAllClipItems(limit: 10);
+        expect(page, hasLength(2));
+        expect(calls['textDeltaApplyBatch'], 1);
+        expect(calls['textDeltaApply'], isNull);
+      });
+    },
+    // 增量编解码只有 Linux 原生实现，其他平台始终保存全文
+    skip: !Platform.isLinux,
+  );
+}
@@ -0,0 +1,88 @@
+import 'dart:async';
+import 'dart:typed_data';
+
+import 'package:clip_flow/core/services/platform/ocr/native_ocr_impl.dart';
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+/// 捕获时识别随剪贴板变化被取代
+///
+/// 原生侧由一个替身代替：按剪贴板序号登记带 captureSequence 的识别，
+/// 序号前进时以 CANCELLED 结束早于它的识别，与 Linux 插件的约定一致。
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  const channel = MethodChannel('clipboard_service');
+  late int sequence;
+  late Map<int, (int, Completer<Object?>)> pending;
+  late List<Map<Object?, Object?>> calls;
+
+  // 剪贴板内容变化：取消属于更早捕获的识别
+  void captureChanged() {
+    sequence++;
+    pending.removeWhere((jobId, job) {
+      final (captureSequence, completer) = job;
+      if (captureSequence >= sequence) return false;
+      completer.completeError(
+        PlatformException(code: 'CANCELLED', message: 'OCR job was cancelled'),
+      );
+      return true;
+    });
+  }
+
+  setUp(() {
+    sequence = 1;
+    pending = {};
+    calls = [];
+    channel.setMockMethodCallHandler((call) async {
+      if (call.method != 'performOCR') return null;
+      final args = call.arguments as Map;
+      calls.add(args);
+      final captureSequence = args['captureSequence'] as int?;
+      if (captureSequence == null) {
+        return {'text': 'untracked', 'confidence': 0.9};
+      }
+      final completer = Completer<Object?>();
+      pending[args['jobId'] as int] = (captureSequence, completer);
+      return completer.future;
+    });
+  });
+
+  tearDown(() {
+    channel.setMockMethodCallHandler(null);
+  });
+
+  test('第二次捕获取代第一次捕获的识别', () async {
+    final ocr = NativeOcrImpl();
+    final first = ocr.recognizeText(
+      Uint8List.fromList([1, 2, 3]),
+      captureSequence: sequence,
+    );
+    await Future<void>.delayed(Duration.zero);
+
+    captureChanged();
+    final second = ocr.recognizeText(
+      Uint8List.fromList([4, 5, 6]),
+      captureSequence: sequence,
+    );
+    await Future<void>.delayed(Duration.zero);
+
+    expect(await first, isNull);
+    expect(pending, hasLength(1));
+    final (_, completer) = pending.values.single;
+    completer.complete({'text': 'second', 'confidence': 0.9});
+    expect((await second)?.text, equals('second'));
+
+    expect(calls.map((args) => args['captureSequence']), equals([1, 2]));
+    expect(calls.every((args) => args['supersede'] == true), isTrue);
+  });
+
+  test('未给出捕获序号的识别不受剪贴板变化影响', () async {
+    final result = await NativeOcrImpl().recognizeText(
+      Uint8List.fromList([1, 2, 3]),
+    );
+    expect(result?.text, equals('untracked'));
+    expect(calls.single.containsKey('captureSequence'), isFalse);
+    expect(calls.single.containsKey('supersede'), isFalse);
+  });
+}
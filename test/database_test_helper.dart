@@ -0,0 +1,42 @@
+import 'dart:io';
+
+import 'package:clip_flow/core/services/storage/index.dart';
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:sqflite/sqflite.dart' show databaseFactory;
+import 'package:sqflite_common_ffi/sqflite_ffi.dart'
+    show databaseFactoryFfi, sqfliteFfiInit;
+
+/// 为当前测试组准备真实的数据库环境
+///
+/// 测试进程中没有 sqflite 的原生插件，数据库改用 FFI 实现，文件放在临时目录
+/// （通过 path_provider 通道指向该目录）。clipboard_service 通道的调用交给
+/// [onClipboardCall]；每个测试结束后清空剪贴板条目，整组结束后删除临时目录。
+void setUpDatabaseTest({
+  required Future<Object?> Function(MethodCall call) onClipboardCall,
+}) {
+  const clipboardChannel = MethodChannel('clipboard_service');
+  const pathProviderChannel = MethodChannel('plugins.flutter.io/path_provider');
+  late Directory supportDir;
+
+  setUpAll(() async {
+    sqfliteFfiInit();
+    databaseFactory = databaseFactoryFfi;
+    supportDir = await Directory.systemTemp.createTemp('clip_flow_test');
+    pathProviderChannel.setMockMethodCallHandler((call) async {
+      return supportDir.path;
+    });
+    clipboardChannel.setMockMethodCallHandler(onClipboardCall);
+    await DatabaseService.instance.initialize();
+  });
+
+  tearDownAll(() async {
+    clipboardChannel.setMockMethodCallHandler(null);
+    pathProviderChannel.setMockMethodCallHandler(null);
+    await supportDir.delete(recursive: true);
+  });
+
+  tearDown(() async {
+    await DatabaseService.instance.clearAllClipItems();
+  });
+}
@@ -18,6 +18,8 @@ class MockOcrService implements OcrService {
     Uint8List imageBytes, {
     String language = 'auto',
     double? minConfidence,
+    double? textThreshold,
+    int? captureSequence,
   }) async {
     // 模拟OCR处理
     if (imageBytes.isEmpty) {
@@ -36,6 +38,11 @@ class MockOcrService implements OcrService {
     );
   }
 
+  @override
+  Future<void> warmUp({String language = 'auto'}) async {
+    // 模拟预热
+  }
+
   @override
   Future<void> dispose() async {
     // 模拟清理